@@ -1,41 +1,316 @@
 #include "AsyncFileWriter.h"
 #include <quentier/logging/QuentierLogger.h>
 #include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTemporaryFile>
+#include <QMutexLocker>
+#include <QScopedPointer>
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstdio>
+#endif
+
+// The appended data is written in chunks of this size so that the cancellation doesn't have to wait
+// for a large piece of data to be written entirely
+#define ASYNC_FILE_WRITER_CHUNK_SIZE (1024 * 1024)
 
 namespace quentier {
 
+namespace {
+
+bool syncFileToDisk(QFile & file)
+{
+    if (!file.flush()) {
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    return (_commit(file.handle()) == 0);
+#else
+    return (::fsync(file.handle()) == 0);
+#endif
+}
+
+QFile::Permissions targetFilePermissions(const QString & targetFilePath)
+{
+    // The replaced file keeps its permissions
+    QFileInfo targetFileInfo(targetFilePath);
+    if (targetFileInfo.exists()) {
+        return targetFileInfo.permissions();
+    }
+
+    // NOTE: the process umask is not queried since that can only be done by changing it for the whole process
+    return QFile::ReadOwner | QFile::WriteOwner | QFile::ReadUser | QFile::WriteUser |
+           QFile::ReadGroup | QFile::ReadOther;
+}
+
+bool replaceFile(const QString & sourceFilePath, const QString & targetFilePath, const bool syncToDisk,
+                 QString & errorDescription)
+{
+#ifdef Q_OS_WIN
+    DWORD flags = MOVEFILE_REPLACE_EXISTING;
+    if (syncToDisk) {
+        flags |= MOVEFILE_WRITE_THROUGH;
+    }
+
+    QString nativeSourceFilePath = QDir::toNativeSeparators(sourceFilePath);
+    QString nativeTargetFilePath = QDir::toNativeSeparators(targetFilePath);
+    if (!MoveFileExW(reinterpret_cast<const wchar_t*>(nativeSourceFilePath.utf16()),
+                     reinterpret_cast<const wchar_t*>(nativeTargetFilePath.utf16()), flags))
+    {
+        errorDescription = qt_error_string();
+        return false;
+    }
+#else
+    if (::rename(QFile::encodeName(sourceFilePath).constData(), QFile::encodeName(targetFilePath).constData()) != 0) {
+        errorDescription = qt_error_string();
+        return false;
+    }
+
+    if (syncToDisk)
+    {
+        // Make the rename itself durable
+        int dirFd = ::open(QFile::encodeName(QFileInfo(targetFilePath).absolutePath()).constData(), O_RDONLY);
+        if (dirFd >= 0) {
+            Q_UNUSED(::fsync(dirFd))
+            Q_UNUSED(::close(dirFd))
+        }
+    }
+#endif
+
+    return true;
+}
+
+} // namespace
+
 AsyncFileWriter::AsyncFileWriter(const QString & filePath,
                                  const QByteArray & dataToWrite,
                                  QObject * parent) :
     QObject(parent),
     QRunnable(),
     m_filePath(filePath),
-    m_dataToWrite(dataToWrite)
-{}
+    m_atomicWrite(true),
+    m_syncToDisk(false),
+    m_mutex(),
+    m_dataAppended(),
+    m_dataToWrite(),
+    m_numBytesTotal(static_cast<qint64>(dataToWrite.size())),
+    m_finished(true),
+    m_canceled(false)
+{
+    // NOTE: the object deletes itself once the writing is over
+    setAutoDelete(false);
+    m_dataToWrite.enqueue(dataToWrite);
+}
+
+AsyncFileWriter::AsyncFileWriter(const QString & filePath, QObject * parent) :
+    QObject(parent),
+    QRunnable(),
+    m_filePath(filePath),
+    m_atomicWrite(true),
+    m_syncToDisk(false),
+    m_mutex(),
+    m_dataAppended(),
+    m_dataToWrite(),
+    m_numBytesTotal(0),
+    m_finished(false),
+    m_canceled(false)
+{
+    setAutoDelete(false);
+}
+
+void AsyncFileWriter::appendData(QByteArray & data)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+
+    qint64 dataSize = static_cast<qint64>(data.size());
+
+    QMutexLocker locker(&m_mutex);
+    if (Q_UNLIKELY(m_finished)) {
+        QNWARNING(QStringLiteral("AsyncFileWriter: detected attempt to append data after the writing was finished"));
+        return;
+    }
+
+    // Take over the buffer without touching its reference count
+    m_dataToWrite.enqueue(QByteArray());
+    m_dataToWrite.last().swap(data);
+
+    m_numBytesTotal += dataSize;
+    m_dataAppended.wakeOne();
+}
+
+void AsyncFileWriter::finishWriting()
+{
+    QMutexLocker locker(&m_mutex);
+    m_finished = true;
+    m_dataAppended.wakeOne();
+}
+
+void AsyncFileWriter::cancel()
+{
+    QMutexLocker locker(&m_mutex);
+    m_finished = true;
+    m_canceled = true;
+    m_dataToWrite.clear();
+    m_dataAppended.wakeOne();
+}
 
 void AsyncFileWriter::run()
 {
     QNDEBUG(QStringLiteral("AsyncFileWriter::run: file path = ") << m_filePath);
 
-    QFile file(m_filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
+    writeFile();
+    deleteLater();
+}
+
+void AsyncFileWriter::writeFile()
+{
+    QScopedPointer<QFile> pFile;
+    if (m_atomicWrite)
+    {
+        // The temporary file needs to reside in the same directory as the target file for the rename to be atomic
+        QTemporaryFile * pTemporaryFile = new QTemporaryFile(m_filePath + QStringLiteral(".XXXXXX"));
+        pTemporaryFile->setAutoRemove(true);
+        pFile.reset(pTemporaryFile);
+    }
+    else
+    {
+        pFile.reset(new QFile(m_filePath));
+    }
+
+    if (!pFile->open(QIODevice::WriteOnly)) {
         ErrorString error(QT_TR_NOOP("can't open file for writing"));
+        error.details() = pFile->errorString();
+        QNWARNING(error);
+        Q_EMIT fileWriteFailed(error);
+        return;
+    }
+
+    QFile & file = *pFile;
+    qint64 bytesWrittenTotal = 0;
+
+    while(true)
+    {
+        QByteArray data;
+
+        {
+            QMutexLocker locker(&m_mutex);
+            while(m_dataToWrite.isEmpty() && !m_finished) {
+                m_dataAppended.wait(&m_mutex);
+            }
+
+            if (m_canceled) {
+                QNDEBUG(QStringLiteral("The writing of the file was canceled"));
+                file.close();
+                Q_UNUSED(file.remove())
+                return;
+            }
+
+            if (m_dataToWrite.isEmpty()) {
+                break;
+            }
+
+            // The dequeued buffer is released right after it is written
+            data.swap(m_dataToWrite.head());
+            m_dataToWrite.dequeue();
+        }
+
+        qint64 dataSize = static_cast<qint64>(data.size());
+        qint64 offset = 0;
+        while(offset < dataSize)
+        {
+            if (offset > 0)
+            {
+                QMutexLocker locker(&m_mutex);
+                if (m_canceled) {
+                    QNDEBUG(QStringLiteral("The writing of the file was canceled"));
+                    locker.unlock();
+                    file.close();
+                    Q_UNUSED(file.remove())
+                    return;
+                }
+            }
+
+            qint64 chunkSize = std::min(dataSize - offset, static_cast<qint64>(ASYNC_FILE_WRITER_CHUNK_SIZE));
+            qint64 bytesWritten = file.write(data.constData() + offset, chunkSize);
+            if (bytesWritten > 0) {
+                bytesWrittenTotal += bytesWritten;
+            }
+
+            if (bytesWritten != chunkSize)
+            {
+                qint64 numBytesTotal = 0;
+                {
+                    QMutexLocker locker(&m_mutex);
+                    numBytesTotal = m_numBytesTotal;
+                    m_finished = true;
+                    m_dataToWrite.clear();
+                }
+
+                QNDEBUG(QStringLiteral("Couldn't write the entire file: expected ")
+                        << numBytesTotal << QStringLiteral(", got only ") << bytesWrittenTotal
+                        << QStringLiteral("; error: ") << file.errorString());
+
+                if (m_atomicWrite) {
+                    // The target file is left intact
+                    file.close();
+                    Q_UNUSED(file.remove())
+                }
+
+                Q_EMIT fileWriteIncomplete(bytesWrittenTotal, numBytesTotal);
+                return;
+            }
+
+            offset += bytesWritten;
+        }
+
+        Q_EMIT dataWritten(dataSize);
+    }
+
+    if (m_syncToDisk && !syncFileToDisk(file))
+    {
+        ErrorString error(QT_TR_NOOP("can't flush the written file to disk"));
         error.details() = file.errorString();
         QNWARNING(error);
+        file.close();
+        if (m_atomicWrite) {
+            Q_UNUSED(file.remove())
+        }
         Q_EMIT fileWriteFailed(error);
+        return;
     }
 
-    qint64 dataSize = static_cast<qint64>(m_dataToWrite.size());
-    qint64 bytesWritten = file.write(m_dataToWrite);
-    if (bytesWritten != dataSize) {
-        QNDEBUG(QStringLiteral("Couldn't write the entire file: expected ")
-                << dataSize << QStringLiteral(", got only ") << bytesWritten);
-        Q_EMIT fileWriteIncomplete(bytesWritten, dataSize);
+    if (m_atomicWrite) {
+        // QTemporaryFile creates the file readable and writable by the owner only
+        Q_UNUSED(file.setPermissions(targetFilePermissions(m_filePath)))
     }
-    else {
-        QNDEBUG(QStringLiteral("Successfully written the file"));
-        Q_EMIT fileSuccessfullyWritten(m_filePath);
+
+    file.close();
+
+    if (m_atomicWrite)
+    {
+        QString errorDescription;
+        if (!replaceFile(file.fileName(), m_filePath, m_syncToDisk, errorDescription)) {
+            ErrorString error(QT_TR_NOOP("can't replace the target file with the written one"));
+            error.details() = errorDescription;
+            QNWARNING(error);
+            Q_UNUSED(file.remove())
+            Q_EMIT fileWriteFailed(error);
+            return;
+        }
     }
+
+    QNDEBUG(QStringLiteral("Successfully written the file"));
+    Q_EMIT fileSuccessfullyWritten(m_filePath);
 }
 
 } // namespace quentier
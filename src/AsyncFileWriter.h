@@ -6,9 +6,25 @@
 #include <QObject>
 #include <QRunnable>
 #include <QString>
+#include <QByteArray>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
 
 namespace quentier {
 
+/**
+ * @brief The AsyncFileWriter class writes the data to file within the thread pool's thread
+ *
+ * The data can either be passed in full to the constructor or be streamed: in the latter case the data is appended
+ * piece by piece via appendData from the object's own thread while the writing is already in progress; the writing
+ * finishes once finishWriting is called and all the appended data is written. The object deletes itself
+ * once the writing is over so the streaming side should keep a QPointer to it
+ *
+ * By default the data is written into a temporary file next to the target one which then atomically replaces
+ * the target file so that the target file is never left partially written; the data is written in chunks
+ * so that the cancellation doesn't have to wait for a large piece of data to be written entirely
+ */
 class AsyncFileWriter: public QObject,
                        public QRunnable
 {
@@ -17,18 +33,65 @@ public:
     explicit AsyncFileWriter(const QString & filePath, const QByteArray & dataToWrite,
                              QObject * parent = Q_NULLPTR);
 
+    /**
+     * Constructs the writer for streaming the data into the file
+     */
+    explicit AsyncFileWriter(const QString & filePath, QObject * parent = Q_NULLPTR);
+
+    /**
+     * Whether the data should be written into a temporary file replacing the target file once all the data
+     * is written; true by default; must be set before the writing starts
+     */
+    bool atomicWrite() const { return m_atomicWrite; }
+    void setAtomicWrite(const bool atomicWrite) { m_atomicWrite = atomicWrite; }
+
+    /**
+     * Whether the written data should be flushed to disk before the file is considered written; false by default;
+     * must be set before the writing starts
+     */
+    bool syncToDisk() const { return m_syncToDisk; }
+    void setSyncToDisk(const bool syncToDisk) { m_syncToDisk = syncToDisk; }
+
+    /**
+     * Appends the data to write; the writer takes the buffer over so that it can release the memory as soon as
+     * the data is written, @param data is left empty; the caller which needs to keep the data should pass a copy
+     * which is cheap since QByteArray is implicitly shared
+     */
+    void appendData(QByteArray & data);
+    void finishWriting();
+
+    /**
+     * Stops the writing and removes the partially written file
+     */
+    void cancel();
+
 Q_SIGNALS:
     void fileSuccessfullyWritten(QString filePath);
     void fileWriteFailed(ErrorString error);
     void fileWriteIncomplete(const qint64 bytesWritten,
                              const qint64 bytesTotal);
 
+    /**
+     * The signal emitted each time the next appended piece of data has been written into the file
+     */
+    void dataWritten(qint64 numBytes);
+
 private:
     virtual void run() Q_DECL_OVERRIDE;
 
+    void writeFile();
+
 private:
-    QString     m_filePath;
-    QByteArray  m_dataToWrite;
+    QString             m_filePath;
+    bool                m_atomicWrite;
+    bool                m_syncToDisk;
+
+    QMutex              m_mutex;
+    QWaitCondition      m_dataAppended;
+    QQueue<QByteArray>  m_dataToWrite;
+    qint64              m_numBytesTotal;
+    bool                m_finished;
+    bool                m_canceled;
 };
 
 } // namespace quentier
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_CANCELLATION_FLAG_H
+#define QUENTIER_CANCELLATION_FLAG_H
+
+#include <QtGlobal>
+#include <QAtomicInt>
+
+namespace quentier {
+
+/**
+ * Helpers for the QAtomicInt based flags by which the background jobs are canceled:
+ * QAtomicInt::loadAcquire and QAtomicInt::storeRelease only exist in Qt5
+ * so Qt4 builds use the ordered read-modify-write operations existing in both
+ */
+
+inline bool isCanceled(QAtomicInt & canceledFlag)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    return (canceledFlag.loadAcquire() != 0);
+#else
+    // Only succeeds (and changes nothing) if the flag is already set
+    return canceledFlag.testAndSetOrdered(1, 1);
+#endif
+}
+
+inline void setCanceled(QAtomicInt & canceledFlag)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    canceledFlag.storeRelease(1);
+#else
+    Q_UNUSED(canceledFlag.fetchAndStoreOrdered(1))
+#endif
+}
+
+} // namespace quentier
+
+#endif // QUENTIER_CANCELLATION_FLAG_H
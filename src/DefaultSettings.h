@@ -30,6 +30,11 @@
 #define DEFAULT_REMOVE_EMPTY_UNEDITED_NOTES (true)
 #define DEFAULT_EDITOR_CONVERT_TO_NOTE_TIMEOUT (500)
 #define DEFAULT_EXPUNGE_NOTE_TIMEOUT (500)
+#define DEFAULT_AUTO_SAVE_NOTE_IDLE_TIMEOUT (3000)
+#define DEFAULT_AUTO_SAVE_NOTE_MAX_DELAY (30000)
+
+// In megabytes; zero or negative limit means no note editor tabs are ever hibernated
+#define DEFAULT_NOTE_EDITOR_TABS_MEMORY_LIMIT (256)
 
 #define DEFAULT_DOWNLOAD_NOTE_THUMBNAILS (true)
 #define DEFAULT_DOWNLOAD_INK_NOTE_IMAGES (true)
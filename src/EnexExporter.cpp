@@ -1,35 +1,64 @@
 #include "EnexExporter.h"
+#include "AsyncFileWriter.h"
+#include "CancellationFlag.h"
+#include "EnexNoteEncoderAsync.h"
 #include "NoteEditorTabsAndWindowsCoordinator.h"
-#include "widgets/NoteEditorWidget.h"
 #include "models/TagModel.h"
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
-#include <quentier/enml/ENMLConverter.h>
 #include <quentier/logging/QuentierLogger.h>
 #include <QVector>
+#include <QThreadPool>
+#include <QThread>
+#include <algorithm>
 
-#define QUENTIER_ENEX_VERSION QStringLiteral("Quentier")
+// The limits on the number of notes fetched from the local storage but not yet written to ENEX file
+// (per encoding thread) and on the amount of ENEX data passed on to the file writer but not yet written
+#define ENEX_EXPORTER_MAX_PENDING_NOTES_PER_THREAD (4)
+#define ENEX_EXPORTER_MAX_PENDING_WRITE_BYTES (32 * 1024 * 1024)
 
 namespace quentier {
 
 EnexExporter::EnexExporter(LocalStorageManagerAsync & localStorageManagerAsync,
-                           NoteEditorTabsAndWindowsCoordinator & coordinator,
+                           NoteEditorTabsAndWindowsCoordinator * pCoordinator,
                            TagModel & tagModel, QObject * parent) :
     QObject(parent),
     m_localStorageManagerAsync(localStorageManagerAsync),
-    m_noteEditorTabsAndWindowsCoordinator(coordinator),
+    m_pNoteEditorTabsAndWindowsCoordinator(pCoordinator),
     m_pTagModel(&tagModel),
+    m_targetEnexFilePath(),
     m_noteLocalUids(),
-    m_findNoteRequestIds(),
-    m_notesByLocalUid(),
-    m_includeTags(),
+    m_includeTags(false),
+    m_noteIndicesToFind(),
+    m_nextNoteToFindIndex(0),
+    m_noteIndexByFindNoteRequestId(),
+    m_foundNoteIndicesPendingWrite(),
+    m_noteIndexBySavingNoteLocalUid(),
+    m_notesPendingEncodingByIndex(),
+    m_encodeNotesRequestId(),
+    m_pEncodeNotesCanceled(),
+    m_encoderThreadPool(),
+    m_encodedNotesByIndex(),
+    m_nextNoteToWriteIndex(0),
+    m_enexHeader(),
+    m_enexFooter(),
+    m_pEnexFileWriter(),
+    m_numBytesPendingWrite(0),
+    m_allNotesWritten(false),
     m_connectedToLocalStorage(false)
 {
+    m_encoderThreadPool.setMaxThreadCount(std::max(QThread::idealThreadCount(), 1));
+
     if (!tagModel.allTagsListed()) {
         QObject::connect(&tagModel, QNSIGNAL(TagModel,notifyAllTagsListed),
                          this, QNSLOT(EnexExporter,onAllTagsListed));
     }
 }
 
+EnexExporter::~EnexExporter()
+{
+    cancel();
+}
+
 void EnexExporter::setNoteLocalUids(const QStringList & noteLocalUids)
 {
     QNDEBUG(QStringLiteral("EnexExporter::setNoteLocalUids: ")
@@ -68,8 +97,8 @@ bool EnexExporter::isInProgress() const
         return false;
     }
 
-    if (m_findNoteRequestIds.isEmpty()) {
-        QNDEBUG(QStringLiteral("No pending requests to find notes in the local storage"));
+    if (m_pEnexFileWriter.isNull()) {
+        QNDEBUG(QStringLiteral("The ENEX file is not being written"));
         return false;
     }
 
@@ -94,94 +123,146 @@ void EnexExporter::start()
         return;
     }
 
-    m_findNoteRequestIds.clear();
-    m_notesByLocalUid.clear();
+    if (m_targetEnexFilePath.isEmpty()) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't export note to ENEX: no target file path was specified"));
+        QNWARNING(errorDescription);
+        Q_EMIT failedToExportNotesToEnex(errorDescription);
+        return;
+    }
 
-    for(auto it = m_noteLocalUids.constBegin(), end = m_noteLocalUids.constEnd(); it != end; ++it)
+    cancel();
+
+    m_pEnexFileWriter = new AsyncFileWriter(m_targetEnexFilePath);
+    // The existing ENEX file at the target path is only replaced once the entire new one is written to disk
+    m_pEnexFileWriter->setSyncToDisk(true);
+    QObject::connect(m_pEnexFileWriter.data(), QNSIGNAL(AsyncFileWriter,dataWritten,qint64),
+                     this, QNSLOT(EnexExporter,onEnexDataWritten,qint64));
+    QObject::connect(m_pEnexFileWriter.data(), QNSIGNAL(AsyncFileWriter,fileSuccessfullyWritten,QString),
+                     this, QNSLOT(EnexExporter,onEnexFileWritten,QString));
+    QObject::connect(m_pEnexFileWriter.data(), QNSIGNAL(AsyncFileWriter,fileWriteFailed,ErrorString),
+                     this, QNSLOT(EnexExporter,onEnexFileWriteFailed,ErrorString));
+    QObject::connect(m_pEnexFileWriter.data(), QNSIGNAL(AsyncFileWriter,fileWriteIncomplete,qint64,qint64),
+                     this, QNSLOT(EnexExporter,onEnexFileWriteIncomplete,qint64,qint64));
+    QThreadPool::globalInstance()->start(m_pEnexFileWriter.data());
+
+    m_encodeNotesRequestId = QUuid::createUuid();
+    m_pEncodeNotesCanceled = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+
+    for(int i = 0, numNotes = m_noteLocalUids.size(); i < numNotes; ++i)
     {
-        const QString & noteLocalUid = *it;
+        const QString & noteLocalUid = m_noteLocalUids.at(i);
 
-        NoteEditorWidget * pNoteEditorWidget = m_noteEditorTabsAndWindowsCoordinator.noteEditorWidgetForNoteLocalUid(noteLocalUid);
+        NoteEditorWidget * pNoteEditorWidget = (m_pNoteEditorTabsAndWindowsCoordinator.isNull()
+                                                ? Q_NULLPTR
+                                                : m_pNoteEditorTabsAndWindowsCoordinator->noteEditorWidgetForNoteLocalUid(noteLocalUid));
         if (!pNoteEditorWidget) {
             QNTRACE(QStringLiteral("Found no note editor widget for note local uid ") << noteLocalUid);
-            findNoteInLocalStorage(noteLocalUid);
+            m_noteIndicesToFind << i;
             continue;
         }
 
         QNTRACE(QStringLiteral("Found note editor with loaded note ") << noteLocalUid);
 
+        if (pNoteEditorWidget->isLoadingResourceBinaryData()) {
+            QNDEBUG(QStringLiteral("The note editor has no binary data of the note's resources yet, will find the note "
+                                   "in the local storage"));
+            m_noteIndicesToFind << i;
+            continue;
+        }
+
         const Note * pNote = pNoteEditorWidget->currentNote();
         if (Q_UNLIKELY(!pNote)) {
             QNDEBUG(QStringLiteral("There is no note in the editor, will try to find it "
                                    "in the local storage"));
-            findNoteInLocalStorage(noteLocalUid);
+            m_noteIndicesToFind << i;
             continue;
         }
 
         if (!pNoteEditorWidget->isModified()) {
             QNTRACE(QStringLiteral("Fetched the unmodified note from editor: ") << noteLocalUid);
-            m_notesByLocalUid[noteLocalUid] = *pNote;
-            continue;
-        }
-
-        QNTRACE(QStringLiteral("The note within the editor was modified, saving it"));
-
-        ErrorString noteSavingError;
-        NoteEditorWidget::NoteSaveStatus::type saveStatus = pNoteEditorWidget->checkAndSaveModifiedNote(noteSavingError);
-        if (saveStatus != NoteEditorWidget::NoteSaveStatus::Ok) {
-            QNWARNING(QStringLiteral("Could not save the note loaded into the editor: status = ")
-                      << saveStatus << QStringLiteral(", error: ") << noteSavingError
-                      << QStringLiteral("; will try to find the note in the local storage"));
-            findNoteInLocalStorage(noteLocalUid);
+            m_notesPendingEncodingByIndex[i] = *pNote;
             continue;
         }
 
-        pNote = pNoteEditorWidget->currentNote();
-        if (Q_UNLIKELY(!pNote)) {
-            QNWARNING(QStringLiteral("Note editor's current note has unexpectedly become nullptr "
-                                     "after the note has been saved; will try to find the note "
-                                     "in the local storage"));
-            findNoteInLocalStorage(noteLocalUid);
+        if (!pNoteEditorWidget->isSavingNote() && !pNoteEditorWidget->saveModifiedNoteAsync()) {
+            QNTRACE(QStringLiteral("Fetched the note from editor, there was nothing to save: ") << noteLocalUid);
+            m_notesPendingEncodingByIndex[i] = *pNote;
             continue;
         }
 
-        QNTRACE(QStringLiteral("Fetched the modified & saved note from editor: ") << noteLocalUid);
-        m_notesByLocalUid[noteLocalUid] = *pNote;
+        QNTRACE(QStringLiteral("The note within the editor was modified, it would be taken from the editor "
+                               "once it is saved"));
+        m_noteIndexBySavingNoteLocalUid[noteLocalUid] = i;
+        QObject::connect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,noteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString),
+                         this, QNSLOT(EnexExporter,onNoteEditorNoteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString),
+                         Qt::UniqueConnection);
     }
 
-    if (!m_findNoteRequestIds.isEmpty()) {
-        QNDEBUG(QStringLiteral("Not all requested notes were found loaded into the editors, "
-                               "currently pending ") << m_findNoteRequestIds.size()
-                << QStringLiteral(" find note in local storage requests "));
-        return;
-    }
+    QNDEBUG(QStringLiteral("Gathered ") << m_notesPendingEncodingByIndex.size()
+            << QStringLiteral(" notes from the editors, ") << m_noteIndicesToFind.size()
+            << QStringLiteral(" notes need to be found in the local storage, ") << m_noteIndexBySavingNoteLocalUid.size()
+            << QStringLiteral(" notes are being saved within the editors"));
 
-    QNDEBUG(QStringLiteral("All requested notes were found loaded into the editors "
-                           "and were successfully gathered from them"));
+    encodeReadyNotes();
+    findNotesInLocalStorage();
+}
 
-    if (m_includeTags && !m_pTagModel->allTagsListed()) {
-        QNDEBUG(QStringLiteral("Waiting for the tag model to get all tags listed"));
-        return;
+void EnexExporter::cancel()
+{
+    if (!m_pEnexFileWriter.isNull()) {
+        QNDEBUG(QStringLiteral("EnexExporter::cancel"));
+        QObject::disconnect(m_pEnexFileWriter.data(), Q_NULLPTR, this, Q_NULLPTR);
+        m_pEnexFileWriter->cancel();
+        m_pEnexFileWriter.clear();
     }
 
-    ErrorString errorDescription;
-    QString enex = convertNotesToEnex(errorDescription);
-    if (enex.isEmpty()) {
-        Q_EMIT failedToExportNotesToEnex(errorDescription);
-        return;
+    if (!m_pEncodeNotesCanceled.isNull()) {
+        setCanceled(*m_pEncodeNotesCanceled);
+        m_pEncodeNotesCanceled.clear();
+    }
+
+    resetExportState();
+}
+
+void EnexExporter::resetExportState()
+{
+    if (!m_pNoteEditorTabsAndWindowsCoordinator.isNull())
+    {
+        for(auto it = m_noteIndexBySavingNoteLocalUid.constBegin(),
+            end = m_noteIndexBySavingNoteLocalUid.constEnd(); it != end; ++it)
+        {
+            NoteEditorWidget * pNoteEditorWidget =
+                m_pNoteEditorTabsAndWindowsCoordinator->noteEditorWidgetForNoteLocalUid(it.key());
+            if (pNoteEditorWidget) {
+                QObject::disconnect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,noteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString),
+                                    this, QNSLOT(EnexExporter,onNoteEditorNoteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString));
+            }
+        }
     }
 
-    Q_EMIT notesExportedToEnex(enex);
+    m_noteIndexBySavingNoteLocalUid.clear();
+    m_noteIndicesToFind.clear();
+    m_nextNoteToFindIndex = 0;
+    m_noteIndexByFindNoteRequestId.clear();
+    m_foundNoteIndicesPendingWrite.clear();
+    m_notesPendingEncodingByIndex.clear();
+    m_encodeNotesRequestId = QUuid();
+    m_encodedNotesByIndex.clear();
+    m_nextNoteToWriteIndex = 0;
+    m_enexHeader.clear();
+    m_enexFooter.clear();
+    m_numBytesPendingWrite = 0;
+    m_allNotesWritten = false;
 }
 
 void EnexExporter::clear()
 {
     QNDEBUG(QStringLiteral("EnexExporter::clear"));
 
+    cancel();
+
     m_targetEnexFilePath.clear();
     m_noteLocalUids.clear();
-    m_findNoteRequestIds.clear();
-    m_notesByLocalUid.clear();
 
     disconnectFromLocalStorage();
     m_connectedToLocalStorage = false;
@@ -189,56 +270,34 @@ void EnexExporter::clear()
 
 void EnexExporter::onFindNoteComplete(Note note, bool withResourceBinaryData, QUuid requestId)
 {
-    auto it = m_findNoteRequestIds.find(requestId);
-    if (it == m_findNoteRequestIds.end()) {
+    auto it = m_noteIndexByFindNoteRequestId.find(requestId);
+    if (it == m_noteIndexByFindNoteRequestId.end()) {
         return;
     }
 
     QNDEBUG(QStringLiteral("EnexExporter::onFindNoteComplete: request id = ")
-            << requestId << QStringLiteral(", note: ") << note);
+            << requestId << QStringLiteral(", note local uid: ") << note.localUid());
 
     Q_UNUSED(withResourceBinaryData)
 
-    m_notesByLocalUid[note.localUid()] = note;
-    m_findNoteRequestIds.erase(it);
-
-    if (!m_findNoteRequestIds.isEmpty()) {
-        QNDEBUG(QStringLiteral("Still pending  ") << m_findNoteRequestIds.size()
-                << QStringLiteral(" find note in local storage requests "));
-        return;
-    }
-
-    if (m_includeTags)
-    {
-        if (Q_UNLIKELY(m_pTagModel.isNull())) {
-            ErrorString errorDescription(QT_TR_NOOP("Can't export note(s) to ENEX: the tag model has expired"));
-            QNWARNING(errorDescription);
-            clear();
-            Q_EMIT failedToExportNotesToEnex(errorDescription);
-            return;
-        }
-
-        if (!m_pTagModel->allTagsListed()) {
-            QNDEBUG(QStringLiteral("Not all tags were listed within the tag model yet"));
-            return;
-        }
-    }
+    m_notesPendingEncodingByIndex[it.value()] = note;
+    Q_UNUSED(m_noteIndexByFindNoteRequestId.erase(it))
 
-    ErrorString errorDescription;
-    QString enex = convertNotesToEnex(errorDescription);
-    if (enex.isEmpty()) {
-        Q_EMIT failedToExportNotesToEnex(errorDescription);
+    if (m_includeTags && Q_UNLIKELY(m_pTagModel.isNull())) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't export note(s) to ENEX: the tag model has expired"));
+        QNWARNING(errorDescription);
+        failExport(errorDescription);
         return;
     }
 
-    Q_EMIT notesExportedToEnex(enex);
+    encodeReadyNotes();
 }
 
 void EnexExporter::onFindNoteFailed(Note note, bool withResourceBinaryData,
                                     ErrorString errorDescription, QUuid requestId)
 {
-    auto it = m_findNoteRequestIds.find(requestId);
-    if (it == m_findNoteRequestIds.end()) {
+    auto it = m_noteIndexByFindNoteRequestId.find(requestId);
+    if (it == m_noteIndexByFindNoteRequestId.end()) {
         return;
     }
 
@@ -254,8 +313,7 @@ void EnexExporter::onFindNoteFailed(Note note, bool withResourceBinaryData,
     error.details() = errorDescription.details();
     QNWARNING(error);
 
-    clear();
-    Q_EMIT failedToExportNotesToEnex(error);
+    failExport(error);
 }
 
 void EnexExporter::onAllTagsListed()
@@ -265,36 +323,156 @@ void EnexExporter::onAllTagsListed()
     QObject::disconnect(m_pTagModel.data(), QNSIGNAL(TagModel,notifyAllTagsListed),
                         this, QNSLOT(EnexExporter,onAllTagsListed));
 
-    if (m_noteLocalUids.isEmpty()) {
-        QNDEBUG(QStringLiteral("No note local uids are specified, won't do anything"));
+    if (!isInProgress()) {
+        QNDEBUG(QStringLiteral("The export is not in progress, won't do anything"));
         return;
     }
 
-    if (!m_findNoteRequestIds.isEmpty()) {
-        QNDEBUG(QStringLiteral("Still pending  ") << m_findNoteRequestIds.size()
-                << QStringLiteral(" find note in local storage requests "));
+    encodeReadyNotes();
+}
+
+void EnexExporter::onNoteEditorNoteSaveFinished(NoteEditorWidget::NoteSaveStatus::type status,
+                                                ErrorString errorDescription)
+{
+    NoteEditorWidget * pNoteEditorWidget = qobject_cast<NoteEditorWidget*>(sender());
+    if (Q_UNLIKELY(!pNoteEditorWidget)) {
         return;
     }
 
-    ErrorString errorDescription;
-    QString enex = convertNotesToEnex(errorDescription);
-    if (enex.isEmpty()) {
-        Q_EMIT failedToExportNotesToEnex(errorDescription);
+    QObject::disconnect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,noteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString),
+                        this, QNSLOT(EnexExporter,onNoteEditorNoteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString));
+
+    auto it = m_noteIndexBySavingNoteLocalUid.find(pNoteEditorWidget->noteLocalUid());
+    if (it == m_noteIndexBySavingNoteLocalUid.end()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexExporter::onNoteEditorNoteSaveFinished: note local uid = ") << it.key()
+            << QStringLiteral(", status = ") << status << QStringLiteral(", error: ") << errorDescription);
+
+    int noteIndex = it.value();
+    Q_UNUSED(m_noteIndexBySavingNoteLocalUid.erase(it))
+
+    const Note * pNote = pNoteEditorWidget->currentNote();
+    if ((status != NoteEditorWidget::NoteSaveStatus::Ok) || !pNote) {
+        QNWARNING(QStringLiteral("Could not save the note loaded into the editor; will try to find the note "
+                                 "in the local storage"));
+
+        // NOTE: the note is found right away, past the limit of pending notes: the notes are written in order
+        // so the notes with higher indices filling that limit can't be written before this one
+        findNoteInLocalStorage(noteIndex);
         return;
     }
 
-    Q_EMIT notesExportedToEnex(enex);
+    QNTRACE(QStringLiteral("Fetched the modified & saved note from editor: ") << pNote->localUid());
+    m_notesPendingEncodingByIndex[noteIndex] = *pNote;
+    encodeReadyNotes();
+}
+
+void EnexExporter::onNoteEncoded(QByteArray noteEnex, QByteArray enexHeader, QByteArray enexFooter,
+                                 int noteIndex, QUuid requestId)
+{
+    if (requestId != m_encodeNotesRequestId) {
+        return;
+    }
+
+    QNTRACE(QStringLiteral("EnexExporter::onNoteEncoded: note index = ") << noteIndex);
+
+    if (m_enexHeader.isEmpty()) {
+        m_enexHeader = enexHeader;
+        m_enexFooter = enexFooter;
+    }
+
+    m_encodedNotesByIndex[noteIndex] = noteEnex;
+    writeEncodedNotes();
+}
+
+void EnexExporter::onNoteEncodingFailed(ErrorString errorDescription, QUuid requestId)
+{
+    if (requestId != m_encodeNotesRequestId) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("EnexExporter::onNoteEncodingFailed: ") << errorDescription);
+    failExport(errorDescription);
+}
+
+void EnexExporter::onEnexDataWritten(qint64 numBytes)
+{
+    QNTRACE(QStringLiteral("EnexExporter::onEnexDataWritten: ") << numBytes);
+
+    m_numBytesPendingWrite = std::max(m_numBytesPendingWrite - numBytes, qint64(0));
+
+    if (!m_allNotesWritten) {
+        findNotesInLocalStorage();
+    }
 }
 
-void EnexExporter::findNoteInLocalStorage(const QString & noteLocalUid)
+void EnexExporter::onEnexFileWritten(QString filePath)
 {
+    QNDEBUG(QStringLiteral("EnexExporter::onEnexFileWritten: ") << filePath);
+
+    m_pEnexFileWriter.clear();
+    resetExportState();
+    Q_EMIT notesExportedToEnex(filePath);
+}
+
+void EnexExporter::onEnexFileWriteFailed(ErrorString errorDescription)
+{
+    QNWARNING(QStringLiteral("EnexExporter::onEnexFileWriteFailed: ") << errorDescription);
+
+    ErrorString error(QT_TR_NOOP("Can't export note(s) to ENEX, failed to write the ENEX to file"));
+    error.appendBase(errorDescription.base());
+    error.appendBase(errorDescription.additionalBases());
+    error.details() = errorDescription.details();
+    failExport(error);
+}
+
+void EnexExporter::onEnexFileWriteIncomplete(qint64 bytesWritten, qint64 bytesTotal)
+{
+    QNWARNING(QStringLiteral("EnexExporter::onEnexFileWriteIncomplete: bytes written = ")
+              << bytesWritten << QStringLiteral(", bytes total = ") << bytesTotal);
+
+    ErrorString error(QT_TR_NOOP("Can't export note(s) to ENEX, failed to write the ENEX to file, "
+                                 "only a portion of data has been written"));
+    error.details() = QString::number(bytesWritten) + QStringLiteral("/") + QString::number(bytesTotal);
+    failExport(error);
+}
+
+void EnexExporter::findNotesInLocalStorage()
+{
+    // The notes are being encoded in parallel so there should be enough of them to keep all the encoding threads busy
+    int maxPendingNotes = std::max(m_encoderThreadPool.maxThreadCount(), 1) * ENEX_EXPORTER_MAX_PENDING_NOTES_PER_THREAD;
+
+    while(m_nextNoteToFindIndex < m_noteIndicesToFind.size())
+    {
+        if (m_foundNoteIndicesPendingWrite.size() >= maxPendingNotes) {
+            QNTRACE(QStringLiteral("Too many notes are pending write, won't find more notes for now"));
+            return;
+        }
+
+        if (m_numBytesPendingWrite >= ENEX_EXPORTER_MAX_PENDING_WRITE_BYTES) {
+            QNTRACE(QStringLiteral("Too much data is pending write, won't find more notes for now"));
+            return;
+        }
+
+        int noteIndex = m_noteIndicesToFind[m_nextNoteToFindIndex];
+        findNoteInLocalStorage(noteIndex);
+        ++m_nextNoteToFindIndex;
+    }
+}
+
+void EnexExporter::findNoteInLocalStorage(const int noteIndex)
+{
+    const QString & noteLocalUid = m_noteLocalUids.at(noteIndex);
     QNDEBUG(QStringLiteral("EnexExporter::findNoteInLocalStorage: ") << noteLocalUid);
 
     Note dummyNote;
     dummyNote.setLocalUid(noteLocalUid);
 
     QUuid requestId = QUuid::createUuid();
-    Q_UNUSED(m_findNoteRequestIds.insert(requestId))
+    m_noteIndexByFindNoteRequestId[requestId] = noteIndex;
+    Q_UNUSED(m_foundNoteIndicesPendingWrite.insert(noteIndex))
 
     connectToLocalStorage();
 
@@ -303,86 +481,160 @@ void EnexExporter::findNoteInLocalStorage(const QString & noteLocalUid)
     Q_EMIT findNote(dummyNote, /* with resource binary data */ true, requestId);
 }
 
-QString EnexExporter::convertNotesToEnex(ErrorString & errorDescription)
+void EnexExporter::encodeReadyNotes()
 {
-    QNDEBUG(QStringLiteral("EnexExporter::convertNotesToEnex"));
+    QNDEBUG(QStringLiteral("EnexExporter::encodeReadyNotes"));
 
-    if (m_notesByLocalUid.isEmpty()) {
-        errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: no notes were specified or found"));
-        QNWARNING(errorDescription);
-        return QString();
+    if (m_pEnexFileWriter.isNull() || m_pEncodeNotesCanceled.isNull()) {
+        QNDEBUG(QStringLiteral("The ENEX file is not being written"));
+        return;
     }
 
-    if (m_includeTags && m_pTagModel.isNull()) {
-        errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: the tag model has expired"));
-        QNWARNING(errorDescription);
-        return QString();
+    if (m_includeTags && !m_pTagModel->allTagsListed()) {
+        QNDEBUG(QStringLiteral("Waiting for the tag model to get all tags listed"));
+        return;
     }
 
-    QVector<Note> notes;
-    notes.reserve(m_notesByLocalUid.size());
+    // The tag names are collected here since the tag model can only be accessed from its own thread
+    for(auto it = m_notesPendingEncodingByIndex.constBegin(),
+        end = m_notesPendingEncodingByIndex.constEnd(); it != end; ++it)
+    {
+        const Note & note = it.value();
+
+        QHash<QString, QString> tagNameByTagLocalUid;
+        ErrorString errorDescription;
+        if (m_includeTags && !collectTagNames(note, tagNameByTagLocalUid, errorDescription)) {
+            failExport(errorDescription);
+            return;
+        }
+
+        EnexNoteEncoderAsync * pEncoder = new EnexNoteEncoderAsync(note, tagNameByTagLocalUid, m_includeTags,
+                                                                   it.key(), m_encodeNotesRequestId,
+                                                                   m_pEncodeNotesCanceled);
+        QObject::connect(pEncoder, QNSIGNAL(EnexNoteEncoderAsync,noteEncoded,QByteArray,QByteArray,QByteArray,int,QUuid),
+                         this, QNSLOT(EnexExporter,onNoteEncoded,QByteArray,QByteArray,QByteArray,int,QUuid),
+                         Qt::QueuedConnection);
+        QObject::connect(pEncoder, QNSIGNAL(EnexNoteEncoderAsync,failed,ErrorString,QUuid),
+                         this, QNSLOT(EnexExporter,onNoteEncodingFailed,ErrorString,QUuid),
+                         Qt::QueuedConnection);
+        m_encoderThreadPool.start(pEncoder);
+    }
 
-    QHash<QString, QString> tagNameByTagLocalUid;
-    for(auto it = m_notesByLocalUid.constBegin(), end = m_notesByLocalUid.constEnd(); it != end; ++it)
+    m_notesPendingEncodingByIndex.clear();
+}
+
+void EnexExporter::writeEncodedNotes()
+{
+    QNDEBUG(QStringLiteral("EnexExporter::writeEncodedNotes"));
+
+    if (m_pEnexFileWriter.isNull()) {
+        QNDEBUG(QStringLiteral("The ENEX file is not being written"));
+        return;
+    }
+
+    int numNotes = m_noteLocalUids.size();
+    while(!m_encodedNotesByIndex.isEmpty())
     {
-        const Note & currentNote = it.value();
+        auto it = m_encodedNotesByIndex.begin();
+        if (it.key() != m_nextNoteToWriteIndex) {
+            QNTRACE(QStringLiteral("The next note to write has not been encoded yet: ") << m_nextNoteToWriteIndex);
+            break;
+        }
 
-        if (m_includeTags && currentNote.hasTagLocalUids())
-        {
-            const QStringList & tagLocalUids = currentNote.tagLocalUids();
-            for(auto tagIt = tagLocalUids.constBegin(), tagEnd = tagLocalUids.constEnd(); tagIt != tagEnd; ++tagIt)
-            {
-                const TagModelItem * pModelItem = m_pTagModel->itemForLocalUid(*tagIt);
-                if (Q_UNLIKELY(!pModelItem)) {
-                    errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: internal error, "
-                                                        "detected note with tag local uid for which no tag "
-                                                        "model item was found"));
-                    QNWARNING(errorDescription << QStringLiteral(", tag local uid = ") << *tagIt
-                              << QStringLiteral(", note: ") << currentNote);
-                    return QString();
-                }
-
-                if (Q_UNLIKELY(pModelItem->type() != TagModelItem::Type::Tag)) {
-                    errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: internal error, "
-                                                        "detected tag model item corresponding to tag local uid "
-                                                        "but not of a tag type"));
-                    QNWARNING(errorDescription << QStringLiteral(", tag local uid = ") << *tagIt
-                              << QStringLiteral(", tag model item: ") << *pModelItem << QStringLiteral("\nNote: ")
-                              << currentNote);
-                    return QString();
-                }
-
-                const TagItem * pTagItem = pModelItem->tagItem();
-                if (Q_UNLIKELY(!pTagItem)) {
-                    errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: internal error, "
-                                                        "detected tag model item corresponding to tag local uid "
-                                                        "and of a tag type but containing no actual tag item"));
-                    QNWARNING(errorDescription << QStringLiteral(", tag local uid = ") << *tagIt
-                              << QStringLiteral(", tag model item: ") << *pModelItem << QStringLiteral("\nNote: ")
-                              << currentNote);
-                    return QString();
-                }
-
-                tagNameByTagLocalUid[*tagIt] = pTagItem->name();
-            }
+        if (m_nextNoteToWriteIndex == 0) {
+            QByteArray enexHeader = m_enexHeader;
+            writeEnexData(enexHeader);
         }
 
-        notes << currentNote;
+        // The encoded note is handed over to the writer which releases it as soon as it is written
+        QByteArray noteEnex;
+        noteEnex.swap(it.value());
+        writeEnexData(noteEnex);
+        Q_UNUSED(m_encodedNotesByIndex.erase(it))
+        Q_UNUSED(m_foundNoteIndicesPendingWrite.remove(m_nextNoteToWriteIndex))
+        ++m_nextNoteToWriteIndex;
+
+        Q_EMIT notesExportToEnexProgress(m_nextNoteToWriteIndex, numNotes);
+    }
+
+    if (m_nextNoteToWriteIndex < numNotes) {
+        findNotesInLocalStorage();
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("All notes have been converted to ENEX, finishing the ENEX file"));
+
+    QByteArray enexFooter = m_enexFooter;
+    writeEnexData(enexFooter);
+    m_allNotesWritten = true;
+    m_pEnexFileWriter->finishWriting();
+}
+
+bool EnexExporter::collectTagNames(const Note & note, QHash<QString, QString> & tagNameByTagLocalUid,
+                                   ErrorString & errorDescription) const
+{
+    if (!note.hasTagLocalUids()) {
+        return true;
+    }
+
+    if (Q_UNLIKELY(m_pTagModel.isNull())) {
+        errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: the tag model has expired"));
+        QNWARNING(errorDescription);
+        return false;
     }
 
-    QString enex;
-    ENMLConverter converter;
-    ENMLConverter::EnexExportTags::type exportTagsOption = (m_includeTags
-                                                            ? ENMLConverter::EnexExportTags::Yes
-                                                            : ENMLConverter::EnexExportTags::No);
-    bool res = converter.exportNotesToEnex(notes, tagNameByTagLocalUid, exportTagsOption,
-                                           enex, errorDescription, QUENTIER_ENEX_VERSION);
-    if (!res) {
-        return QString();
+    const QStringList & tagLocalUids = note.tagLocalUids();
+    for(auto tagIt = tagLocalUids.constBegin(), tagEnd = tagLocalUids.constEnd(); tagIt != tagEnd; ++tagIt)
+    {
+        const TagModelItem * pModelItem = m_pTagModel->itemForLocalUid(*tagIt);
+        if (Q_UNLIKELY(!pModelItem)) {
+            errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: internal error, "
+                                                "detected note with tag local uid for which no tag "
+                                                "model item was found"));
+            QNWARNING(errorDescription << QStringLiteral(", tag local uid = ") << *tagIt
+                      << QStringLiteral(", note: ") << note);
+            return false;
+        }
+
+        if (Q_UNLIKELY(pModelItem->type() != TagModelItem::Type::Tag)) {
+            errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: internal error, "
+                                                "detected tag model item corresponding to tag local uid "
+                                                "but not of a tag type"));
+            QNWARNING(errorDescription << QStringLiteral(", tag local uid = ") << *tagIt
+                      << QStringLiteral(", tag model item: ") << *pModelItem << QStringLiteral("\nNote: ")
+                      << note);
+            return false;
+        }
+
+        const TagItem * pTagItem = pModelItem->tagItem();
+        if (Q_UNLIKELY(!pTagItem)) {
+            errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: internal error, "
+                                                "detected tag model item corresponding to tag local uid "
+                                                "and of a tag type but containing no actual tag item"));
+            QNWARNING(errorDescription << QStringLiteral(", tag local uid = ") << *tagIt
+                      << QStringLiteral(", tag model item: ") << *pModelItem << QStringLiteral("\nNote: ")
+                      << note);
+            return false;
+        }
+
+        tagNameByTagLocalUid[*tagIt] = pTagItem->name();
     }
 
-    QNDEBUG(QStringLiteral("Successfully exported note(s) to ENEX"));
-    return enex;
+    return true;
+}
+
+void EnexExporter::writeEnexData(QByteArray & data)
+{
+    m_numBytesPendingWrite += static_cast<qint64>(data.size());
+    m_pEnexFileWriter->appendData(data);
+}
+
+void EnexExporter::failExport(const ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("EnexExporter::failExport: ") << errorDescription);
+
+    cancel();
+    Q_EMIT failedToExportNotesToEnex(errorDescription);
 }
 
 void EnexExporter::connectToLocalStorage()
@@ -1,6 +1,7 @@
 #ifndef QUENTIER_ENEX_EXPORTER_H
 #define QUENTIER_ENEX_EXPORTER_H
 
+#include "widgets/NoteEditorWidget.h"
 #include <quentier/utility/Macros.h>
 #include <quentier/types/ErrorString.h>
 #include <quentier/types/Note.h>
@@ -10,20 +11,41 @@
 #include <QHash>
 #include <QUuid>
 #include <QPointer>
+#include <QMap>
+#include <QVector>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QThreadPool>
 
 namespace quentier {
 
 QT_FORWARD_DECLARE_CLASS(LocalStorageManagerAsync)
 QT_FORWARD_DECLARE_CLASS(NoteEditorTabsAndWindowsCoordinator)
 QT_FORWARD_DECLARE_CLASS(TagModel)
-
+QT_FORWARD_DECLARE_CLASS(AsyncFileWriter)
+
+/**
+ * @brief The EnexExporter class exports notes to ENEX file
+ *
+ * The ENEX is streamed into the target file note by note in the order of note local uids: each note is converted
+ * to ENEX by EnexNoteEncoderAsync within the exporter's thread pool as soon as it is fetched from the local storage,
+ * the converted notes are passed on to AsyncFileWriter in the original order, so neither the whole set of notes nor
+ * the whole ENEX document is ever kept in memory. The number of notes being fetched or converted and the amount
+ * of ENEX data not yet written to the file are limited
+ */
 class EnexExporter: public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * @param pCoordinator      The coordinator of note editors the notes being edited are taken from; if null,
+     *                          all notes are taken from the local storage
+     */
     explicit EnexExporter(LocalStorageManagerAsync & localStorageManagerAsync,
-                          NoteEditorTabsAndWindowsCoordinator & coordinator,
+                          NoteEditorTabsAndWindowsCoordinator * pCoordinator,
                           TagModel & tagModel, QObject * parent = Q_NULLPTR);
+    virtual ~EnexExporter();
 
     const QString & targetEnexFilePath() const { return m_targetEnexFilePath; }
     void setTargetEnexFilePath(const QString & path) { m_targetEnexFilePath = path; }
@@ -37,11 +59,17 @@ public:
     bool isInProgress() const;
     void start();
 
+    /**
+     * Stops the export in progress, if any, and removes the partially written ENEX file
+     */
+    void cancel();
+
     void clear();
 
 Q_SIGNALS:
-    void notesExportedToEnex(QString enex);
+    void notesExportedToEnex(QString enexFilePath);
     void failedToExportNotesToEnex(ErrorString errorDescription);
+    void notesExportToEnexProgress(int numExportedNotes, int numNotes);
 
 // private signals:
     void findNote(Note note, bool withResourceBinaryData, QUuid requestId);
@@ -53,22 +81,69 @@ private Q_SLOTS:
 
     void onAllTagsListed();
 
+    void onNoteEditorNoteSaveFinished(NoteEditorWidget::NoteSaveStatus::type status, ErrorString errorDescription);
+
+    void onNoteEncoded(QByteArray noteEnex, QByteArray enexHeader, QByteArray enexFooter,
+                       int noteIndex, QUuid requestId);
+    void onNoteEncodingFailed(ErrorString errorDescription, QUuid requestId);
+
+    void onEnexDataWritten(qint64 numBytes);
+    void onEnexFileWritten(QString filePath);
+    void onEnexFileWriteFailed(ErrorString errorDescription);
+    void onEnexFileWriteIncomplete(qint64 bytesWritten, qint64 bytesTotal);
+
 private:
-    void findNoteInLocalStorage(const QString & noteLocalUid);
-    QString convertNotesToEnex(ErrorString & errorDescription);
+    void findNotesInLocalStorage();
+    void findNoteInLocalStorage(const int noteIndex);
+
+    void encodeReadyNotes();
+    void writeEncodedNotes();
+    bool collectTagNames(const Note & note, QHash<QString, QString> & tagNameByTagLocalUid,
+                         ErrorString & errorDescription) const;
+    void writeEnexData(QByteArray & data);
+    void failExport(const ErrorString & errorDescription);
+    void resetExportState();
 
     void connectToLocalStorage();
     void disconnectFromLocalStorage();
 
 private:
     LocalStorageManagerAsync &              m_localStorageManagerAsync;
-    NoteEditorTabsAndWindowsCoordinator &   m_noteEditorTabsAndWindowsCoordinator;
+    QPointer<NoteEditorTabsAndWindowsCoordinator>   m_pNoteEditorTabsAndWindowsCoordinator;
     QPointer<TagModel>                      m_pTagModel;
     QString                                 m_targetEnexFilePath;
     QStringList                             m_noteLocalUids;
-    QSet<QUuid>                             m_findNoteRequestIds;
-    QHash<QString, Note>                    m_notesByLocalUid;
     bool                                    m_includeTags;
+
+    // The notes are identified by their indices within the list of note local uids; the notes not found
+    // within the note editors are fetched from the local storage in the original order
+    QVector<int>                            m_noteIndicesToFind;
+    int                                     m_nextNoteToFindIndex;
+    QHash<QUuid, int>                       m_noteIndexByFindNoteRequestId;
+    QSet<int>                               m_foundNoteIndicesPendingWrite;
+
+    // The modified notes within the note editors are taken from the editors once they are saved
+    QHash<QString, int>                     m_noteIndexBySavingNoteLocalUid;
+
+    // The notes waiting for the tag model to get all tags listed before they can be converted
+    QMap<int, Note>                         m_notesPendingEncodingByIndex;
+
+    QUuid                                   m_encodeNotesRequestId;
+    QSharedPointer<QAtomicInt>              m_pEncodeNotesCanceled;
+    QThreadPool                             m_encoderThreadPool;
+
+    // The notes converted ahead of the next note to write
+    QMap<int, QByteArray>                   m_encodedNotesByIndex;
+    int                                     m_nextNoteToWriteIndex;
+
+    // The parts of ENEX document surrounding the notes, taken from the first converted note
+    QByteArray                              m_enexHeader;
+    QByteArray                              m_enexFooter;
+
+    QPointer<AsyncFileWriter>               m_pEnexFileWriter;
+    qint64                                  m_numBytesPendingWrite;
+    bool                                    m_allNotesWritten;
+
     bool                                    m_connectedToLocalStorage;
 };
 
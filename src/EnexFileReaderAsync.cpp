@@ -0,0 +1,364 @@
+#include "EnexFileReaderAsync.h"
+#include "EnexNoteDecoderAsync.h"
+#include "CancellationFlag.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <QFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QCryptographicHash>
+#include <QThread>
+#include <QThreadPool>
+#include <QScopedPointer>
+
+#include <algorithm>
+
+#define ENEX_FILE_READER_SEMAPHORE_POLLING_TIMEOUT_MSEC (100)
+
+// The weight of each note accounts for the Note object and the bookkeeping around it besides the note's data
+#define ENEX_FILE_READER_MIN_NOTE_WEIGHT (4)
+
+namespace quentier {
+
+// The decoders of all the ENEX files being read share the same thread pool sized by the number of cores
+Q_GLOBAL_STATIC(QThreadPool, enexNoteDecoderThreadPool)
+
+EnexFileReaderAsync::EnexFileReaderAsync(const QString & enexFilePath, const QUuid & requestId,
+                                         const QSharedPointer<QSemaphore> & pPendingNotesSemaphore,
+                                         const int pendingNotesSemaphoreCapacity,
+                                         const QSharedPointer<QAtomicInt> & pCanceled,
+                                         const qint64 numNotesToSkip,
+                                         const QByteArray & lastSkippedNoteContentHash,
+                                         QObject * parent) :
+    QObject(parent),
+    QRunnable(),
+    m_enexFilePath(enexFilePath),
+    m_requestId(requestId),
+    m_pPendingNotesSemaphore(pPendingNotesSemaphore),
+    m_pendingNotesSemaphoreCapacity(std::max(pendingNotesSemaphoreCapacity, 1)),
+    m_pCanceled(pCanceled),
+    m_numNotesToSkip(numNotesToSkip),
+    m_lastSkippedNoteContentHash(lastSkippedNoteContentHash),
+    m_dtd(),
+    m_enExportAttributes(),
+    m_pFinishedDecodersSemaphore(new QSemaphore(0)),
+    m_numStartedDecoders(0)
+{}
+
+void EnexFileReaderAsync::run()
+{
+    QNDEBUG(QStringLiteral("EnexFileReaderAsync::run: ENEX file path = ") << m_enexFilePath
+            << QStringLiteral(", request id = ") << m_requestId << QStringLiteral(", num notes to skip = ")
+            << m_numNotesToSkip);
+
+    QFile enexFile(m_enexFilePath);
+    if (Q_UNLIKELY(!enexFile.open(QIODevice::ReadOnly))) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't import ENEX: can't open enex file for reading"));
+        errorDescription.details() = m_enexFilePath;
+        QNWARNING(errorDescription);
+        Q_EMIT failed(errorDescription, m_requestId);
+        return;
+    }
+
+    // NOTE: QXmlStreamReader reads the data from the device in small chunks as the parsing goes on
+    QXmlStreamReader reader(&enexFile);
+
+    qint64 numNotesToSkip = std::max(m_numNotesToSkip, qint64(0));
+    if (numNotesToSkip == 0) {
+        Q_EMIT notesSkipped(0, m_requestId);
+    }
+
+    qint64 numNotesRead = 0;
+    ErrorString errorDescription;
+
+    while(!reader.atEnd())
+    {
+        if (isCanceled()) {
+            QNDEBUG(QStringLiteral("Reading the ENEX file was canceled"));
+            waitForDecoders();
+            return;
+        }
+
+        Q_UNUSED(reader.readNext())
+
+        if (reader.atEnd() && !reader.hasError() && (numNotesRead < numNotesToSkip))
+        {
+            QNINFO(QStringLiteral("The ENEX file contains fewer notes than the number of notes to skip, "
+                                  "reading it from the beginning"));
+            if (!rewind(enexFile, reader, errorDescription)) {
+                break;
+            }
+
+            numNotesToSkip = 0;
+            numNotesRead = 0;
+            Q_EMIT notesSkipped(0, m_requestId);
+            continue;
+        }
+
+        if (reader.isDTD()) {
+            m_dtd = reader.text().toString();
+            continue;
+        }
+
+        if (!reader.isStartElement()) {
+            continue;
+        }
+
+        QStringRef elementName = reader.name();
+        if (elementName == QStringLiteral("en-export")) {
+            m_enExportAttributes = reader.attributes();
+            continue;
+        }
+
+        if (elementName != QStringLiteral("note")) {
+            continue;
+        }
+
+        const bool skipNote = (numNotesRead < numNotesToSkip);
+
+        QString noteEnex;
+        QCryptographicHash contentHash(QCryptographicHash::Sha1);
+        if (!readNoteElement(reader, (skipNote ? Q_NULLPTR : &noteEnex), contentHash, errorDescription)) {
+            break;
+        }
+
+        if (skipNote)
+        {
+            ++numNotesRead;
+            if (numNotesRead < numNotesToSkip) {
+                continue;
+            }
+
+            if (contentHash.result() == m_lastSkippedNoteContentHash) {
+                QNDEBUG(QStringLiteral("Skipped ") << numNotesRead << QStringLiteral(" already imported notes"));
+                Q_EMIT notesSkipped(numNotesRead, m_requestId);
+                continue;
+            }
+
+            QNINFO(QStringLiteral("The last skipped note doesn't match the expected one, reading the ENEX file "
+                                  "from the beginning"));
+            if (!rewind(enexFile, reader, errorDescription)) {
+                break;
+            }
+
+            numNotesToSkip = 0;
+            numNotesRead = 0;
+            Q_EMIT notesSkipped(0, m_requestId);
+            continue;
+        }
+
+        int weight = noteWeight(noteEnex);
+        if (!acquirePendingNoteSlot(weight)) {
+            QNDEBUG(QStringLiteral("Reading the ENEX file was canceled while waiting for the pending notes to be processed"));
+            waitForDecoders();
+            return;
+        }
+
+        decodeNoteEnex(noteEnex, contentHash.result(), numNotesRead, weight);
+        ++numNotesRead;
+    }
+
+    waitForDecoders();
+
+    if (isCanceled()) {
+        QNDEBUG(QStringLiteral("Reading the ENEX file was canceled"));
+        return;
+    }
+
+    if (reader.hasError() || !errorDescription.isEmpty())
+    {
+        if (errorDescription.isEmpty()) {
+            errorDescription.setBase(QT_TR_NOOP("Can't import ENEX: failed to parse the enex file"));
+            errorDescription.details() = reader.errorString();
+            errorDescription.details() += QStringLiteral(", line ");
+            errorDescription.details() += QString::number(reader.lineNumber());
+        }
+
+        QNWARNING(errorDescription);
+        Q_EMIT failed(errorDescription, m_requestId);
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("Finished reading the ENEX file, read ") << numNotesRead << QStringLiteral(" notes"));
+    Q_EMIT finished(numNotesRead, m_requestId);
+}
+
+bool EnexFileReaderAsync::readNoteElement(QXmlStreamReader & reader, QString * pNoteEnex,
+                                          QCryptographicHash & contentHash, ErrorString & errorDescription) const
+{
+    // The note element is rewritten into the standalone ENEX document containing just this one note
+    QScopedPointer<QXmlStreamWriter> pWriter;
+    if (pNoteEnex) {
+        pWriter.reset(new QXmlStreamWriter(pNoteEnex));
+        pWriter->writeStartDocument();
+
+        if (!m_dtd.isEmpty()) {
+            pWriter->writeDTD(m_dtd);
+        }
+
+        pWriter->writeStartElement(QStringLiteral("en-export"));
+        pWriter->writeAttributes(m_enExportAttributes);
+    }
+
+    // The content hash covers only the note element itself, not the export specific parts of the document
+    // such as the export date
+    addStartElementToContentHash(reader, contentHash);
+    if (pWriter) {
+        pWriter->writeStartElement(reader.qualifiedName().toString());
+        pWriter->writeAttributes(reader.attributes());
+    }
+
+    int depth = 1;
+    while((depth > 0) && !reader.atEnd())
+    {
+        QXmlStreamReader::TokenType tokenType = reader.readNext();
+        switch(tokenType)
+        {
+        case QXmlStreamReader::StartElement:
+            ++depth;
+            addStartElementToContentHash(reader, contentHash);
+            if (pWriter) {
+                pWriter->writeStartElement(reader.qualifiedName().toString());
+                pWriter->writeAttributes(reader.attributes());
+            }
+            break;
+        case QXmlStreamReader::EndElement:
+            --depth;
+            contentHash.addData(QByteArray("/>", 2));
+            if (pWriter) {
+                pWriter->writeEndElement();
+            }
+            break;
+        case QXmlStreamReader::Characters:
+            contentHash.addData(reader.text().toString().toUtf8());
+            if (!pWriter) {
+                break;
+            }
+
+            if (reader.isCDATA()) {
+                pWriter->writeCDATA(reader.text().toString());
+            }
+            else {
+                pWriter->writeCharacters(reader.text().toString());
+            }
+            break;
+        case QXmlStreamReader::EntityReference:
+            contentHash.addData(QByteArray("&", 1));
+            contentHash.addData(reader.name().toString().toUtf8());
+            if (pWriter) {
+                pWriter->writeEntityReference(reader.name().toString());
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (Q_UNLIKELY(depth > 0))
+    {
+        errorDescription.setBase(QT_TR_NOOP("Can't import ENEX: failed to parse the enex file"));
+        if (reader.hasError()) {
+            errorDescription.details() = reader.errorString();
+        }
+        else {
+            errorDescription.details() = QStringLiteral("unexpected end of file within note element");
+        }
+
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    if (pWriter) {
+        // Closing en-export element
+        pWriter->writeEndElement();
+        pWriter->writeEndDocument();
+    }
+
+    return true;
+}
+
+void EnexFileReaderAsync::addStartElementToContentHash(const QXmlStreamReader & reader,
+                                                       QCryptographicHash & contentHash) const
+{
+    contentHash.addData(QByteArray("<", 1));
+    contentHash.addData(reader.qualifiedName().toString().toUtf8());
+
+    QXmlStreamAttributes attributes = reader.attributes();
+    for(auto it = attributes.constBegin(), end = attributes.constEnd(); it != end; ++it) {
+        contentHash.addData(QByteArray(" ", 1));
+        contentHash.addData(it->qualifiedName().toString().toUtf8());
+        contentHash.addData(QByteArray("=", 1));
+        contentHash.addData(it->value().toString().toUtf8());
+    }
+
+    contentHash.addData(QByteArray(">", 1));
+}
+
+bool EnexFileReaderAsync::rewind(QFile & enexFile, QXmlStreamReader & reader, ErrorString & errorDescription)
+{
+    waitForDecoders();
+
+    if (Q_UNLIKELY(!enexFile.seek(0))) {
+        errorDescription.setBase(QT_TR_NOOP("Can't import ENEX: can't read the enex file from the beginning"));
+        errorDescription.details() = enexFile.errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    reader.clear();
+    reader.setDevice(&enexFile);
+
+    m_dtd.clear();
+    m_enExportAttributes.clear();
+    return true;
+}
+
+void EnexFileReaderAsync::decodeNoteEnex(const QString & noteEnex, const QByteArray & noteContentHash,
+                                         const qint64 noteIndex, const int noteWeight)
+{
+    EnexNoteDecoderAsync * pDecoder = new EnexNoteDecoderAsync(noteEnex, noteContentHash, noteIndex, noteWeight,
+                                                               m_requestId, m_pCanceled,
+                                                               m_pFinishedDecodersSemaphore);
+    QObject::connect(pDecoder, QNSIGNAL(EnexNoteDecoderAsync,noteDecoded,Note,QStringList,QByteArray,qint64,int,QUuid),
+                     this, QNSIGNAL(EnexFileReaderAsync,noteDecoded,Note,QStringList,QByteArray,qint64,int,QUuid),
+                     Qt::DirectConnection);
+    QObject::connect(pDecoder, QNSIGNAL(EnexNoteDecoderAsync,noteDecodingFailed,ErrorString,QByteArray,qint64,int,QUuid),
+                     this, QNSIGNAL(EnexFileReaderAsync,noteDecodingFailed,ErrorString,QByteArray,qint64,int,QUuid),
+                     Qt::DirectConnection);
+
+    ++m_numStartedDecoders;
+    enexNoteDecoderThreadPool()->start(pDecoder);
+}
+
+void EnexFileReaderAsync::waitForDecoders()
+{
+    m_pFinishedDecodersSemaphore->acquire(m_numStartedDecoders);
+    m_numStartedDecoders = 0;
+}
+
+int EnexFileReaderAsync::noteWeight(const QString & noteEnex) const
+{
+    // NOTE: the note's ENEX is mostly the base64 encoded resources' data and ASCII markup so its length
+    // is close to the size of the decoded note
+    int weight = (noteEnex.size() + 1023) / 1024;
+    weight = std::max(weight, ENEX_FILE_READER_MIN_NOTE_WEIGHT);
+    return std::min(weight, m_pendingNotesSemaphoreCapacity);
+}
+
+bool EnexFileReaderAsync::acquirePendingNoteSlot(const int noteWeight) const
+{
+    while(!m_pPendingNotesSemaphore->tryAcquire(noteWeight, ENEX_FILE_READER_SEMAPHORE_POLLING_TIMEOUT_MSEC))
+    {
+        if (isCanceled()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool EnexFileReaderAsync::isCanceled() const
+{
+    return quentier::isCanceled(*m_pCanceled);
+}
+
+} // namespace quentier
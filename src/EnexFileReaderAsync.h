@@ -0,0 +1,117 @@
+#ifndef QUENTIER_ENEX_FILE_READER_ASYNC_H
+#define QUENTIER_ENEX_FILE_READER_ASYNC_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Note.h>
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <QStringList>
+#include <QXmlStreamAttributes>
+#include <QSharedPointer>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QUuid>
+#include <QByteArray>
+
+QT_FORWARD_DECLARE_CLASS(QXmlStreamReader)
+QT_FORWARD_DECLARE_CLASS(QCryptographicHash)
+QT_FORWARD_DECLARE_CLASS(QFile)
+
+namespace quentier {
+
+/**
+ * @brief The EnexFileReaderAsync class reads the notes from ENEX file one by one within the thread pool's thread
+ * without ever reading the whole file into memory: the file is parsed incrementally and each note element
+ * is passed on to EnexNoteDecoderAsync as soon as it is read completely
+ *
+ * The decoders run in parallel within the thread pool shared by all the readers so that several ENEX files imported
+ * at once don't multiply the number of decoding threads; each decoded note is passed on via noteDecoded signal
+ * along with its index within the file as the notes may be decoded out of order, the note which can't be decoded
+ * is passed on via noteDecodingFailed signal and doesn't stop the reading of the file.
+ *
+ * In order to keep the memory usage bounded the reader acquires the resources of the shared semaphore before decoding
+ * each note: one resource per kilobyte of the note's ENEX but no fewer than a few ones per note to account for
+ * the per note overhead and no more than the semaphore's capacity. The number of acquired resources, the note's weight,
+ * is passed on along with the decoded note and the consumer of notes is expected to release that many resources
+ * once it no longer needs the note. So the memory bound is not one note at a time: the notes being decoded,
+ * the decoded notes waiting for the preceding ones and the notes being added to the local storage take at most
+ * the semaphore's capacity in kilobytes of ENEX in total, plus the note currently being read; the single note
+ * heavier than that is let through alone once all the previous ones are released.
+ *
+ * Each note is accompanied by the hash of the contents of its note element, it is the same for the same note
+ * within different ENEX files. The reader can skip the given number of notes from the start of the file in order
+ * to resume the interrupted import; the skipped notes are parsed but not decoded. If the hash of the last skipped note
+ * doesn't match the expected one, the file is not the one the import of which was interrupted, so no notes are skipped
+ */
+class EnexFileReaderAsync: public QObject,
+                           public QRunnable
+{
+    Q_OBJECT
+public:
+    explicit EnexFileReaderAsync(const QString & enexFilePath, const QUuid & requestId,
+                                 const QSharedPointer<QSemaphore> & pPendingNotesSemaphore,
+                                 const int pendingNotesSemaphoreCapacity,
+                                 const QSharedPointer<QAtomicInt> & pCanceled,
+                                 const qint64 numNotesToSkip = 0,
+                                 const QByteArray & lastSkippedNoteContentHash = QByteArray(),
+                                 QObject * parent = Q_NULLPTR);
+
+Q_SIGNALS:
+    /**
+     * The signal is emitted before any decoded notes: the indices of decoded notes start from @param numSkippedNotes
+     */
+    void notesSkipped(qint64 numSkippedNotes, QUuid requestId);
+
+    void noteDecoded(Note note, QStringList tagNames, QByteArray noteContentHash, qint64 noteIndex,
+                     int noteWeight, QUuid requestId);
+    void noteDecodingFailed(ErrorString errorDescription, QByteArray noteContentHash, qint64 noteIndex,
+                            int noteWeight, QUuid requestId);
+    void finished(qint64 numNotesRead, QUuid requestId);
+    void failed(ErrorString errorDescription, QUuid requestId);
+
+private:
+    virtual void run() Q_DECL_OVERRIDE;
+
+    /**
+     * Reads the note element the reader is at; if @param pNoteEnex is not null, writes the standalone ENEX document
+     * containing just this one note into it
+     */
+    bool readNoteElement(QXmlStreamReader & reader, QString * pNoteEnex, QCryptographicHash & contentHash,
+                         ErrorString & errorDescription) const;
+    void addStartElementToContentHash(const QXmlStreamReader & reader, QCryptographicHash & contentHash) const;
+
+    // Restarts reading the file from the beginning once all the notes already being decoded are done
+    bool rewind(QFile & enexFile, QXmlStreamReader & reader, ErrorString & errorDescription);
+
+    void decodeNoteEnex(const QString & noteEnex, const QByteArray & noteContentHash, const qint64 noteIndex,
+                        const int noteWeight);
+
+    // NOTE: the decoders' signals are relayed through this object so it needs to outlive them
+    void waitForDecoders();
+    int noteWeight(const QString & noteEnex) const;
+    bool acquirePendingNoteSlot(const int noteWeight) const;
+    bool isCanceled() const;
+
+private:
+    QString                     m_enexFilePath;
+    QUuid                       m_requestId;
+    QSharedPointer<QSemaphore>  m_pPendingNotesSemaphore;
+    int                         m_pendingNotesSemaphoreCapacity;
+    QSharedPointer<QAtomicInt>  m_pCanceled;
+    qint64                      m_numNotesToSkip;
+    QByteArray                  m_lastSkippedNoteContentHash;
+
+    // The parts of the original ENEX document which every single note ENEX is wrapped into
+    QString                     m_dtd;
+    QXmlStreamAttributes        m_enExportAttributes;
+
+    // Each decoder started by this reader releases one resource of the semaphore once it is done
+    QSharedPointer<QSemaphore>  m_pFinishedDecodersSemaphore;
+    int                         m_numStartedDecoders;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_ENEX_FILE_READER_ASYNC_H
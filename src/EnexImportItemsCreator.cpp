@@ -0,0 +1,172 @@
+#include "EnexImportItemsCreator.h"
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <quentier/logging/QuentierLogger.h>
+
+namespace quentier {
+
+EnexImportItemsCreator::EnexImportItemsCreator(LocalStorageManagerAsync & localStorageManagerAsync,
+                                               QObject * parent) :
+    QObject(parent),
+    m_localStorageManagerAsync(localStorageManagerAsync),
+    m_addTagRequestIdByTagNameBimap(),
+    m_addNotebookRequestIdByNotebookNameBimap(),
+    m_addedTagsByName(),
+    m_addedNotebooksByName(),
+    m_connectedToLocalStorage(false)
+{}
+
+void EnexImportItemsCreator::requestTag(const QString & tagName)
+{
+    QNDEBUG(QStringLiteral("EnexImportItemsCreator::requestTag: ") << tagName);
+
+    QString lowerTagName = tagName.toLower();
+
+    auto addedTagIt = m_addedTagsByName.find(lowerTagName);
+    if (addedTagIt != m_addedTagsByName.end()) {
+        QNDEBUG(QStringLiteral("The tag has already been added to the local storage"));
+        Q_EMIT tagAdded(addedTagIt.value());
+        return;
+    }
+
+    auto it = m_addTagRequestIdByTagNameBimap.left.find(lowerTagName);
+    if (it != m_addTagRequestIdByTagNameBimap.left.end()) {
+        QNDEBUG(QStringLiteral("The tag is already being added to the local storage"));
+        return;
+    }
+
+    connectToLocalStorage();
+
+    Tag newTag;
+    newTag.setName(tagName);
+
+    QUuid requestId = QUuid::createUuid();
+    Q_UNUSED(m_addTagRequestIdByTagNameBimap.insert(AddRequestIdByNameBimap::value_type(lowerTagName, requestId)))
+    QNTRACE(QStringLiteral("Emitting the request to add tag to local storage: request id = ")
+            << requestId << QStringLiteral(", tag: ") << newTag);
+    Q_EMIT addTag(newTag, requestId);
+}
+
+void EnexImportItemsCreator::requestNotebook(const QString & notebookName)
+{
+    QNDEBUG(QStringLiteral("EnexImportItemsCreator::requestNotebook: ") << notebookName);
+
+    QString lowerNotebookName = notebookName.toLower();
+
+    auto addedNotebookIt = m_addedNotebooksByName.find(lowerNotebookName);
+    if (addedNotebookIt != m_addedNotebooksByName.end()) {
+        QNDEBUG(QStringLiteral("The notebook has already been added to the local storage"));
+        Q_EMIT notebookAdded(addedNotebookIt.value());
+        return;
+    }
+
+    auto it = m_addNotebookRequestIdByNotebookNameBimap.left.find(lowerNotebookName);
+    if (it != m_addNotebookRequestIdByNotebookNameBimap.left.end()) {
+        QNDEBUG(QStringLiteral("The notebook is already being added to the local storage"));
+        return;
+    }
+
+    connectToLocalStorage();
+
+    Notebook newNotebook;
+    newNotebook.setName(notebookName);
+
+    QUuid requestId = QUuid::createUuid();
+    Q_UNUSED(m_addNotebookRequestIdByNotebookNameBimap.insert(AddRequestIdByNameBimap::value_type(lowerNotebookName,
+                                                                                                  requestId)))
+    QNTRACE(QStringLiteral("Emitting the request to add notebook to local storage: request id = ")
+            << requestId << QStringLiteral(", notebook: ") << newNotebook);
+    Q_EMIT addNotebook(newNotebook, requestId);
+}
+
+void EnexImportItemsCreator::onAddTagComplete(Tag tag, QUuid requestId)
+{
+    auto it = m_addTagRequestIdByTagNameBimap.right.find(requestId);
+    if (it == m_addTagRequestIdByTagNameBimap.right.end()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImportItemsCreator::onAddTagComplete: request id = ")
+            << requestId << QStringLiteral(", tag: ") << tag);
+
+    m_addedTagsByName[it->second] = tag;
+    Q_UNUSED(m_addTagRequestIdByTagNameBimap.right.erase(it))
+
+    Q_EMIT tagAdded(tag);
+}
+
+void EnexImportItemsCreator::onAddTagFailed(Tag tag, ErrorString errorDescription, QUuid requestId)
+{
+    auto it = m_addTagRequestIdByTagNameBimap.right.find(requestId);
+    if (it == m_addTagRequestIdByTagNameBimap.right.end()) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("EnexImportItemsCreator::onAddTagFailed: request id = ")
+              << requestId << QStringLiteral(", error description = ")
+              << errorDescription << QStringLiteral(", tag: ") << tag);
+
+    QString tagName = it->second;
+    Q_UNUSED(m_addTagRequestIdByTagNameBimap.right.erase(it))
+
+    Q_EMIT tagAddFailed(tagName, errorDescription);
+}
+
+void EnexImportItemsCreator::onAddNotebookComplete(Notebook notebook, QUuid requestId)
+{
+    auto it = m_addNotebookRequestIdByNotebookNameBimap.right.find(requestId);
+    if (it == m_addNotebookRequestIdByNotebookNameBimap.right.end()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImportItemsCreator::onAddNotebookComplete: request id = ")
+            << requestId << QStringLiteral(", notebook: ") << notebook);
+
+    m_addedNotebooksByName[it->second] = notebook;
+    Q_UNUSED(m_addNotebookRequestIdByNotebookNameBimap.right.erase(it))
+
+    Q_EMIT notebookAdded(notebook);
+}
+
+void EnexImportItemsCreator::onAddNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId)
+{
+    auto it = m_addNotebookRequestIdByNotebookNameBimap.right.find(requestId);
+    if (it == m_addNotebookRequestIdByNotebookNameBimap.right.end()) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("EnexImportItemsCreator::onAddNotebookFailed: request id = ")
+              << requestId << QStringLiteral(", error description = ")
+              << errorDescription << QStringLiteral(", notebook: ") << notebook);
+
+    QString notebookName = it->second;
+    Q_UNUSED(m_addNotebookRequestIdByNotebookNameBimap.right.erase(it))
+
+    Q_EMIT notebookAddFailed(notebookName, errorDescription);
+}
+
+void EnexImportItemsCreator::connectToLocalStorage()
+{
+    if (m_connectedToLocalStorage) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImportItemsCreator::connectToLocalStorage"));
+
+    QObject::connect(this, QNSIGNAL(EnexImportItemsCreator,addTag,Tag,QUuid),
+                     &m_localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onAddTagRequest,Tag,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,addTagComplete,Tag,QUuid),
+                     this, QNSLOT(EnexImportItemsCreator,onAddTagComplete,Tag,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,addTagFailed,Tag,ErrorString,QUuid),
+                     this, QNSLOT(EnexImportItemsCreator,onAddTagFailed,Tag,ErrorString,QUuid));
+
+    QObject::connect(this, QNSIGNAL(EnexImportItemsCreator,addNotebook,Notebook,QUuid),
+                     &m_localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onAddNotebookRequest,Notebook,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,addNotebookComplete,Notebook,QUuid),
+                     this, QNSLOT(EnexImportItemsCreator,onAddNotebookComplete,Notebook,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,addNotebookFailed,Notebook,ErrorString,QUuid),
+                     this, QNSLOT(EnexImportItemsCreator,onAddNotebookFailed,Notebook,ErrorString,QUuid));
+
+    m_connectedToLocalStorage = true;
+}
+
+} // namespace quentier
@@ -0,0 +1,74 @@
+#ifndef QUENTIER_ENEX_IMPORT_ITEMS_CREATOR_H
+#define QUENTIER_ENEX_IMPORT_ITEMS_CREATOR_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Tag.h>
+#include <quentier/types/Notebook.h>
+#include <QObject>
+#include <QUuid>
+#include <QHash>
+
+// NOTE: Workaround a bug in Qt4 which may prevent building with some boost versions
+#ifndef Q_MOC_RUN
+#include <boost/bimap.hpp>
+#endif
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(LocalStorageManagerAsync)
+
+/**
+ * @brief The EnexImportItemsCreator class creates the tags and notebooks needed by several concurrently running
+ * EnexImporters: each tag or notebook name is sent to the local storage only once no matter how many importers
+ * request it, the outcome is reported to all of them
+ */
+class EnexImportItemsCreator: public QObject
+{
+    Q_OBJECT
+public:
+    explicit EnexImportItemsCreator(LocalStorageManagerAsync & localStorageManagerAsync,
+                                    QObject * parent = Q_NULLPTR);
+
+    void requestTag(const QString & tagName);
+    void requestNotebook(const QString & notebookName);
+
+Q_SIGNALS:
+    void tagAdded(Tag tag);
+    void tagAddFailed(QString tagName, ErrorString errorDescription);
+
+    void notebookAdded(Notebook notebook);
+    void notebookAddFailed(QString notebookName, ErrorString errorDescription);
+
+// private signals:
+    void addTag(Tag tag, QUuid requestId);
+    void addNotebook(Notebook notebook, QUuid requestId);
+
+private Q_SLOTS:
+    void onAddTagComplete(Tag tag, QUuid requestId);
+    void onAddTagFailed(Tag tag, ErrorString errorDescription, QUuid requestId);
+
+    void onAddNotebookComplete(Notebook notebook, QUuid requestId);
+    void onAddNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId);
+
+private:
+    void connectToLocalStorage();
+
+private:
+    LocalStorageManagerAsync &      m_localStorageManagerAsync;
+
+    // The names are lowercase as the tag and notebook names are case insensitive
+    typedef boost::bimap<QString, QUuid> AddRequestIdByNameBimap;
+    AddRequestIdByNameBimap         m_addTagRequestIdByTagNameBimap;
+    AddRequestIdByNameBimap         m_addNotebookRequestIdByNotebookNameBimap;
+
+    // The items created already are reported right away to those requesting them later
+    QHash<QString, Tag>             m_addedTagsByName;
+    QHash<QString, Notebook>        m_addedNotebooksByName;
+
+    bool                            m_connectedToLocalStorage;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_ENEX_IMPORT_ITEMS_CREATOR_H
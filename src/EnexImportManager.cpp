@@ -0,0 +1,183 @@
+#include "EnexImportManager.h"
+#include "EnexImporter.h"
+#include "EnexImportItemsCreator.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <QThread>
+#include <algorithm>
+
+#define ENEX_IMPORT_MANAGER_MAX_DEFAULT_CONCURRENT_IMPORTS (4)
+
+namespace quentier {
+
+EnexImportManager::EnexImportManager(const Account & account,
+                                     LocalStorageManagerAsync & localStorageManagerAsync,
+                                     TagModel & tagModel, NotebookModel & notebookModel,
+                                     QObject * parent) :
+    QObject(parent),
+    m_account(account),
+    m_localStorageManagerAsync(localStorageManagerAsync),
+    m_tagModel(tagModel),
+    m_notebookModel(notebookModel),
+    m_pItemsCreator(new EnexImportItemsCreator(localStorageManagerAsync, this)),
+    m_maxConcurrentImports(1),
+    m_pendingImports(),
+    m_numImportedNotesByRunningImporter(),
+    m_numFiles(0),
+    m_numFinishedFiles(0),
+    m_numFailedFiles(0),
+    m_numImportedNotesByFinishedImporters(0),
+    m_lastErrorDescription(),
+    m_importTimer()
+{
+    // Each importer decodes the notes using all the cores so there's little point in running many of them at once;
+    // a few concurrent importers help to keep the cores busy while the other importers wait for the local storage
+    m_maxConcurrentImports = std::max(1, std::min(QThread::idealThreadCount() / 2,
+                                                  ENEX_IMPORT_MANAGER_MAX_DEFAULT_CONCURRENT_IMPORTS));
+}
+
+bool EnexImportManager::isInProgress() const
+{
+    return !m_pendingImports.isEmpty() || !m_numImportedNotesByRunningImporter.isEmpty();
+}
+
+void EnexImportManager::import(const QStringList & enexFilePaths, const QString & notebookName)
+{
+    QNDEBUG(QStringLiteral("EnexImportManager::import: ") << enexFilePaths.join(QStringLiteral(", "))
+            << QStringLiteral("; notebook name = ") << notebookName);
+
+    if (!isInProgress()) {
+        m_numFiles = 0;
+        m_numFinishedFiles = 0;
+        m_numFailedFiles = 0;
+        m_numImportedNotesByFinishedImporters = 0;
+        m_lastErrorDescription.clear();
+        m_importTimer.start();
+    }
+
+    for(auto it = enexFilePaths.constBegin(), end = enexFilePaths.constEnd(); it != end; ++it) {
+        PendingImport pendingImport;
+        pendingImport.m_enexFilePath = *it;
+        pendingImport.m_notebookName = notebookName;
+        m_pendingImports << pendingImport;
+        ++m_numFiles;
+    }
+
+    startPendingImports();
+}
+
+void EnexImportManager::setMaxConcurrentImports(const int maxConcurrentImports)
+{
+    QNDEBUG(QStringLiteral("EnexImportManager::setMaxConcurrentImports: ") << maxConcurrentImports);
+    m_maxConcurrentImports = std::max(maxConcurrentImports, 1);
+    startPendingImports();
+}
+
+void EnexImportManager::onEnexImportedSuccessfully(QString enexFilePath)
+{
+    QNDEBUG(QStringLiteral("EnexImportManager::onEnexImportedSuccessfully: ") << enexFilePath);
+
+    EnexImporter * pImporter = qobject_cast<EnexImporter*>(sender());
+    if (Q_UNLIKELY(!pImporter || !m_numImportedNotesByRunningImporter.contains(pImporter))) {
+        return;
+    }
+
+    finishImport(pImporter);
+}
+
+void EnexImportManager::onEnexImportFailed(ErrorString errorDescription)
+{
+    QNDEBUG(QStringLiteral("EnexImportManager::onEnexImportFailed: ") << errorDescription);
+
+    EnexImporter * pImporter = qobject_cast<EnexImporter*>(sender());
+    if (Q_UNLIKELY(!pImporter || !m_numImportedNotesByRunningImporter.contains(pImporter))) {
+        return;
+    }
+
+    ++m_numFailedFiles;
+    m_lastErrorDescription = errorDescription;
+    finishImport(pImporter);
+}
+
+void EnexImportManager::onEnexImportProgress(qint64 numImportedNotes, double notesPerSecond)
+{
+    Q_UNUSED(notesPerSecond)
+
+    EnexImporter * pImporter = qobject_cast<EnexImporter*>(sender());
+    auto it = m_numImportedNotesByRunningImporter.find(pImporter);
+    if (Q_UNLIKELY(it == m_numImportedNotesByRunningImporter.end())) {
+        return;
+    }
+
+    it.value() = numImportedNotes;
+    reportProgress();
+}
+
+void EnexImportManager::startPendingImports()
+{
+    while(!m_pendingImports.isEmpty() && (m_numImportedNotesByRunningImporter.size() < m_maxConcurrentImports))
+    {
+        PendingImport pendingImport = m_pendingImports.takeFirst();
+        QNDEBUG(QStringLiteral("Starting the import of ENEX file ") << pendingImport.m_enexFilePath);
+
+        EnexImporter * pImporter = new EnexImporter(pendingImport.m_enexFilePath, pendingImport.m_notebookName,
+                                                    m_account, m_localStorageManagerAsync, m_tagModel,
+                                                    m_notebookModel, this);
+        pImporter->setItemsCreator(m_pItemsCreator);
+
+        QObject::connect(pImporter, QNSIGNAL(EnexImporter,enexImportedSuccessfully,QString),
+                         this, QNSLOT(EnexImportManager,onEnexImportedSuccessfully,QString));
+        QObject::connect(pImporter, QNSIGNAL(EnexImporter,enexImportFailed,ErrorString),
+                         this, QNSLOT(EnexImportManager,onEnexImportFailed,ErrorString));
+        QObject::connect(pImporter, QNSIGNAL(EnexImporter,enexImportProgress,qint64,double),
+                         this, QNSLOT(EnexImportManager,onEnexImportProgress,qint64,double));
+
+        m_numImportedNotesByRunningImporter[pImporter] = 0;
+        pImporter->start();
+    }
+}
+
+void EnexImportManager::finishImport(EnexImporter * pImporter)
+{
+    m_numImportedNotesByFinishedImporters += m_numImportedNotesByRunningImporter.take(pImporter);
+    ++m_numFinishedFiles;
+
+    // NOTE: the failed importer might still have some requests pending within the local storage; it must outlive them
+    // in order to record the notes added by them so it is only deleted once it has been canceled
+    QObject::disconnect(pImporter, Q_NULLPTR, this, Q_NULLPTR);
+    QObject::connect(pImporter, QNSIGNAL(EnexImporter,canceled),
+                     pImporter, QNSLOT(EnexImporter,deleteLater));
+    pImporter->cancel();
+
+    reportProgress();
+    startPendingImports();
+
+    if (isInProgress()) {
+        return;
+    }
+
+    QNINFO(QStringLiteral("Finished the import of ") << m_numFiles << QStringLiteral(" ENEX files, ")
+           << m_numFailedFiles << QStringLiteral(" of them failed, imported ") << m_numImportedNotesByFinishedImporters
+           << QStringLiteral(" notes in ") << m_importTimer.elapsed() << QStringLiteral(" msec"));
+
+    Q_EMIT enexImportFinished(m_numFiles, m_numFailedFiles, m_lastErrorDescription);
+}
+
+void EnexImportManager::reportProgress()
+{
+    qint64 numImportedNotes = m_numImportedNotesByFinishedImporters;
+    for(auto it = m_numImportedNotesByRunningImporter.constBegin(),
+        end = m_numImportedNotesByRunningImporter.constEnd(); it != end; ++it)
+    {
+        numImportedNotes += it.value();
+    }
+
+    qint64 elapsedMsec = m_importTimer.elapsed();
+    double notesPerSecond = 0.0;
+    if (elapsedMsec > 0) {
+        notesPerSecond = static_cast<double>(numImportedNotes) * 1000.0 / static_cast<double>(elapsedMsec);
+    }
+
+    Q_EMIT enexImportProgress(m_numFinishedFiles, m_numFiles, numImportedNotes, notesPerSecond);
+}
+
+} // namespace quentier
@@ -0,0 +1,92 @@
+#ifndef QUENTIER_ENEX_IMPORT_MANAGER_H
+#define QUENTIER_ENEX_IMPORT_MANAGER_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Account.h>
+#include <QObject>
+#include <QStringList>
+#include <QHash>
+#include <QElapsedTimer>
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(LocalStorageManagerAsync)
+QT_FORWARD_DECLARE_CLASS(TagModel)
+QT_FORWARD_DECLARE_CLASS(NotebookModel)
+QT_FORWARD_DECLARE_CLASS(EnexImporter)
+QT_FORWARD_DECLARE_CLASS(EnexImportItemsCreator)
+
+/**
+ * @brief The EnexImportManager class imports several ENEX files into the same notebook running a limited number
+ * of EnexImporters concurrently; the importers share the creation of tags and the notebook, the progress
+ * of all of them is reported as a whole
+ */
+class EnexImportManager: public QObject
+{
+    Q_OBJECT
+public:
+    explicit EnexImportManager(const Account & account,
+                               LocalStorageManagerAsync & localStorageManagerAsync,
+                               TagModel & tagModel, NotebookModel & notebookModel,
+                               QObject * parent = Q_NULLPTR);
+
+    bool isInProgress() const;
+
+    /**
+     * Schedules the import of the given ENEX files; the files scheduled while the previous ones are still
+     * being imported join the same import
+     */
+    void import(const QStringList & enexFilePaths, const QString & notebookName);
+
+    int maxConcurrentImports() const { return m_maxConcurrentImports; }
+    void setMaxConcurrentImports(const int maxConcurrentImports);
+
+Q_SIGNALS:
+    void enexImportProgress(int numFinishedFiles, int numFiles, qint64 numImportedNotes, double notesPerSecond);
+
+    /**
+     * The signal emitted once all the scheduled files have been processed; @param errorDescription is the error
+     * of the last failed file, if any
+     */
+    void enexImportFinished(int numFiles, int numFailedFiles, ErrorString errorDescription);
+
+private Q_SLOTS:
+    void onEnexImportedSuccessfully(QString enexFilePath);
+    void onEnexImportFailed(ErrorString errorDescription);
+    void onEnexImportProgress(qint64 numImportedNotes, double notesPerSecond);
+
+private:
+    void startPendingImports();
+    void finishImport(EnexImporter * pImporter);
+    void reportProgress();
+
+private:
+    Account                         m_account;
+    LocalStorageManagerAsync &      m_localStorageManagerAsync;
+    TagModel &                      m_tagModel;
+    NotebookModel &                 m_notebookModel;
+
+    EnexImportItemsCreator *        m_pItemsCreator;
+    int                             m_maxConcurrentImports;
+
+    struct PendingImport
+    {
+        QString     m_enexFilePath;
+        QString     m_notebookName;
+    };
+
+    QList<PendingImport>            m_pendingImports;
+    QHash<EnexImporter*, qint64>    m_numImportedNotesByRunningImporter;
+
+    int                             m_numFiles;
+    int                             m_numFinishedFiles;
+    int                             m_numFailedFiles;
+    qint64                          m_numImportedNotesByFinishedImporters;
+    ErrorString                     m_lastErrorDescription;
+    QElapsedTimer                   m_importTimer;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_ENEX_IMPORT_MANAGER_H
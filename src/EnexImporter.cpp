@@ -1,14 +1,37 @@
 #include "EnexImporter.h"
+#include "EnexFileReaderAsync.h"
+#include "EnexImportItemsCreator.h"
+#include "CancellationFlag.h"
+#include "SettingsNames.h"
 #include "models/TagModel.h"
 #include "models/NotebookModel.h"
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
-#include <quentier/enml/ENMLConverter.h>
 #include <quentier/logging/QuentierLogger.h>
+#include <quentier/utility/ApplicationSettings.h>
+#include <quentier/utility/StandardPaths.h>
+#include <QThreadPool>
 #include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <algorithm>
+
+// The total weight of the notes read from the ENEX file but not yet added to the local storage,
+// in kilobytes of the notes' ENEX, the same bound as the ENEX exporter's one for the pending writes
+#define ENEX_IMPORTER_MAX_PENDING_NOTES_WEIGHT (32 * 1024)
+#define ENEX_IMPORTER_DEFAULT_MAX_PENDING_ADD_NOTE_REQUESTS (50)
+
+#define ENEX_IMPORTER_NOTE_CONTENT_HASH_SIZE (20)
 
 namespace quentier {
 
+// NOTE: the readers spend most of their time waiting for the imported notes to be processed so they don't take
+// the threads of the global thread pool from the rest of the application
+Q_GLOBAL_STATIC(QThreadPool, enexFileReaderThreadPool)
+
 EnexImporter::EnexImporter(const QString & enexFilePath, const QString & notebookName,
+                           const Account & account,
                            LocalStorageManagerAsync & localStorageManagerAsync,
                            TagModel & tagModel, NotebookModel & notebookModel, QObject * parent) :
     QObject(parent),
@@ -16,16 +39,39 @@ EnexImporter::EnexImporter(const QString & enexFilePath, const QString & noteboo
     m_tagModel(tagModel),
     m_notebookModel(notebookModel),
     m_enexFilePath(enexFilePath),
+    m_account(account),
     m_notebookName(notebookName),
     m_notebookLocalUid(),
+    m_pItemsCreator(),
     m_tagNamesByImportedNoteLocalUid(),
     m_addTagRequestIdByTagNameBimap(),
     m_expungedTagLocalUids(),
     m_addNotebookRequestId(),
     m_notesPendingTagAddition(),
     m_addNoteRequestIds(),
+    m_readEnexFileRequestId(),
+    m_pPendingNotesSemaphore(),
+    m_pReadEnexFileCanceled(),
+    m_decodedNotesByIndex(),
+    m_nextDecodedNoteIndex(0),
+    m_numEnexFileNotes(-1),
+    m_importTimer(),
+    m_numImportedNotes(0),
+    m_notesPendingAddition(),
+    m_maxPendingAddNoteRequests(ENEX_IMPORTER_DEFAULT_MAX_PENDING_ADD_NOTE_REQUESTS),
+    m_numFinishedAddNoteRequestsSinceCheckpoint(0),
+    m_numFailedNotes(0),
+    m_lastFailedNoteErrorDescription(),
+    m_numCheckpointNotes(0),
+    m_lastCheckpointNoteContentHash(),
+    m_committedNoteContentHashesAheadByIndex(),
+    m_importedNoteInfoByLocalUid(),
+    m_importedNoteContentHashes(),
+    m_newImportedNoteContentHashes(),
+    m_numSkippedAlreadyImportedNotes(0),
     m_pendingNotebookModelToStart(false),
-    m_connectedToLocalStorage(false)
+    m_connectedToLocalStorage(false),
+    m_canceled(false)
 {
     if (!m_tagModel.allTagsListed()) {
         QObject::connect(&m_tagModel, QNSIGNAL(TagModel,notifyAllTagsListed),
@@ -54,6 +100,17 @@ bool EnexImporter::isInProgress() const
         return true;
     }
 
+    if (!m_notesPendingAddition.isEmpty()) {
+        QNDEBUG(QStringLiteral("There are ") << m_notesPendingAddition.size()
+                << QStringLiteral(" notes pending addition to the local storage"));
+        return true;
+    }
+
+    if (!m_readEnexFileRequestId.isNull()) {
+        QNDEBUG(QStringLiteral("The ENEX file is still being imported"));
+        return true;
+    }
+
     if (!m_tagModel.allTagsListed() && !m_notesPendingTagAddition.isEmpty()) {
         QNDEBUG(QStringLiteral("Not all tags were listed in the tag model yet + there are ")
                 << m_notesPendingTagAddition.size() << QStringLiteral(" notes pending tag addition"));
@@ -121,82 +178,38 @@ void EnexImporter::start()
         m_notebookLocalUid = notebookLocalUid;
     }
 
-    QFile enexFile(m_enexFilePath);
-    bool res = enexFile.open(QIODevice::ReadOnly);
-    if (Q_UNLIKELY(!res)) {
-        ErrorString errorDescription(QT_TR_NOOP("Can't import ENEX: can't open enex file for writing"));
-        errorDescription.details() = m_enexFilePath;
-        QNWARNING(errorDescription);
-        Q_EMIT enexImportFailed(errorDescription);
-        return;
-    }
-
-    QString enex = QString::fromUtf8(enexFile.readAll());
-    enexFile.close();
-
-    QVector<Note> importedNotes;
-    ErrorString errorDescription;
-    ENMLConverter converter;
-    res = converter.importEnex(enex, importedNotes, m_tagNamesByImportedNoteLocalUid, errorDescription);
-    if (!res) {
-        Q_EMIT enexImportFailed(errorDescription);
-        return;
-    }
-
-    for(auto it = importedNotes.begin(); it != importedNotes.end(); )
-    {
-        Note & note = *it;
-        note.setNotebookLocalUid(m_notebookLocalUid);
-
-        auto tagIt = m_tagNamesByImportedNoteLocalUid.find(note.localUid());
-        if (tagIt == m_tagNamesByImportedNoteLocalUid.end()) {
-            QNTRACE(QStringLiteral("Imported note doesn't have tag names assigned to it, can add it to local storage right away: ")
-                    << note);
-            addNoteToLocalStorage(note);
-            it = importedNotes.erase(it);
-            continue;
-        }
-
-        QStringList & tagNames = tagIt.value();
-        for(auto tagNameIt = tagNames.begin(); tagNameIt != tagNames.end(); )
-        {
-            const QString & tagName = *tagNameIt;
-            if (!tagName.isEmpty()) {
-                ++tagNameIt;
-                continue;
-            }
-
-            QNDEBUG(QStringLiteral("Removing empty tag name from the list of tag names for note ") << note.localUid());
-            tagNameIt = tagNames.erase(tagNameIt);
-        }
-
-        if (Q_UNLIKELY(tagNames.isEmpty()))
-        {
-            QNDEBUG(QStringLiteral("No tag names are left for note ") << note.localUid()
-                    << QStringLiteral(" after the cleanup of empty tag names, can add the note to local storage right away"));
+    startReadingEnexFile();
+}
 
-            addNoteToLocalStorage(note);
-            it = importedNotes.erase(it);
-            continue;
-        }
+void EnexImporter::setMaxPendingAddNoteRequests(const int maxPendingAddNoteRequests)
+{
+    QNDEBUG(QStringLiteral("EnexImporter::setMaxPendingAddNoteRequests: ") << maxPendingAddNoteRequests);
+    m_maxPendingAddNoteRequests = std::max(maxPendingAddNoteRequests, 1);
+}
 
-        ++it;
-    }
+void EnexImporter::setItemsCreator(EnexImportItemsCreator * pItemsCreator)
+{
+    QNDEBUG(QStringLiteral("EnexImporter::setItemsCreator"));
 
-    if (importedNotes.isEmpty()) {
-        QNDEBUG(QStringLiteral("No notes had any tags, waiting for the completion of all add note requests"));
-        return;
+    if (!m_pItemsCreator.isNull()) {
+        QObject::disconnect(m_pItemsCreator.data(), Q_NULLPTR, this, Q_NULLPTR);
     }
 
-    m_notesPendingTagAddition = importedNotes;
-    QNDEBUG(QStringLiteral("There are ") << m_notesPendingTagAddition.size() << QStringLiteral(" notes which need tags assignment to them"));
-
-    if (!m_tagModel.allTagsListed()) {
-        QNDEBUG(QStringLiteral("Not all tags were listed from the tag model, waiting for it"));
+    m_pItemsCreator = pItemsCreator;
+    if (m_pItemsCreator.isNull()) {
         return;
     }
 
-    processNotesPendingTagAddition();
+    // NOTE: queued connections since the creator reports the already added items right away
+    // while the importer might be iterating over its notes pending tags addition
+    QObject::connect(m_pItemsCreator.data(), QNSIGNAL(EnexImportItemsCreator,tagAdded,Tag),
+                     this, QNSLOT(EnexImporter,onSharedTagAdded,Tag), Qt::QueuedConnection);
+    QObject::connect(m_pItemsCreator.data(), QNSIGNAL(EnexImportItemsCreator,tagAddFailed,QString,ErrorString),
+                     this, QNSLOT(EnexImporter,onSharedTagAddFailed,QString,ErrorString), Qt::QueuedConnection);
+    QObject::connect(m_pItemsCreator.data(), QNSIGNAL(EnexImportItemsCreator,notebookAdded,Notebook),
+                     this, QNSLOT(EnexImporter,onSharedNotebookAdded,Notebook), Qt::QueuedConnection);
+    QObject::connect(m_pItemsCreator.data(), QNSIGNAL(EnexImportItemsCreator,notebookAddFailed,QString,ErrorString),
+                     this, QNSLOT(EnexImporter,onSharedNotebookAddFailed,QString,ErrorString), Qt::QueuedConnection);
 }
 
 void EnexImporter::clear()
@@ -211,8 +224,75 @@ void EnexImporter::clear()
 
     m_notesPendingTagAddition.clear();
     m_addNoteRequestIds.clear();
+    m_notesPendingAddition.clear();
+    m_numFinishedAddNoteRequestsSinceCheckpoint = 0;
+
+    m_numFailedNotes = 0;
+    m_lastFailedNoteErrorDescription.clear();
 
+    cancelReadingEnexFile();
+
+    m_numCheckpointNotes = 0;
+    m_lastCheckpointNoteContentHash.clear();
+    m_committedNoteContentHashesAheadByIndex.clear();
+    m_importedNoteInfoByLocalUid.clear();
+    m_importedNoteContentHashes.clear();
+    m_newImportedNoteContentHashes.clear();
+    m_numSkippedAlreadyImportedNotes = 0;
+
+    m_pendingNotebookModelToStart = false;
+    m_canceled = false;
+}
+
+void EnexImporter::cancel()
+{
+    QNDEBUG(QStringLiteral("EnexImporter::cancel"));
+
+    cancelReadingEnexFile();
+
+    m_tagNamesByImportedNoteLocalUid.clear();
+    m_notesPendingTagAddition.clear();
+    m_notesPendingAddition.clear();
     m_pendingNotebookModelToStart = false;
+
+    // NOTE: the tags and the notebook requested from the items creator are created by it regardless of this importer
+    if (!m_pItemsCreator.isNull()) {
+        m_addTagRequestIdByTagNameBimap.clear();
+        m_addNotebookRequestId = QUuid();
+    }
+
+    m_canceled = true;
+    checkCancelationCompletion();
+}
+
+bool EnexImporter::hasPendingRequests() const
+{
+    return !m_addNoteRequestIds.isEmpty() || !m_addTagRequestIdByTagNameBimap.empty() ||
+           !m_addNotebookRequestId.isNull();
+}
+
+void EnexImporter::checkCancelationCompletion()
+{
+    if (!m_canceled) {
+        return;
+    }
+
+    if (hasPendingRequests()) {
+        QNDEBUG(QStringLiteral("The import is canceled but still pending ") << m_addNoteRequestIds.size()
+                << QStringLiteral(" add note requests and ") << m_addTagRequestIdByTagNameBimap.size()
+                << QStringLiteral(" add tag requests"));
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("The canceled import has no pending requests left"));
+
+    // Keep what has been imported before the cancellation so that the next attempt could resume from it
+    saveNewImportedNoteContentHashes();
+    saveImportCheckpoint();
+
+    disconnectFromLocalStorage();
+    m_canceled = false;
+    Q_EMIT canceled();
 }
 
 void EnexImporter::onAddTagComplete(Tag tag, QUuid requestId)
@@ -227,6 +307,16 @@ void EnexImporter::onAddTagComplete(Tag tag, QUuid requestId)
 
     Q_UNUSED(m_addTagRequestIdByTagNameBimap.right.erase(it))
 
+    if (m_canceled) {
+        checkCancelationCompletion();
+        return;
+    }
+
+    processAddedTag(tag);
+}
+
+void EnexImporter::processAddedTag(const Tag & tag)
+{
     if (Q_UNLIKELY(!tag.hasName())) {
         ErrorString errorDescription(QT_TR_NOOP("Can't import ENEX: internal error, "
                                                 "could not create a new tag in the local storage: "
@@ -301,6 +391,11 @@ void EnexImporter::onAddTagFailed(Tag tag, ErrorString errorDescription, QUuid r
 
     Q_UNUSED(m_addTagRequestIdByTagNameBimap.right.erase(it))
 
+    if (m_canceled) {
+        checkCancelationCompletion();
+        return;
+    }
+
     ErrorString error(QT_TR_NOOP("Can't import ENEX"));
     error.appendBase(errorDescription.base());
     error.appendBase(errorDescription.additionalBases());
@@ -359,6 +454,17 @@ void EnexImporter::onAddNotebookComplete(Notebook notebook, QUuid requestId)
             << QStringLiteral(", notebook: ") << notebook);
 
     m_addNotebookRequestId = QUuid();
+
+    if (m_canceled) {
+        checkCancelationCompletion();
+        return;
+    }
+
+    processAddedNotebook(notebook);
+}
+
+void EnexImporter::processAddedNotebook(const Notebook & notebook)
+{
     m_notebookLocalUid = notebook.localUid();
     start();
 }
@@ -375,6 +481,11 @@ void EnexImporter::onAddNotebookFailed(Notebook notebook, ErrorString errorDescr
 
     m_addNotebookRequestId = QUuid();
 
+    if (m_canceled) {
+        checkCancelationCompletion();
+        return;
+    }
+
     ErrorString error(QT_TR_NOOP("Can't import ENEX"));
     error.appendBase(errorDescription.base());
     error.appendBase(errorDescription.additionalBases());
@@ -407,19 +518,20 @@ void EnexImporter::onAddNoteComplete(Note note, QUuid requestId)
 
     Q_UNUSED(m_addNoteRequestIds.erase(it))
 
-    if (!m_addNoteRequestIds.isEmpty()) {
-        QNDEBUG(QStringLiteral("Still pending ") << m_addNoteRequestIds.size() << QStringLiteral(" add note request ids"));
-        return;
-    }
-
-    if (!m_notesPendingTagAddition.isEmpty()) {
-        QNDEBUG(QStringLiteral("There are still ") << m_notesPendingTagAddition.size() << QStringLiteral(" notes pending tag addition"));
-        return;
+    ++m_numImportedNotes;
+
+    int noteWeight = 0;
+    auto infoIt = m_importedNoteInfoByLocalUid.find(note.localUid());
+    if (infoIt != m_importedNoteInfoByLocalUid.end()) {
+        const ImportedNoteInfo & info = infoIt.value();
+        Q_UNUSED(m_importedNoteContentHashes.insert(info.m_contentHash))
+        m_newImportedNoteContentHashes << info.m_contentHash;
+        markNoteCommitted(info.m_index, info.m_contentHash);
+        noteWeight = info.m_weight;
+        Q_UNUSED(m_importedNoteInfoByLocalUid.erase(infoIt))
     }
 
-    QNDEBUG(QStringLiteral("There are no pending add note requests and no notes pending tags addition => "
-                           "it looks like the import has finished"));
-    Q_EMIT enexImportedSuccessfully(m_enexFilePath);
+    onAddNoteRequestFinished(noteWeight);
 }
 
 void EnexImporter::onAddNoteFailed(Note note, ErrorString errorDescription, QUuid requestId)
@@ -435,6 +547,81 @@ void EnexImporter::onAddNoteFailed(Note note, ErrorString errorDescription, QUui
 
     Q_UNUSED(m_addNoteRequestIds.erase(it))
 
+    // NOTE: the failed note is never committed so the checkpoint doesn't move past it and the resumed import
+    // would retry it while skipping the notes following it which have already been imported
+    int noteWeight = 0;
+    auto infoIt = m_importedNoteInfoByLocalUid.find(note.localUid());
+    if (infoIt != m_importedNoteInfoByLocalUid.end()) {
+        noteWeight = infoIt.value().m_weight;
+        Q_UNUSED(m_importedNoteInfoByLocalUid.erase(infoIt))
+    }
+
+    ++m_numFailedNotes;
+    m_lastFailedNoteErrorDescription = errorDescription;
+    onAddNoteRequestFinished(noteWeight);
+}
+
+void EnexImporter::onSharedTagAdded(Tag tag)
+{
+    if (Q_UNLIKELY(!tag.hasName())) {
+        return;
+    }
+
+    auto it = m_addTagRequestIdByTagNameBimap.left.find(tag.name().toLower());
+    if (it == m_addTagRequestIdByTagNameBimap.left.end()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImporter::onSharedTagAdded: ") << tag);
+
+    Q_UNUSED(m_addTagRequestIdByTagNameBimap.left.erase(it))
+    processAddedTag(tag);
+}
+
+void EnexImporter::onSharedTagAddFailed(QString tagName, ErrorString errorDescription)
+{
+    auto it = m_addTagRequestIdByTagNameBimap.left.find(tagName.toLower());
+    if (it == m_addTagRequestIdByTagNameBimap.left.end()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImporter::onSharedTagAddFailed: tag name = ") << tagName
+            << QStringLiteral(", error description = ") << errorDescription);
+
+    Q_UNUSED(m_addTagRequestIdByTagNameBimap.left.erase(it))
+
+    ErrorString error(QT_TR_NOOP("Can't import ENEX"));
+    error.appendBase(errorDescription.base());
+    error.appendBase(errorDescription.additionalBases());
+    error.details() = errorDescription.details();
+    Q_EMIT enexImportFailed(error);
+}
+
+void EnexImporter::onSharedNotebookAdded(Notebook notebook)
+{
+    if (m_addNotebookRequestId.isNull() || !notebook.hasName() ||
+        (notebook.name().toLower() != m_notebookName.toLower()))
+    {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImporter::onSharedNotebookAdded: ") << notebook);
+
+    m_addNotebookRequestId = QUuid();
+    processAddedNotebook(notebook);
+}
+
+void EnexImporter::onSharedNotebookAddFailed(QString notebookName, ErrorString errorDescription)
+{
+    if (m_addNotebookRequestId.isNull() || (notebookName.toLower() != m_notebookName.toLower())) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImporter::onSharedNotebookAddFailed: notebook name = ") << notebookName
+            << QStringLiteral(", error description = ") << errorDescription);
+
+    m_addNotebookRequestId = QUuid();
+
     ErrorString error(QT_TR_NOOP("Can't import ENEX"));
     error.appendBase(errorDescription.base());
     error.appendBase(errorDescription.additionalBases());
@@ -471,6 +658,597 @@ void EnexImporter::onAllNotebooksListed()
     start();
 }
 
+void EnexImporter::onEnexFileNotesSkipped(qint64 numSkippedNotes, QUuid requestId)
+{
+    if (requestId != m_readEnexFileRequestId) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImporter::onEnexFileNotesSkipped: ") << numSkippedNotes);
+
+    m_nextDecodedNoteIndex = numSkippedNotes;
+
+    if (numSkippedNotes == 0) {
+        m_numCheckpointNotes = 0;
+        m_lastCheckpointNoteContentHash.clear();
+    }
+    else {
+        QNINFO(QStringLiteral("Resuming the import of ENEX file ") << m_enexFilePath << QStringLiteral(" after ")
+               << numSkippedNotes << QStringLiteral(" already imported notes"));
+        m_numCheckpointNotes = numSkippedNotes;
+    }
+
+    m_committedNoteContentHashesAheadByIndex.clear();
+}
+
+void EnexImporter::onEnexFileNoteDecoded(Note note, QStringList tagNames, QByteArray noteContentHash,
+                                         qint64 noteIndex, int noteWeight, QUuid requestId)
+{
+    if (requestId != m_readEnexFileRequestId) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImporter::onEnexFileNoteDecoded: note index = ") << noteIndex
+            << QStringLiteral(", note local uid = ") << note.localUid());
+
+    DecodedNote decodedNote;
+    decodedNote.m_note = note;
+    decodedNote.m_tagNames = tagNames;
+    decodedNote.m_contentHash = noteContentHash;
+    decodedNote.m_weight = noteWeight;
+    enqueueDecodedNote(decodedNote, noteIndex);
+}
+
+void EnexImporter::onEnexFileNoteDecodingFailed(ErrorString errorDescription, QByteArray noteContentHash,
+                                                qint64 noteIndex, int noteWeight, QUuid requestId)
+{
+    if (requestId != m_readEnexFileRequestId) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("EnexImporter::onEnexFileNoteDecodingFailed: note index = ") << noteIndex
+              << QStringLiteral(", error: ") << errorDescription);
+
+    DecodedNote decodedNote;
+    decodedNote.m_contentHash = noteContentHash;
+    decodedNote.m_weight = noteWeight;
+    decodedNote.m_decodingFailed = true;
+    decodedNote.m_errorDescription = errorDescription;
+    enqueueDecodedNote(decodedNote, noteIndex);
+}
+
+void EnexImporter::enqueueDecodedNote(DecodedNote & decodedNote, const qint64 noteIndex)
+{
+    if (noteIndex != m_nextDecodedNoteIndex) {
+        QNTRACE(QStringLiteral("The note ") << noteIndex << QStringLiteral(" was decoded ahead of the next note ")
+                << QStringLiteral("in order, index ") << m_nextDecodedNoteIndex << QStringLiteral(", will wait for it"));
+        m_decodedNotesByIndex[noteIndex] = decodedNote;
+        return;
+    }
+
+    processDecodedNote(decodedNote, noteIndex);
+    ++m_nextDecodedNoteIndex;
+
+    while(!m_decodedNotesByIndex.isEmpty())
+    {
+        auto it = m_decodedNotesByIndex.begin();
+        if (it.key() != m_nextDecodedNoteIndex) {
+            break;
+        }
+
+        DecodedNote nextDecodedNote = it.value();
+        Q_UNUSED(m_decodedNotesByIndex.erase(it))
+
+        processDecodedNote(nextDecodedNote, m_nextDecodedNoteIndex);
+        ++m_nextDecodedNoteIndex;
+    }
+
+    // The last notes of the file might all be the already imported ones
+    if (m_nextDecodedNoteIndex == m_numEnexFileNotes) {
+        checkImportCompletion();
+    }
+}
+
+void EnexImporter::processDecodedNote(DecodedNote & decodedNote, const qint64 noteIndex)
+{
+    Note & note = decodedNote.m_note;
+    QStringList & tagNames = decodedNote.m_tagNames;
+    const QByteArray & noteContentHash = decodedNote.m_contentHash;
+
+    QNDEBUG(QStringLiteral("EnexImporter::processDecodedNote: note local uid = ") << note.localUid()
+            << QStringLiteral(", index = ") << noteIndex << QStringLiteral(", tag names: ")
+            << tagNames.join(QStringLiteral(", ")));
+
+    if (decodedNote.m_decodingFailed)
+    {
+        // NOTE: the note which can't be decoded would fail the same way on the resumed import
+        // so the checkpoint moves past it
+        QNDEBUG(QStringLiteral("Skipping the note which failed to be decoded"));
+        ++m_numFailedNotes;
+        m_lastFailedNoteErrorDescription = decodedNote.m_errorDescription;
+        markNoteCommitted(noteIndex, noteContentHash);
+        releasePendingNoteWeight(decodedNote.m_weight);
+        return;
+    }
+
+    if (m_importedNoteContentHashes.contains(noteContentHash))
+    {
+        QNDEBUG(QStringLiteral("The note has already been imported before, skipping it"));
+        ++m_numSkippedAlreadyImportedNotes;
+        markNoteCommitted(noteIndex, noteContentHash);
+        releasePendingNoteWeight(decodedNote.m_weight);
+        return;
+    }
+
+    ImportedNoteInfo & info = m_importedNoteInfoByLocalUid[note.localUid()];
+    info.m_index = noteIndex;
+    info.m_contentHash = noteContentHash;
+    info.m_weight = decodedNote.m_weight;
+
+    note.setNotebookLocalUid(m_notebookLocalUid);
+
+    for(auto tagNameIt = tagNames.begin(); tagNameIt != tagNames.end(); )
+    {
+        const QString & tagName = *tagNameIt;
+        if (!tagName.isEmpty()) {
+            ++tagNameIt;
+            continue;
+        }
+
+        QNDEBUG(QStringLiteral("Removing empty tag name from the list of tag names for note ") << note.localUid());
+        tagNameIt = tagNames.erase(tagNameIt);
+    }
+
+    if (tagNames.isEmpty()) {
+        QNTRACE(QStringLiteral("Imported note doesn't have tag names assigned to it, can add it to local storage right away: ")
+                << note);
+        addNoteToLocalStorage(note);
+        return;
+    }
+
+    m_tagNamesByImportedNoteLocalUid[note.localUid()] = tagNames;
+    m_notesPendingTagAddition << note;
+    QNDEBUG(QStringLiteral("There are ") << m_notesPendingTagAddition.size() << QStringLiteral(" notes which need tags assignment to them"));
+
+    if (!m_tagModel.allTagsListed()) {
+        QNDEBUG(QStringLiteral("Not all tags were listed from the tag model, waiting for it"));
+        return;
+    }
+
+    processNotesPendingTagAddition();
+}
+
+void EnexImporter::onEnexFileReadFinished(qint64 numNotesRead, QUuid requestId)
+{
+    if (requestId != m_readEnexFileRequestId) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImporter::onEnexFileReadFinished: num notes read = ") << numNotesRead);
+
+    m_numEnexFileNotes = numNotesRead;
+    checkImportCompletion();
+}
+
+void EnexImporter::onEnexFileReadFailed(ErrorString errorDescription, QUuid requestId)
+{
+    if (requestId != m_readEnexFileRequestId) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("EnexImporter::onEnexFileReadFailed: ") << errorDescription);
+
+    // Stop the reading and decoding of the remaining notes, if any
+    cancelReadingEnexFile();
+
+    // Keep what has been imported so far so that the next attempt could resume from it
+    saveNewImportedNoteContentHashes();
+    saveImportCheckpoint();
+
+    Q_EMIT enexImportFailed(errorDescription);
+}
+
+void EnexImporter::startReadingEnexFile()
+{
+    QNDEBUG(QStringLiteral("EnexImporter::startReadingEnexFile"));
+
+    cancelReadingEnexFile();
+
+    // The semaphore bounds the total weight of the notes being decoded and the decoded notes waiting
+    // for addition to the local storage; unlike the number of notes that bounds the memory they take
+    m_readEnexFileRequestId = QUuid::createUuid();
+    m_pPendingNotesSemaphore = QSharedPointer<QSemaphore>(new QSemaphore(ENEX_IMPORTER_MAX_PENDING_NOTES_WEIGHT));
+    m_pReadEnexFileCanceled = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+
+    Q_UNUSED(loadImportCheckpoint())
+    loadImportedNoteContentHashes();
+
+    EnexFileReaderAsync * pReader = new EnexFileReaderAsync(m_enexFilePath, m_readEnexFileRequestId,
+                                                            m_pPendingNotesSemaphore,
+                                                            ENEX_IMPORTER_MAX_PENDING_NOTES_WEIGHT,
+                                                            m_pReadEnexFileCanceled,
+                                                            m_numCheckpointNotes, m_lastCheckpointNoteContentHash);
+    QObject::connect(pReader, QNSIGNAL(EnexFileReaderAsync,notesSkipped,qint64,QUuid),
+                     this, QNSLOT(EnexImporter,onEnexFileNotesSkipped,qint64,QUuid),
+                     Qt::QueuedConnection);
+    QObject::connect(pReader, QNSIGNAL(EnexFileReaderAsync,noteDecoded,Note,QStringList,QByteArray,qint64,int,QUuid),
+                     this, QNSLOT(EnexImporter,onEnexFileNoteDecoded,Note,QStringList,QByteArray,qint64,int,QUuid),
+                     Qt::QueuedConnection);
+    QObject::connect(pReader, QNSIGNAL(EnexFileReaderAsync,noteDecodingFailed,ErrorString,QByteArray,qint64,int,QUuid),
+                     this, QNSLOT(EnexImporter,onEnexFileNoteDecodingFailed,ErrorString,QByteArray,qint64,int,QUuid),
+                     Qt::QueuedConnection);
+    QObject::connect(pReader, QNSIGNAL(EnexFileReaderAsync,finished,qint64,QUuid),
+                     this, QNSLOT(EnexImporter,onEnexFileReadFinished,qint64,QUuid),
+                     Qt::QueuedConnection);
+    QObject::connect(pReader, QNSIGNAL(EnexFileReaderAsync,failed,ErrorString,QUuid),
+                     this, QNSLOT(EnexImporter,onEnexFileReadFailed,ErrorString,QUuid),
+                     Qt::QueuedConnection);
+
+    m_decodedNotesByIndex.clear();
+    m_nextDecodedNoteIndex = 0;
+    m_numEnexFileNotes = -1;
+    m_numImportedNotes = 0;
+    m_numFailedNotes = 0;
+    m_lastFailedNoteErrorDescription.clear();
+    m_numFinishedAddNoteRequestsSinceCheckpoint = 0;
+    m_committedNoteContentHashesAheadByIndex.clear();
+    m_importedNoteInfoByLocalUid.clear();
+    m_numSkippedAlreadyImportedNotes = 0;
+    m_importTimer.start();
+
+    QNTRACE(QStringLiteral("Starting to read the ENEX file: request id = ") << m_readEnexFileRequestId);
+    enexFileReaderThreadPool()->start(pReader);
+}
+
+void EnexImporter::cancelReadingEnexFile()
+{
+    if (!m_pReadEnexFileCanceled.isNull()) {
+        QNDEBUG(QStringLiteral("EnexImporter::cancelReadingEnexFile: request id = ") << m_readEnexFileRequestId);
+        setCanceled(*m_pReadEnexFileCanceled);
+        m_pReadEnexFileCanceled.clear();
+    }
+
+    m_readEnexFileRequestId = QUuid();
+    m_pPendingNotesSemaphore.clear();
+
+    m_decodedNotesByIndex.clear();
+    m_nextDecodedNoteIndex = 0;
+    m_numEnexFileNotes = -1;
+}
+
+void EnexImporter::checkImportCompletion()
+{
+    if (m_readEnexFileRequestId.isNull()) {
+        QNDEBUG(QStringLiteral("The ENEX file is not being imported"));
+        return;
+    }
+
+    if ((m_numEnexFileNotes < 0) || (m_nextDecodedNoteIndex < m_numEnexFileNotes)) {
+        QNDEBUG(QStringLiteral("The ENEX file is still being read"));
+        return;
+    }
+
+    if (!m_addNoteRequestIds.isEmpty()) {
+        QNDEBUG(QStringLiteral("Still pending ") << m_addNoteRequestIds.size() << QStringLiteral(" add note request ids"));
+        return;
+    }
+
+    if (!m_notesPendingTagAddition.isEmpty()) {
+        QNDEBUG(QStringLiteral("There are still ") << m_notesPendingTagAddition.size() << QStringLiteral(" notes pending tag addition"));
+        return;
+    }
+
+    if (!m_notesPendingAddition.isEmpty()) {
+        QNDEBUG(QStringLiteral("There are still ") << m_notesPendingAddition.size()
+                << QStringLiteral(" notes pending addition to the local storage"));
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("The ENEX file has been read, there are no pending add note requests and no notes "
+                           "pending tags addition => it looks like the import has finished"));
+
+    m_readEnexFileRequestId = QUuid();
+    m_pReadEnexFileCanceled.clear();
+    m_pPendingNotesSemaphore.clear();
+
+    if (m_numSkippedAlreadyImportedNotes > 0) {
+        QNINFO(QStringLiteral("Skipped ") << m_numSkippedAlreadyImportedNotes
+               << QStringLiteral(" notes which have already been imported before"));
+    }
+
+    saveNewImportedNoteContentHashes();
+
+    if (m_numFailedNotes > 0)
+    {
+        saveImportCheckpoint();
+
+        ErrorString error(QT_TR_NOOP("Can't import ENEX: some notes could not be imported"));
+        error.appendBase(m_lastFailedNoteErrorDescription.base());
+        error.appendBase(m_lastFailedNoteErrorDescription.additionalBases());
+        error.details() = QString::number(m_numFailedNotes) + QStringLiteral(" of ") +
+                          QString::number(m_numFailedNotes + m_numImportedNotes);
+        if (!m_lastFailedNoteErrorDescription.details().isEmpty()) {
+            error.details() += QStringLiteral("; ") + m_lastFailedNoteErrorDescription.details();
+        }
+
+        QNWARNING(error);
+        Q_EMIT enexImportFailed(error);
+        return;
+    }
+
+    // NOTE: the content hashes of the imported notes stay in the notebook's index for the next imports
+    removeImportCheckpoint();
+    Q_EMIT enexImportedSuccessfully(m_enexFilePath);
+}
+
+void EnexImporter::sendNotesPendingAddition()
+{
+    if (m_notesPendingAddition.isEmpty()) {
+        return;
+    }
+
+    int numNotesToSend = std::min(m_notesPendingAddition.size(),
+                                  m_maxPendingAddNoteRequests - m_addNoteRequestIds.size());
+    if (numNotesToSend <= 0) {
+        QNTRACE(QStringLiteral("Too many notes are still being added to the local storage: ")
+                << m_addNoteRequestIds.size() << QStringLiteral(", ") << m_notesPendingAddition.size()
+                << QStringLiteral(" notes wait for them"));
+        return;
+    }
+
+    connectToLocalStorage();
+
+    QNTRACE(QStringLiteral("Sending ") << numNotesToSend << QStringLiteral(" notes to the local storage"));
+
+    // NOTE: LocalStorageManagerAsync has no bulk insert request and doesn't expose its transactions so each note
+    // is a separate add note request committed within its own transaction; the window of pending requests only
+    // saves the round trip between the next note and the completion of the previous one
+    for(int i = 0; i < numNotesToSend; ++i)
+    {
+        const Note & note = m_notesPendingAddition.at(i);
+        QUuid requestId = QUuid::createUuid();
+        Q_UNUSED(m_addNoteRequestIds.insert(requestId));
+        QNTRACE(QStringLiteral("Emitting the request to add note to local storage: request id = ")
+                << requestId << QStringLiteral(", note: ") << note);
+        Q_EMIT addNote(note, requestId);
+    }
+
+    m_notesPendingAddition.remove(0, numNotesToSend);
+}
+
+void EnexImporter::onAddNoteRequestFinished(const int noteWeight)
+{
+    releasePendingNoteWeight(noteWeight);
+
+    if (m_canceled) {
+        checkCancelationCompletion();
+        return;
+    }
+
+    // The next note is sent to the local storage right away instead of waiting for all the pending ones
+    sendNotesPendingAddition();
+
+    ++m_numFinishedAddNoteRequestsSinceCheckpoint;
+    if ((m_numFinishedAddNoteRequestsSinceCheckpoint >= m_maxPendingAddNoteRequests) ||
+        m_addNoteRequestIds.isEmpty())
+    {
+        QNDEBUG(QStringLiteral("Imported ") << m_numImportedNotes << QStringLiteral(" notes so far, failed to import ")
+                << m_numFailedNotes);
+
+        m_numFinishedAddNoteRequestsSinceCheckpoint = 0;
+        saveNewImportedNoteContentHashes();
+        saveImportCheckpoint();
+        reportImportProgress();
+    }
+
+    checkImportCompletion();
+}
+
+void EnexImporter::releasePendingNoteWeight(const int noteWeight)
+{
+    if (!m_pPendingNotesSemaphore.isNull() && (noteWeight > 0)) {
+        m_pPendingNotesSemaphore->release(noteWeight);
+    }
+}
+
+void EnexImporter::markNoteCommitted(const qint64 noteIndex, const QByteArray & noteContentHash)
+{
+    if (noteIndex != m_numCheckpointNotes) {
+        QNTRACE(QStringLiteral("The note with index ") << noteIndex << QStringLiteral(" was committed ahead of ")
+                << QStringLiteral("the note with index ") << m_numCheckpointNotes);
+        m_committedNoteContentHashesAheadByIndex[noteIndex] = noteContentHash;
+        return;
+    }
+
+    ++m_numCheckpointNotes;
+    m_lastCheckpointNoteContentHash = noteContentHash;
+
+    while(!m_committedNoteContentHashesAheadByIndex.isEmpty())
+    {
+        auto it = m_committedNoteContentHashesAheadByIndex.begin();
+        if (it.key() != m_numCheckpointNotes) {
+            break;
+        }
+
+        ++m_numCheckpointNotes;
+        m_lastCheckpointNoteContentHash = it.value();
+        Q_UNUSED(m_committedNoteContentHashesAheadByIndex.erase(it))
+    }
+}
+
+bool EnexImporter::loadImportCheckpoint()
+{
+    QNDEBUG(QStringLiteral("EnexImporter::loadImportCheckpoint"));
+
+    m_numCheckpointNotes = 0;
+    m_lastCheckpointNoteContentHash.clear();
+
+    ApplicationSettings appSettings(m_account, QUENTIER_UI_SETTINGS);
+    appSettings.beginGroup(importCheckpointSettingsGroupName());
+    QString enexFilePath = appSettings.value(ENEX_IMPORT_CHECKPOINT_FILE_PATH_SETTINGS_KEY).toString();
+    qint64 enexFileSize = appSettings.value(ENEX_IMPORT_CHECKPOINT_FILE_SIZE_SETTINGS_KEY).toLongLong();
+    qint64 enexFileLastModified = appSettings.value(ENEX_IMPORT_CHECKPOINT_FILE_LAST_MODIFIED_SETTINGS_KEY).toLongLong();
+    qint64 numNotes = appSettings.value(ENEX_IMPORT_CHECKPOINT_NUM_NOTES_SETTINGS_KEY).toLongLong();
+    QByteArray lastNoteContentHash = appSettings.value(ENEX_IMPORT_CHECKPOINT_LAST_NOTE_HASH_SETTINGS_KEY).toByteArray();
+    appSettings.endGroup();
+
+    if ((numNotes < 0) || (enexFilePath != m_enexFilePath)) {
+        QNDEBUG(QStringLiteral("No import checkpoint for this ENEX file and notebook"));
+        return false;
+    }
+
+    QFileInfo enexFileInfo(m_enexFilePath);
+    if ((enexFileInfo.size() != enexFileSize) ||
+        (enexFileInfo.lastModified().toMSecsSinceEpoch() != enexFileLastModified))
+    {
+        QNDEBUG(QStringLiteral("The ENEX file has changed since the import checkpoint was saved, ignoring it"));
+        removeImportCheckpoint();
+        return false;
+    }
+
+    QNDEBUG(QStringLiteral("Found the import checkpoint: ") << numNotes << QStringLiteral(" notes already imported"));
+    m_numCheckpointNotes = numNotes;
+    m_lastCheckpointNoteContentHash = lastNoteContentHash;
+    return true;
+}
+
+void EnexImporter::saveImportCheckpoint()
+{
+    // NOTE: the notes past the checkpoint are recognized by the notebook's content hashes index on their own
+    if (m_numCheckpointNotes <= 0) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImporter::saveImportCheckpoint: ") << m_numCheckpointNotes);
+
+    QFileInfo enexFileInfo(m_enexFilePath);
+
+    ApplicationSettings appSettings(m_account, QUENTIER_UI_SETTINGS);
+    appSettings.beginGroup(importCheckpointSettingsGroupName());
+    appSettings.setValue(ENEX_IMPORT_CHECKPOINT_FILE_PATH_SETTINGS_KEY, m_enexFilePath);
+    appSettings.setValue(ENEX_IMPORT_CHECKPOINT_FILE_SIZE_SETTINGS_KEY, enexFileInfo.size());
+    appSettings.setValue(ENEX_IMPORT_CHECKPOINT_FILE_LAST_MODIFIED_SETTINGS_KEY,
+                         enexFileInfo.lastModified().toMSecsSinceEpoch());
+    appSettings.setValue(ENEX_IMPORT_CHECKPOINT_NUM_NOTES_SETTINGS_KEY, m_numCheckpointNotes);
+    appSettings.setValue(ENEX_IMPORT_CHECKPOINT_LAST_NOTE_HASH_SETTINGS_KEY, m_lastCheckpointNoteContentHash);
+    appSettings.endGroup();
+}
+
+void EnexImporter::removeImportCheckpoint()
+{
+    QNDEBUG(QStringLiteral("EnexImporter::removeImportCheckpoint"));
+
+    ApplicationSettings appSettings(m_account, QUENTIER_UI_SETTINGS);
+    appSettings.remove(importCheckpointSettingsGroupName());
+}
+
+QString EnexImporter::importKey() const
+{
+    // NOTE: the file path can't be used as the settings group or file name as is since it contains slashes
+    QByteArray key = m_enexFilePath.toUtf8() + '\n' + m_notebookName.toUtf8();
+    return QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex());
+}
+
+QString EnexImporter::importCheckpointSettingsGroupName() const
+{
+    return ENEX_EXPORT_IMPORT_SETTINGS_GROUP_NAME + QStringLiteral("/") + ENEX_IMPORT_CHECKPOINTS_SETTINGS_GROUP_NAME +
+           QStringLiteral("/") + importKey();
+}
+
+QString EnexImporter::importedNoteContentHashesFilePath() const
+{
+    // NOTE: keyed by the notebook's local uid rather than by its name so that the index survives the renaming
+    // of the notebook; the local uid is hashed for the same reason as the import key
+    QByteArray notebookKey = QCryptographicHash::hash(m_notebookLocalUid.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return accountPersistentStoragePath(m_account) + QStringLiteral("/enexImport/notebookNoteContentHashes/") +
+           QString::fromLatin1(notebookKey);
+}
+
+void EnexImporter::loadImportedNoteContentHashes()
+{
+    QNDEBUG(QStringLiteral("EnexImporter::loadImportedNoteContentHashes"));
+
+    m_importedNoteContentHashes.clear();
+    m_newImportedNoteContentHashes.clear();
+
+    QFile file(importedNoteContentHashesFilePath());
+    if (!file.exists()) {
+        QNDEBUG(QStringLiteral("No notes have been imported into this notebook before"));
+        return;
+    }
+
+    if (Q_UNLIKELY(!file.open(QIODevice::ReadOnly))) {
+        QNWARNING(QStringLiteral("Can't open the file with content hashes of imported notes: ")
+                  << file.errorString());
+        return;
+    }
+
+    // The file is just the sequence of fixed size hashes
+    QByteArray data = file.readAll();
+    int numHashes = data.size() / ENEX_IMPORTER_NOTE_CONTENT_HASH_SIZE;
+    m_importedNoteContentHashes.reserve(numHashes);
+    for(int i = 0; i < numHashes; ++i) {
+        Q_UNUSED(m_importedNoteContentHashes.insert(data.mid(i * ENEX_IMPORTER_NOTE_CONTENT_HASH_SIZE,
+                                                             ENEX_IMPORTER_NOTE_CONTENT_HASH_SIZE)))
+    }
+
+    QNDEBUG(QStringLiteral("Loaded ") << m_importedNoteContentHashes.size()
+            << QStringLiteral(" content hashes of imported notes"));
+}
+
+void EnexImporter::saveNewImportedNoteContentHashes()
+{
+    if (m_newImportedNoteContentHashes.isEmpty()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("EnexImporter::saveNewImportedNoteContentHashes: ")
+            << m_newImportedNoteContentHashes.size());
+
+    QString filePath = importedNoteContentHashesFilePath();
+    QDir dir = QFileInfo(filePath).absoluteDir();
+    if (!dir.exists() && Q_UNLIKELY(!dir.mkpath(dir.absolutePath()))) {
+        QNWARNING(QStringLiteral("Can't create the directory for the content hashes of imported notes: ")
+                  << dir.absolutePath());
+        return;
+    }
+
+    QFile file(filePath);
+    if (Q_UNLIKELY(!file.open(QIODevice::WriteOnly | QIODevice::Append))) {
+        QNWARNING(QStringLiteral("Can't open the file with content hashes of imported notes for writing: ")
+                  << file.errorString());
+        return;
+    }
+
+    for(auto it = m_newImportedNoteContentHashes.constBegin(),
+        end = m_newImportedNoteContentHashes.constEnd(); it != end; ++it)
+    {
+        const QByteArray & hash = *it;
+        if (Q_UNLIKELY(hash.size() != ENEX_IMPORTER_NOTE_CONTENT_HASH_SIZE)) {
+            continue;
+        }
+
+        Q_UNUSED(file.write(hash))
+    }
+
+    m_newImportedNoteContentHashes.clear();
+}
+
+void EnexImporter::reportImportProgress()
+{
+    qint64 elapsedMsec = m_importTimer.elapsed();
+    double notesPerSecond = 0.0;
+    if (elapsedMsec > 0) {
+        notesPerSecond = static_cast<double>(m_numImportedNotes) * 1000.0 / static_cast<double>(elapsedMsec);
+    }
+
+    QNINFO(QStringLiteral("Imported ") << m_numImportedNotes << QStringLiteral(" notes from ENEX file ")
+           << m_enexFilePath << QStringLiteral(" in ") << elapsedMsec << QStringLiteral(" msec, ")
+           << notesPerSecond << QStringLiteral(" notes per second"));
+
+    Q_EMIT enexImportProgress(m_numImportedNotes, notesPerSecond);
+}
+
 void EnexImporter::connectToLocalStorage()
 {
     QNDEBUG(QStringLiteral("EnexImporter::connectToLocalStorage"));
@@ -632,13 +1410,8 @@ void EnexImporter::addNoteToLocalStorage(const Note & note)
 {
     QNDEBUG(QStringLiteral("EnexImporter::addNoteToLocalStorage"));
 
-    connectToLocalStorage();
-
-    QUuid requestId = QUuid::createUuid();
-    Q_UNUSED(m_addNoteRequestIds.insert(requestId));
-    QNTRACE(QStringLiteral("Emitting the request to add note to local storage: request id = ")
-            << requestId << QStringLiteral(", note: ") << note);
-    Q_EMIT addNote(note, requestId);
+    m_notesPendingAddition << note;
+    sendNotesPendingAddition();
 }
 
 void EnexImporter::addTagToLocalStorage(const QString & tagName)
@@ -647,6 +1420,14 @@ void EnexImporter::addTagToLocalStorage(const QString & tagName)
 
     connectToLocalStorage();
 
+    if (!m_pItemsCreator.isNull()) {
+        // The request id only marks the tag name as the pending one, the outcome comes from the items creator
+        Q_UNUSED(m_addTagRequestIdByTagNameBimap.insert(AddTagRequestIdByTagNameBimap::value_type(tagName.toLower(),
+                                                                                                  QUuid::createUuid())))
+        m_pItemsCreator->requestTag(tagName);
+        return;
+    }
+
     Tag newTag;
     newTag.setName(tagName);
 
@@ -664,6 +1445,12 @@ void EnexImporter::addNotebookToLocalStorage(const QString & notebookName)
 
     connectToLocalStorage();
 
+    if (!m_pItemsCreator.isNull()) {
+        m_addNotebookRequestId = QUuid::createUuid();
+        m_pItemsCreator->requestNotebook(notebookName);
+        return;
+    }
+
     Notebook newNotebook;
     newNotebook.setName(notebookName);
 
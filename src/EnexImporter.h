@@ -6,9 +6,18 @@
 #include <quentier/types/Note.h>
 #include <quentier/types/Tag.h>
 #include <quentier/types/Notebook.h>
+#include <quentier/types/Account.h>
 #include <QObject>
 #include <QUuid>
 #include <QHash>
+#include <QSharedPointer>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QSet>
+#include <QByteArray>
+#include <QPointer>
 
 // NOTE: Workaround a bug in Qt4 which may prevent building with some boost versions
 #ifndef Q_MOC_RUN
@@ -20,12 +29,31 @@ namespace quentier {
 QT_FORWARD_DECLARE_CLASS(LocalStorageManagerAsync)
 QT_FORWARD_DECLARE_CLASS(TagModel)
 QT_FORWARD_DECLARE_CLASS(NotebookModel)
+QT_FORWARD_DECLARE_CLASS(EnexImportItemsCreator)
 
+/**
+ * @brief The EnexImporter class imports the notes from ENEX file into the local storage
+ *
+ * The import is resumable: the number of notes from the start of the file added to the local storage is saved
+ * as a checkpoint within the account's settings every few added notes so the interrupted import of the same file
+ * into the same notebook continues from that point; the checkpoint is removed once the import is complete.
+ *
+ * The content hashes of all notes ever imported into the notebook are kept within the account's persistent storage
+ * as the index keyed by the notebook's local uid, regardless of the file they came from; the index is consulted
+ * on every import so that neither the notes past the checkpoint added before the interruption nor the notes
+ * imported before from this or another file are imported into the same notebook again
+ *
+ * The memory taken by the notes being imported is bounded by their size rather than by their number:
+ * the notes read from the ENEX file but not yet added to the local storage (being decoded, waiting for the preceding
+ * notes, waiting for tags or for the pending add note requests) take at most 32 megabytes of ENEX in total,
+ * see EnexFileReaderAsync for how the notes are weighted
+ */
 class EnexImporter: public QObject
 {
     Q_OBJECT
 public:
     explicit EnexImporter(const QString & enexFilePath, const QString & notebookName,
+                          const Account & account,
                           LocalStorageManagerAsync & localStorageManagerAsync,
                           TagModel & tagModel, NotebookModel & notebookModel,
                           QObject * parent = Q_NULLPTR);
@@ -33,11 +61,42 @@ public:
     bool isInProgress() const;
     void start();
 
+    /**
+     * The maximum number of add note requests sent to the local storage at once: the next note is sent as soon
+     * as one of the previous ones has been added; this is not a bulk insert, the local storage handles the requests
+     * one by one and commits each note within its own transaction, with its own completion signal; the checkpoint
+     * is saved and the progress is reported once per this number of added notes
+     */
+    int maxPendingAddNoteRequests() const { return m_maxPendingAddNoteRequests; }
+    void setMaxPendingAddNoteRequests(const int maxPendingAddNoteRequests);
+
+    /**
+     * When several importers run concurrently, they should share the creation of tags and notebooks in order
+     * not to create several tags or notebooks with the same name; must be set before the start of the import
+     */
+    void setItemsCreator(EnexImportItemsCreator * pItemsCreator);
+
     void clear();
 
+    /**
+     * Stops the import: the ENEX file is no longer read and the notes not yet sent to the local storage are dropped
+     * while the add requests already sent to the local storage are still awaited so that the notes added by them
+     * make it into the checkpoint and the content hashes index; the canceled signal is emitted once none of them
+     * is left, right away if there are none, after which the importer can be deleted
+     */
+    void cancel();
+    bool hasPendingRequests() const;
+
 Q_SIGNALS:
     void enexImportedSuccessfully(QString enexFilePath);
     void enexImportFailed(ErrorString errorDescription);
+    void canceled();
+
+    /**
+     * The signal reporting the progress of the import, emitted every few added notes: the number
+     * of notes added to the local storage so far and the average import speed
+     */
+    void enexImportProgress(qint64 numImportedNotes, double notesPerSecond);
 
 // private signals:
     void addTag(Tag tag, QUuid requestId);
@@ -56,14 +115,53 @@ private Q_SLOTS:
     void onAddNoteComplete(Note note, QUuid requestId);
     void onAddNoteFailed(Note note, ErrorString errorDescription, QUuid requestId);
 
+    void onSharedTagAdded(Tag tag);
+    void onSharedTagAddFailed(QString tagName, ErrorString errorDescription);
+    void onSharedNotebookAdded(Notebook notebook);
+    void onSharedNotebookAddFailed(QString notebookName, ErrorString errorDescription);
+
     void onAllTagsListed();
     void onAllNotebooksListed();
 
+    void onEnexFileNotesSkipped(qint64 numSkippedNotes, QUuid requestId);
+    void onEnexFileNoteDecoded(Note note, QStringList tagNames, QByteArray noteContentHash,
+                               qint64 noteIndex, int noteWeight, QUuid requestId);
+    void onEnexFileNoteDecodingFailed(ErrorString errorDescription, QByteArray noteContentHash,
+                                      qint64 noteIndex, int noteWeight, QUuid requestId);
+    void onEnexFileReadFinished(qint64 numNotesRead, QUuid requestId);
+    void onEnexFileReadFailed(ErrorString errorDescription, QUuid requestId);
+
 private:
     void connectToLocalStorage();
     void disconnectFromLocalStorage();
 
+    void startReadingEnexFile();
+    void cancelReadingEnexFile();
+    void checkImportCompletion();
+    struct DecodedNote;
+    void enqueueDecodedNote(DecodedNote & decodedNote, const qint64 noteIndex);
+    void processDecodedNote(DecodedNote & decodedNote, const qint64 noteIndex);
+    void reportImportProgress();
+    void sendNotesPendingAddition();
+    void onAddNoteRequestFinished(const int noteWeight);
+    void checkCancelationCompletion();
+    void releasePendingNoteWeight(const int noteWeight);
+
+    void markNoteCommitted(const qint64 noteIndex, const QByteArray & noteContentHash);
+    QString importKey() const;
+
+    bool loadImportCheckpoint();
+    void saveImportCheckpoint();
+    void removeImportCheckpoint();
+    QString importCheckpointSettingsGroupName() const;
+
+    QString importedNoteContentHashesFilePath() const;
+    void loadImportedNoteContentHashes();
+    void saveNewImportedNoteContentHashes();
+
     void processNotesPendingTagAddition();
+    void processAddedTag(const Tag & tag);
+    void processAddedNotebook(const Notebook & notebook);
 
     void addNoteToLocalStorage(const Note & note);
     void addTagToLocalStorage(const QString & tagName);
@@ -74,9 +172,12 @@ private:
     TagModel &                              m_tagModel;
     NotebookModel &                         m_notebookModel;
     QString                                 m_enexFilePath;
+    Account                                 m_account;
     QString                                 m_notebookName;
     QString                                 m_notebookLocalUid;
 
+    QPointer<EnexImportItemsCreator>        m_pItemsCreator;
+
     QHash<QString, QStringList>             m_tagNamesByImportedNoteLocalUid;
 
     typedef boost::bimap<QString, QUuid> AddTagRequestIdByTagNameBimap;
@@ -89,8 +190,71 @@ private:
     QVector<Note>                           m_notesPendingTagAddition;
     QSet<QUuid>                             m_addNoteRequestIds;
 
+    // The ENEX file is read by EnexFileReaderAsync note by note; the total weight (roughly the size in kilobytes)
+    // of the notes read but not yet added to the local storage is limited by the semaphore shared with the reader
+    QUuid                                   m_readEnexFileRequestId;
+    QSharedPointer<QSemaphore>              m_pPendingNotesSemaphore;
+    QSharedPointer<QAtomicInt>              m_pReadEnexFileCanceled;
+
+    // The notes are decoded in parallel so they may come out of order; the notes decoded ahead of
+    // the next one in the original order wait here in order to be added to the local storage in the original order;
+    // the notes which failed to be decoded keep their place in the order along with the error
+    struct DecodedNote
+    {
+        DecodedNote() : m_note(), m_tagNames(), m_contentHash(), m_weight(0), m_decodingFailed(false), m_errorDescription() {}
+
+        Note        m_note;
+        QStringList m_tagNames;
+        QByteArray  m_contentHash;
+        int         m_weight;
+        bool        m_decodingFailed;
+        ErrorString m_errorDescription;
+    };
+
+    QMap<qint64, DecodedNote>               m_decodedNotesByIndex;
+    qint64                                  m_nextDecodedNoteIndex;
+
+    // -1 until the reader reports the number of notes within the ENEX file
+    qint64                                  m_numEnexFileNotes;
+
+    QElapsedTimer                           m_importTimer;
+    qint64                                  m_numImportedNotes;
+
+    // The notes ready to be added to the local storage once the number of pending add note requests allows that
+    QVector<Note>                           m_notesPendingAddition;
+    int                                     m_maxPendingAddNoteRequests;
+    int                                     m_numFinishedAddNoteRequestsSinceCheckpoint;
+
+    // The failure to decode some note or to add it to the local storage doesn't stop the import of others,
+    // the failures are reported at the end
+    qint64                                  m_numFailedNotes;
+    ErrorString                             m_lastFailedNoteErrorDescription;
+
+    // The resume checkpoint: the number of notes from the start of the file which have been either added
+    // to the local storage or skipped as the already imported ones and the content hash of the last such note
+    qint64                                  m_numCheckpointNotes;
+    QByteArray                              m_lastCheckpointNoteContentHash;
+
+    // The notes are committed out of order when some of them wait for tags addition
+    QMap<qint64, QByteArray>                m_committedNoteContentHashesAheadByIndex;
+
+    struct ImportedNoteInfo
+    {
+        qint64      m_index;
+        QByteArray  m_contentHash;
+        int         m_weight;
+    };
+
+    QHash<QString, ImportedNoteInfo>        m_importedNoteInfoByLocalUid;
+
+    // The content hashes of the notes added to the target notebook by all the previous imports and by the current one
+    QSet<QByteArray>                        m_importedNoteContentHashes;
+    QVector<QByteArray>                     m_newImportedNoteContentHashes;
+    qint64                                  m_numSkippedAlreadyImportedNotes;
+
     bool                                    m_pendingNotebookModelToStart;
     bool                                    m_connectedToLocalStorage;
+    bool                                    m_canceled;
 };
 
 } // namespace quentier
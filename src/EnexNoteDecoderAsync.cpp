@@ -0,0 +1,70 @@
+#include "EnexNoteDecoderAsync.h"
+#include "CancellationFlag.h"
+#include <quentier/enml/ENMLConverter.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QVector>
+#include <QHash>
+
+namespace quentier {
+
+EnexNoteDecoderAsync::EnexNoteDecoderAsync(const QString & noteEnex, const QByteArray & noteContentHash,
+                                           const qint64 noteIndex, const int noteWeight,
+                                           const QUuid & requestId,
+                                           const QSharedPointer<QAtomicInt> & pCanceled,
+                                           const QSharedPointer<QSemaphore> & pFinishedDecodersSemaphore,
+                                           QObject * parent) :
+    QObject(parent),
+    QRunnable(),
+    m_noteEnex(noteEnex),
+    m_noteContentHash(noteContentHash),
+    m_noteIndex(noteIndex),
+    m_noteWeight(noteWeight),
+    m_requestId(requestId),
+    m_pCanceled(pCanceled),
+    m_pFinishedDecodersSemaphore(pFinishedDecodersSemaphore)
+{}
+
+void EnexNoteDecoderAsync::run()
+{
+    decodeNote();
+    m_pFinishedDecodersSemaphore->release();
+}
+
+void EnexNoteDecoderAsync::decodeNote()
+{
+    if (isCanceled(*m_pCanceled)) {
+        return;
+    }
+
+    QVector<Note> notes;
+    QHash<QString, QStringList> tagNamesByNoteLocalUid;
+    ErrorString errorDescription;
+
+    ENMLConverter converter;
+    bool res = converter.importEnex(m_noteEnex, notes, tagNamesByNoteLocalUid, errorDescription);
+
+    // The note's ENEX is no longer needed, free the memory right away
+    m_noteEnex.clear();
+
+    if (!res) {
+        QNWARNING(QStringLiteral("Failed to decode the note ") << m_noteIndex
+                  << QStringLiteral(" from ENEX: ") << errorDescription);
+        Q_EMIT noteDecodingFailed(errorDescription, m_noteContentHash, m_noteIndex, m_noteWeight, m_requestId);
+        return;
+    }
+
+    if (Q_UNLIKELY(notes.size() != 1)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't import ENEX: internal error, unexpected number of notes "
+                                            "converted from a single note element"));
+        errorDescription.details() = QString::number(notes.size());
+        QNWARNING(errorDescription);
+        Q_EMIT noteDecodingFailed(errorDescription, m_noteContentHash, m_noteIndex, m_noteWeight, m_requestId);
+        return;
+    }
+
+    const Note & note = notes.at(0);
+    Q_EMIT noteDecoded(note, tagNamesByNoteLocalUid.value(note.localUid()), m_noteContentHash,
+                       m_noteIndex, m_noteWeight, m_requestId);
+}
+
+} // namespace quentier
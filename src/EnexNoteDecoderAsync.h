@@ -0,0 +1,63 @@
+#ifndef QUENTIER_ENEX_NOTE_DECODER_ASYNC_H
+#define QUENTIER_ENEX_NOTE_DECODER_ASYNC_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Note.h>
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QUuid>
+
+namespace quentier {
+
+/**
+ * @brief The EnexNoteDecoderAsync class converts a single note ENEX document into a note: it parses the note's
+ * ENML and decodes its resources' data; several decoders can run in parallel, the index of the note within
+ * the ENEX file allows the consumer of decoded notes to restore their original order
+ *
+ * The note which can't be decoded is reported via noteDecodingFailed signal so that the rest of the file
+ * can still be imported; the decoder releases one resource of the finished decoders semaphore once it is done
+ * so that the one starting the decoders can wait for them. The weight of the note is passed on with the decoded note
+ * as is, see EnexFileReaderAsync
+ */
+class EnexNoteDecoderAsync: public QObject,
+                            public QRunnable
+{
+    Q_OBJECT
+public:
+    explicit EnexNoteDecoderAsync(const QString & noteEnex, const QByteArray & noteContentHash,
+                                  const qint64 noteIndex, const int noteWeight, const QUuid & requestId,
+                                  const QSharedPointer<QAtomicInt> & pCanceled,
+                                  const QSharedPointer<QSemaphore> & pFinishedDecodersSemaphore,
+                                  QObject * parent = Q_NULLPTR);
+
+Q_SIGNALS:
+    void noteDecoded(Note note, QStringList tagNames, QByteArray noteContentHash, qint64 noteIndex,
+                     int noteWeight, QUuid requestId);
+    void noteDecodingFailed(ErrorString errorDescription, QByteArray noteContentHash, qint64 noteIndex,
+                            int noteWeight, QUuid requestId);
+
+private:
+    virtual void run() Q_DECL_OVERRIDE;
+
+    void decodeNote();
+
+private:
+    QString                     m_noteEnex;
+    QByteArray                  m_noteContentHash;
+    qint64                      m_noteIndex;
+    int                         m_noteWeight;
+    QUuid                       m_requestId;
+    QSharedPointer<QAtomicInt>  m_pCanceled;
+    QSharedPointer<QSemaphore>  m_pFinishedDecodersSemaphore;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_ENEX_NOTE_DECODER_ASYNC_H
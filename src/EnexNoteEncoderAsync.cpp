@@ -0,0 +1,80 @@
+#include "EnexNoteEncoderAsync.h"
+#include "CancellationFlag.h"
+#include <quentier/enml/ENMLConverter.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QVector>
+
+#define QUENTIER_ENEX_VERSION QStringLiteral("Quentier")
+
+namespace quentier {
+
+EnexNoteEncoderAsync::EnexNoteEncoderAsync(const Note & note, const QHash<QString, QString> & tagNameByTagLocalUid,
+                                           const bool includeTags, const int noteIndex, const QUuid & requestId,
+                                           const QSharedPointer<QAtomicInt> & pCanceled,
+                                           QObject * parent) :
+    QObject(parent),
+    QRunnable(),
+    m_note(note),
+    m_tagNameByTagLocalUid(tagNameByTagLocalUid),
+    m_includeTags(includeTags),
+    m_noteIndex(noteIndex),
+    m_requestId(requestId),
+    m_pCanceled(pCanceled)
+{}
+
+void EnexNoteEncoderAsync::run()
+{
+    if (isCanceled(*m_pCanceled)) {
+        return;
+    }
+
+    QVector<Note> notes;
+    notes << m_note;
+
+    // The note is no longer needed, free the memory taken by its resources' data right away
+    m_note = Note();
+
+    QString enex;
+    ErrorString errorDescription;
+    ENMLConverter converter;
+    ENMLConverter::EnexExportTags::type exportTagsOption = (m_includeTags
+                                                            ? ENMLConverter::EnexExportTags::Yes
+                                                            : ENMLConverter::EnexExportTags::No);
+    bool res = converter.exportNotesToEnex(notes, m_tagNameByTagLocalUid, exportTagsOption,
+                                           enex, errorDescription, QUENTIER_ENEX_VERSION);
+    notes.clear();
+
+    if (!res) {
+        QNWARNING(QStringLiteral("Failed to encode the note ") << m_noteIndex
+                  << QStringLiteral(" to ENEX: ") << errorDescription);
+        Q_EMIT failed(errorDescription, m_requestId);
+        return;
+    }
+
+    // The ENEX document is converted to UTF-8 only once, the QString is released right away
+    QByteArray noteEnex = enex.toUtf8();
+    enex.clear();
+
+    // The ENEX document with the single note is split into the note element and the parts surrounding it;
+    // the latter are the same for all notes. The note element is cut out in place, without copying it
+    int enExportIndex = noteEnex.indexOf("<en-export");
+    int noteStartIndex = ((enExportIndex < 0) ? -1 : noteEnex.indexOf("<note", enExportIndex));
+    int noteEndIndex = noteEnex.lastIndexOf("</en-export>");
+    if (Q_UNLIKELY((noteStartIndex < 0) || (noteEndIndex < noteStartIndex))) {
+        errorDescription.setBase(QT_TR_NOOP("Can't export notes to ENEX: internal error, "
+                                            "unexpected structure of the note's ENEX"));
+        errorDescription.details() = QString::number(m_noteIndex);
+        QNWARNING(errorDescription);
+        Q_EMIT failed(errorDescription, m_requestId);
+        return;
+    }
+
+    QByteArray enexHeader = noteEnex.left(noteStartIndex);
+    QByteArray enexFooter = noteEnex.mid(noteEndIndex);
+    noteEnex.truncate(noteEndIndex);
+    noteEnex.remove(0, noteStartIndex);
+
+    Q_EMIT noteEncoded(noteEnex, enexHeader, enexFooter, m_noteIndex, m_requestId);
+}
+
+} // namespace quentier
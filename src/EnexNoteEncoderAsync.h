@@ -0,0 +1,54 @@
+#ifndef QUENTIER_ENEX_NOTE_ENCODER_ASYNC_H
+#define QUENTIER_ENEX_NOTE_ENCODER_ASYNC_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Note.h>
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <QHash>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QUuid>
+
+namespace quentier {
+
+/**
+ * @brief The EnexNoteEncoderAsync class converts a single note into the UTF-8 encoded ENEX note element: it converts
+ * the note's ENML and encodes its resources' data; several encoders can run in parallel, the index of the note
+ * allows the consumer of encoded notes to write them in the original order
+ *
+ * Along with the note element the encoder provides the parts of ENEX document preceding and following the notes
+ */
+class EnexNoteEncoderAsync: public QObject,
+                            public QRunnable
+{
+    Q_OBJECT
+public:
+    explicit EnexNoteEncoderAsync(const Note & note, const QHash<QString, QString> & tagNameByTagLocalUid,
+                                  const bool includeTags, const int noteIndex, const QUuid & requestId,
+                                  const QSharedPointer<QAtomicInt> & pCanceled,
+                                  QObject * parent = Q_NULLPTR);
+
+Q_SIGNALS:
+    void noteEncoded(QByteArray noteEnex, QByteArray enexHeader, QByteArray enexFooter,
+                     int noteIndex, QUuid requestId);
+    void failed(ErrorString errorDescription, QUuid requestId);
+
+private:
+    virtual void run() Q_DECL_OVERRIDE;
+
+private:
+    Note                        m_note;
+    QHash<QString, QString>     m_tagNameByTagLocalUid;
+    bool                        m_includeTags;
+    int                         m_noteIndex;
+    QUuid                       m_requestId;
+    QSharedPointer<QAtomicInt>  m_pCanceled;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_ENEX_NOTE_ENCODER_ASYNC_H
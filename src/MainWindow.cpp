@@ -19,13 +19,13 @@
 #include "MainWindow.h"
 #include "SettingsNames.h"
 #include "DefaultSettings.h"
-#include "AsyncFileWriter.h"
 #include "SystemTrayIconManager.h"
 #include "ActionsInfo.h"
 #include "EditNoteDialogsManager.h"
 #include "NoteFiltersManager.h"
 #include "EnexExporter.h"
-#include "EnexImporter.h"
+#include "NotePdfExporter.h"
+#include "EnexImportManager.h"
 #include "NetworkProxySettingsHelpers.h"
 #include "models/NoteFilterModel.h"
 #include "color-picker-tool-button/ColorPickerToolButton.h"
@@ -117,6 +117,8 @@ using quentier::LogViewerWidget;
 #include <QMenu>
 #include <QThreadPool>
 #include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QClipboard>
 #include <cmath>
 #include <algorithm>
@@ -146,6 +148,9 @@ using quentier::LogViewerWidget;
 #define PERSIST_GEOMETRY_AND_STATE_DELAY (500)
 #define RESTORE_SPLITTER_SIZES_DELAY (200)
 
+// The number of notes above and below the current one in the note list which are prefetched into the note cache
+#define NUM_NEIGHBOUR_NOTES_TO_PREFETCH (2)
+
 using namespace quentier;
 
 MainWindow::MainWindow(QWidget * pParentWidget) :
@@ -203,6 +208,12 @@ MainWindow::MainWindow(QWidget * pParentWidget) :
     m_defaultAccountFirstNoteLocalUid(),
     m_pNoteEditorTabsAndWindowsCoordinator(Q_NULLPTR),
     m_pEditNoteDialogsManager(Q_NULLPTR),
+    m_pNotesPdfExporter(),
+    m_pCancelExportNotesToPdfButton(Q_NULLPTR),
+    m_localUidsOfNotesRenderingToPdf(),
+    m_pCancelRenderingNotesToPdfButton(Q_NULLPTR),
+    m_pNotesEnexExporter(),
+    m_pCancelExportNotesToEnexButton(Q_NULLPTR),
     m_pUndoStack(new QUndoStack(this)),
     m_noteSearchQueryValidated(false),
     m_styleSheetInfo(),
@@ -1746,8 +1757,8 @@ void MainWindow::onImportEnexAction()
 
     ErrorString errorDescription;
 
-    QString enexFilePath = pEnexImportDialog->importEnexFilePath(&errorDescription);
-    if (enexFilePath.isEmpty())
+    QStringList enexFilePaths = pEnexImportDialog->importEnexFilePaths(&errorDescription);
+    if (enexFilePaths.isEmpty())
     {
         if (errorDescription.isEmpty()) {
             errorDescription.setBase(QT_TR_NOOP("Can't import ENEX: internal error, can't retrieve ENEX file path"));
@@ -1770,13 +1781,13 @@ void MainWindow::onImportEnexAction()
         return;
     }
 
-    EnexImporter * pImporter = new EnexImporter(enexFilePath, notebookName, *m_pLocalStorageManagerAsync,
-                                                *m_pTagModel, *m_pNotebookModel, this);
-    QObject::connect(pImporter, QNSIGNAL(EnexImporter,enexImportedSuccessfully,QString),
-                     this, QNSLOT(MainWindow,onEnexImportCompletedSuccessfully,QString));
-    QObject::connect(pImporter, QNSIGNAL(EnexImporter,enexImportFailed,ErrorString),
-                     this, QNSLOT(MainWindow,onEnexImportFailed,ErrorString));
-    pImporter->start();
+    EnexImportManager * pImportManager = new EnexImportManager(*m_pAccount, *m_pLocalStorageManagerAsync,
+                                                               *m_pTagModel, *m_pNotebookModel, this);
+    QObject::connect(pImportManager, QNSIGNAL(EnexImportManager,enexImportFinished,int,int,ErrorString),
+                     this, QNSLOT(MainWindow,onEnexImportFinished,int,int,ErrorString));
+    QObject::connect(pImportManager, QNSIGNAL(EnexImportManager,enexImportProgress,int,int,qint64,double),
+                     this, QNSLOT(MainWindow,onEnexImportProgress,int,int,qint64,double));
+    pImportManager->import(enexFilePaths, notebookName);
 }
 
 void MainWindow::onSynchronizationStarted()
@@ -2456,6 +2467,10 @@ void MainWindow::onCurrentNoteInListChanged(QString noteLocalUid)
 {
     QNDEBUG(QStringLiteral("MainWindow::onCurrentNoteInListChanged: ") << noteLocalUid);
     m_pNoteEditorTabsAndWindowsCoordinator->addNote(noteLocalUid);
+
+    // The notes next to the current one are the likely candidates to be opened next
+    QStringList neighbourNoteLocalUids = m_pUI->noteListView->neighbourNotesLocalUids(NUM_NEIGHBOUR_NOTES_TO_PREFETCH);
+    m_pNoteEditorTabsAndWindowsCoordinator->prefetchNotes(neighbourNoteLocalUids);
 }
 
 void MainWindow::onOpenNoteInSeparateWindow(QString noteLocalUid)
@@ -2630,52 +2645,64 @@ void MainWindow::onExportNotesToEnexRequested(QStringList noteLocalUids)
         }
     }
 
-    EnexExporter * pExporter = new EnexExporter(*m_pLocalStorageManagerAsync,
-                                                *m_pNoteEditorTabsAndWindowsCoordinator,
-                                                *m_pTagModel, this);
-    pExporter->setTargetEnexFilePath(enexFilePath);
-    pExporter->setIncludeTags(pExportEnexDialog->exportTags());
-    pExporter->setNoteLocalUids(noteLocalUids);
+    if (!m_pNotesEnexExporter.isNull()) {
+        QNDEBUG(QStringLiteral("Canceling the previous export of notes to ENEX"));
+        m_pNotesEnexExporter->cancel();
+        m_pNotesEnexExporter->clear();
+        m_pNotesEnexExporter->deleteLater();
+        m_pNotesEnexExporter.clear();
+    }
 
-    QObject::connect(pExporter, QNSIGNAL(EnexExporter,notesExportedToEnex,QString),
+    m_pNotesEnexExporter = new EnexExporter(*m_pLocalStorageManagerAsync,
+                                            m_pNoteEditorTabsAndWindowsCoordinator,
+                                            *m_pTagModel, this);
+    m_pNotesEnexExporter->setTargetEnexFilePath(enexFilePath);
+    m_pNotesEnexExporter->setIncludeTags(pExportEnexDialog->exportTags());
+    m_pNotesEnexExporter->setNoteLocalUids(noteLocalUids);
+
+    QObject::connect(m_pNotesEnexExporter.data(), QNSIGNAL(EnexExporter,notesExportedToEnex,QString),
                      this, QNSLOT(MainWindow,onExportedNotesToEnex,QString));
-    QObject::connect(pExporter, QNSIGNAL(EnexExporter,failedToExportNotesToEnex,ErrorString),
+    QObject::connect(m_pNotesEnexExporter.data(), QNSIGNAL(EnexExporter,failedToExportNotesToEnex,ErrorString),
                      this, QNSLOT(MainWindow,onExportNotesToEnexFailed,ErrorString));
-    pExporter->start();
+    QObject::connect(m_pNotesEnexExporter.data(), QNSIGNAL(EnexExporter,notesExportToEnexProgress,int,int),
+                     this, QNSLOT(MainWindow,onExportNotesToEnexProgress,int,int));
+
+    if (!m_pCancelExportNotesToEnexButton) {
+        m_pCancelExportNotesToEnexButton = new QPushButton(tr("Cancel ENEX export"), this);
+        QObject::connect(m_pCancelExportNotesToEnexButton, QNSIGNAL(QPushButton,clicked),
+                         this, QNSLOT(MainWindow,onCancelExportNotesToEnex));
+        m_pUI->statusBar->addPermanentWidget(m_pCancelExportNotesToEnexButton);
+    }
+
+    m_pCancelExportNotesToEnexButton->show();
+    m_pNotesEnexExporter->start();
 }
 
-void MainWindow::onExportedNotesToEnex(QString enex)
+void MainWindow::onExportedNotesToEnex(QString enexFilePath)
 {
-    QNDEBUG(QStringLiteral("MainWindow::onExportedNotesToEnex"));
+    QNDEBUG(QStringLiteral("MainWindow::onExportedNotesToEnex: ") << enexFilePath);
+
+    onSetStatusBarText(tr("Successfully exported note(s) to ENEX: ") + QDir::toNativeSeparators(enexFilePath),
+                       SEC_TO_MSEC(5));
 
     EnexExporter * pExporter = qobject_cast<EnexExporter*>(sender());
-    if (Q_UNLIKELY(!pExporter)) {
-        ErrorString error(QT_TR_NOOP("Can't export notes to ENEX: internal error, "
-                                     "can't cast the slot invoker to EnexExporter"));
-        QNWARNING(error);
-        onSetStatusBarText(error.localizedString(), SEC_TO_MSEC(30));
-        return;
+    if (pExporter) {
+        pExporter->clear();
+        pExporter->deleteLater();
     }
 
-    QString enexFilePath = pExporter->targetEnexFilePath();
-    if (Q_UNLIKELY(enexFilePath.isEmpty())) {
-        ErrorString error(QT_TR_NOOP("Can't export notes to ENEX: internal error, "
-                                     "the selected ENEX file path was lost"));
-        QNWARNING(error);
-        onSetStatusBarText(error.localizedString(), SEC_TO_MSEC(30));
-        return;
+    if (m_pCancelExportNotesToEnexButton) {
+        m_pCancelExportNotesToEnexButton->hide();
     }
+}
 
-    QByteArray enexRawData = enex.toUtf8();
+void MainWindow::onExportNotesToEnexProgress(int numExportedNotes, int numNotes)
+{
+    QNTRACE(QStringLiteral("MainWindow::onExportNotesToEnexProgress: ") << numExportedNotes
+            << QStringLiteral(" of ") << numNotes);
 
-    AsyncFileWriter * pAsyncFileWriter = new AsyncFileWriter(enexFilePath, enexRawData);
-    QObject::connect(pAsyncFileWriter, QNSIGNAL(AsyncFileWriter,fileSuccessfullyWritten,QString),
-                     this, QNSLOT(MainWindow,onEnexFileWrittenSuccessfully,QString));
-    QObject::connect(pAsyncFileWriter, QNSIGNAL(AsyncFileWriter,fileWriteFailed,ErrorString),
-                     this, QNSLOT(MainWindow,onEnexFileWriteFailed));
-    QObject::connect(pAsyncFileWriter, QNSIGNAL(AsyncFileWriter,fileWriteIncomplete,qint64,qint64),
-                     this, QNSLOT(MainWindow,onEnexFileWriteIncomplete,qint64,qint64));
-    QThreadPool::globalInstance()->start(pAsyncFileWriter);
+    onSetStatusBarText(tr("Exporting notes to ENEX") + QStringLiteral(": ") + QString::number(numExportedNotes) +
+                       QStringLiteral("/") + QString::number(numNotes), SEC_TO_MSEC(5));
 }
 
 void MainWindow::onExportNotesToEnexFailed(ErrorString errorDescription)
@@ -2688,65 +2715,292 @@ void MainWindow::onExportNotesToEnexFailed(ErrorString errorDescription)
         pExporter->deleteLater();
     }
 
+    if (m_pCancelExportNotesToEnexButton) {
+        m_pCancelExportNotesToEnexButton->hide();
+    }
+
+    onSetStatusBarText(errorDescription.localizedString(), SEC_TO_MSEC(30));
+}
+
+void MainWindow::onCancelExportNotesToEnex()
+{
+    QNDEBUG(QStringLiteral("MainWindow::onCancelExportNotesToEnex"));
+
+    if (m_pCancelExportNotesToEnexButton) {
+        m_pCancelExportNotesToEnexButton->hide();
+    }
+
+    if (m_pNotesEnexExporter.isNull()) {
+        return;
+    }
+
+    // NOTE: that also removes the partially written ENEX file
+    m_pNotesEnexExporter->cancel();
+    m_pNotesEnexExporter->clear();
+    m_pNotesEnexExporter->deleteLater();
+    m_pNotesEnexExporter.clear();
+
+    onSetStatusBarText(tr("The export of notes to ENEX has been canceled"), SEC_TO_MSEC(5));
+}
+
+void MainWindow::onExportNotesToPdfRequested(QStringList noteLocalUids)
+{
+    QNDEBUG(QStringLiteral("MainWindow::onExportNotesToPdfRequested: ")
+            << noteLocalUids.join(QStringLiteral(", ")));
+
+    if (Q_UNLIKELY(noteLocalUids.isEmpty())) {
+        QNDEBUG(QStringLiteral("The list of note local uids to export is empty"));
+        return;
+    }
+
+    if (Q_UNLIKELY(!m_pAccount)) {
+        QNDEBUG(QStringLiteral("No current account, skipping"));
+        return;
+    }
+
+    if (Q_UNLIKELY(!m_pLocalStorageManagerAsync)) {
+        QNDEBUG(QStringLiteral("No local storage manager, skipping"));
+        return;
+    }
+
+    ApplicationSettings appSettings(*m_pAccount, QUENTIER_UI_SETTINGS);
+    appSettings.beginGroup(NOTE_EDITOR_SETTINGS_GROUP_NAME);
+    QString lastExportNoteToPdfPath = appSettings.value(LAST_EXPORT_NOTE_TO_PDF_PATH_SETTINGS_KEY).toString();
+    appSettings.endGroup();
+
+    if (lastExportNoteToPdfPath.isEmpty()) {
+        lastExportNoteToPdfPath = documentsPath();
+    }
+
+    QScopedPointer<QFileDialog> pFileDialog(new QFileDialog(this, tr("Please select the folder to export notes into"),
+                                                            lastExportNoteToPdfPath));
+    pFileDialog->setWindowModality(Qt::WindowModal);
+    pFileDialog->setFileMode(QFileDialog::Directory);
+    pFileDialog->setOption(QFileDialog::ShowDirsOnly, true);
+    if (pFileDialog->exec() != QDialog::Accepted) {
+        QNDEBUG(QStringLiteral("Pdf export was not confirmed"));
+        return;
+    }
+
+    QStringList selectedDirs = pFileDialog->selectedFiles();
+    if (selectedDirs.isEmpty()) {
+        QNDEBUG(QStringLiteral("No folder was selected for pdf export"));
+        return;
+    }
+
+    QString targetDirPath = selectedDirs.at(0);
+    QFileInfo targetDirInfo(targetDirPath);
+    if (!targetDirInfo.isDir() || !targetDirInfo.isWritable()) {
+        QNINFO(QStringLiteral("Chosen pdf export folder is not writable: ") << targetDirPath);
+        onSetStatusBarText(tr("The folder selected for pdf export is not writable") +
+                           QStringLiteral(": ") + targetDirPath, SEC_TO_MSEC(30));
+        return;
+    }
+
+    appSettings.beginGroup(NOTE_EDITOR_SETTINGS_GROUP_NAME);
+    appSettings.setValue(LAST_EXPORT_NOTE_TO_PDF_PATH_SETTINGS_KEY, targetDirInfo.absoluteFilePath());
+    appSettings.endGroup();
+
+    if (!m_pNotesPdfExporter.isNull()) {
+        QNDEBUG(QStringLiteral("Canceling the previous export of notes to pdf"));
+        m_pNotesPdfExporter->cancel();
+        m_pNotesPdfExporter->clear();
+        m_pNotesPdfExporter->deleteLater();
+        m_pNotesPdfExporter.clear();
+    }
+
+    m_pNotesPdfExporter = new NotePdfExporter(*m_pLocalStorageManagerAsync,
+                                              m_pNoteEditorTabsAndWindowsCoordinator, this);
+    m_pNotesPdfExporter->setTargetDirPath(targetDirInfo.absoluteFilePath());
+    m_pNotesPdfExporter->setNoteLocalUids(noteLocalUids);
+
+    QObject::connect(m_pNotesPdfExporter.data(), QNSIGNAL(NotePdfExporter,notesExportedToPdf,QStringList),
+                     this, QNSLOT(MainWindow,onExportedNotesToPdf,QStringList));
+    QObject::connect(m_pNotesPdfExporter.data(), QNSIGNAL(NotePdfExporter,failedToExportNotesToPdf,ErrorString),
+                     this, QNSLOT(MainWindow,onExportNotesToPdfFailed,ErrorString));
+    QObject::connect(m_pNotesPdfExporter.data(), QNSIGNAL(NotePdfExporter,notesExportToPdfProgress,int,int),
+                     this, QNSLOT(MainWindow,onExportNotesToPdfProgress,int,int));
+
+    if (!m_pCancelExportNotesToPdfButton) {
+        m_pCancelExportNotesToPdfButton = new QPushButton(tr("Cancel pdf export"), this);
+        QObject::connect(m_pCancelExportNotesToPdfButton, QNSIGNAL(QPushButton,clicked),
+                         this, QNSLOT(MainWindow,onCancelExportNotesToPdf));
+        m_pUI->statusBar->addPermanentWidget(m_pCancelExportNotesToPdfButton);
+    }
+
+    m_pCancelExportNotesToPdfButton->show();
+    m_pNotesPdfExporter->start();
+}
+
+void MainWindow::onExportedNotesToPdf(QStringList pdfFilePaths)
+{
+    QNDEBUG(QStringLiteral("MainWindow::onExportedNotesToPdf: ") << pdfFilePaths.join(QStringLiteral(", ")));
+
+    QString targetDirPath;
+    NotePdfExporter * pExporter = qobject_cast<NotePdfExporter*>(sender());
+    if (pExporter) {
+        targetDirPath = pExporter->targetDirPath();
+        pExporter->clear();
+        pExporter->deleteLater();
+    }
+
+    if (m_pCancelExportNotesToPdfButton) {
+        m_pCancelExportNotesToPdfButton->hide();
+    }
+
+    onSetStatusBarText(tr("Successfully exported note(s) to pdf") + QStringLiteral(": ") +
+                       QString::number(pdfFilePaths.size()) + QStringLiteral(", ") +
+                       QDir::toNativeSeparators(targetDirPath), SEC_TO_MSEC(5));
+}
+
+void MainWindow::onExportNotesToPdfFailed(ErrorString errorDescription)
+{
+    QNDEBUG(QStringLiteral("MainWindow::onExportNotesToPdfFailed: ") << errorDescription);
+
+    NotePdfExporter * pExporter = qobject_cast<NotePdfExporter*>(sender());
+    if (pExporter) {
+        pExporter->clear();
+        pExporter->deleteLater();
+    }
+
+    if (m_pCancelExportNotesToPdfButton) {
+        m_pCancelExportNotesToPdfButton->hide();
+    }
+
     onSetStatusBarText(errorDescription.localizedString(), SEC_TO_MSEC(30));
 }
 
-void MainWindow::onEnexFileWrittenSuccessfully(QString filePath)
+void MainWindow::onExportNotesToPdfProgress(int numExportedNotes, int numNotes)
 {
-    QNDEBUG(QStringLiteral("MainWindow::onEnexFileWrittenSuccessfully: ") << filePath);
-    onSetStatusBarText(tr("Successfully exported note(s) to ENEX: ") + QDir::toNativeSeparators(filePath), SEC_TO_MSEC(5));
+    QNTRACE(QStringLiteral("MainWindow::onExportNotesToPdfProgress: ") << numExportedNotes
+            << QStringLiteral(" of ") << numNotes);
+
+    onSetStatusBarText(tr("Exporting notes to pdf") + QStringLiteral(": ") + QString::number(numExportedNotes) +
+                       QStringLiteral("/") + QString::number(numNotes), SEC_TO_MSEC(5));
 }
 
-void MainWindow::onEnexFileWriteFailed(ErrorString errorDescription)
+void MainWindow::onCancelExportNotesToPdf()
 {
-    QNDEBUG(QStringLiteral("MainWindow::onEnexFileWriteFailed: ") << errorDescription);
-    onSetStatusBarText(tr("Can't export note(s) to ENEX, failed to write the ENEX to file") +
-                       QStringLiteral(": ") + errorDescription.localizedString(), SEC_TO_MSEC(30));
+    QNDEBUG(QStringLiteral("MainWindow::onCancelExportNotesToPdf"));
+
+    if (m_pCancelExportNotesToPdfButton) {
+        m_pCancelExportNotesToPdfButton->hide();
+    }
+
+    if (m_pNotesPdfExporter.isNull()) {
+        return;
+    }
+
+    m_pNotesPdfExporter->cancel();
+    m_pNotesPdfExporter->clear();
+    m_pNotesPdfExporter->deleteLater();
+    m_pNotesPdfExporter.clear();
+
+    onSetStatusBarText(tr("The export of notes to pdf has been canceled"), SEC_TO_MSEC(5));
 }
 
-void MainWindow::onEnexFileWriteIncomplete(qint64 bytesWritten, qint64 bytesTotal)
+void MainWindow::onNoteRenderingToPdfStarted(QString noteLocalUid)
 {
-    QNDEBUG(QStringLiteral("MainWindow::onEnexFileWriteIncomplete: bytes written = ")
-            << bytesWritten << QStringLiteral(", bytes total = ") << bytesTotal);
+    QNDEBUG(QStringLiteral("MainWindow::onNoteRenderingToPdfStarted: note local uid = ") << noteLocalUid);
 
+    Q_UNUSED(m_localUidsOfNotesRenderingToPdf.insert(noteLocalUid))
 
-    if (bytesWritten == 0) {
-        onSetStatusBarText(tr("Can't export note(s) to ENEX, failed to write the ENEX to file"), SEC_TO_MSEC(30));
+    if (!m_pCancelRenderingNotesToPdfButton) {
+        m_pCancelRenderingNotesToPdfButton = new QPushButton(tr("Cancel printing"), this);
+        QObject::connect(m_pCancelRenderingNotesToPdfButton, QNSIGNAL(QPushButton,clicked),
+                         this, QNSLOT(MainWindow,onCancelRenderingNotesToPdf));
+        m_pUI->statusBar->addPermanentWidget(m_pCancelRenderingNotesToPdfButton);
     }
-    else {
-        onSetStatusBarText(tr("Can't export note(s) to ENEX, failed to write the ENEX to file, "
-                              "only a portion of data has been written") + QStringLiteral(": ") +
-                           QString::number(bytesWritten) + QStringLiteral("/") + QString::number(bytesTotal), SEC_TO_MSEC(30));
+
+    m_pCancelRenderingNotesToPdfButton->show();
+    onSetStatusBarText(tr("Printing or exporting note(s) to pdf") + QStringLiteral(": ") +
+                       QString::number(m_localUidsOfNotesRenderingToPdf.size()), SEC_TO_MSEC(5));
+}
+
+void MainWindow::onNoteRenderingToPdfFinished(QString noteLocalUid)
+{
+    QNDEBUG(QStringLiteral("MainWindow::onNoteRenderingToPdfFinished: note local uid = ") << noteLocalUid);
+
+    // NOTE: the failures of rendering are reported by the note editors as errors
+    if (!m_localUidsOfNotesRenderingToPdf.remove(noteLocalUid) || !m_localUidsOfNotesRenderingToPdf.isEmpty()) {
+        return;
+    }
+
+    if (m_pCancelRenderingNotesToPdfButton) {
+        m_pCancelRenderingNotesToPdfButton->hide();
     }
 }
 
-void MainWindow::onEnexImportCompletedSuccessfully(QString enexFilePath)
+void MainWindow::onCancelRenderingNotesToPdf()
 {
-    QNDEBUG(QStringLiteral("MainWindow::onEnexImportCompletedSuccessfully: ") << enexFilePath);
+    QNDEBUG(QStringLiteral("MainWindow::onCancelRenderingNotesToPdf"));
 
-    onSetStatusBarText(tr("Successfully imported note(s) from ENEX file") +
-                       QStringLiteral(": ") + QDir::toNativeSeparators(enexFilePath), SEC_TO_MSEC(5));
+    if (m_pCancelRenderingNotesToPdfButton) {
+        m_pCancelRenderingNotesToPdfButton->hide();
+    }
+
+    QSet<QString> noteLocalUids = m_localUidsOfNotesRenderingToPdf;
+    m_localUidsOfNotesRenderingToPdf.clear();
 
-    EnexImporter * pImporter = qobject_cast<EnexImporter*>(sender());
-    if (pImporter) {
-        pImporter->clear();
-        pImporter->deleteLater();
+    if (m_pNoteEditorTabsAndWindowsCoordinator)
+    {
+        for(auto it = noteLocalUids.constBegin(), end = noteLocalUids.constEnd(); it != end; ++it)
+        {
+            NoteEditorWidget * pNoteEditorWidget =
+                m_pNoteEditorTabsAndWindowsCoordinator->noteEditorWidgetForNoteLocalUid(*it);
+            if (pNoteEditorWidget) {
+                pNoteEditorWidget->cancelRenderingNoteToPdf();
+            }
+        }
     }
+
+    onSetStatusBarText(tr("Printing or exporting note(s) to pdf has been canceled"), SEC_TO_MSEC(5));
 }
 
-void MainWindow::onEnexImportFailed(ErrorString errorDescription)
+void MainWindow::onEnexImportFinished(int numFiles, int numFailedFiles, ErrorString errorDescription)
 {
-    QNDEBUG(QStringLiteral("MainWindow::onEnexImportFailed: ") << errorDescription);
+    QNDEBUG(QStringLiteral("MainWindow::onEnexImportFinished: num files = ") << numFiles
+            << QStringLiteral(", num failed files = ") << numFailedFiles
+            << QStringLiteral(", error description = ") << errorDescription);
 
-    onSetStatusBarText(errorDescription.localizedString(), SEC_TO_MSEC(30));
+    if (numFailedFiles == 0) {
+        onSetStatusBarText(tr("Successfully imported note(s) from ENEX files") + QStringLiteral(": ") +
+                           QString::number(numFiles), SEC_TO_MSEC(5));
+    }
+    else if (numFiles == 1) {
+        onSetStatusBarText(errorDescription.localizedString(), SEC_TO_MSEC(30));
+    }
+    else {
+        onSetStatusBarText(tr("Failed to import some ENEX files") + QStringLiteral(": ") +
+                           QString::number(numFailedFiles) + QStringLiteral(" ") + tr("of") + QStringLiteral(" ") +
+                           QString::number(numFiles) + QStringLiteral("; ") + errorDescription.localizedString(),
+                           SEC_TO_MSEC(30));
+    }
 
-    EnexImporter * pImporter = qobject_cast<EnexImporter*>(sender());
-    if (pImporter) {
-        pImporter->clear();
-        pImporter->deleteLater();
+    EnexImportManager * pImportManager = qobject_cast<EnexImportManager*>(sender());
+    if (pImportManager) {
+        pImportManager->deleteLater();
     }
 }
 
+void MainWindow::onEnexImportProgress(int numFinishedFiles, int numFiles, qint64 numImportedNotes,
+                                      double notesPerSecond)
+{
+    QNDEBUG(QStringLiteral("MainWindow::onEnexImportProgress: finished files: ") << numFinishedFiles
+            << QStringLiteral(" of ") << numFiles << QStringLiteral(", num imported notes = ") << numImportedNotes
+            << QStringLiteral(", notes per second = ") << notesPerSecond);
+
+    QString text = tr("Importing notes from ENEX") + QStringLiteral(": ") + QString::number(numImportedNotes) +
+                   QStringLiteral(" (") + QString::number(notesPerSecond, 'f', 1) + QStringLiteral(" ") +
+                   tr("notes per second") + QStringLiteral(")");
+    if (numFiles > 1) {
+        text += QStringLiteral(", ") + tr("files") + QStringLiteral(": ") + QString::number(numFinishedFiles) +
+                QStringLiteral("/") + QString::number(numFiles);
+    }
+
+    onSetStatusBarText(text, SEC_TO_MSEC(5));
+}
+
 void MainWindow::onUseLimitedFontsPreferenceChanged(bool flag)
 {
     QNDEBUG(QStringLiteral("MainWindow::onUseLimitedFontsPreferenceChanged: flag = ")
@@ -4403,6 +4657,8 @@ void MainWindow::setupViews()
                      this, QNSLOT(MainWindow,onOpenNoteInSeparateWindow,QString), Qt::UniqueConnection);
     QObject::connect(pNoteListView, QNSIGNAL(NoteListView,enexExportRequested,QStringList),
                      this, QNSLOT(MainWindow,onExportNotesToEnexRequested,QStringList), Qt::UniqueConnection);
+    QObject::connect(pNoteListView, QNSIGNAL(NoteListView,pdfExportRequested,QStringList),
+                     this, QNSLOT(MainWindow,onExportNotesToPdfRequested,QStringList), Qt::UniqueConnection);
     QObject::connect(pNoteListView, QNSIGNAL(NoteListView,newNoteCreationRequested),
                      this, QNSLOT(MainWindow,onNewNoteCreationRequested), Qt::UniqueConnection);
     QObject::connect(pNoteListView, QNSIGNAL(NoteListView,copyInAppNoteLinkRequested,QString,QString),
@@ -4581,6 +4837,15 @@ void MainWindow::setupNoteEditorTabWidgetsCoordinator()
                      this, QNSLOT(MainWindow,onNoteEditorError,ErrorString));
     QObject::connect(m_pNoteEditorTabsAndWindowsCoordinator, QNSIGNAL(NoteEditorTabsAndWindowsCoordinator,currentNoteChanged,QString),
                      m_pUI->noteListView, QNSLOT(NoteListView,setCurrentNoteByLocalUid,QString));
+    QObject::connect(m_pNoteEditorTabsAndWindowsCoordinator, QNSIGNAL(NoteEditorTabsAndWindowsCoordinator,noteRenderingToPdfStarted,QString),
+                     this, QNSLOT(MainWindow,onNoteRenderingToPdfStarted,QString));
+    QObject::connect(m_pNoteEditorTabsAndWindowsCoordinator, QNSIGNAL(NoteEditorTabsAndWindowsCoordinator,noteRenderingToPdfFinished,QString),
+                     this, QNSLOT(MainWindow,onNoteRenderingToPdfFinished,QString));
+
+    m_localUidsOfNotesRenderingToPdf.clear();
+    if (m_pCancelRenderingNotesToPdfButton) {
+        m_pCancelRenderingNotesToPdfButton->hide();
+    }
 }
 
 bool MainWindow::onceDisplayedGreeterScreen() const
@@ -64,6 +64,7 @@ class MainWindow;
 QT_FORWARD_DECLARE_CLASS(QUrl)
 QT_FORWARD_DECLARE_CLASS(QUndoStack)
 QT_FORWARD_DECLARE_CLASS(QActionGroup)
+QT_FORWARD_DECLARE_CLASS(QPushButton)
 
 QT_FORWARD_DECLARE_CLASS(ColumnChangeRerouter)
 
@@ -73,6 +74,8 @@ QT_FORWARD_DECLARE_CLASS(NoteFilterModel)
 QT_FORWARD_DECLARE_CLASS(NoteFiltersManager)
 QT_FORWARD_DECLARE_CLASS(EditNoteDialogsManager)
 QT_FORWARD_DECLARE_CLASS(SystemTrayIconManager)
+QT_FORWARD_DECLARE_CLASS(NotePdfExporter)
+QT_FORWARD_DECLARE_CLASS(EnexExporter)
 }
 
 using namespace quentier;
@@ -238,15 +241,23 @@ private Q_SLOTS:
     void onCurrentNotePdfExportRequested();
 
     void onExportNotesToEnexRequested(QStringList noteLocalUids);
-    void onExportedNotesToEnex(QString enex);
+    void onExportedNotesToEnex(QString enexFilePath);
     void onExportNotesToEnexFailed(ErrorString errorDescription);
+    void onExportNotesToEnexProgress(int numExportedNotes, int numNotes);
+    void onCancelExportNotesToEnex();
 
-    void onEnexFileWrittenSuccessfully(QString filePath);
-    void onEnexFileWriteFailed(ErrorString errorDescription);
-    void onEnexFileWriteIncomplete(qint64 bytesWritten, qint64 bytesTotal);
+    void onExportNotesToPdfRequested(QStringList noteLocalUids);
+    void onExportedNotesToPdf(QStringList pdfFilePaths);
+    void onExportNotesToPdfFailed(ErrorString errorDescription);
+    void onExportNotesToPdfProgress(int numExportedNotes, int numNotes);
+    void onCancelExportNotesToPdf();
 
-    void onEnexImportCompletedSuccessfully(QString enexFilePath);
-    void onEnexImportFailed(ErrorString errorDescription);
+    void onNoteRenderingToPdfStarted(QString noteLocalUid);
+    void onNoteRenderingToPdfFinished(QString noteLocalUid);
+    void onCancelRenderingNotesToPdf();
+
+    void onEnexImportFinished(int numFiles, int numFailedFiles, ErrorString errorDescription);
+    void onEnexImportProgress(int numFinishedFiles, int numFiles, qint64 numImportedNotes, double notesPerSecond);
 
     // Preferences dialog slots
     void onUseLimitedFontsPreferenceChanged(bool flag);
@@ -544,6 +555,21 @@ private:
     NoteEditorTabsAndWindowsCoordinator *   m_pNoteEditorTabsAndWindowsCoordinator;
     EditNoteDialogsManager *                m_pEditNoteDialogsManager;
 
+    // The export of notes to pdf in progress, if any, and the status bar button canceling it;
+    // the new export cancels the previous one
+    QPointer<NotePdfExporter>               m_pNotesPdfExporter;
+    QPushButton *                           m_pCancelExportNotesToPdfButton;
+
+    // The notes printed or exported to pdf one by one from the note editors and the status bar button
+    // canceling their rendering
+    QSet<QString>                           m_localUidsOfNotesRenderingToPdf;
+    QPushButton *                           m_pCancelRenderingNotesToPdfButton;
+
+    // The export of notes to ENEX in progress, if any, and the status bar button canceling it;
+    // the new export cancels the previous one
+    QPointer<EnexExporter>                  m_pNotesEnexExporter;
+    QPushButton *                           m_pCancelExportNotesToEnexButton;
+
     QUndoStack *            m_pUndoStack;
 
     bool                    m_noteSearchQueryValidated;
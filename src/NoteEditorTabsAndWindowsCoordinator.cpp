@@ -39,6 +39,8 @@
 #include <QEvent>
 #include <QTimerEvent>
 #include <QTimer>
+#include <QVector>
+#include <QPair>
 #include <QApplication>
 #include <algorithm>
 
@@ -46,10 +48,14 @@
 #define MIN_NUM_NOTES_IN_TABS (1)
 
 #define BLANK_NOTE_KEY QStringLiteral("BlankNoteId")
+
+#define NOTE_EDITOR_WIDGETS_POOL_SIZE (2)
+#define FILL_NOTE_EDITOR_WIDGETS_POOL_DELAY (1000)
 #define MAX_TAB_NAME_SIZE (10)
 #define MAX_WINDOW_NAME_SIZE (120)
 
 #define OPEN_NOTES_LOCAL_UIDS_IN_TABS_SETTINGS_KEY QStringLiteral("LocalUidsOfNotesLastOpenInNoteEditorTabs")
+#define OPEN_NOTES_TAB_NAMES_SETTINGS_KEY QStringLiteral("TabNamesOfNotesLastOpenInNoteEditorTabs")
 #define OPEN_NOTES_LOCAL_UIDS_IN_WINDOWS_SETTINGS_KEY QStringLiteral("LocalUidsOfNotesLastOpenInNoteEditorWindows")
 #define LAST_CURRENT_TAB_NOTE_LOCAL_UID QStringLiteral("LastCurrentTabNoteLocalUid")
 
@@ -57,6 +63,13 @@
 
 #define PERSIST_NOTE_EDITOR_WINDOW_GEOMETRY_DELAY (3000)
 
+// The prefetching starts once the set of notes to prefetch stays the same for this long
+// so that quickly moving through the notes doesn't flood the local storage with requests
+#define PREFETCH_NOTES_DELAY (300)
+
+// The overall limit on the time spent waiting for the notes from the closed editors to be saved
+#define PENDING_NOTE_SAVES_TIMEOUT_MSEC (30000)
+
 namespace quentier {
 
 NoteEditorTabsAndWindowsCoordinator::NoteEditorTabsAndWindowsCoordinator(const Account & account, LocalStorageManagerAsync & localStorageManagerAsync,
@@ -77,6 +90,8 @@ NoteEditorTabsAndWindowsCoordinator::NoteEditorTabsAndWindowsCoordinator(const A
     m_pSpellChecker(Q_NULLPTR),
     m_connectedToLocalStorage(false),
     m_maxNumNotesInTabs(-1),
+    m_maxNoteEditorTabsMemoryUsage(0),
+    m_noteLocalUidsOfTabsByActivation(),
     m_localUidsOfNotesInTabbedEditors(),
     m_lastCurrentTabNoteLocalUid(),
     m_noteEditorWindowsByNoteLocalUid(),
@@ -84,6 +99,13 @@ NoteEditorTabsAndWindowsCoordinator::NoteEditorTabsAndWindowsCoordinator(const A
     m_noteEditorModeByCreateNoteRequestIds(),
     m_expungeNoteRequestIds(),
     m_inAppNoteLinkFindNoteRequestIds(),
+    m_noteLocalUidsToPrefetch(),
+    m_prefetchNoteRequestId(),
+    m_pPrefetchNotesTimer(Q_NULLPTR),
+    m_noteEditorWidgetsPool(),
+    m_noteEditorWidgetsPoolFillingSuspended(false),
+    m_noteEditorWidgetsWithPendingSave(),
+    m_pPendingNoteSavesEventLoop(Q_NULLPTR),
     m_pTabBarContextMenu(Q_NULLPTR),
     m_localUidOfNoteToBeExpunged(),
     m_pExpungeNoteDeadlineTimer(Q_NULLPTR),
@@ -92,6 +114,7 @@ NoteEditorTabsAndWindowsCoordinator::NoteEditorTabsAndWindowsCoordinator(const A
     ApplicationSettings appSettings(m_currentAccount, QUENTIER_UI_SETTINGS);
     appSettings.beginGroup(NOTE_EDITOR_SETTINGS_GROUP_NAME);
     QVariant maxNumNoteTabsData = appSettings.value(QStringLiteral("MaxNumNoteTabs"));
+    QVariant noteEditorTabsMemoryLimitData = appSettings.value(NOTE_EDITOR_TABS_MEMORY_LIMIT_SETTINGS_KEY);
     appSettings.endGroup();
 
     bool conversionResult = false;
@@ -106,19 +129,24 @@ NoteEditorTabsAndWindowsCoordinator::NoteEditorTabsAndWindowsCoordinator(const A
         m_maxNumNotesInTabs = maxNumNoteTabs;
     }
 
+    conversionResult = false;
+    int noteEditorTabsMemoryLimit = noteEditorTabsMemoryLimitData.toInt(&conversionResult);
+    if (!conversionResult) {
+        QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator: no persisted note editor tabs memory limit setting, "
+                               "fallback to the default value of ") << DEFAULT_NOTE_EDITOR_TABS_MEMORY_LIMIT
+                << QStringLiteral(" Mb"));
+        noteEditorTabsMemoryLimit = DEFAULT_NOTE_EDITOR_TABS_MEMORY_LIMIT;
+    }
+
+    m_maxNoteEditorTabsMemoryUsage = static_cast<qint64>(noteEditorTabsMemoryLimit) * 1024 * 1024;
+
     m_localUidsOfNotesInTabbedEditors.set_capacity(static_cast<size_t>(std::max(m_maxNumNotesInTabs, MIN_NUM_NOTES_IN_TABS)));
     QNTRACE(QStringLiteral("Tabbed note local uids circular buffer capacity: ") << m_localUidsOfNotesInTabbedEditors.capacity());
 
     setupFileIO();
     setupSpellChecker();
 
-    QUndoStack * pUndoStack = new QUndoStack;
-    m_pBlankNoteEditor = new NoteEditorWidget(m_currentAccount, m_localStorageManagerAsync,
-                                              *m_pFileIOProcessorAsync, *m_pSpellChecker,
-                                              m_noteCache, m_notebookCache, m_tagCache,
-                                              *m_pTagModel, pUndoStack, m_pTabWidget);
-    pUndoStack->setParent(m_pBlankNoteEditor);
-
+    m_pBlankNoteEditor = takeNoteEditorWidgetFromPool();
     Q_UNUSED(m_pTabWidget->addTab(m_pBlankNoteEditor, BLANK_NOTE_KEY))
 
     QTabBar * pTabBar = m_pTabWidget->tabBar();
@@ -162,6 +190,10 @@ void NoteEditorTabsAndWindowsCoordinator::clear()
 
     m_pBlankNoteEditor = Q_NULLPTR;
 
+    // NOTE: the pool must not be refilled with the editors bound to the account being cleared while
+    // the pending note saves are waited for below
+    m_noteEditorWidgetsPoolFillingSuspended = true;
+
     // Prevent currentChanged signal from tabs removal inside this method to mess with last current tab note local uid
     QObject::disconnect(m_pTabWidget, QNSIGNAL(TabWidget,currentChanged,int),
                         this, QNSLOT(NoteEditorTabsAndWindowsCoordinator,onCurrentTabChanged,int));
@@ -185,18 +217,8 @@ void NoteEditorTabsAndWindowsCoordinator::clear()
         QString noteLocalUid = pNoteEditorWidget->noteLocalUid();
         QNTRACE(QStringLiteral("Safely closing note editor tab: ") << noteLocalUid);
 
-        ErrorString errorDescription;
-        NoteEditorWidget::NoteSaveStatus::type res = pNoteEditorWidget->checkAndSaveModifiedNote(errorDescription);
-        if (Q_UNLIKELY(res != NoteEditorWidget::NoteSaveStatus::Ok)) {
-            QNINFO(QStringLiteral("Could not save note: ") << pNoteEditorWidget->noteLocalUid()
-                   << QStringLiteral(", status: ") << res << QStringLiteral(", error: ") << errorDescription);
-        }
-
         m_pTabWidget->removeTab(0);
-
-        pNoteEditorWidget->removeEventFilter(this);
-        pNoteEditorWidget->hide();
-        pNoteEditorWidget->deleteLater();
+        deleteNoteEditorWidgetAfterSave(pNoteEditorWidget);
 
         QNTRACE(QStringLiteral("Removed note editor tab: ") << noteLocalUid);
     }
@@ -214,22 +236,21 @@ void NoteEditorTabsAndWindowsCoordinator::clear()
         QString noteLocalUid = pNoteEditorWidget->noteLocalUid();
         QNTRACE(QStringLiteral("Safely closing note editor window: ") << noteLocalUid);
 
-        ErrorString errorDescription;
-        NoteEditorWidget::NoteSaveStatus::type res = pNoteEditorWidget->checkAndSaveModifiedNote(errorDescription);
-        if (Q_UNLIKELY(res != NoteEditorWidget::NoteSaveStatus::Ok)) {
-            QNINFO(QStringLiteral("Could not save note: ") << pNoteEditorWidget->noteLocalUid()
-                   << QStringLiteral(", status: ") << res << QStringLiteral(", error: ") << errorDescription);
-        }
-
-        pNoteEditorWidget->removeEventFilter(this);
-        pNoteEditorWidget->hide();
-        pNoteEditorWidget->deleteLater();
+        deleteNoteEditorWidgetAfterSave(pNoteEditorWidget);
         Q_UNUSED(m_noteEditorWindowsByNoteLocalUid.erase(it))
 
         QNTRACE(QStringLiteral("Closed note editor window: ") << noteLocalUid);
     }
 
+    // The pooled editors are bound to the account being cleared
+    clearNoteEditorWidgetsPool();
+
+    // NOTE: the notes from all the closed editors are saved in parallel; this is the only place waiting for
+    // the saves to finish as the local storage might be switched or shut down right after the editors are cleared
+    waitForPendingNoteSaves();
+
     m_localUidsOfNotesInTabbedEditors.clear();
+    m_noteLocalUidsOfTabsByActivation.clear();
     m_lastCurrentTabNoteLocalUid.clear();
     m_noteEditorWindowsByNoteLocalUid.clear();
 
@@ -245,6 +266,12 @@ void NoteEditorTabsAndWindowsCoordinator::clear()
     m_expungeNoteRequestIds.clear();
     m_inAppNoteLinkFindNoteRequestIds.clear();
 
+    m_noteLocalUidsToPrefetch.clear();
+    m_prefetchNoteRequestId = QUuid();
+    if (m_pPrefetchNotesTimer) {
+        m_pPrefetchNotesTimer->stop();
+    }
+
     m_localUidOfNoteToBeExpunged.clear();
 }
 
@@ -426,12 +453,7 @@ void NoteEditorTabsAndWindowsCoordinator::addNote(const QString & noteLocalUid,
         return;
     }
 
-    QUndoStack * pUndoStack = new QUndoStack;
-    NoteEditorWidget * pNoteEditorWidget = new NoteEditorWidget(m_currentAccount, m_localStorageManagerAsync,
-                                                                *m_pFileIOProcessorAsync, *m_pSpellChecker,
-                                                                m_noteCache, m_notebookCache, m_tagCache,
-                                                                *m_pTagModel, pUndoStack, m_pTabWidget);
-    pUndoStack->setParent(pNoteEditorWidget);
+    NoteEditorWidget * pNoteEditorWidget = takeNoteEditorWidgetFromPool();
     pNoteEditorWidget->setNoteLocalUid(noteLocalUid, isNewNote);
     insertNoteEditorWidget(pNoteEditorWidget, noteEditorMode);
 }
@@ -507,6 +529,57 @@ void NoteEditorTabsAndWindowsCoordinator::setUseLimitedFonts(const bool flag)
     }
 }
 
+void NoteEditorTabsAndWindowsCoordinator::prefetchNotes(const QStringList & noteLocalUids)
+{
+    QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::prefetchNotes: ") << noteLocalUids.join(QStringLiteral(", ")));
+
+    // NOTE: the request already sent to the local storage is not revoked, the rest of the previous notes are dropped
+    m_noteLocalUidsToPrefetch = noteLocalUids;
+
+    if (m_noteLocalUidsToPrefetch.isEmpty()) {
+        if (m_pPrefetchNotesTimer) {
+            m_pPrefetchNotesTimer->stop();
+        }
+        return;
+    }
+
+    if (!m_pPrefetchNotesTimer) {
+        m_pPrefetchNotesTimer = new QTimer(this);
+        m_pPrefetchNotesTimer->setSingleShot(true);
+        QObject::connect(m_pPrefetchNotesTimer, QNSIGNAL(QTimer,timeout),
+                         this, QNSLOT(NoteEditorTabsAndWindowsCoordinator,prefetchNextNote));
+    }
+
+    m_pPrefetchNotesTimer->start(PREFETCH_NOTES_DELAY);
+}
+
+void NoteEditorTabsAndWindowsCoordinator::prefetchNextNote()
+{
+    if (!m_prefetchNoteRequestId.isNull()) {
+        QNTRACE(QStringLiteral("The previous note is still being prefetched"));
+        return;
+    }
+
+    while(!m_noteLocalUidsToPrefetch.isEmpty())
+    {
+        QString noteLocalUid = m_noteLocalUidsToPrefetch.takeFirst();
+        if (noteLocalUid.isEmpty() || isNoteOpen(noteLocalUid) || m_noteCache.get(noteLocalUid)) {
+            continue;
+        }
+
+        connectToLocalStorage();
+
+        // NOTE: the binary data of resources is loaded by the note editor once the note is open
+        m_prefetchNoteRequestId = QUuid::createUuid();
+        Note dummy;
+        dummy.setLocalUid(noteLocalUid);
+        QNTRACE(QStringLiteral("Emitting the request to prefetch note: local uid = ") << noteLocalUid
+                << QStringLiteral(", request id = ") << m_prefetchNoteRequestId);
+        Q_EMIT findNote(dummy, /* with resource binary data = */ false, m_prefetchNoteRequestId);
+        return;
+    }
+}
+
 void NoteEditorTabsAndWindowsCoordinator::refreshNoteEditorWidgetsSpecialIcons()
 {
     QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::refreshNoteEditorWidgetsSpecialIcons"));
@@ -561,10 +634,11 @@ bool NoteEditorTabsAndWindowsCoordinator::eventFilter(QObject * pWatched, QEvent
 
                 if (pNoteEditorWidget->isModified())
                 {
-                    ErrorString errorDescription;
-                    NoteEditorWidget::NoteSaveStatus::type status = pNoteEditorWidget->checkAndSaveModifiedNote(errorDescription);
-                    QNDEBUG(QStringLiteral("Check and save modified note, status: ") << status
-                            << QStringLiteral(", error description: ") << errorDescription);
+                    // NOTE: the window is closed without waiting for the note to be saved; the widget postpones
+                    // its deletion until the save is finished
+                    if ((pEvent->type() == QEvent::Close) && pNoteEditorWidget->saveModifiedNoteAsync()) {
+                        trackPendingNoteSave(pNoteEditorWidget);
+                    }
                 }
                 else
                 {
@@ -597,6 +671,22 @@ bool NoteEditorTabsAndWindowsCoordinator::eventFilter(QObject * pWatched, QEvent
     return QObject::eventFilter(pWatched, pEvent);
 }
 
+void NoteEditorTabsAndWindowsCoordinator::onPendingNoteSaveFinished()
+{
+    onNoteEditorWidgetWithPendingSaveDestroyed(sender());
+}
+
+void NoteEditorTabsAndWindowsCoordinator::onNoteEditorWidgetWithPendingSaveDestroyed(QObject * pObject)
+{
+    if (!m_noteEditorWidgetsWithPendingSave.remove(pObject)) {
+        return;
+    }
+
+    if (m_noteEditorWidgetsWithPendingSave.isEmpty() && m_pPendingNoteSavesEventLoop) {
+        m_pPendingNoteSavesEventLoop->exitAsSuccess();
+    }
+}
+
 void NoteEditorTabsAndWindowsCoordinator::onNoteEditorWidgetResolved()
 {
     QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::onNoteEditorWidgetResolved"));
@@ -706,7 +796,11 @@ void NoteEditorTabsAndWindowsCoordinator::onNoteTitleOrPreviewTextChanged(QStrin
         }
 
         QString tabName = shortenEditorName(titleOrPreview);
-        m_pTabWidget->setTabText(i, tabName);
+        if (m_pTabWidget->tabText(i) != tabName) {
+            m_pTabWidget->setTabText(i, tabName);
+            persistLocalUidsOfNotesInEditorTabs();
+        }
+
         return;
     }
 
@@ -759,6 +853,9 @@ void NoteEditorTabsAndWindowsCoordinator::onInAppNoteLinkClicked(QString userId,
 void NoteEditorTabsAndWindowsCoordinator::onNoteLoadedInEditor()
 {
     QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::onNoteLoadedInEditor"));
+
+    // The estimate of the memory used by the editor is only known once the note is loaded
+    checkAndHibernateNoteEditorTabs();
 }
 
 void NoteEditorTabsAndWindowsCoordinator::onNoteEditorError(ErrorString errorDescription)
@@ -792,6 +889,33 @@ void NoteEditorTabsAndWindowsCoordinator::onNoteEditorError(ErrorString errorDes
     Q_EMIT notifyError(error);
 }
 
+void NoteEditorTabsAndWindowsCoordinator::onNoteEditorRenderingToPdfStarted()
+{
+    NoteEditorWidget * pNoteEditorWidget = qobject_cast<NoteEditorWidget*>(sender());
+    if (Q_UNLIKELY(!pNoteEditorWidget)) {
+        QNWARNING(QStringLiteral("Can't cast the sender of the note rendering to pdf start to NoteEditorWidget"));
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::onNoteEditorRenderingToPdfStarted: note local uid = ")
+            << pNoteEditorWidget->noteLocalUid());
+    Q_EMIT noteRenderingToPdfStarted(pNoteEditorWidget->noteLocalUid());
+}
+
+void NoteEditorTabsAndWindowsCoordinator::onNoteEditorRenderingToPdfFinished()
+{
+    // NOTE: the signal is also emitted from the destructor of NoteEditorWidget
+    NoteEditorWidget * pNoteEditorWidget = qobject_cast<NoteEditorWidget*>(sender());
+    if (Q_UNLIKELY(!pNoteEditorWidget)) {
+        QNWARNING(QStringLiteral("Can't cast the sender of the note rendering to pdf finish to NoteEditorWidget"));
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::onNoteEditorRenderingToPdfFinished: note local uid = ")
+            << pNoteEditorWidget->noteLocalUid());
+    Q_EMIT noteRenderingToPdfFinished(pNoteEditorWidget->noteLocalUid());
+}
+
 void NoteEditorTabsAndWindowsCoordinator::onAddNoteComplete(Note note, QUuid requestId)
 {
     auto it = m_noteEditorModeByCreateNoteRequestIds.find(requestId);
@@ -831,6 +955,24 @@ void NoteEditorTabsAndWindowsCoordinator::onAddNoteFailed(Note note, ErrorString
 
 void NoteEditorTabsAndWindowsCoordinator::onFindNoteComplete(Note note, bool withResourceBinaryData, QUuid requestId)
 {
+    if (!m_prefetchNoteRequestId.isNull() && (requestId == m_prefetchNoteRequestId))
+    {
+        QNTRACE(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::onFindNoteComplete: prefetched note ") << note.localUid());
+
+        m_prefetchNoteRequestId = QUuid();
+        m_noteCache.put(note.localUid(), note);
+
+        if (m_noteLocalUidsToPrefetch.isEmpty()) {
+            checkPendingRequestsAndDisconnectFromLocalStorage();
+            return;
+        }
+
+        // NOTE: going through the event loop before the next request lets other requests to the local storage
+        // be sent ahead of it
+        QTimer::singleShot(0, this, SLOT(prefetchNextNote()));
+        return;
+    }
+
     auto it = m_inAppNoteLinkFindNoteRequestIds.find(requestId);
     if (it == m_inAppNoteLinkFindNoteRequestIds.end()) {
         return;
@@ -850,6 +992,22 @@ void NoteEditorTabsAndWindowsCoordinator::onFindNoteComplete(Note note, bool wit
 void NoteEditorTabsAndWindowsCoordinator::onFindNoteFailed(Note note, bool withResourceBinaryData,
                                                            ErrorString errorDescription, QUuid requestId)
 {
+    if (!m_prefetchNoteRequestId.isNull() && (requestId == m_prefetchNoteRequestId))
+    {
+        QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::onFindNoteFailed: failed to prefetch note ")
+                << note.localUid() << QStringLiteral(": ") << errorDescription);
+
+        m_prefetchNoteRequestId = QUuid();
+
+        if (m_noteLocalUidsToPrefetch.isEmpty()) {
+            checkPendingRequestsAndDisconnectFromLocalStorage();
+            return;
+        }
+
+        QTimer::singleShot(0, this, SLOT(prefetchNextNote()));
+        return;
+    }
+
     auto it = m_inAppNoteLinkFindNoteRequestIds.find(requestId);
     if (it == m_inAppNoteLinkFindNoteRequestIds.end()) {
         return;
@@ -938,6 +1096,13 @@ void NoteEditorTabsAndWindowsCoordinator::onCurrentTabChanged(int currentIndex)
         return;
     }
 
+    // NOTE: that also cancels the hibernation waiting for the note to be saved; while the last open notes
+    // are being restored the tabs become current one after another so they are not woken up until the restoring
+    // is over
+    if (m_trackingCurrentTab) {
+        pNoteEditorWidget->wakeUp();
+    }
+
     pNoteEditorWidget->setFocusToEditor();
 
     if (pNoteEditorWidget == m_pBlankNoteEditor)
@@ -956,11 +1121,15 @@ void NoteEditorTabsAndWindowsCoordinator::onCurrentTabChanged(int currentIndex)
         return;
     }
 
+    QString currentNoteLocalUid = pNoteEditorWidget->noteLocalUid();
+    Q_UNUSED(m_noteLocalUidsOfTabsByActivation.removeAll(currentNoteLocalUid))
+    m_noteLocalUidsOfTabsByActivation << currentNoteLocalUid;
+    checkAndHibernateNoteEditorTabs();
+
     if (!m_trackingCurrentTab) {
         return;
     }
 
-    QString currentNoteLocalUid = pNoteEditorWidget->noteLocalUid();
     if (m_lastCurrentTabNoteLocalUid != currentNoteLocalUid)
     {
         m_lastCurrentTabNoteLocalUid = currentNoteLocalUid;
@@ -1104,16 +1273,9 @@ void NoteEditorTabsAndWindowsCoordinator::onTabContextMenuSaveNoteAction()
             return;
         }
 
-        ErrorString errorDescription;
-        NoteEditorWidget::NoteSaveStatus::type res = pNoteEditorWidget->checkAndSaveModifiedNote(errorDescription);
-        if (Q_UNLIKELY(res != NoteEditorWidget::NoteSaveStatus::Ok))
-        {
-            ErrorString error(QT_TR_NOOP("Couldn't save the note"));
-            error.appendBase(errorDescription.base());
-            error.appendBase(errorDescription.additionalBases());
-            error.details() = errorDescription.details();
-            QNWARNING(error << QStringLiteral(", note local uid = ") << noteLocalUid);
-            Q_EMIT notifyError(error);
+        // NOTE: the failure to save the note is reported by the note editor widget itself
+        if (pNoteEditorWidget->saveModifiedNoteAsync()) {
+            trackPendingNoteSave(pNoteEditorWidget);
         }
 
         return;
@@ -1213,11 +1375,19 @@ void NoteEditorTabsAndWindowsCoordinator::insertNoteEditorWidget(NoteEditorWidge
                      this, QNSLOT(NoteEditorTabsAndWindowsCoordinator,onInAppNoteLinkClicked,QString,QString,QString));
     QObject::connect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,notifyError,ErrorString),
                      this, QNSLOT(NoteEditorTabsAndWindowsCoordinator,onNoteEditorError,ErrorString));
+    QObject::connect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,noteRenderingToPdfStarted),
+                     this, QNSLOT(NoteEditorTabsAndWindowsCoordinator,onNoteEditorRenderingToPdfStarted));
+    QObject::connect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,noteRenderingToPdfFinished),
+                     this, QNSLOT(NoteEditorTabsAndWindowsCoordinator,onNoteEditorRenderingToPdfFinished));
 
     if (noteEditorMode == NoteEditorMode::Window)
     {
         QString noteLocalUid = pNoteEditorWidget->noteLocalUid();
 
+        // NOTE: only the note editors in background tabs are hibernated, the one moved from such a tab
+        // into a separate window must load its note back
+        pNoteEditorWidget->wakeUp();
+
         Q_UNUSED(pNoteEditorWidget->makeSeparateWindow())
 
         QString displayName = shortenEditorName(pNoteEditorWidget->titleOrPreview(), MAX_WINDOW_NAME_SIZE);
@@ -1239,7 +1409,6 @@ void NoteEditorTabsAndWindowsCoordinator::insertNoteEditorWidget(NoteEditorWidge
     m_localUidsOfNotesInTabbedEditors.push_back(pNoteEditorWidget->noteLocalUid());
     QNTRACE(QStringLiteral("Added tabbed note local uid: ") << pNoteEditorWidget->noteLocalUid()
             << QStringLiteral(", the number of tabbed note local uids = ") << m_localUidsOfNotesInTabbedEditors.size());
-    persistLocalUidsOfNotesInEditorTabs();
 
     QString displayName = shortenEditorName(pNoteEditorWidget->titleOrPreview());
 
@@ -1251,6 +1420,8 @@ void NoteEditorTabsAndWindowsCoordinator::insertNoteEditorWidget(NoteEditorWidge
         m_pTabWidget->setTabText(tabIndex, displayName);
     }
 
+    persistLocalUidsOfNotesInEditorTabs();
+
     m_pTabWidget->setCurrentIndex(tabIndex);
 
     pNoteEditorWidget->installEventFilter(this);
@@ -1295,10 +1466,10 @@ void NoteEditorTabsAndWindowsCoordinator::removeNoteEditorTab(int tabIndex, cons
 
     if (pNoteEditorWidget->isModified())
     {
-        ErrorString errorDescription;
-        NoteEditorWidget::NoteSaveStatus::type status = pNoteEditorWidget->checkAndSaveModifiedNote(errorDescription);
-        QNDEBUG(QStringLiteral("Check and save modified note, status: ") << status
-                << QStringLiteral(", error description: ") << errorDescription);
+        // NOTE: the tab is removed without waiting for the note to be saved
+        if (pNoteEditorWidget->saveModifiedNoteAsync()) {
+            trackPendingNoteSave(pNoteEditorWidget);
+        }
     }
     else
     {
@@ -1306,6 +1477,7 @@ void NoteEditorTabsAndWindowsCoordinator::removeNoteEditorTab(int tabIndex, cons
     }
 
     QString noteLocalUid = pNoteEditorWidget->noteLocalUid();
+    Q_UNUSED(m_noteLocalUidsOfTabsByActivation.removeAll(noteLocalUid))
 
     auto it = std::find(m_localUidsOfNotesInTabbedEditors.begin(), m_localUidsOfNotesInTabbedEditors.end(), noteLocalUid);
     if (it != m_localUidsOfNotesInTabbedEditors.end()) {
@@ -1330,11 +1502,22 @@ void NoteEditorTabsAndWindowsCoordinator::removeNoteEditorTab(int tabIndex, cons
 
     if (m_pTabWidget->count() == 1)
     {
-        // That should remove the note from the editor (if any)
-        pNoteEditorWidget->setNoteLocalUid(QString());
-        m_pBlankNoteEditor = pNoteEditorWidget;
+        if (closeEditor && pNoteEditorWidget->isSavingNote())
+        {
+            // The editor can't become the blank one until its note is saved so another editor takes its place
+            m_pBlankNoteEditor = takeNoteEditorWidgetFromPool();
+            Q_UNUSED(m_pTabWidget->addTab(m_pBlankNoteEditor, BLANK_NOTE_KEY))
+            m_pTabWidget->removeTab(tabIndex);
+            deleteNoteEditorWidgetAfterSave(pNoteEditorWidget);
+        }
+        else
+        {
+            // That should remove the note from the editor (if any)
+            pNoteEditorWidget->setNoteLocalUid(QString());
+            m_pBlankNoteEditor = pNoteEditorWidget;
+            m_pTabWidget->setTabText(0, BLANK_NOTE_KEY);
+        }
 
-        m_pTabWidget->setTabText(0, BLANK_NOTE_KEY);
         m_pTabWidget->tabBar()->hide();
         m_pTabWidget->setTabsClosable(false);
 
@@ -1347,9 +1530,12 @@ void NoteEditorTabsAndWindowsCoordinator::removeNoteEditorTab(int tabIndex, cons
 
     m_pTabWidget->removeTab(tabIndex);
 
-    if (closeEditor) {
-        pNoteEditorWidget->hide();
-        pNoteEditorWidget->deleteLater();
+    if (closeEditor)
+    {
+        if (!returnNoteEditorWidgetToPool(pNoteEditorWidget)) {
+            deleteNoteEditorWidgetAfterSave(pNoteEditorWidget);
+        }
+
         pNoteEditorWidget = Q_NULLPTR;
     }
 
@@ -1363,6 +1549,245 @@ void NoteEditorTabsAndWindowsCoordinator::removeNoteEditorTab(int tabIndex, cons
     }
 }
 
+void NoteEditorTabsAndWindowsCoordinator::checkAndHibernateNoteEditorTabs()
+{
+    if (m_maxNoteEditorTabsMemoryUsage <= 0) {
+        return;
+    }
+
+    NoteEditorWidget * pCurrentNoteEditorWidget = qobject_cast<NoteEditorWidget*>(m_pTabWidget->currentWidget());
+
+    qint64 memoryUsage = 0;
+    QVector<QPair<int, NoteEditorWidget*> > candidatesByActivation;
+
+    for(int i = 0, numTabs = m_pTabWidget->count(); i < numTabs; ++i)
+    {
+        NoteEditorWidget * pNoteEditorWidget = qobject_cast<NoteEditorWidget*>(m_pTabWidget->widget(i));
+        if (!pNoteEditorWidget || (pNoteEditorWidget == m_pBlankNoteEditor)) {
+            continue;
+        }
+
+        // NOTE: the hibernated tabs still keep their editor pages
+        memoryUsage += pNoteEditorWidget->estimatedMemoryUsage();
+
+        if (pNoteEditorWidget->isHibernated() || (pNoteEditorWidget == pCurrentNoteEditorWidget)) {
+            continue;
+        }
+
+        // NOTE: the tabs never activated, i.e. restored on startup, come first
+        int activationIndex = m_noteLocalUidsOfTabsByActivation.indexOf(pNoteEditorWidget->noteLocalUid());
+        candidatesByActivation << qMakePair(activationIndex, pNoteEditorWidget);
+    }
+
+    if (memoryUsage <= m_maxNoteEditorTabsMemoryUsage) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::checkAndHibernateNoteEditorTabs: estimated memory usage ")
+            << memoryUsage << QStringLiteral(" exceeds the limit of ") << m_maxNoteEditorTabsMemoryUsage);
+
+    std::sort(candidatesByActivation.begin(), candidatesByActivation.end());
+
+    for(auto it = candidatesByActivation.constBegin(), end = candidatesByActivation.constEnd(); it != end; ++it)
+    {
+        NoteEditorWidget * pNoteEditorWidget = it->second;
+        QNTRACE(QStringLiteral("Hibernating note editor tab: ") << pNoteEditorWidget->noteLocalUid());
+
+        memoryUsage -= pNoteEditorWidget->estimatedNoteMemoryUsage();
+        pNoteEditorWidget->hibernate();
+
+        if (memoryUsage <= m_maxNoteEditorTabsMemoryUsage) {
+            break;
+        }
+    }
+}
+
+void NoteEditorTabsAndWindowsCoordinator::deleteNoteEditorWidgetAfterSave(NoteEditorWidget * pNoteEditorWidget)
+{
+    QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::deleteNoteEditorWidgetAfterSave: note local uid = ")
+            << pNoteEditorWidget->noteLocalUid());
+
+    pNoteEditorWidget->removeEventFilter(this);
+    pNoteEditorWidget->hide();
+    pNoteEditorWidget->saveModifiedNoteAndDeleteLater();
+    trackPendingNoteSave(pNoteEditorWidget);
+}
+
+NoteEditorWidget * NoteEditorTabsAndWindowsCoordinator::takeNoteEditorWidgetFromPool()
+{
+    NoteEditorWidget * pNoteEditorWidget = Q_NULLPTR;
+    while(!pNoteEditorWidget && !m_noteEditorWidgetsPool.isEmpty()) {
+        pNoteEditorWidget = m_noteEditorWidgetsPool.takeFirst().data();
+    }
+
+    m_noteEditorWidgetsPoolFillingSuspended = false;
+    QTimer::singleShot(FILL_NOTE_EDITOR_WIDGETS_POOL_DELAY, this, SLOT(fillNoteEditorWidgetsPool()));
+
+    if (pNoteEditorWidget) {
+        QNTRACE(QStringLiteral("Took note editor widget from the pool, ") << m_noteEditorWidgetsPool.size()
+                << QStringLiteral(" widgets are left in the pool"));
+        return pNoteEditorWidget;
+    }
+
+    QUndoStack * pUndoStack = new QUndoStack;
+    pNoteEditorWidget = new NoteEditorWidget(m_currentAccount, m_localStorageManagerAsync,
+                                             *m_pFileIOProcessorAsync, *m_pSpellChecker,
+                                             m_noteCache, m_notebookCache, m_tagCache,
+                                             *m_pTagModel, pUndoStack, m_pTabWidget);
+    pUndoStack->setParent(pNoteEditorWidget);
+    return pNoteEditorWidget;
+}
+
+bool NoteEditorTabsAndWindowsCoordinator::returnNoteEditorWidgetToPool(NoteEditorWidget * pNoteEditorWidget)
+{
+    if (m_noteEditorWidgetsPool.size() >= NOTE_EDITOR_WIDGETS_POOL_SIZE) {
+        return false;
+    }
+
+    // NOTE: the editor which still has the note to save is deleted once the note is saved; the one still rendering
+    // the note to pdf is not reused for another note while the rendering is reported
+    if (pNoteEditorWidget->isSavingNote() || pNoteEditorWidget->isModified() || pNoteEditorWidget->isSeparateWindow() ||
+        pNoteEditorWidget->isRenderingNoteToPdf())
+    {
+        return false;
+    }
+
+    QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::returnNoteEditorWidgetToPool: note local uid = ")
+            << pNoteEditorWidget->noteLocalUid());
+
+    // The connections are restored once the widget is taken from the pool and inserted again
+    QObject::disconnect(pNoteEditorWidget, Q_NULLPTR, this, Q_NULLPTR);
+    pNoteEditorWidget->removeEventFilter(this);
+    pNoteEditorWidget->hide();
+
+    // That should remove the note from the editor
+    pNoteEditorWidget->setNoteLocalUid(QString());
+
+    // The undo commands refer to the note which is no longer within the editor
+    pNoteEditorWidget->clearUndoStack();
+
+    m_noteEditorWidgetsPool << QPointer<NoteEditorWidget>(pNoteEditorWidget);
+    return true;
+}
+
+void NoteEditorTabsAndWindowsCoordinator::clearNoteEditorWidgetsPool()
+{
+    while(!m_noteEditorWidgetsPool.isEmpty())
+    {
+        QPointer<NoteEditorWidget> pNoteEditorWidget = m_noteEditorWidgetsPool.takeFirst();
+        if (!pNoteEditorWidget.isNull()) {
+            pNoteEditorWidget->deleteLater();
+        }
+    }
+}
+
+void NoteEditorTabsAndWindowsCoordinator::fillNoteEditorWidgetsPool()
+{
+    if (m_noteEditorWidgetsPoolFillingSuspended || (m_noteEditorWidgetsPool.size() >= NOTE_EDITOR_WIDGETS_POOL_SIZE)) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::fillNoteEditorWidgetsPool: pool size = ")
+            << m_noteEditorWidgetsPool.size());
+
+    QUndoStack * pUndoStack = new QUndoStack;
+    NoteEditorWidget * pNoteEditorWidget = new NoteEditorWidget(m_currentAccount, m_localStorageManagerAsync,
+                                                                *m_pFileIOProcessorAsync, *m_pSpellChecker,
+                                                                m_noteCache, m_notebookCache, m_tagCache,
+                                                                *m_pTagModel, pUndoStack, m_pTabWidget);
+    pUndoStack->setParent(pNoteEditorWidget);
+    pNoteEditorWidget->hide();
+
+    m_noteEditorWidgetsPool << QPointer<NoteEditorWidget>(pNoteEditorWidget);
+
+    // NOTE: one widget is constructed per event loop iteration not to stall the UI
+    if (m_noteEditorWidgetsPool.size() < NOTE_EDITOR_WIDGETS_POOL_SIZE) {
+        QTimer::singleShot(0, this, SLOT(fillNoteEditorWidgetsPool()));
+    }
+}
+
+void NoteEditorTabsAndWindowsCoordinator::trackPendingNoteSave(NoteEditorWidget * pNoteEditorWidget)
+{
+    if (!pNoteEditorWidget->isSavingNote()) {
+        return;
+    }
+
+    QNTRACE(QStringLiteral("Tracking the pending save of note ") << pNoteEditorWidget->noteLocalUid());
+
+    Q_UNUSED(m_noteEditorWidgetsWithPendingSave.insert(pNoteEditorWidget))
+
+    QObject::connect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,noteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString),
+                     this, QNSLOT(NoteEditorTabsAndWindowsCoordinator,onPendingNoteSaveFinished), Qt::UniqueConnection);
+    QObject::connect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,destroyed,QObject*),
+                     this, QNSLOT(NoteEditorTabsAndWindowsCoordinator,onNoteEditorWidgetWithPendingSaveDestroyed,QObject*),
+                     Qt::UniqueConnection);
+}
+
+void NoteEditorTabsAndWindowsCoordinator::waitForPendingNoteSaves()
+{
+    for(auto it = m_noteEditorWidgetsWithPendingSave.begin(); it != m_noteEditorWidgetsWithPendingSave.end(); )
+    {
+        NoteEditorWidget * pNoteEditorWidget = qobject_cast<NoteEditorWidget*>(*it);
+        if (!pNoteEditorWidget || !pNoteEditorWidget->isSavingNote()) {
+            it = m_noteEditorWidgetsWithPendingSave.erase(it);
+            continue;
+        }
+
+        ++it;
+    }
+
+    if (m_noteEditorWidgetsWithPendingSave.isEmpty()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::waitForPendingNoteSaves: ")
+            << m_noteEditorWidgetsWithPendingSave.size() << QStringLiteral(" notes are being saved"));
+
+    // NOTE: each save is bounded by the deadline of its own note editor widget's conversion to note but the writing
+    // of the note to the local storage is not, hence the overall timeout
+    int eventLoopResult = -1;
+    {
+        QTimer timer;
+        timer.setInterval(PENDING_NOTE_SAVES_TIMEOUT_MSEC);
+        timer.setSingleShot(true);
+
+        EventLoopWithExitStatus eventLoop;
+        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &eventLoop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
+
+        m_pPendingNoteSavesEventLoop = &eventLoop;
+        timer.start();
+        eventLoopResult = eventLoop.exec(QEventLoop::ExcludeUserInputEvents);
+        m_pPendingNoteSavesEventLoop = Q_NULLPTR;
+    }
+
+    if (eventLoopResult != EventLoopWithExitStatus::ExitStatus::Timeout) {
+        QNDEBUG(QStringLiteral("All pending note saves are finished"));
+        return;
+    }
+
+    QStringList unsavedNoteTitles;
+    for(auto it = m_noteEditorWidgetsWithPendingSave.constBegin(),
+        end = m_noteEditorWidgetsWithPendingSave.constEnd(); it != end; ++it)
+    {
+        NoteEditorWidget * pNoteEditorWidget = qobject_cast<NoteEditorWidget*>(*it);
+        if (!pNoteEditorWidget) {
+            continue;
+        }
+
+        QString titleOrPreview = pNoteEditorWidget->titleOrPreview();
+        unsavedNoteTitles << (titleOrPreview.isEmpty() ? pNoteEditorWidget->noteLocalUid() : titleOrPreview);
+    }
+
+    // NOTE: the widgets still saving their notes are left alone, they delete themselves once the save is over;
+    // they are no longer waited for though
+    m_noteEditorWidgetsWithPendingSave.clear();
+
+    ErrorString error(QT_TR_NOOP("Some notes could not be saved in time"));
+    error.details() = unsavedNoteTitles.join(QStringLiteral(", "));
+    QNWARNING(error);
+    Q_EMIT notifyError(error);
+}
+
 void NoteEditorTabsAndWindowsCoordinator::checkAndCloseOlderNoteEditorTabs()
 {
     for(int i = 0; i < m_pTabWidget->count(); ++i)
@@ -1681,19 +2106,37 @@ void NoteEditorTabsAndWindowsCoordinator::persistLocalUidsOfNotesInEditorTabs()
 {
     QNDEBUG("NoteEditorTabsAndWindowsCoordinator::persistLocalUidsOfNotesInEditorTabs");
 
+    // The titles or previews of notes are persisted as well so that the tabs restored without loading their notes
+    // are named properly; the full titles are persisted rather than the shortened tab texts as the hibernated
+    // note editors report them as their titles
+    QHash<QString, QString> tabNamesByNoteLocalUid;
+    for(int i = 0, count = m_pTabWidget->count(); i < count; ++i)
+    {
+        NoteEditorWidget * pNoteEditorWidget = qobject_cast<NoteEditorWidget*>(m_pTabWidget->widget(i));
+        if (Q_UNLIKELY(!pNoteEditorWidget)) {
+            continue;
+        }
+
+        tabNamesByNoteLocalUid[pNoteEditorWidget->noteLocalUid()] = pNoteEditorWidget->titleOrPreview();
+    }
+
     QStringList openNotesLocalUids;
+    QStringList openNotesTabNames;
     size_t size = m_localUidsOfNotesInTabbedEditors.size();
     openNotesLocalUids.reserve(static_cast<int>(size));
+    openNotesTabNames.reserve(static_cast<int>(size));
 
     for(auto it = m_localUidsOfNotesInTabbedEditors.begin(),
         end = m_localUidsOfNotesInTabbedEditors.end(); it != end; ++it)
     {
         openNotesLocalUids << *it;
+        openNotesTabNames << tabNamesByNoteLocalUid.value(*it);
     }
 
     ApplicationSettings appSettings(m_currentAccount, QUENTIER_UI_SETTINGS);
     appSettings.beginGroup(NOTE_EDITOR_SETTINGS_GROUP_NAME);
     appSettings.setValue(OPEN_NOTES_LOCAL_UIDS_IN_TABS_SETTINGS_KEY, openNotesLocalUids);
+    appSettings.setValue(OPEN_NOTES_TAB_NAMES_SETTINGS_KEY, openNotesTabNames);
     appSettings.endGroup();
 }
 
@@ -1740,6 +2183,8 @@ void NoteEditorTabsAndWindowsCoordinator::restoreLastOpenNotes()
 
     QStringList localUidsOfLastNotesInTabs =
             appSettings.value(OPEN_NOTES_LOCAL_UIDS_IN_TABS_SETTINGS_KEY).toStringList();
+    QStringList tabNamesOfLastNotesInTabs =
+            appSettings.value(OPEN_NOTES_TAB_NAMES_SETTINGS_KEY).toStringList();
     QStringList localUidsOfLastNotesInWindows =
             appSettings.value(OPEN_NOTES_LOCAL_UIDS_IN_WINDOWS_SETTINGS_KEY).toStringList();
 
@@ -1748,10 +2193,37 @@ void NoteEditorTabsAndWindowsCoordinator::restoreLastOpenNotes()
 
     appSettings.endGroup();
 
+    // Only the note of the last current tab is loaded right away; the rest of tabs are inserted with hibernated
+    // note editors which load their notes once their tabs become current
+    QString currentTabNoteLocalUid = m_lastCurrentTabNoteLocalUid;
+    if (!localUidsOfLastNotesInTabs.contains(currentTabNoteLocalUid) && !localUidsOfLastNotesInTabs.isEmpty()) {
+        currentTabNoteLocalUid = localUidsOfLastNotesInTabs.last();
+    }
+
     m_trackingCurrentTab = false;
 
-    for(auto it = localUidsOfLastNotesInTabs.constBegin(), end = localUidsOfLastNotesInTabs.constEnd(); it != end; ++it) {
-        addNote(*it, NoteEditorMode::Tab);
+    for(int i = 0, numTabs = localUidsOfLastNotesInTabs.size(); i < numTabs; ++i)
+    {
+        const QString & noteLocalUid = localUidsOfLastNotesInTabs[i];
+        if (noteLocalUid == currentTabNoteLocalUid) {
+            addNote(noteLocalUid, NoteEditorMode::Tab);
+            continue;
+        }
+
+        NoteEditorWidget * pNoteEditorWidget = Q_NULLPTR;
+        if (m_pBlankNoteEditor) {
+            pNoteEditorWidget = m_pBlankNoteEditor;
+            m_pBlankNoteEditor = Q_NULLPTR;
+        }
+        else {
+            pNoteEditorWidget = takeNoteEditorWidgetFromPool();
+        }
+
+        QString tabName = ((i < tabNamesOfLastNotesInTabs.size())
+                           ? tabNamesOfLastNotesInTabs[i]
+                           : QString());
+        pNoteEditorWidget->setHibernatedNoteLocalUid(noteLocalUid, tabName);
+        insertNoteEditorWidget(pNoteEditorWidget, NoteEditorMode::Tab);
     }
 
     for(auto it = localUidsOfLastNotesInWindows.constBegin(), end = localUidsOfLastNotesInWindows.constEnd(); it != end; ++it) {
@@ -1787,6 +2259,12 @@ void NoteEditorTabsAndWindowsCoordinator::restoreLastOpenNotes()
         }
     }
 
+    // The current tab might have not changed after the restoring so its note editor needs to be woken up explicitly
+    NoteEditorWidget * pCurrentNoteEditorWidget = qobject_cast<NoteEditorWidget*>(m_pTabWidget->currentWidget());
+    if (pCurrentNoteEditorWidget) {
+        pCurrentNoteEditorWidget->wakeUp();
+    }
+
     return;
 }
 
@@ -1887,13 +2365,25 @@ void NoteEditorTabsAndWindowsCoordinator::expungeNoteSynchronously(const QString
     }
 }
 
+bool NoteEditorTabsAndWindowsCoordinator::isNoteOpen(const QString & noteLocalUid) const
+{
+    if (std::find(m_localUidsOfNotesInTabbedEditors.begin(), m_localUidsOfNotesInTabbedEditors.end(),
+                  noteLocalUid) != m_localUidsOfNotesInTabbedEditors.end())
+    {
+        return true;
+    }
+
+    return m_noteEditorWindowsByNoteLocalUid.contains(noteLocalUid);
+}
+
 void NoteEditorTabsAndWindowsCoordinator::checkPendingRequestsAndDisconnectFromLocalStorage()
 {
     QNDEBUG(QStringLiteral("NoteEditorTabsAndWindowsCoordinator::checkPendingRequestsAndDisconnectFromLocalStorage"));
 
     if (m_noteEditorModeByCreateNoteRequestIds.empty() &&
         m_expungeNoteRequestIds.isEmpty() &&
-        m_inAppNoteLinkFindNoteRequestIds.isEmpty())
+        m_inAppNoteLinkFindNoteRequestIds.isEmpty() &&
+        m_prefetchNoteRequestId.isNull())
     {
         disconnectFromLocalStorage();
     }
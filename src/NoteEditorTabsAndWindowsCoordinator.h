@@ -31,6 +31,8 @@
 #include <QMap>
 #include <QPointer>
 #include <QUuid>
+#include <QStringList>
+#include <QList>
 
 // NOTE: Workaround a bug in Qt4 which may prevent building with some boost versions
 #ifndef Q_MOC_RUN
@@ -51,6 +53,7 @@ QT_FORWARD_DECLARE_CLASS(NoteEditorWidget)
 QT_FORWARD_DECLARE_CLASS(TabWidget)
 QT_FORWARD_DECLARE_CLASS(FileIOProcessorAsync)
 QT_FORWARD_DECLARE_CLASS(SpellChecker)
+QT_FORWARD_DECLARE_CLASS(EventLoopWithExitStatus)
 
 class NoteEditorTabsAndWindowsCoordinator: public QObject
 {
@@ -92,6 +95,13 @@ public:
 
     void setUseLimitedFonts(const bool flag);
 
+    /**
+     * @brief prefetchNotes - loads the notes which are likely to be opened next into the note cache
+     * in background, one note at a time, so that opening them doesn't have to wait for the local storage;
+     * the notes from the previous call not prefetched yet are no longer prefetched
+     */
+    void prefetchNotes(const QStringList & noteLocalUids);
+
     void refreshNoteEditorWidgetsSpecialIcons();
 
 Q_SIGNALS:
@@ -99,6 +109,9 @@ Q_SIGNALS:
 
     void currentNoteChanged(QString noteLocalUid);
 
+    void noteRenderingToPdfStarted(QString noteLocalUid);
+    void noteRenderingToPdfFinished(QString noteLocalUid);
+
     // private signals
     void requestAddNote(Note note, QUuid requestId);
     void requestExpungeNote(Note note, QUuid requestId);
@@ -117,6 +130,8 @@ private Q_SLOTS:
 
     void onNoteLoadedInEditor();
     void onNoteEditorError(ErrorString errorDescription);
+    void onNoteEditorRenderingToPdfStarted();
+    void onNoteEditorRenderingToPdfFinished();
 
     void onAddNoteComplete(Note note, QUuid requestId);
     void onAddNoteFailed(Note note, ErrorString errorDescription, QUuid requestId);
@@ -136,6 +151,13 @@ private Q_SLOTS:
 
     void expungeNoteFromLocalStorage();
 
+    void prefetchNextNote();
+
+    void fillNoteEditorWidgetsPool();
+
+    void onPendingNoteSaveFinished();
+    void onNoteEditorWidgetWithPendingSaveDestroyed(QObject * pObject);
+
 private:
     virtual bool eventFilter(QObject * pWatched, QEvent * pEvent) Q_DECL_OVERRIDE;
     virtual void timerEvent(QTimerEvent * pTimerEvent) Q_DECL_OVERRIDE;
@@ -144,7 +166,23 @@ private:
     void insertNoteEditorWidget(NoteEditorWidget * pNoteEditorWidget, const NoteEditorMode::type noteEditorMode);
 
     void removeNoteEditorTab(int tabIndex, const bool closeEditor);
+
+    // The note editors are closed without waiting for their notes to be saved: the editor is deleted once its save
+    // is finished; the pending saves are waited for only when all editors are closed at once
+    void deleteNoteEditorWidgetAfterSave(NoteEditorWidget * pNoteEditorWidget);
+
+    // A few note editor widgets are kept constructed and connected to the local storage so that opening a note
+    // doesn't have to wait for the construction of the widget; the editors of closed tabs are reused
+    NoteEditorWidget * takeNoteEditorWidgetFromPool();
+    bool returnNoteEditorWidgetToPool(NoteEditorWidget * pNoteEditorWidget);
+    void clearNoteEditorWidgetsPool();
+    void trackPendingNoteSave(NoteEditorWidget * pNoteEditorWidget);
+    void waitForPendingNoteSaves();
     void checkAndCloseOlderNoteEditorTabs();
+
+    // The tabs other than the current one are hibernated in the order of their last activation
+    // once the estimated memory usage of note editor tabs exceeds the limit
+    void checkAndHibernateNoteEditorTabs();
     void setCurrentNoteEditorWidgetTab(const QString & noteLocalUid);
 
     void scheduleNoteEditorWindowGeometrySave(const QString & noteLocalUid);
@@ -174,6 +212,8 @@ private:
 
     void checkPendingRequestsAndDisconnectFromLocalStorage();
 
+    bool isNoteOpen(const QString & noteLocalUid) const;
+
 private:
     Account                             m_currentAccount;
     LocalStorageManagerAsync &          m_localStorageManagerAsync;
@@ -192,6 +232,10 @@ private:
     bool                                m_connectedToLocalStorage;
 
     int                                 m_maxNumNotesInTabs;
+    qint64                              m_maxNoteEditorTabsMemoryUsage;
+
+    // The least recently activated tabs go first
+    QStringList                         m_noteLocalUidsOfTabsByActivation;
 
     boost::circular_buffer<QString>     m_localUidsOfNotesInTabbedEditors;
     QString                             m_lastCurrentTabNoteLocalUid;
@@ -206,6 +250,18 @@ private:
     QSet<QUuid>                         m_expungeNoteRequestIds;
     QSet<QUuid>                         m_inAppNoteLinkFindNoteRequestIds;
 
+    QStringList                         m_noteLocalUidsToPrefetch;
+    QUuid                               m_prefetchNoteRequestId;
+    QTimer *                            m_pPrefetchNotesTimer;
+
+    QList<QPointer<NoteEditorWidget> >  m_noteEditorWidgetsPool;
+
+    // The pool is not refilled after the editors are cleared until an editor is needed again, i.e. for another account
+    bool                                m_noteEditorWidgetsPoolFillingSuspended;
+
+    QSet<QObject*>                      m_noteEditorWidgetsWithPendingSave;
+    EventLoopWithExitStatus *           m_pPendingNoteSavesEventLoop;
+
     QMenu *                             m_pTabBarContextMenu;
 
     QString                             m_localUidOfNoteToBeExpunged;
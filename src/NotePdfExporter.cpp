@@ -0,0 +1,422 @@
+#include "NotePdfExporter.h"
+#include "NotePdfRendererAsync.h"
+#include "NoteEditorTabsAndWindowsCoordinator.h"
+#include "CancellationFlag.h"
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QPrinter>
+#include <QDir>
+#include <QFileInfo>
+#include <QRegExp>
+#include <QThread>
+#include <algorithm>
+
+// The limit on the number of notes fetched from the local storage but not yet rendered (per rendering thread)
+#define NOTE_PDF_EXPORTER_MAX_PENDING_NOTES_PER_THREAD (2)
+
+#define NOTE_PDF_EXPORTER_MAX_FILE_NAME_SIZE (60)
+
+namespace quentier {
+
+NotePdfExporter::NotePdfExporter(LocalStorageManagerAsync & localStorageManagerAsync,
+                                 NoteEditorTabsAndWindowsCoordinator * pCoordinator,
+                                 QObject * parent) :
+    QObject(parent),
+    m_localStorageManagerAsync(localStorageManagerAsync),
+    m_pNoteEditorTabsAndWindowsCoordinator(pCoordinator),
+    m_targetDirPath(),
+    m_noteLocalUids(),
+    m_inProgress(false),
+    m_noteLocalUidsPendingSave(),
+    m_nextNoteToFindIndex(0),
+    m_noteIndexByFindNoteRequestId(),
+    m_noteIndicesPendingRender(),
+    m_renderNotesRequestId(),
+    m_pRenderNotesCanceled(),
+    m_rendererThreadPool(),
+    m_pdfFilePathsByNoteIndex(),
+    m_usedPdfFileNames(),
+    m_numRenderedNotes(0),
+    m_connectedToLocalStorage(false)
+{
+    m_rendererThreadPool.setMaxThreadCount(std::max(QThread::idealThreadCount(), 1));
+}
+
+NotePdfExporter::~NotePdfExporter()
+{
+    cancel();
+}
+
+void NotePdfExporter::setNoteLocalUids(const QStringList & noteLocalUids)
+{
+    QNDEBUG(QStringLiteral("NotePdfExporter::setNoteLocalUids: ")
+            << noteLocalUids.join(QStringLiteral(", ")));
+
+    if (isInProgress()) {
+        clear();
+    }
+
+    m_noteLocalUids = noteLocalUids;
+}
+
+bool NotePdfExporter::isInProgress() const
+{
+    return m_inProgress;
+}
+
+void NotePdfExporter::start()
+{
+    QNDEBUG(QStringLiteral("NotePdfExporter::start"));
+
+    if (m_noteLocalUids.isEmpty()) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't export notes to pdf: no note local uids were specified"));
+        QNWARNING(errorDescription);
+        Q_EMIT failedToExportNotesToPdf(errorDescription);
+        return;
+    }
+
+    QFileInfo targetDirInfo(m_targetDirPath);
+    if (m_targetDirPath.isEmpty() || !targetDirInfo.isDir() || !targetDirInfo.isWritable()) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't export notes to pdf: the target folder is not writable"));
+        errorDescription.details() = m_targetDirPath;
+        QNWARNING(errorDescription);
+        Q_EMIT failedToExportNotesToPdf(errorDescription);
+        return;
+    }
+
+    cancel();
+
+    m_inProgress = true;
+    m_renderNotesRequestId = QUuid::createUuid();
+    m_pRenderNotesCanceled = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+
+    // The modifications of notes within the editors need to get to the local storage before the notes are fetched
+    if (!m_pNoteEditorTabsAndWindowsCoordinator.isNull())
+    {
+        for(auto it = m_noteLocalUids.constBegin(), end = m_noteLocalUids.constEnd(); it != end; ++it)
+        {
+            NoteEditorWidget * pNoteEditorWidget = m_pNoteEditorTabsAndWindowsCoordinator->noteEditorWidgetForNoteLocalUid(*it);
+            if (!pNoteEditorWidget || !pNoteEditorWidget->isModified()) {
+                continue;
+            }
+
+            if (!pNoteEditorWidget->isSavingNote() && !pNoteEditorWidget->saveModifiedNoteAsync()) {
+                continue;
+            }
+
+            Q_UNUSED(m_noteLocalUidsPendingSave.insert(*it))
+            QObject::connect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,noteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString),
+                             this, QNSLOT(NotePdfExporter,onNoteEditorNoteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString),
+                             Qt::UniqueConnection);
+        }
+    }
+
+    if (!m_noteLocalUidsPendingSave.isEmpty()) {
+        QNDEBUG(QStringLiteral("Waiting for ") << m_noteLocalUidsPendingSave.size()
+                << QStringLiteral(" modified notes to be saved within the editors"));
+        return;
+    }
+
+    findNotesInLocalStorage();
+}
+
+void NotePdfExporter::cancel()
+{
+    if (m_inProgress) {
+        QNDEBUG(QStringLiteral("NotePdfExporter::cancel"));
+    }
+
+    if (!m_pRenderNotesCanceled.isNull()) {
+        setCanceled(*m_pRenderNotesCanceled);
+        m_pRenderNotesCanceled.clear();
+    }
+
+    resetExportState();
+}
+
+void NotePdfExporter::resetExportState()
+{
+    if (!m_pNoteEditorTabsAndWindowsCoordinator.isNull())
+    {
+        for(auto it = m_noteLocalUidsPendingSave.constBegin(), end = m_noteLocalUidsPendingSave.constEnd(); it != end; ++it)
+        {
+            NoteEditorWidget * pNoteEditorWidget = m_pNoteEditorTabsAndWindowsCoordinator->noteEditorWidgetForNoteLocalUid(*it);
+            if (pNoteEditorWidget) {
+                QObject::disconnect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,noteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString),
+                                    this, QNSLOT(NotePdfExporter,onNoteEditorNoteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString));
+            }
+        }
+    }
+
+    m_noteLocalUidsPendingSave.clear();
+    m_inProgress = false;
+    m_nextNoteToFindIndex = 0;
+    m_noteIndexByFindNoteRequestId.clear();
+    m_noteIndicesPendingRender.clear();
+    m_renderNotesRequestId = QUuid();
+    m_pdfFilePathsByNoteIndex.clear();
+    m_usedPdfFileNames.clear();
+    m_numRenderedNotes = 0;
+}
+
+void NotePdfExporter::clear()
+{
+    QNDEBUG(QStringLiteral("NotePdfExporter::clear"));
+
+    cancel();
+
+    m_targetDirPath.clear();
+    m_noteLocalUids.clear();
+
+    disconnectFromLocalStorage();
+}
+
+void NotePdfExporter::onNoteEditorNoteSaveFinished(NoteEditorWidget::NoteSaveStatus::type status,
+                                                   ErrorString errorDescription)
+{
+    NoteEditorWidget * pNoteEditorWidget = qobject_cast<NoteEditorWidget*>(sender());
+    if (Q_UNLIKELY(!pNoteEditorWidget)) {
+        return;
+    }
+
+    QObject::disconnect(pNoteEditorWidget, QNSIGNAL(NoteEditorWidget,noteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString),
+                        this, QNSLOT(NotePdfExporter,onNoteEditorNoteSaveFinished,NoteEditorWidget::NoteSaveStatus::type,ErrorString));
+
+    QString noteLocalUid = pNoteEditorWidget->noteLocalUid();
+    if (!m_noteLocalUidsPendingSave.remove(noteLocalUid)) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NotePdfExporter::onNoteEditorNoteSaveFinished: note local uid = ") << noteLocalUid
+            << QStringLiteral(", status = ") << status << QStringLiteral(", error: ") << errorDescription);
+
+    if (status != NoteEditorWidget::NoteSaveStatus::Ok) {
+        QNWARNING(QStringLiteral("Could not save the note loaded into the editor; will export the last saved version "
+                                 "of the note ") << noteLocalUid);
+    }
+
+    if (m_noteLocalUidsPendingSave.isEmpty() && m_inProgress) {
+        findNotesInLocalStorage();
+    }
+}
+
+void NotePdfExporter::onFindNoteComplete(Note note, bool withResourceBinaryData, QUuid requestId)
+{
+    auto it = m_noteIndexByFindNoteRequestId.find(requestId);
+    if (it == m_noteIndexByFindNoteRequestId.end()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NotePdfExporter::onFindNoteComplete: request id = ")
+            << requestId << QStringLiteral(", note local uid: ") << note.localUid());
+
+    Q_UNUSED(withResourceBinaryData)
+
+    int noteIndex = it.value();
+    Q_UNUSED(m_noteIndexByFindNoteRequestId.erase(it))
+
+    renderNote(note, noteIndex);
+}
+
+void NotePdfExporter::onFindNoteFailed(Note note, bool withResourceBinaryData,
+                                       ErrorString errorDescription, QUuid requestId)
+{
+    auto it = m_noteIndexByFindNoteRequestId.find(requestId);
+    if (it == m_noteIndexByFindNoteRequestId.end()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NotePdfExporter::onFindNoteFailed: request id = ")
+            << requestId << QStringLiteral(", error: ") << errorDescription
+            << QStringLiteral(", note: ") << note);
+
+    Q_UNUSED(withResourceBinaryData)
+
+    ErrorString error(QT_TR_NOOP("Can't export notes to pdf: can't find one of notes in the local storage"));
+    error.appendBase(errorDescription.base());
+    error.appendBase(errorDescription.additionalBases());
+    error.details() = errorDescription.details();
+    QNWARNING(error);
+
+    failExport(error);
+}
+
+void NotePdfExporter::onNoteRendered(int noteIndex, QUuid requestId)
+{
+    if (requestId != m_renderNotesRequestId) {
+        return;
+    }
+
+    QNTRACE(QStringLiteral("NotePdfExporter::onNoteRendered: note index = ") << noteIndex);
+
+    Q_UNUSED(m_noteIndicesPendingRender.remove(noteIndex))
+    ++m_numRenderedNotes;
+
+    int numNotes = m_noteLocalUids.size();
+    Q_EMIT notesExportToPdfProgress(m_numRenderedNotes, numNotes);
+
+    if (m_numRenderedNotes < numNotes) {
+        findNotesInLocalStorage();
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("All notes have been exported to pdf"));
+
+    QStringList pdfFilePaths = m_pdfFilePathsByNoteIndex.values();
+    resetExportState();
+    Q_EMIT notesExportedToPdf(pdfFilePaths);
+}
+
+void NotePdfExporter::onNoteRenderingFailed(ErrorString errorDescription, int noteIndex, QUuid requestId)
+{
+    if (requestId != m_renderNotesRequestId) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("NotePdfExporter::onNoteRenderingFailed: note index = ") << noteIndex
+              << QStringLiteral(", error: ") << errorDescription);
+
+    ErrorString error(QT_TR_NOOP("Can't export notes to pdf"));
+    error.appendBase(errorDescription.base());
+    error.appendBase(errorDescription.additionalBases());
+    error.details() = errorDescription.details();
+    failExport(error);
+}
+
+void NotePdfExporter::findNotesInLocalStorage()
+{
+    // The notes are being rendered in parallel so there should be enough of them to keep all the rendering threads busy
+    int maxPendingNotes = std::max(m_rendererThreadPool.maxThreadCount(), 1) * NOTE_PDF_EXPORTER_MAX_PENDING_NOTES_PER_THREAD;
+
+    while(m_nextNoteToFindIndex < m_noteLocalUids.size())
+    {
+        if (m_noteIndicesPendingRender.size() >= maxPendingNotes) {
+            QNTRACE(QStringLiteral("Too many notes are pending render, won't find more notes for now"));
+            return;
+        }
+
+        int noteIndex = m_nextNoteToFindIndex;
+        const QString & noteLocalUid = m_noteLocalUids.at(noteIndex);
+        QNDEBUG(QStringLiteral("NotePdfExporter::findNotesInLocalStorage: ") << noteLocalUid);
+
+        Note dummyNote;
+        dummyNote.setLocalUid(noteLocalUid);
+
+        QUuid requestId = QUuid::createUuid();
+        m_noteIndexByFindNoteRequestId[requestId] = noteIndex;
+        Q_UNUSED(m_noteIndicesPendingRender.insert(noteIndex))
+        ++m_nextNoteToFindIndex;
+
+        connectToLocalStorage();
+
+        QNTRACE(QStringLiteral("Emitting the request to find note in the local storage: note local uid = ")
+                << noteLocalUid << QStringLiteral(", request id = ") << requestId);
+        Q_EMIT findNote(dummyNote, /* with resource binary data */ true, requestId);
+    }
+}
+
+void NotePdfExporter::renderNote(const Note & note, const int noteIndex)
+{
+    QNDEBUG(QStringLiteral("NotePdfExporter::renderNote: note index = ") << noteIndex);
+
+    if (!m_inProgress || m_pRenderNotesCanceled.isNull()) {
+        QNDEBUG(QStringLiteral("The export is not in progress"));
+        return;
+    }
+
+    QString pdfFilePath = pdfFilePathForNote(note);
+    m_pdfFilePathsByNoteIndex[noteIndex] = pdfFilePath;
+
+    // The printer is set up within the GUI thread and handed over to the renderer
+    QPrinter * pPrinter = new QPrinter(QPrinter::HighResolution);
+    pPrinter->setOutputFormat(QPrinter::PdfFormat);
+    pPrinter->setOutputFileName(pdfFilePath);
+
+    NotePdfRendererAsync * pRenderer = new NotePdfRendererAsync(note, pPrinter, noteIndex, m_renderNotesRequestId,
+                                                                m_pRenderNotesCanceled);
+    QObject::connect(pRenderer, QNSIGNAL(NotePdfRendererAsync,noteRendered,int,QUuid),
+                     this, QNSLOT(NotePdfExporter,onNoteRendered,int,QUuid),
+                     Qt::QueuedConnection);
+    QObject::connect(pRenderer, QNSIGNAL(NotePdfRendererAsync,failed,ErrorString,int,QUuid),
+                     this, QNSLOT(NotePdfExporter,onNoteRenderingFailed,ErrorString,int,QUuid),
+                     Qt::QueuedConnection);
+    m_rendererThreadPool.start(pRenderer);
+}
+
+QString NotePdfExporter::pdfFilePathForNote(const Note & note)
+{
+    QString baseName;
+    if (note.hasTitle()) {
+        baseName = note.title();
+    }
+    else if (note.hasContent()) {
+        baseName = note.plainText();
+    }
+
+    baseName = baseName.simplified();
+    baseName.replace(QRegExp(QStringLiteral("[\\\\/:*?\"<>|]")), QStringLiteral("_"));
+    baseName.truncate(NOTE_PDF_EXPORTER_MAX_FILE_NAME_SIZE);
+    baseName = baseName.trimmed();
+
+    if (baseName.isEmpty()) {
+        baseName = tr("Note");
+    }
+
+    // Neither the existing files nor the files of other exported notes with the same title are overwritten
+    QDir targetDir(m_targetDirPath);
+    QString fileName = baseName + QStringLiteral(".pdf");
+    for(int i = 2; m_usedPdfFileNames.contains(fileName.toLower()) || targetDir.exists(fileName); ++i) {
+        fileName = baseName + QStringLiteral(" (") + QString::number(i) + QStringLiteral(").pdf");
+    }
+
+    Q_UNUSED(m_usedPdfFileNames.insert(fileName.toLower()))
+    return targetDir.absoluteFilePath(fileName);
+}
+
+void NotePdfExporter::failExport(const ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NotePdfExporter::failExport: ") << errorDescription);
+
+    cancel();
+    Q_EMIT failedToExportNotesToPdf(errorDescription);
+}
+
+void NotePdfExporter::connectToLocalStorage()
+{
+    QNDEBUG(QStringLiteral("NotePdfExporter::connectToLocalStorage"));
+
+    if (m_connectedToLocalStorage) {
+        QNTRACE(QStringLiteral("Already connected to local storage"));
+        return;
+    }
+
+    QObject::connect(this, QNSIGNAL(NotePdfExporter,findNote,Note,bool,QUuid),
+                     &m_localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindNoteRequest,Note,bool,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNoteComplete,Note,bool,QUuid),
+                     this, QNSLOT(NotePdfExporter,onFindNoteComplete,Note,bool,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNoteFailed,Note,bool,ErrorString,QUuid),
+                     this, QNSLOT(NotePdfExporter,onFindNoteFailed,Note,bool,ErrorString,QUuid));
+
+    m_connectedToLocalStorage = true;
+}
+
+void NotePdfExporter::disconnectFromLocalStorage()
+{
+    QNDEBUG(QStringLiteral("NotePdfExporter::disconnectFromLocalStorage"));
+
+    if (!m_connectedToLocalStorage) {
+        QNTRACE(QStringLiteral("Not connected to local storage at the moment"));
+        return;
+    }
+
+    QObject::disconnect(this, QNSIGNAL(NotePdfExporter,findNote,Note,bool,QUuid),
+                        &m_localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindNoteRequest,Note,bool,QUuid));
+    QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNoteComplete,Note,bool,QUuid),
+                        this, QNSLOT(NotePdfExporter,onFindNoteComplete,Note,bool,QUuid));
+    QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNoteFailed,Note,bool,ErrorString,QUuid),
+                        this, QNSLOT(NotePdfExporter,onFindNoteFailed,Note,bool,ErrorString,QUuid));
+
+    m_connectedToLocalStorage = false;
+}
+
+} // namespace quentier
@@ -0,0 +1,120 @@
+#ifndef QUENTIER_NOTE_PDF_EXPORTER_H
+#define QUENTIER_NOTE_PDF_EXPORTER_H
+
+#include "widgets/NoteEditorWidget.h"
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Note.h>
+#include <QObject>
+#include <QStringList>
+#include <QSet>
+#include <QHash>
+#include <QMap>
+#include <QUuid>
+#include <QPointer>
+#include <QVector>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QThreadPool>
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(LocalStorageManagerAsync)
+QT_FORWARD_DECLARE_CLASS(NoteEditorTabsAndWindowsCoordinator)
+
+/**
+ * @brief The NotePdfExporter class exports notes to PDF files within the target directory, one file per note
+ * named after the note's title
+ *
+ * The notes are fetched from the local storage one after another and rendered by NotePdfRendererAsync within
+ * the exporter's thread pool as soon as they are fetched; the number of notes being fetched or rendered is limited.
+ * The modified notes within the note editors are saved before the export
+ */
+class NotePdfExporter: public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @param pCoordinator      The coordinator of note editors which might contain the modified notes to be saved
+     *                          before the export; if null, all notes are taken from the local storage as is
+     */
+    explicit NotePdfExporter(LocalStorageManagerAsync & localStorageManagerAsync,
+                             NoteEditorTabsAndWindowsCoordinator * pCoordinator,
+                             QObject * parent = Q_NULLPTR);
+    virtual ~NotePdfExporter();
+
+    const QString & targetDirPath() const { return m_targetDirPath; }
+    void setTargetDirPath(const QString & path) { m_targetDirPath = path; }
+
+    const QStringList & noteLocalUids() const { return m_noteLocalUids; }
+    void setNoteLocalUids(const QStringList & noteLocalUids);
+
+    bool isInProgress() const;
+    void start();
+
+    /**
+     * Stops the export in progress, if any; the partially written PDF file of the note being rendered is removed,
+     * the files of the notes already exported are kept
+     */
+    void cancel();
+
+    void clear();
+
+Q_SIGNALS:
+    void notesExportedToPdf(QStringList pdfFilePaths);
+    void failedToExportNotesToPdf(ErrorString errorDescription);
+    void notesExportToPdfProgress(int numExportedNotes, int numNotes);
+
+// private signals:
+    void findNote(Note note, bool withResourceBinaryData, QUuid requestId);
+
+private Q_SLOTS:
+    void onFindNoteComplete(Note note, bool withResourceBinaryData, QUuid requestId);
+    void onFindNoteFailed(Note note, bool withResourceBinaryData,
+                          ErrorString errorDescription, QUuid requestId);
+
+    void onNoteEditorNoteSaveFinished(NoteEditorWidget::NoteSaveStatus::type status, ErrorString errorDescription);
+
+    void onNoteRendered(int noteIndex, QUuid requestId);
+    void onNoteRenderingFailed(ErrorString errorDescription, int noteIndex, QUuid requestId);
+
+private:
+    void findNotesInLocalStorage();
+    void renderNote(const Note & note, const int noteIndex);
+    QString pdfFilePathForNote(const Note & note);
+    void failExport(const ErrorString & errorDescription);
+    void resetExportState();
+
+    void connectToLocalStorage();
+    void disconnectFromLocalStorage();
+
+private:
+    LocalStorageManagerAsync &              m_localStorageManagerAsync;
+    QPointer<NoteEditorTabsAndWindowsCoordinator>   m_pNoteEditorTabsAndWindowsCoordinator;
+    QString                                 m_targetDirPath;
+    QStringList                             m_noteLocalUids;
+
+    bool                                    m_inProgress;
+
+    // The notes are only fetched once the modified notes within the note editors are saved
+    QSet<QString>                           m_noteLocalUidsPendingSave;
+
+    // The notes are identified by their indices within the list of note local uids
+    int                                     m_nextNoteToFindIndex;
+    QHash<QUuid, int>                       m_noteIndexByFindNoteRequestId;
+    QSet<int>                               m_noteIndicesPendingRender;
+
+    QUuid                                   m_renderNotesRequestId;
+    QSharedPointer<QAtomicInt>              m_pRenderNotesCanceled;
+    QThreadPool                             m_rendererThreadPool;
+
+    QMap<int, QString>                      m_pdfFilePathsByNoteIndex;
+    QSet<QString>                           m_usedPdfFileNames;
+    int                                     m_numRenderedNotes;
+
+    bool                                    m_connectedToLocalStorage;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_NOTE_PDF_EXPORTER_H
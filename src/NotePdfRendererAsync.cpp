@@ -0,0 +1,277 @@
+#include "NotePdfRendererAsync.h"
+#include "CancellationFlag.h"
+#include <quentier/types/Resource.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QPrinter>
+#include <QPainter>
+#include <QTextDocument>
+#include <QImage>
+#include <QUrl>
+#include <QFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QCryptographicHash>
+#include <QList>
+
+// The rich text document is laid out at this resolution and scaled to the resolution of the printer when painted
+#define NOTE_PDF_RENDERER_DOCUMENT_DPI (96.0)
+
+#define NOTE_PDF_RENDERER_IMAGE_URL_PREFIX QStringLiteral("resource-")
+
+namespace quentier {
+
+NotePdfRendererAsync::NotePdfRendererAsync(const Note & note, QPrinter * pPrinter,
+                                           const int noteIndex, const QUuid & requestId,
+                                           const QSharedPointer<QAtomicInt> & pCanceled,
+                                           QObject * parent) :
+    QObject(parent),
+    QRunnable(),
+    m_note(note),
+    m_pPrinter(pPrinter),
+    m_noteIndex(noteIndex),
+    m_requestId(requestId),
+    m_pCanceled(pCanceled)
+{}
+
+NotePdfRendererAsync::~NotePdfRendererAsync()
+{}
+
+void NotePdfRendererAsync::run()
+{
+    if (isCanceled()) {
+        return;
+    }
+
+    QString noteTitle = (m_note.hasTitle() ? m_note.title() : QString());
+    QString noteContent = (m_note.hasContent() ? m_note.content() : QString());
+
+    QHash<QString, QImage> imagesByHash;
+    QHash<QString, QSize> imageSizesByHash;
+
+    QList<Resource> resources = m_note.resources();
+
+    // The note is no longer needed, free the memory taken by its resources' data as soon as the images are decoded
+    m_note = Note();
+
+    while(!resources.isEmpty())
+    {
+        Resource resource = resources.takeFirst();
+        if (!resource.hasMime() || !resource.mime().startsWith(QStringLiteral("image/")) || !resource.hasDataBody()) {
+            continue;
+        }
+
+        QImage image;
+        if (!image.loadFromData(resource.dataBody())) {
+            QNDEBUG(QStringLiteral("Can't decode the image resource of note ") << m_noteIndex
+                    << QStringLiteral(", mime type = ") << resource.mime());
+            continue;
+        }
+
+        QByteArray dataHash = (resource.hasDataHash()
+                               ? resource.dataHash()
+                               : QCryptographicHash::hash(resource.dataBody(), QCryptographicHash::Md5));
+        QString hash = QString::fromLocal8Bit(dataHash.toHex());
+        imagesByHash[hash] = image;
+        imageSizesByHash[hash] = image.size();
+    }
+
+    QPrinter & printer = *m_pPrinter;
+
+    // The document is laid out into pages of the printable area's size
+    QRectF printableRect = printer.pageRect(QPrinter::DevicePixel);
+    qreal scale = printer.resolution() / NOTE_PDF_RENDERER_DOCUMENT_DPI;
+    QSizeF pageSize(printableRect.width() / scale, printableRect.height() / scale);
+
+    QString html;
+    ErrorString errorDescription;
+    if (!noteContentToHtml(noteContent, noteTitle, imageSizesByHash, pageSize.width(), html, errorDescription)) {
+        QNWARNING(QStringLiteral("Failed to render the note ") << m_noteIndex << QStringLiteral(": ")
+                  << errorDescription);
+        Q_EMIT failed(errorDescription, m_noteIndex, m_requestId);
+        return;
+    }
+
+    noteContent.clear();
+
+    QTextDocument document;
+    document.setPageSize(pageSize);
+
+    for(auto it = imagesByHash.constBegin(), end = imagesByHash.constEnd(); it != end; ++it) {
+        document.addResource(QTextDocument::ImageResource, QUrl(NOTE_PDF_RENDERER_IMAGE_URL_PREFIX + it.key()),
+                             QVariant(it.value()));
+    }
+
+    imagesByHash.clear();
+
+    document.setHtml(html);
+    html.clear();
+
+    QPainter painter;
+    if (!painter.begin(&printer)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't render the note: can't start painting onto the printer"));
+        errorDescription.details() = printer.outputFileName();
+        QNWARNING(errorDescription);
+        Q_EMIT failed(errorDescription, m_noteIndex, m_requestId);
+        return;
+    }
+
+    painter.scale(scale, scale);
+
+    int numPages = document.pageCount();
+    for(int i = 0; i < numPages; ++i)
+    {
+        if (isCanceled())
+        {
+            QNDEBUG(QStringLiteral("The rendering of note ") << m_noteIndex << QStringLiteral(" was canceled"));
+            Q_UNUSED(printer.abort())
+            painter.end();
+
+            QString outputFilePath = printer.outputFileName();
+            if (!outputFilePath.isEmpty()) {
+                Q_UNUSED(QFile::remove(outputFilePath))
+            }
+
+            return;
+        }
+
+        if ((i > 0) && !printer.newPage()) {
+            errorDescription.setBase(QT_TR_NOOP("Can't render the note: can't start the new page"));
+            errorDescription.details() = printer.outputFileName();
+            QNWARNING(errorDescription);
+            painter.end();
+            Q_EMIT failed(errorDescription, m_noteIndex, m_requestId);
+            return;
+        }
+
+        painter.save();
+        painter.translate(0.0, -i * pageSize.height());
+        document.drawContents(&painter, QRectF(0.0, i * pageSize.height(), pageSize.width(), pageSize.height()));
+        painter.restore();
+    }
+
+    if (!painter.end()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't render the note: can't finish painting onto the printer"));
+        errorDescription.details() = printer.outputFileName();
+        QNWARNING(errorDescription);
+        Q_EMIT failed(errorDescription, m_noteIndex, m_requestId);
+        return;
+    }
+
+    // The PDF file is complete once the printer is gone
+    m_pPrinter.reset();
+
+    Q_EMIT noteRendered(m_noteIndex, m_requestId);
+}
+
+bool NotePdfRendererAsync::noteContentToHtml(const QString & noteContent, const QString & noteTitle,
+                                             const QHash<QString, QSize> & imageSizesByHash, const qreal maxImageWidth,
+                                             QString & html, ErrorString & errorDescription) const
+{
+    html.clear();
+
+    QXmlStreamWriter writer(&html);
+    writer.writeStartElement(QStringLiteral("html"));
+    writer.writeStartElement(QStringLiteral("body"));
+
+    if (!noteTitle.isEmpty()) {
+        writer.writeTextElement(QStringLiteral("h1"), noteTitle);
+    }
+
+    QXmlStreamReader reader(noteContent);
+    while(!reader.atEnd())
+    {
+        Q_UNUSED(reader.readNext())
+
+        if (reader.isStartElement())
+        {
+            QString elementName = reader.name().toString();
+
+            if (elementName == QStringLiteral("en-note")) {
+                writer.writeStartElement(QStringLiteral("div"));
+                writer.writeAttributes(reader.attributes());
+                continue;
+            }
+
+            if (elementName == QStringLiteral("en-media"))
+            {
+                QXmlStreamAttributes attributes = reader.attributes();
+                QString hash = attributes.value(QStringLiteral("hash")).toString();
+                QString type = attributes.value(QStringLiteral("type")).toString();
+
+                auto it = imageSizesByHash.find(hash);
+                if (it != imageSizesByHash.end())
+                {
+                    // The images wider than the page are scaled down to fit it
+                    QSizeF imageSize(it.value());
+                    if ((imageSize.width() > maxImageWidth) && (maxImageWidth > 0.0)) {
+                        imageSize.scale(maxImageWidth, imageSize.height(), Qt::KeepAspectRatio);
+                    }
+
+                    writer.writeStartElement(QStringLiteral("img"));
+                    writer.writeAttribute(QStringLiteral("src"), NOTE_PDF_RENDERER_IMAGE_URL_PREFIX + hash);
+                    writer.writeAttribute(QStringLiteral("width"), QString::number(qRound(imageSize.width())));
+                    writer.writeAttribute(QStringLiteral("height"), QString::number(qRound(imageSize.height())));
+                    writer.writeEndElement();
+                }
+                else
+                {
+                    writer.writeTextElement(QStringLiteral("i"), QStringLiteral("[") + tr("Attachment") +
+                                            QStringLiteral(": ") + type + QStringLiteral("]"));
+                }
+
+                reader.skipCurrentElement();
+                continue;
+            }
+
+            if (elementName == QStringLiteral("en-todo"))
+            {
+                bool checked = (reader.attributes().value(QStringLiteral("checked")).toString() == QStringLiteral("true"));
+                writer.writeCharacters(checked ? QString(QChar(0x2611)) : QString(QChar(0x2610)));
+                writer.writeCharacters(QStringLiteral(" "));
+                reader.skipCurrentElement();
+                continue;
+            }
+
+            if (elementName == QStringLiteral("en-crypt")) {
+                writer.writeTextElement(QStringLiteral("i"), QStringLiteral("[") + tr("Encrypted text") +
+                                        QStringLiteral("]"));
+                reader.skipCurrentElement();
+                continue;
+            }
+
+            writer.writeStartElement(elementName);
+            writer.writeAttributes(reader.attributes());
+        }
+        else if (reader.isEndElement())
+        {
+            writer.writeEndElement();
+        }
+        else if (reader.isCharacters())
+        {
+            writer.writeCharacters(reader.text().toString());
+        }
+        else if (reader.isEntityReference())
+        {
+            // The entities declared within ENML DTD are not resolved by the reader; the rich text document
+            // understands the HTML entities
+            writer.writeEntityReference(reader.name().toString());
+        }
+    }
+
+    if (reader.hasError()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't render the note: can't parse the note content"));
+        errorDescription.details() = reader.errorString();
+        return false;
+    }
+
+    writer.writeEndElement();
+    writer.writeEndElement();
+    return true;
+}
+
+bool NotePdfRendererAsync::isCanceled() const
+{
+    return quentier::isCanceled(*m_pCanceled);
+}
+
+} // namespace quentier
@@ -0,0 +1,68 @@
+#ifndef QUENTIER_NOTE_PDF_RENDERER_ASYNC_H
+#define QUENTIER_NOTE_PDF_RENDERER_ASYNC_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Note.h>
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <QHash>
+#include <QSize>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QUuid>
+
+QT_FORWARD_DECLARE_CLASS(QPrinter)
+
+namespace quentier {
+
+/**
+ * @brief The NotePdfRendererAsync class renders a single note onto the printer within the thread pool's thread:
+ * the note's ENML is converted to the rich text document along with the images among the note's resources
+ * and the document is painted page by page; the printer set up to the PDF output format produces the PDF file.
+ * Several renderers can run in parallel, the index of the note identifies the rendered note for the consumer
+ *
+ * The renderer takes the ownership of the printer which should be set up within the GUI thread; the rendering
+ * is checked for cancellation before each page
+ *
+ * NOTE: the rich text document is not the note editor's page so the rendered note is less faithful than the note
+ * shown in the editor: the editor's CSS is not applied, the encrypted text is replaced with a placeholder rather than
+ * shown as the editor's encrypted area, the non-image attachments are replaced with placeholders naming their mime
+ * types instead of the editor's generic resource widgets and the checkboxes are rendered as text symbols
+ */
+class NotePdfRendererAsync: public QObject,
+                            public QRunnable
+{
+    Q_OBJECT
+public:
+    explicit NotePdfRendererAsync(const Note & note, QPrinter * pPrinter,
+                                  const int noteIndex, const QUuid & requestId,
+                                  const QSharedPointer<QAtomicInt> & pCanceled,
+                                  QObject * parent = Q_NULLPTR);
+    virtual ~NotePdfRendererAsync();
+
+Q_SIGNALS:
+    void noteRendered(int noteIndex, QUuid requestId);
+    void failed(ErrorString errorDescription, int noteIndex, QUuid requestId);
+
+private:
+    virtual void run() Q_DECL_OVERRIDE;
+
+    bool noteContentToHtml(const QString & noteContent, const QString & noteTitle,
+                           const QHash<QString, QSize> & imageSizesByHash, const qreal maxImageWidth,
+                           QString & html, ErrorString & errorDescription) const;
+    bool isCanceled() const;
+
+private:
+    Note                        m_note;
+    QScopedPointer<QPrinter>    m_pPrinter;
+    int                         m_noteIndex;
+    QUuid                       m_requestId;
+    QSharedPointer<QAtomicInt>  m_pCanceled;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_NOTE_PDF_RENDERER_ASYNC_H
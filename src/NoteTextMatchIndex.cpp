@@ -0,0 +1,388 @@
+#include "NoteTextMatchIndex.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <QTimer>
+#include <QStringRef>
+#include <algorithm>
+
+// The number of characters of HTML converted to text and of text searched per event loop iteration
+#define NOTE_TEXT_MATCH_INDEX_CHUNK_SIZE (256 * 1024)
+
+// The entities longer than that are not decoded
+#define NOTE_TEXT_MATCH_INDEX_MAX_ENTITY_SIZE (10)
+
+namespace quentier {
+
+NoteTextMatchIndex::NoteTextMatchIndex(QObject * parent) :
+    QObject(parent),
+    m_html(),
+    m_htmlPosition(0),
+    m_text(),
+    m_insideTag(false),
+    m_currentTagName(),
+    m_collectingTagName(false),
+    m_skippedElementsDepth(0),
+    m_preformattedElementsDepth(0),
+    m_hasUndecodedEntities(false),
+    m_textToFind(),
+    m_matchCase(false),
+    m_searchPosition(0),
+    m_matchPositions(),
+    m_pScanTimer(new QTimer(this))
+{
+    m_pScanTimer->setInterval(0);
+    QObject::connect(m_pScanTimer, QNSIGNAL(QTimer,timeout),
+                     this, QNSLOT(NoteTextMatchIndex,onScanTimeout));
+}
+
+void NoteTextMatchIndex::setHtml(const QString & html)
+{
+    if (html == m_html) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NoteTextMatchIndex::setHtml: size = ") << html.size());
+
+    m_html = html;
+    m_htmlPosition = 0;
+    m_text.clear();
+    m_insideTag = false;
+    m_currentTagName.clear();
+    m_collectingTagName = false;
+    m_skippedElementsDepth = 0;
+    m_preformattedElementsDepth = 0;
+    m_hasUndecodedEntities = false;
+
+    if (!m_textToFind.isEmpty()) {
+        restartScan();
+    }
+}
+
+void NoteTextMatchIndex::search(const QString & textToFind, const bool matchCase)
+{
+    QNDEBUG(QStringLiteral("NoteTextMatchIndex::search: text to find = ") << textToFind
+            << QStringLiteral(", match case = ") << (matchCase ? QStringLiteral("true") : QStringLiteral("false")));
+
+    if (textToFind.isEmpty())
+    {
+        m_pScanTimer->stop();
+        m_textToFind.clear();
+        m_searchPosition = 0;
+        m_matchPositions.clear();
+        Q_EMIT matchCountChanged(0, true);
+        return;
+    }
+
+    if ((textToFind == m_textToFind) && (matchCase == m_matchCase)) {
+        QNTRACE(QStringLiteral("The search has not changed"));
+        Q_EMIT matchCountChanged(m_matchPositions.size(), isComplete());
+        return;
+    }
+
+    if (!canNarrowSearch(textToFind, matchCase)) {
+        m_textToFind = textToFind;
+        m_matchCase = matchCase;
+        restartScan();
+        return;
+    }
+
+    // The occurrences of the extended text are among the occurrences of the previous one; the matches can't overlap
+    Qt::CaseSensitivity caseSensitivity = (matchCase ? Qt::CaseSensitive : Qt::CaseInsensitive);
+    int textToFindSize = textToFind.size();
+    int numMatches = 0;
+    int lastMatchEnd = 0;
+
+    for(int i = 0, size = m_matchPositions.size(); i < size; ++i)
+    {
+        int position = m_matchPositions[i];
+        if (position < lastMatchEnd) {
+            continue;
+        }
+
+        if (m_text.midRef(position, textToFindSize).compare(textToFind, caseSensitivity) != 0) {
+            continue;
+        }
+
+        m_matchPositions[numMatches] = position;
+        ++numMatches;
+        lastMatchEnd = position + textToFindSize;
+    }
+
+    m_matchPositions.resize(numMatches);
+    m_textToFind = textToFind;
+
+    QNTRACE(QStringLiteral("Narrowed down the matches to ") << numMatches);
+    Q_EMIT matchCountChanged(numMatches, true);
+}
+
+void NoteTextMatchIndex::clear()
+{
+    QNDEBUG(QStringLiteral("NoteTextMatchIndex::clear"));
+
+    m_pScanTimer->stop();
+    setHtml(QString());
+    m_textToFind.clear();
+    m_searchPosition = 0;
+    m_matchPositions.clear();
+}
+
+bool NoteTextMatchIndex::isComplete() const
+{
+    return (m_htmlPosition >= m_html.size()) && (m_searchPosition > m_text.size() - m_textToFind.size());
+}
+
+bool NoteTextMatchIndex::matchesEditorSearch(const QString & textToFind) const
+{
+    if (m_hasUndecodedEntities) {
+        return false;
+    }
+
+    for(int i = 0, size = textToFind.size(); i < size; ++i)
+    {
+        if (textToFind.at(i).isSpace()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void NoteTextMatchIndex::onScanTimeout()
+{
+    if (m_htmlPosition < m_html.size()) {
+        extractTextChunk();
+    }
+
+    searchExtractedText();
+
+    bool complete = isComplete();
+    if (complete) {
+        QNTRACE(QStringLiteral("Finished searching the note's text: ") << m_matchPositions.size()
+                << QStringLiteral(" matches"));
+        m_pScanTimer->stop();
+    }
+
+    Q_EMIT matchCountChanged(m_matchPositions.size(), complete);
+}
+
+void NoteTextMatchIndex::restartScan()
+{
+    m_searchPosition = 0;
+    m_matchPositions.clear();
+    m_pScanTimer->start();
+}
+
+void NoteTextMatchIndex::extractTextChunk()
+{
+    int end = std::min(m_html.size(), m_htmlPosition + NOTE_TEXT_MATCH_INDEX_CHUNK_SIZE);
+    const QChar * pData = m_html.constData();
+
+    int i = m_htmlPosition;
+    while(i < end)
+    {
+        QChar c = pData[i];
+
+        if (m_insideTag)
+        {
+            if (c == QChar::fromLatin1('>')) {
+                m_insideTag = false;
+                finishTag();
+            }
+            else if (m_collectingTagName) {
+                if (c.isLetterOrNumber() || ((c == QChar::fromLatin1('/')) && m_currentTagName.isEmpty())) {
+                    m_currentTagName += c.toLower();
+                }
+                else {
+                    m_collectingTagName = false;
+                }
+            }
+
+            ++i;
+            continue;
+        }
+
+        if (c == QChar::fromLatin1('<')) {
+            m_insideTag = true;
+            m_collectingTagName = true;
+            m_currentTagName.clear();
+            ++i;
+            continue;
+        }
+
+        if (m_skippedElementsDepth > 0) {
+            ++i;
+            continue;
+        }
+
+        if (c == QChar::fromLatin1('&'))
+        {
+            int semicolonIndex = m_html.indexOf(QChar::fromLatin1(';'), i + 1);
+            if ((semicolonIndex > i + 1) && (semicolonIndex - i <= NOTE_TEXT_MATCH_INDEX_MAX_ENTITY_SIZE)) {
+                appendEntity(m_html.mid(i + 1, semicolonIndex - i - 1));
+                i = semicolonIndex + 1;
+                continue;
+            }
+        }
+
+        // The whitespace is collapsed the same way it is when the HTML is displayed, except for the preformatted text
+        if (c.isSpace() && (m_preformattedElementsDepth > 0))
+        {
+            if (c != QChar::fromLatin1('\r')) {
+                m_text += c;
+            }
+
+            ++i;
+            continue;
+        }
+
+        if (c.isSpace())
+        {
+            if (!m_text.isEmpty() && !m_text.endsWith(QChar::fromLatin1(' ')) &&
+                !m_text.endsWith(QChar::fromLatin1('\n')))
+            {
+                m_text += QChar::fromLatin1(' ');
+            }
+
+            ++i;
+            continue;
+        }
+
+        m_text += c;
+        ++i;
+    }
+
+    m_htmlPosition = i;
+}
+
+void NoteTextMatchIndex::finishTag()
+{
+    bool closingTag = m_currentTagName.startsWith(QChar::fromLatin1('/'));
+    QString tagName = (closingTag ? m_currentTagName.mid(1) : m_currentTagName);
+    m_currentTagName.clear();
+    m_collectingTagName = false;
+
+    // The contents of these elements are not displayed
+    if ((tagName == QStringLiteral("head")) || (tagName == QStringLiteral("script")) ||
+        (tagName == QStringLiteral("style")) || (tagName == QStringLiteral("title")))
+    {
+        m_skippedElementsDepth = (closingTag
+                                  ? std::max(m_skippedElementsDepth - 1, 0)
+                                  : (m_skippedElementsDepth + 1));
+        return;
+    }
+
+    if (tagName == QStringLiteral("pre")) {
+        m_preformattedElementsDepth = (closingTag
+                                       ? std::max(m_preformattedElementsDepth - 1, 0)
+                                       : (m_preformattedElementsDepth + 1));
+    }
+
+    // The text found within different blocks doesn't form a single match
+    if ((tagName == QStringLiteral("div")) || (tagName == QStringLiteral("p")) ||
+        (tagName == QStringLiteral("br")) || (tagName == QStringLiteral("li")) ||
+        (tagName == QStringLiteral("tr")) || (tagName == QStringLiteral("td")) ||
+        (tagName == QStringLiteral("hr")) || (tagName == QStringLiteral("pre")) ||
+        (tagName == QStringLiteral("blockquote")) ||
+        ((tagName.size() == 2) && tagName.startsWith(QChar::fromLatin1('h')) && tagName.at(1).isDigit()))
+    {
+        if (!m_text.isEmpty() && !m_text.endsWith(QChar::fromLatin1('\n')))
+        {
+            if (m_text.endsWith(QChar::fromLatin1(' '))) {
+                m_text.chop(1);
+            }
+
+            m_text += QChar::fromLatin1('\n');
+        }
+    }
+}
+
+void NoteTextMatchIndex::appendEntity(const QString & entityName)
+{
+    if (entityName == QStringLiteral("amp")) {
+        m_text += QChar::fromLatin1('&');
+    }
+    else if (entityName == QStringLiteral("lt")) {
+        m_text += QChar::fromLatin1('<');
+    }
+    else if (entityName == QStringLiteral("gt")) {
+        m_text += QChar::fromLatin1('>');
+    }
+    else if (entityName == QStringLiteral("quot")) {
+        m_text += QChar::fromLatin1('"');
+    }
+    else if (entityName == QStringLiteral("apos")) {
+        m_text += QChar::fromLatin1('\'');
+    }
+    else if (entityName == QStringLiteral("nbsp")) {
+        m_text += QChar::fromLatin1(' ');
+    }
+    else if (entityName.startsWith(QChar::fromLatin1('#')))
+    {
+        bool conversionResult = false;
+        uint code = ((entityName.size() > 1) && (entityName.at(1).toLower() == QChar::fromLatin1('x'))
+                     ? entityName.mid(2).toUInt(&conversionResult, 16)
+                     : entityName.mid(1).toUInt(&conversionResult, 10));
+        if (conversionResult) {
+            m_text += QString::fromUcs4(&code, 1);
+        }
+        else {
+            m_hasUndecodedEntities = true;
+        }
+    }
+    else
+    {
+        m_text += QChar::fromLatin1('&') + entityName + QChar::fromLatin1(';');
+        m_hasUndecodedEntities = true;
+    }
+}
+
+void NoteTextMatchIndex::searchExtractedText()
+{
+    int textToFindSize = m_textToFind.size();
+    if (textToFindSize == 0) {
+        return;
+    }
+
+    int end = std::min(m_text.size(), m_searchPosition + NOTE_TEXT_MATCH_INDEX_CHUNK_SIZE + textToFindSize);
+    QStringRef text = m_text.leftRef(end);
+    Qt::CaseSensitivity caseSensitivity = (m_matchCase ? Qt::CaseSensitive : Qt::CaseInsensitive);
+
+    int from = m_searchPosition;
+    while(true)
+    {
+        int index = text.indexOf(m_textToFind, from, caseSensitivity);
+        if (index < 0) {
+            break;
+        }
+
+        m_matchPositions << index;
+        from = index + textToFindSize;
+    }
+
+    // The match might start within the tail of the searched text and end within the text not yet extracted
+    m_searchPosition = std::max(from, end - textToFindSize + 1);
+}
+
+bool NoteTextMatchIndex::canNarrowSearch(const QString & textToFind, const bool matchCase) const
+{
+    if (m_textToFind.isEmpty() || (matchCase != m_matchCase) || !isComplete()) {
+        return false;
+    }
+
+    Qt::CaseSensitivity caseSensitivity = (matchCase ? Qt::CaseSensitive : Qt::CaseInsensitive);
+    if (!textToFind.startsWith(m_textToFind, caseSensitivity)) {
+        return false;
+    }
+
+    // The previous matches include all the occurrences of the previous text only if its occurrences can't overlap,
+    // i.e. if no proper prefix of the text is also its suffix
+    for(int i = 1, size = m_textToFind.size(); i < size; ++i)
+    {
+        if (m_textToFind.endsWith(m_textToFind.leftRef(i), caseSensitivity)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace quentier
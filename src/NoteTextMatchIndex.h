@@ -0,0 +1,88 @@
+#ifndef QUENTIER_NOTE_TEXT_MATCH_INDEX_H
+#define QUENTIER_NOTE_TEXT_MATCH_INDEX_H
+
+#include <quentier/utility/Macros.h>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+QT_FORWARD_DECLARE_CLASS(QTimer)
+
+namespace quentier {
+
+/**
+ * @brief The NoteTextMatchIndex class keeps the positions of the occurrences of the searched text within the text
+ * of the note
+ *
+ * The text is extracted from the note editor's HTML and searched in chunks from the event loop so that even
+ * a very large note doesn't block the UI; a new search cancels the one in progress. The index built for some text
+ * is narrowed down in place when the searched text is extended as the user types it
+ */
+class NoteTextMatchIndex: public QObject
+{
+    Q_OBJECT
+public:
+    explicit NoteTextMatchIndex(QObject * parent = Q_NULLPTR);
+
+    /**
+     * Sets the HTML (or ENML) of the note to search in; the search in progress, if any, is restarted
+     */
+    void setHtml(const QString & html);
+    bool hasHtml() const { return !m_html.isEmpty(); }
+
+    void search(const QString & textToFind, const bool matchCase);
+    void clear();
+
+    int numMatches() const { return m_matchPositions.size(); }
+    bool isComplete() const;
+
+    /**
+     * @return true if the occurrences of @param textToFind counted by the index are exactly the ones the note editor
+     * would find; that is not the case for the text containing whitespace which the editor might display differently
+     * than the index collapses it (i.e. due to the styling of the note) or if the note contains the entities
+     * the index doesn't decode
+     */
+    bool matchesEditorSearch(const QString & textToFind) const;
+
+Q_SIGNALS:
+    /**
+     * The signal emitted each time the next chunk of the note's text has been searched;
+     * @param complete is true once the entire text has been searched
+     */
+    void matchCountChanged(int numMatches, bool complete);
+
+private Q_SLOTS:
+    void onScanTimeout();
+
+private:
+    void restartScan();
+    void extractTextChunk();
+    void finishTag();
+    void appendEntity(const QString & entityName);
+    void searchExtractedText();
+    bool canNarrowSearch(const QString & textToFind, const bool matchCase) const;
+
+private:
+    QString             m_html;
+    int                 m_htmlPosition;
+
+    // The state of the extraction of text from HTML between the chunks
+    QString             m_text;
+    bool                m_insideTag;
+    QString             m_currentTagName;
+    bool                m_collectingTagName;
+    int                 m_skippedElementsDepth;
+    int                 m_preformattedElementsDepth;
+    bool                m_hasUndecodedEntities;
+
+    QString             m_textToFind;
+    bool                m_matchCase;
+    int                 m_searchPosition;
+    QVector<int>        m_matchPositions;
+
+    QTimer *            m_pScanTimer;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_NOTE_TEXT_MATCH_INDEX_H
@@ -31,6 +31,9 @@
 #define LAST_EXPORT_NOTE_TO_PDF_PATH_SETTINGS_KEY QStringLiteral("LastExportNoteToPdfPath")
 #define CONVERT_TO_NOTE_TIMEOUT_SETTINGS_KEY QStringLiteral("ConvertToNoteTimeout")
 #define EXPUNGE_NOTE_TIMEOUT_SETTINGS_KEY QStringLiteral("ExpungeNoteTimeout")
+#define AUTO_SAVE_NOTE_IDLE_TIMEOUT_SETTINGS_KEY QStringLiteral("AutoSaveNoteIdleTimeout")
+#define AUTO_SAVE_NOTE_MAX_DELAY_SETTINGS_KEY QStringLiteral("AutoSaveNoteMaxDelay")
+#define NOTE_EDITOR_TABS_MEMORY_LIMIT_SETTINGS_KEY QStringLiteral("NoteEditorTabsMemoryLimit")
 
 // Other UI related settings keys
 #define LOOK_AND_FEEL_SETTINGS_GROUP_NAME QStringLiteral("LookAndFeel")
@@ -46,6 +49,13 @@
 #define LAST_IMPORT_ENEX_PATH_SETTINGS_KEY QStringLiteral("LastImportEnexPath")
 #define LAST_IMPORT_ENEX_NOTEBOOK_NAME_SETTINGS_KEY QStringLiteral("LastImportEnexNotebookName")
 
+#define ENEX_IMPORT_CHECKPOINTS_SETTINGS_GROUP_NAME QStringLiteral("EnexImportCheckpoints")
+#define ENEX_IMPORT_CHECKPOINT_FILE_PATH_SETTINGS_KEY QStringLiteral("EnexFilePath")
+#define ENEX_IMPORT_CHECKPOINT_FILE_SIZE_SETTINGS_KEY QStringLiteral("EnexFileSize")
+#define ENEX_IMPORT_CHECKPOINT_FILE_LAST_MODIFIED_SETTINGS_KEY QStringLiteral("EnexFileLastModified")
+#define ENEX_IMPORT_CHECKPOINT_NUM_NOTES_SETTINGS_KEY QStringLiteral("NumImportedNotes")
+#define ENEX_IMPORT_CHECKPOINT_LAST_NOTE_HASH_SETTINGS_KEY QStringLiteral("LastImportedNoteHash")
+
 // Account-related settings keys
 #define ACCOUNT_SETTINGS_GROUP QStringLiteral("AccountSettings")
 
@@ -30,7 +30,15 @@ LogViewerDelegate::LogViewerDelegate(QObject * parent) :
     m_margin(0.4),
     m_widestLogLevelName(QStringLiteral("Warning")),
     m_sampleDateTimeString(QStringLiteral("26/09/2017 19:31:23:457")),
-    m_sampleSourceFileLineNumberString(QStringLiteral("99999"))
+    m_sampleSourceFileLineNumberString(QStringLiteral("99999")),
+    m_cachedFont(),
+    m_fontMetricsCacheValid(false),
+    m_lineSpacing(0),
+    m_charWidth(0),
+    m_sampleDateTimeStringWidth(0),
+    m_sampleSourceFileLineNumberStringWidth(0),
+    m_widestLogLevelNameWidth(0),
+    m_sourceFileNameWidths()
 {}
 
 QWidget * LogViewerDelegate::createEditor(QWidget * pParent,
@@ -58,24 +66,24 @@ QSize LogViewerDelegate::sizeHint(const QStyleOptionViewItem & option, const QMo
     // it has to be very fast, otherwise the performance is complete crap
     // so there are some shortcuts and missing checks which should normally be here
 
-    QFontMetrics fontMetrics(option.font);
+    updateFontMetricsCache(option.font);
     QSize size;
 
-#define STRING_SIZE_HINT(str) \
+#define STRING_SIZE_HINT(strWidth) \
     { \
-        size.setWidth(static_cast<int>(std::floor(fontMetrics.width(str) * (1.0 + m_margin) + 0.5))); \
-        size.setHeight(static_cast<int>(std::floor(fontMetrics.lineSpacing() * (1.0 + m_margin) + 0.5))); \
+        size.setWidth(static_cast<int>(std::floor(strWidth * (1.0 + m_margin) + 0.5))); \
+        size.setHeight(static_cast<int>(std::floor(m_lineSpacing * (1.0 + m_margin) + 0.5))); \
         return size; \
     }
 
     switch(index.column())
     {
     case LogViewerModel::Columns::Timestamp:
-        STRING_SIZE_HINT(m_sampleDateTimeString)
+        STRING_SIZE_HINT(m_sampleDateTimeStringWidth)
     case LogViewerModel::Columns::SourceFileLineNumber:
-        STRING_SIZE_HINT(m_sampleSourceFileLineNumberString)
+        STRING_SIZE_HINT(m_sampleSourceFileLineNumberStringWidth)
     case LogViewerModel::Columns::LogLevel:
-        STRING_SIZE_HINT(m_widestLogLevelName)
+        STRING_SIZE_HINT(m_widestLogLevelNameWidth)
     }
 
 #undef STRING_SIZE_HINT
@@ -103,34 +111,62 @@ QSize LogViewerDelegate::sizeHint(const QStyleOptionViewItem & option, const QMo
     }
 
     int row = sourceIndex.row();
-    const LogViewerModel::Data * pDataEntry = pModel->dataEntry(row);
-    if (Q_UNLIKELY(!pDataEntry)) {
+    if (Q_UNLIKELY(row >= pModel->rowCount())) {
         return QStyledItemDelegate::sizeHint(option, index);
     }
 
     if (index.column() == LogViewerModel::Columns::SourceFileName)
     {
+        int originalWidth = sourceFileNameWidth(pModel->sourceFileName(row));
         int numSubRows = 1;
-        QString sourceFileName = pDataEntry->m_sourceFileName;
-        int originalWidth = static_cast<int>(std::floor(fontMetrics.width(sourceFileName) * (1.0 + m_margin) + 0.5));
-        int width = originalWidth;
-        while(width > MAX_SOURCE_FILE_NAME_COLUMN_WIDTH) {
-            ++numSubRows;
-            width -= MAX_SOURCE_FILE_NAME_COLUMN_WIDTH;
+        if (originalWidth > MAX_SOURCE_FILE_NAME_COLUMN_WIDTH) {
+            numSubRows += (originalWidth - 1) / MAX_SOURCE_FILE_NAME_COLUMN_WIDTH;
         }
 
         size.setWidth(std::min(originalWidth, MAX_SOURCE_FILE_NAME_COLUMN_WIDTH));
-        size.setHeight(static_cast<int>(std::floor(fontMetrics.lineSpacing() * (numSubRows + 1 + m_margin) + 0.5)));
+        size.setHeight(static_cast<int>(std::floor(m_lineSpacing * (numSubRows + 1 + m_margin) + 0.5)));
         return size;
     }
 
-    size.setWidth(static_cast<int>(std::floor(fontMetrics.width(QStringLiteral("w")) *
-                                              (pDataEntry->m_logEntryMaxNumCharsPerLine + 2 + m_margin) + 0.5)));
-    size.setHeight(static_cast<int>(std::floor(fontMetrics.lineSpacing() *
-                                               (pDataEntry->m_numLogEntryLines + 1 + m_margin) + 0.5)));
+    size.setWidth(static_cast<int>(std::floor(m_charWidth *
+                                              (pModel->logEntryMaxNumCharsPerLine(row) + 2 + m_margin) + 0.5)));
+    size.setHeight(static_cast<int>(std::floor(m_lineSpacing *
+                                               (pModel->numLogEntryLines(row) + 1 + m_margin) + 0.5)));
     return size;
 }
 
+void LogViewerDelegate::updateFontMetricsCache(const QFont & font) const
+{
+    if (m_fontMetricsCacheValid && (font == m_cachedFont)) {
+        return;
+    }
+
+    QFontMetrics fontMetrics(font);
+    m_lineSpacing = fontMetrics.lineSpacing();
+    m_charWidth = fontMetrics.width(QStringLiteral("w"));
+    m_sampleDateTimeStringWidth = fontMetrics.width(m_sampleDateTimeString);
+    m_sampleSourceFileLineNumberStringWidth = fontMetrics.width(m_sampleSourceFileLineNumberString);
+    m_widestLogLevelNameWidth = fontMetrics.width(m_widestLogLevelName);
+
+    m_sourceFileNameWidths.clear();
+
+    m_cachedFont = font;
+    m_fontMetricsCacheValid = true;
+}
+
+int LogViewerDelegate::sourceFileNameWidth(const QString & sourceFileName) const
+{
+    auto it = m_sourceFileNameWidths.constFind(sourceFileName);
+    if (it != m_sourceFileNameWidths.constEnd()) {
+        return it.value();
+    }
+
+    QFontMetrics fontMetrics(m_cachedFont);
+    int width = static_cast<int>(std::floor(fontMetrics.width(sourceFileName) * (1.0 + m_margin) + 0.5));
+    m_sourceFileNameWidths[sourceFileName] = width;
+    return width;
+}
+
 bool LogViewerDelegate::paintImpl(QPainter * pPainter, const QStyleOptionViewItem & option, const QModelIndex & index) const
 {
     if (Q_UNLIKELY(!pPainter)) {
@@ -157,11 +193,12 @@ bool LogViewerDelegate::paintImpl(QPainter * pPainter, const QStyleOptionViewIte
     }
 
     int row = sourceIndex.row();
-    const LogViewerModel::Data * pDataEntry = pModel->dataEntry(row);
-    if (Q_UNLIKELY(!pDataEntry)) {
+    if (Q_UNLIKELY(row >= pModel->rowCount())) {
         return false;
     }
 
+    LogLevel::type logLevel = pModel->logLevel(row);
+
     pPainter->save();
     pPainter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
 
@@ -170,7 +207,7 @@ bool LogViewerDelegate::paintImpl(QPainter * pPainter, const QStyleOptionViewIte
         pPainter->setPen(option.palette.highlightedText().color());
     }
     else {
-        pPainter->fillRect(option.rect, QBrush(pModel->backgroundColorForLogLevel(pDataEntry->m_logLevel)));
+        pPainter->fillRect(option.rect, QBrush(pModel->backgroundColorForLogLevel(logLevel)));
         pPainter->setPen(Qt::black);
     }
 
@@ -184,7 +221,7 @@ bool LogViewerDelegate::paintImpl(QPainter * pPainter, const QStyleOptionViewIte
     {
     case LogViewerModel::Columns::Timestamp:
         {
-            const QDateTime & timestamp = pDataEntry->m_timestamp;
+            QDateTime timestamp = QDateTime::fromMSecsSinceEpoch(pModel->timestamp(row));
             QDate date = timestamp.date();
             QTime time = timestamp.time();
             QString printedTimestamp = date.toString(Qt::DefaultLocaleShortDate);
@@ -197,20 +234,20 @@ bool LogViewerDelegate::paintImpl(QPainter * pPainter, const QStyleOptionViewIte
         {
             QTextOption textOption(Qt::Alignment(Qt::AlignLeft | Qt::AlignTop));
             textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
-            pPainter->drawText(adjustedRect, pDataEntry->m_sourceFileName, textOption);
+            pPainter->drawText(adjustedRect, pModel->sourceFileName(row), textOption);
         }
         break;
     case LogViewerModel::Columns::SourceFileLineNumber:
-        pPainter->drawText(adjustedRect, QString::number(pDataEntry->m_sourceFileLineNumber),
+        pPainter->drawText(adjustedRect, QString::number(pModel->sourceFileLineNumber(row)),
                            textOption);
         break;
     case LogViewerModel::Columns::LogLevel:
-        pPainter->drawText(adjustedRect, LogViewerModel::logLevelToString(pDataEntry->m_logLevel),
+        pPainter->drawText(adjustedRect, LogViewerModel::logLevelToString(logLevel),
                            textOption);
         break;
     case LogViewerModel::Columns::LogEntry:
         {
-            pPainter->drawText(adjustedRect, pDataEntry->m_logEntry, textOption);
+            pPainter->drawText(adjustedRect, pModel->logEntry(row), textOption);
         }
         break;
     default:
@@ -21,6 +21,8 @@
 
 #include <quentier/utility/Macros.h>
 #include <QStyledItemDelegate>
+#include <QFont>
+#include <QHash>
 
 #define MAX_SOURCE_FILE_NAME_COLUMN_WIDTH (200)
 
@@ -43,11 +45,32 @@ private:
 private:
     bool paintImpl(QPainter * pPainter, const QStyleOptionViewItem & option, const QModelIndex & index) const;
 
+    /**
+     * Updates the cached font metrics dependent values if @param font differs from the one
+     * these values were computed for; the cached source file name widths are dropped then too
+     */
+    void updateFontMetricsCache(const QFont & font) const;
+
+    int sourceFileNameWidth(const QString & sourceFileName) const;
+
 private:
     double      m_margin;
     QString     m_widestLogLevelName;
     QString     m_sampleDateTimeString;
     QString     m_sampleSourceFileLineNumberString;
+
+    // sizeHint is called for each row of the view during the columns/rows resizing
+    // so everything depending only on the font is computed once per font
+    mutable QFont               m_cachedFont;
+    mutable bool                m_fontMetricsCacheValid;
+    mutable int                 m_lineSpacing;
+    mutable int                 m_charWidth;
+    mutable int                 m_sampleDateTimeStringWidth;
+    mutable int                 m_sampleSourceFileLineNumberStringWidth;
+    mutable int                 m_widestLogLevelNameWidth;
+
+    // There are not so many distinct source file names so their widths are cached by name
+    mutable QHash<QString, int> m_sourceFileNameWidths;
 };
 
 } // namespace quentier
@@ -12,6 +12,7 @@
 #include <QFileInfo>
 #include <QScopedPointer>
 #include <QFileDialog>
+#include <QDir>
 #include <algorithm>
 
 namespace quentier {
@@ -23,7 +24,8 @@ EnexImportDialog::EnexImportDialog(const Account & account,
     m_pUi(new Ui::EnexImportDialog),
     m_currentAccount(account),
     m_pNotebookModel(&notebookModel),
-    m_pNotebookNamesModel(new QStringListModel(this))
+    m_pNotebookNamesModel(new QStringListModel(this)),
+    m_selectedEnexFilePaths()
 {
     m_pUi->setupUi(this);
 
@@ -46,49 +48,39 @@ EnexImportDialog::~EnexImportDialog()
     delete m_pUi;
 }
 
-QString EnexImportDialog::importEnexFilePath(ErrorString * pErrorDescription) const
+QStringList EnexImportDialog::importEnexFilePaths(ErrorString * pErrorDescription) const
 {
-    QNDEBUG(QStringLiteral("EnexImportDialog::importEnexFilePath"));
+    QNDEBUG(QStringLiteral("EnexImportDialog::importEnexFilePaths"));
 
-    QString currentFilePath = QDir::fromNativeSeparators(m_pUi->filePathLineEdit->text());
-    QNTRACE(QStringLiteral("Current file path: ") << currentFilePath);
+    QStringList enexFilePaths;
 
-    if (currentFilePath.isEmpty()) {
-        return QString();
-    }
-
-    QFileInfo fileInfo(currentFilePath);
-    if (!fileInfo.exists())
+    if (!m_selectedEnexFilePaths.isEmpty())
     {
-        QNDEBUG(QStringLiteral("ENEX file at specified path doesn't exist"));
-        if (pErrorDescription) {
-            pErrorDescription->setBase(QT_TR_NOOP("ENEX file at specified path doesn't exist"));
-        }
+        QNTRACE(QStringLiteral("Selected paths: ") << m_selectedEnexFilePaths.join(QStringLiteral(", ")));
 
-        return QString();
-    }
-
-    if (!fileInfo.isFile())
-    {
-        QNDEBUG(QStringLiteral("The specified path is not a file"));
-        if (pErrorDescription) {
-            pErrorDescription->setBase(QT_TR_NOOP("The specified path is not a file"));
+        for(auto it = m_selectedEnexFilePaths.constBegin(), end = m_selectedEnexFilePaths.constEnd(); it != end; ++it)
+        {
+            if (!collectEnexFilePaths(*it, enexFilePaths, pErrorDescription)) {
+                return QStringList();
+            }
         }
-
-        return QString();
     }
-
-    if (!fileInfo.isReadable())
+    else
     {
-        QNDEBUG(QStringLiteral("The specified file is not readable"));
-        if (pErrorDescription) {
-            pErrorDescription->setBase(QT_TR_NOOP("The specified file is not readable"));
+        QString currentPath = m_pUi->filePathLineEdit->text().trimmed();
+        QNTRACE(QStringLiteral("Current path: ") << currentPath);
+
+        if (currentPath.isEmpty()) {
+            return QStringList();
         }
 
-        return QString();
+        if (!collectEnexFilePaths(currentPath, enexFilePaths, pErrorDescription)) {
+            return QStringList();
+        }
     }
 
-    return currentFilePath;
+    enexFilePaths.removeDuplicates();
+    return enexFilePaths;
 }
 
 QString EnexImportDialog::notebookName(ErrorString * pErrorDescription) const
@@ -109,21 +101,12 @@ void EnexImportDialog::onBrowsePushButtonClicked()
 {
     QNDEBUG(QStringLiteral("EnexImportDialog::onBrowsePushButtonClicked"));
 
-    ApplicationSettings appSettings(m_currentAccount, QUENTIER_AUXILIARY_SETTINGS);
-    appSettings.beginGroup(ENEX_EXPORT_IMPORT_SETTINGS_GROUP_NAME);
-    QString lastEnexImportPath = appSettings.value(LAST_IMPORT_ENEX_PATH_SETTINGS_KEY).toString();
-    appSettings.endGroup();
-
-    if (lastEnexImportPath.isEmpty()) {
-        lastEnexImportPath = documentsPath();
-    }
-
     QScopedPointer<QFileDialog> pEnexFileDialog(new QFileDialog(this,
-                                                                tr("Please select the ENEX file to import"),
-                                                                lastEnexImportPath));
+                                                                tr("Please select the ENEX files to import"),
+                                                                lastEnexImportPath()));
     pEnexFileDialog->setWindowModality(Qt::WindowModal);
     pEnexFileDialog->setAcceptMode(QFileDialog::AcceptOpen);
-    pEnexFileDialog->setFileMode(QFileDialog::ExistingFile);
+    pEnexFileDialog->setFileMode(QFileDialog::ExistingFiles);
     pEnexFileDialog->setDefaultSuffix(QStringLiteral("enex"));
 
     if (pEnexFileDialog->exec() != QDialog::Accepted) {
@@ -132,42 +115,77 @@ void EnexImportDialog::onBrowsePushButtonClicked()
     }
 
     QStringList selectedFiles = pEnexFileDialog->selectedFiles();
-    int numSelectedFiles = selectedFiles.size();
-
-    if (numSelectedFiles == 0) {
+    if (selectedFiles.isEmpty()) {
         QNDEBUG(QStringLiteral("No ENEX file was selected"));
         setStatusText(tr("No ENEX file was selected"));
         return;
     }
 
-    if (numSelectedFiles > 1) {
-        QNDEBUG(QStringLiteral("More than one ENEX files were selected"));
-        setStatusText(tr("More than one ENEX files were selected"));
-        return;
+    QStringList enexFilePaths;
+    enexFilePaths.reserve(selectedFiles.size());
+    for(auto it = selectedFiles.constBegin(), end = selectedFiles.constEnd(); it != end; ++it)
+    {
+        QFileInfo enexFileInfo(*it);
+        if (!enexFileInfo.exists()) {
+            QNDEBUG(QStringLiteral("The selected ENEX file does not exist: ") << *it);
+            setStatusText(tr("The selected ENEX file does not exist") + QStringLiteral(": ") +
+                          QDir::toNativeSeparators(*it));
+            return;
+        }
+
+        if (!enexFileInfo.isReadable()) {
+            QNDEBUG(QStringLiteral("The selected ENEX file is not readable: ") << *it);
+            setStatusText(tr("The selected ENEX file is not readable") + QStringLiteral(": ") +
+                          QDir::toNativeSeparators(*it));
+            return;
+        }
+
+        enexFilePaths << enexFileInfo.absoluteFilePath();
     }
 
-    QFileInfo enexFileInfo(selectedFiles[0]);
-    if (!enexFileInfo.exists()) {
-        QNDEBUG(QStringLiteral("The selected ENEX file does not exist"));
-        setStatusText(tr("The selected ENEX file does not exist"));
-        return;
+    setLastEnexImportPath(pEnexFileDialog->directory().absolutePath());
+
+    m_selectedEnexFilePaths = enexFilePaths;
+
+    QStringList displayedEnexFilePaths;
+    displayedEnexFilePaths.reserve(enexFilePaths.size());
+    for(auto it = enexFilePaths.constBegin(), end = enexFilePaths.constEnd(); it != end; ++it) {
+        displayedEnexFilePaths << QDir::toNativeSeparators(*it);
     }
 
-    if (!enexFileInfo.isReadable()) {
-        QNDEBUG(QStringLiteral("The selected ENEX file is not readable"));
-        setStatusText(tr("The selected ENEX file is not readable"));
+    m_pUi->filePathLineEdit->setText(displayedEnexFilePaths.join(QStringLiteral("; ")));
+    checkConditionsAndEnableDisableOkButton();
+}
+
+void EnexImportDialog::onBrowseFolderPushButtonClicked()
+{
+    QNDEBUG(QStringLiteral("EnexImportDialog::onBrowseFolderPushButtonClicked"));
+
+    QScopedPointer<QFileDialog> pEnexFolderDialog(new QFileDialog(this,
+                                                                  tr("Please select the folder with ENEX files to import"),
+                                                                  lastEnexImportPath()));
+    pEnexFolderDialog->setWindowModality(Qt::WindowModal);
+    pEnexFolderDialog->setAcceptMode(QFileDialog::AcceptOpen);
+    pEnexFolderDialog->setFileMode(QFileDialog::Directory);
+    pEnexFolderDialog->setOption(QFileDialog::ShowDirsOnly, true);
+
+    if (pEnexFolderDialog->exec() != QDialog::Accepted) {
+        QNDEBUG(QStringLiteral("The import of ENEX was cancelled"));
         return;
     }
 
-    lastEnexImportPath = pEnexFileDialog->directory().absolutePath();
-
-    if (!lastEnexImportPath.isEmpty()) {
-        appSettings.beginGroup(ENEX_EXPORT_IMPORT_SETTINGS_GROUP_NAME);
-        appSettings.setValue(LAST_IMPORT_ENEX_PATH_SETTINGS_KEY, lastEnexImportPath);
-        appSettings.endGroup();
+    QStringList selectedDirs = pEnexFolderDialog->selectedFiles();
+    if (selectedDirs.isEmpty()) {
+        QNDEBUG(QStringLiteral("No folder was selected"));
+        setStatusText(tr("No folder was selected"));
+        return;
     }
 
-    m_pUi->filePathLineEdit->setText(QDir::toNativeSeparators(enexFileInfo.absoluteFilePath()));
+    QFileInfo dirInfo(selectedDirs[0]);
+    setLastEnexImportPath(dirInfo.absoluteFilePath());
+
+    m_selectedEnexFilePaths.clear();
+    m_pUi->filePathLineEdit->setText(QDir::toNativeSeparators(dirInfo.absoluteFilePath()));
     checkConditionsAndEnableDisableOkButton();
 }
 
@@ -180,6 +198,10 @@ void EnexImportDialog::onNotebookNameEdited(const QString & name)
 void EnexImportDialog::onEnexFilePathEdited(const QString & path)
 {
     QNDEBUG(QStringLiteral("EnexImportDialog::onEnexFilePathEdited: ") << path);
+
+    // Once edited manually, the line edit's text is treated as a single path
+    m_selectedEnexFilePaths.clear();
+
     checkConditionsAndEnableDisableOkButton();
 }
 
@@ -275,6 +297,8 @@ void EnexImportDialog::createConnections()
 
     QObject::connect(m_pUi->browsePushButton, QNSIGNAL(QPushButton,clicked),
                      this, QNSLOT(EnexImportDialog,onBrowsePushButtonClicked));
+    QObject::connect(m_pUi->browseFolderPushButton, QNSIGNAL(QPushButton,clicked),
+                     this, QNSLOT(EnexImportDialog,onBrowseFolderPushButtonClicked));
     QObject::connect(m_pUi->filePathLineEdit, QNSIGNAL(QLineEdit,textEdited,QString),
                      this, QNSLOT(EnexImportDialog,onEnexFilePathEdited,QString));
     QObject::connect(m_pUi->notebookNameComboBox, QNSIGNAL(QComboBox,editTextChanged,QString),
@@ -340,6 +364,32 @@ void EnexImportDialog::fillDialogContents()
     m_pUi->buttonBox->button(QDialogButtonBox::Ok)->setDisabled(true);
 }
 
+QString EnexImportDialog::lastEnexImportPath() const
+{
+    ApplicationSettings appSettings(m_currentAccount, QUENTIER_AUXILIARY_SETTINGS);
+    appSettings.beginGroup(ENEX_EXPORT_IMPORT_SETTINGS_GROUP_NAME);
+    QString lastEnexImportPath = appSettings.value(LAST_IMPORT_ENEX_PATH_SETTINGS_KEY).toString();
+    appSettings.endGroup();
+
+    if (lastEnexImportPath.isEmpty()) {
+        lastEnexImportPath = documentsPath();
+    }
+
+    return lastEnexImportPath;
+}
+
+void EnexImportDialog::setLastEnexImportPath(const QString & path)
+{
+    if (path.isEmpty()) {
+        return;
+    }
+
+    ApplicationSettings appSettings(m_currentAccount, QUENTIER_AUXILIARY_SETTINGS);
+    appSettings.beginGroup(ENEX_EXPORT_IMPORT_SETTINGS_GROUP_NAME);
+    appSettings.setValue(LAST_IMPORT_ENEX_PATH_SETTINGS_KEY, path);
+    appSettings.endGroup();
+}
+
 void EnexImportDialog::setStatusText(const QString & text)
 {
     m_pUi->statusTextLabel->setText(text);
@@ -359,8 +409,8 @@ void EnexImportDialog::checkConditionsAndEnableDisableOkButton()
     QNDEBUG(QStringLiteral("EnexImportDialog::checkConditionsAndEnableDisableOkButton"));
 
     ErrorString error;
-    QString enexFilePath = importEnexFilePath(&error);
-    if (enexFilePath.isEmpty()) {
+    QStringList enexFilePaths = importEnexFilePaths(&error);
+    if (enexFilePaths.isEmpty()) {
         QNDEBUG(QStringLiteral("The enex file path is invalid, disabling the ok button"));
         m_pUi->buttonBox->button(QDialogButtonBox::Ok)->setDisabled(true);
         setStatusText(error.localizedString());
@@ -380,4 +430,70 @@ void EnexImportDialog::checkConditionsAndEnableDisableOkButton()
     clearAndHideStatus();
 }
 
+bool EnexImportDialog::collectEnexFilePaths(const QString & path, QStringList & enexFilePaths,
+                                            ErrorString * pErrorDescription) const
+{
+    QString currentPath = QDir::fromNativeSeparators(path);
+
+    QFileInfo fileInfo(currentPath);
+    if (!fileInfo.exists())
+    {
+        QNDEBUG(QStringLiteral("ENEX file at specified path doesn't exist: ") << currentPath);
+        if (pErrorDescription) {
+            pErrorDescription->setBase(QT_TR_NOOP("ENEX file at specified path doesn't exist"));
+            pErrorDescription->details() = currentPath;
+        }
+
+        return false;
+    }
+
+    if (fileInfo.isDir())
+    {
+        QDir dir(currentPath);
+        QStringList dirEnexFileNames = dir.entryList(QStringList() << QStringLiteral("*.enex"),
+                                                     QDir::Files | QDir::Readable, QDir::Name);
+        if (dirEnexFileNames.isEmpty())
+        {
+            QNDEBUG(QStringLiteral("The specified directory contains no ENEX files: ") << currentPath);
+            if (pErrorDescription) {
+                pErrorDescription->setBase(QT_TR_NOOP("The specified directory contains no ENEX files"));
+                pErrorDescription->details() = currentPath;
+            }
+
+            return false;
+        }
+
+        for(auto it = dirEnexFileNames.constBegin(), end = dirEnexFileNames.constEnd(); it != end; ++it) {
+            enexFilePaths << dir.absoluteFilePath(*it);
+        }
+
+        return true;
+    }
+
+    if (!fileInfo.isFile())
+    {
+        QNDEBUG(QStringLiteral("The specified path is not a file: ") << currentPath);
+        if (pErrorDescription) {
+            pErrorDescription->setBase(QT_TR_NOOP("The specified path is not a file"));
+            pErrorDescription->details() = currentPath;
+        }
+
+        return false;
+    }
+
+    if (!fileInfo.isReadable())
+    {
+        QNDEBUG(QStringLiteral("The specified file is not readable: ") << currentPath);
+        if (pErrorDescription) {
+            pErrorDescription->setBase(QT_TR_NOOP("The specified file is not readable"));
+            pErrorDescription->details() = currentPath;
+        }
+
+        return false;
+    }
+
+    enexFilePaths << fileInfo.absoluteFilePath();
+    return true;
+}
+
 } // namespace quentier
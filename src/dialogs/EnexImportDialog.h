@@ -28,11 +28,16 @@ public:
                               QWidget * parent = Q_NULLPTR);
     virtual ~EnexImportDialog();
 
-    QString importEnexFilePath(ErrorString * pErrorDescription = Q_NULLPTR) const;
+    /**
+     * The paths of ENEX files to import: either the files selected via the file dialog or the single path
+     * from the file path line edit which can be either a file or a directory from which all ENEX files are imported
+     */
+    QStringList importEnexFilePaths(ErrorString * pErrorDescription = Q_NULLPTR) const;
     QString notebookName(ErrorString * pErrorDescription = Q_NULLPTR) const;
 
 private Q_SLOTS:
     void onBrowsePushButtonClicked();
+    void onBrowseFolderPushButtonClicked();
     void onNotebookNameEdited(const QString & name);
     void onEnexFilePathEdited(const QString & path);
 
@@ -54,16 +59,26 @@ private:
     void fillNotebookNames();
     void fillDialogContents();
 
+    QString lastEnexImportPath() const;
+    void setLastEnexImportPath(const QString & path);
+
     void setStatusText(const QString & text);
     void clearAndHideStatus();
 
     void checkConditionsAndEnableDisableOkButton();
 
+    bool collectEnexFilePaths(const QString & path, QStringList & enexFilePaths,
+                              ErrorString * pErrorDescription) const;
+
 private:
     Ui::EnexImportDialog *  m_pUi;
     Account                 m_currentAccount;
     QPointer<NotebookModel> m_pNotebookModel;
     QStringListModel *      m_pNotebookNamesModel;
+
+    // The file paths selected via the file dialog are kept as is since any character
+    // used to join them within the line edit might also be a part of a path
+    QStringList             m_selectedEnexFilePaths;
 };
 
 } // namespace quentier
@@ -0,0 +1,506 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogViewerEntryStore.h"
+#include <QFileInfo>
+#include <limits>
+#include <algorithm>
+
+#define LOG_VIEWER_ENTRY_STORE_MAX_LOG_ENTRY_LINE_SIZE (700)
+
+namespace quentier {
+
+LogViewerEntryStore::LogViewerEntryStore() :
+    m_logFiles(),
+    m_sourceFileNames(),
+    m_sourceFileNameIndicesByName(),
+    m_timestamps(),
+    m_logEntryOffsets(),
+    m_logEntrySizes(),
+    m_sourceFileLineNumbers(),
+    m_sourceFileNameIndices(),
+    m_numLogEntryLines(),
+    m_logEntryMaxNumCharsPerLine(),
+    m_logLevels(),
+    m_logFileIndices(),
+    m_logLevelRows(),
+    m_indicesSortedByTimestamp()
+{}
+
+LogViewerEntryStore::~LogViewerEntryStore()
+{
+    closeLogFiles();
+}
+
+int LogViewerEntryStore::addLogFile(const QString & logFilePath, const bool immutable, ErrorString & errorDescription)
+{
+    if (Q_UNLIKELY(m_logFiles.size() > static_cast<int>(std::numeric_limits<quint8>::max()))) {
+        errorDescription.setBase(QT_TR_NOOP("Too many log files are opened at once"));
+        errorDescription.details() = QFileInfo(logFilePath).absoluteFilePath();
+        QNWARNING(errorDescription);
+        return -1;
+    }
+
+    LogFile logFile;
+    logFile.m_immutable = immutable;
+    logFile.m_pFile = QSharedPointer<QFile>(new QFile(logFilePath));
+    if (Q_UNLIKELY(!logFile.m_pFile->open(QIODevice::ReadOnly)))
+    {
+        errorDescription.setBase(QT_TR_NOOP("Can't open log file for reading"));
+        errorDescription.details() = QFileInfo(logFilePath).absoluteFilePath();
+        QNWARNING(errorDescription);
+        return -1;
+    }
+
+    m_logFiles << logFile;
+    return m_logFiles.size() - 1;
+}
+
+void LogViewerEntryStore::closeLogFiles()
+{
+    for(auto it = m_logFiles.begin(), end = m_logFiles.end(); it != end; ++it) {
+        LogFile & logFile = *it;
+        unmapLogFile(logFile);
+        logFile.m_pFile->close();
+    }
+
+    m_logFiles.clear();
+}
+
+QString LogViewerEntryStore::logFilePath(const int logFileIndex) const
+{
+    if (Q_UNLIKELY((logFileIndex < 0) || (logFileIndex >= m_logFiles.size()))) {
+        return QString();
+    }
+
+    return m_logFiles.at(logFileIndex).m_pFile->fileName();
+}
+
+bool LogViewerEntryStore::isLogFileImmutable(const int logFileIndex) const
+{
+    if (Q_UNLIKELY((logFileIndex < 0) || (logFileIndex >= m_logFiles.size()))) {
+        return false;
+    }
+
+    return m_logFiles.at(logFileIndex).m_immutable;
+}
+
+bool LogViewerEntryStore::mapLogFile(const int logFileIndex, const qint64 size, ErrorString & errorDescription)
+{
+    if (Q_UNLIKELY((logFileIndex < 0) || (logFileIndex >= m_logFiles.size()))) {
+        errorDescription.setBase(QT_TR_NOOP("Can't read the log file: the file is not open"));
+        QNWARNING(errorDescription << QStringLiteral(", log file index = ") << logFileIndex);
+        return false;
+    }
+
+    LogFile & logFile = m_logFiles[logFileIndex];
+    if (size == logFile.m_dataSize) {
+        return true;
+    }
+
+    if (!logFile.m_immutable)
+    {
+        // NOTE: the growing log file is never mapped into memory: it can be truncated or rotated
+        // from under the mapping at any moment which would crash the app on the next access to the mapped data;
+        // besides, on Windows the mapping would prevent the log file from being rotated
+        if (size < logFile.m_dataSize) {
+            unmapLogFile(logFile);
+        }
+
+        if (size <= 0) {
+            return true;
+        }
+
+        return readLogFileData(logFile, logFile.m_dataSize, size, errorDescription);
+    }
+
+    unmapLogFile(logFile);
+
+    if (size <= 0) {
+        return true;
+    }
+
+    QFile & file = *logFile.m_pFile;
+    logFile.m_pMappedData = file.map(0, size);
+    if (logFile.m_pMappedData) {
+        logFile.m_dataSize = size;
+        return true;
+    }
+
+    QNDEBUG(QStringLiteral("Failed to map the log file into memory: ") << file.errorString()
+            << QStringLiteral(", falling back to reading it"));
+
+    return readLogFileData(logFile, 0, size, errorDescription);
+}
+
+const char * LogViewerEntryStore::logFileData(const int logFileIndex) const
+{
+    if (Q_UNLIKELY((logFileIndex < 0) || (logFileIndex >= m_logFiles.size()))) {
+        return Q_NULLPTR;
+    }
+
+    const LogFile & logFile = m_logFiles.at(logFileIndex);
+    if (logFile.m_pMappedData) {
+        return reinterpret_cast<const char*>(logFile.m_pMappedData);
+    }
+
+    if (!logFile.m_dataFallback.isEmpty()) {
+        return logFile.m_dataFallback.constData();
+    }
+
+    return Q_NULLPTR;
+}
+
+qint64 LogViewerEntryStore::logFileDataSize(const int logFileIndex) const
+{
+    if (Q_UNLIKELY((logFileIndex < 0) || (logFileIndex >= m_logFiles.size()))) {
+        return 0;
+    }
+
+    return m_logFiles.at(logFileIndex).m_dataSize;
+}
+
+void LogViewerEntryStore::clear()
+{
+    m_sourceFileNames.clear();
+    m_sourceFileNameIndicesByName.clear();
+
+    m_timestamps.clear();
+    m_logEntryOffsets.clear();
+    m_logEntrySizes.clear();
+    m_sourceFileLineNumbers.clear();
+    m_sourceFileNameIndices.clear();
+    m_numLogEntryLines.clear();
+    m_logEntryMaxNumCharsPerLine.clear();
+    m_logLevels.clear();
+    m_logFileIndices.clear();
+
+    m_logLevelRows.clear();
+    m_indicesSortedByTimestamp.clear();
+}
+
+void LogViewerEntryStore::copyEntriesFrom(const LogViewerEntryStore & other)
+{
+    m_sourceFileNames = other.m_sourceFileNames;
+    m_sourceFileNameIndicesByName = other.m_sourceFileNameIndicesByName;
+
+    m_timestamps = other.m_timestamps;
+    m_logEntryOffsets = other.m_logEntryOffsets;
+    m_logEntrySizes = other.m_logEntrySizes;
+    m_sourceFileLineNumbers = other.m_sourceFileLineNumbers;
+    m_sourceFileNameIndices = other.m_sourceFileNameIndices;
+    m_numLogEntryLines = other.m_numLogEntryLines;
+    m_logEntryMaxNumCharsPerLine = other.m_logEntryMaxNumCharsPerLine;
+    m_logLevels = other.m_logLevels;
+    m_logFileIndices = other.m_logFileIndices;
+
+    m_logLevelRows = other.m_logLevelRows;
+    m_indicesSortedByTimestamp = other.m_indicesSortedByTimestamp;
+}
+
+int LogViewerEntryStore::internSourceFileName(const QString & sourceFileName)
+{
+    auto it = m_sourceFileNameIndicesByName.constFind(sourceFileName);
+    if (it != m_sourceFileNameIndicesByName.constEnd()) {
+        return it.value();
+    }
+
+    int index = m_sourceFileNames.size();
+    m_sourceFileNames << sourceFileName;
+    m_sourceFileNameIndicesByName[sourceFileName] = index;
+    return index;
+}
+
+void LogViewerEntryStore::append(const QVector<Entry> & entries)
+{
+    int newSize = m_timestamps.size() + entries.size();
+    if (newSize > m_timestamps.capacity())
+    {
+        // Grow geometrically to avoid reallocating each column on each chunk of entries
+        int capacity = std::max(newSize, m_timestamps.capacity() * 2);
+        m_timestamps.reserve(capacity);
+        m_logEntryOffsets.reserve(capacity);
+        m_logEntrySizes.reserve(capacity);
+        m_sourceFileLineNumbers.reserve(capacity);
+        m_sourceFileNameIndices.reserve(capacity);
+        m_numLogEntryLines.reserve(capacity);
+        m_logEntryMaxNumCharsPerLine.reserve(capacity);
+        m_logLevels.reserve(capacity);
+        m_logFileIndices.reserve(capacity);
+        m_indicesSortedByTimestamp.reserve(capacity);
+    }
+
+    for(auto it = entries.constBegin(), end = entries.constEnd(); it != end; ++it)
+    {
+        const Entry & entry = *it;
+        m_timestamps << entry.m_timestamp;
+        m_logEntryOffsets << entry.m_logEntryOffset;
+        m_logEntrySizes << entry.m_logEntrySize;
+        m_sourceFileLineNumbers << entry.m_sourceFileLineNumber;
+        m_sourceFileNameIndices << entry.m_sourceFileNameIndex;
+        m_numLogEntryLines << entry.m_numLogEntryLines;
+        m_logEntryMaxNumCharsPerLine << entry.m_logEntryMaxNumCharsPerLine;
+        m_logLevels << entry.m_logLevel;
+        m_logFileIndices << entry.m_logFileIndex;
+
+        int index = m_timestamps.size() - 1;
+
+        int logLevelIndex = static_cast<int>(entry.m_logLevel);
+        if (logLevelIndex >= m_logLevelRows.size()) {
+            m_logLevelRows.resize(logLevelIndex + 1);
+        }
+
+        QBitArray & rows = m_logLevelRows[logLevelIndex];
+        if (rows.size() <= index) {
+            rows.resize(newSize);
+        }
+
+        rows.setBit(index);
+
+        addToTimestampIndex(index);
+    }
+}
+
+void LogViewerEntryStore::appendLineToLogEntry(const int index, const qint64 logEntryEnd, const int lineSize)
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_timestamps.size()))) {
+        return;
+    }
+
+    Entry entry;
+    entry.m_logEntryOffset = m_logEntryOffsets.at(index);
+    entry.m_logEntrySize = m_logEntrySizes.at(index);
+    entry.m_numLogEntryLines = m_numLogEntryLines.at(index);
+    entry.m_logEntryMaxNumCharsPerLine = m_logEntryMaxNumCharsPerLine.at(index);
+
+    appendLineToLogEntry(entry, logEntryEnd, lineSize);
+
+    m_logEntrySizes[index] = entry.m_logEntrySize;
+    m_numLogEntryLines[index] = entry.m_numLogEntryLines;
+    m_logEntryMaxNumCharsPerLine[index] = entry.m_logEntryMaxNumCharsPerLine;
+}
+
+void LogViewerEntryStore::appendLineToLogEntry(Entry & entry, const qint64 logEntryEnd, const int lineSize)
+{
+    entry.m_logEntrySize = static_cast<qint32>(std::min(logEntryEnd - entry.m_logEntryOffset,
+                                                        static_cast<qint64>(std::numeric_limits<qint32>::max())));
+
+    if (lineSize <= 0) {
+        return;
+    }
+
+    // NOTE: too long lines are split into several ones to keep the log viewer's rows of reasonable width
+    int numLines = 1;
+    int maxNumCharsPerLine = lineSize;
+    if (lineSize >= LOG_VIEWER_ENTRY_STORE_MAX_LOG_ENTRY_LINE_SIZE) {
+        numLines = (lineSize + LOG_VIEWER_ENTRY_STORE_MAX_LOG_ENTRY_LINE_SIZE - 1) / LOG_VIEWER_ENTRY_STORE_MAX_LOG_ENTRY_LINE_SIZE;
+        maxNumCharsPerLine = LOG_VIEWER_ENTRY_STORE_MAX_LOG_ENTRY_LINE_SIZE;
+    }
+
+    entry.m_numLogEntryLines = static_cast<quint16>(std::min(static_cast<int>(entry.m_numLogEntryLines) + numLines,
+                                                             static_cast<int>(std::numeric_limits<quint16>::max())));
+
+    if (static_cast<int>(entry.m_logEntryMaxNumCharsPerLine) < maxNumCharsPerLine) {
+        entry.m_logEntryMaxNumCharsPerLine = static_cast<quint16>(maxNumCharsPerLine);
+    }
+}
+
+QString LogViewerEntryStore::logEntry(const int index) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_timestamps.size()))) {
+        return QString();
+    }
+
+    int logFileIndex = m_logFileIndices.at(index);
+    const char * pData = logFileData(logFileIndex);
+    if (Q_UNLIKELY(!pData)) {
+        return QString();
+    }
+
+    qint64 offset = m_logEntryOffsets.at(index);
+    qint64 size = m_logEntrySizes.at(index);
+    if (Q_UNLIKELY((offset < 0) || (offset + size > logFileDataSize(logFileIndex)))) {
+        return QString();
+    }
+
+    return logEntryFromRawData(index, pData + offset);
+}
+
+QString LogViewerEntryStore::logEntryFromRawData(const int index, const char * pRawLogEntry) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_timestamps.size()) || !pRawLogEntry)) {
+        return QString();
+    }
+
+    QString rawLogEntry = QString::fromUtf8(pRawLogEntry, static_cast<int>(m_logEntrySizes.at(index)));
+    QStringList lines = rawLogEntry.split(QChar::fromLatin1('\n'), QString::SkipEmptyParts);
+
+    QString result;
+    result.reserve(rawLogEntry.size() + m_numLogEntryLines.at(index));
+
+    for(auto it = lines.constBegin(), end = lines.constEnd(); it != end; ++it)
+    {
+        const QString & line = *it;
+        int lineSize = line.size();
+        int position = 0;
+        while(position < lineSize)
+        {
+            int partSize = std::min(lineSize - position, LOG_VIEWER_ENTRY_STORE_MAX_LOG_ENTRY_LINE_SIZE);
+
+            if (!result.isEmpty()) {
+                result += QStringLiteral("\n");
+            }
+
+            result += line.midRef(position, partSize);
+            position += partSize;
+        }
+    }
+
+    return result;
+}
+
+void LogViewerEntryStore::unmapLogFile(LogFile & logFile)
+{
+    if (logFile.m_pMappedData) {
+        Q_UNUSED(logFile.m_pFile->unmap(logFile.m_pMappedData))
+        logFile.m_pMappedData = Q_NULLPTR;
+    }
+
+    logFile.m_dataFallback.clear();
+    logFile.m_dataSize = 0;
+}
+
+bool LogViewerEntryStore::readLogFileData(LogFile & logFile, const qint64 from, const qint64 size,
+                                          ErrorString & errorDescription)
+{
+    QFile & file = *logFile.m_pFile;
+    if (Q_UNLIKELY(size - from > static_cast<qint64>(std::numeric_limits<int>::max())) ||
+        !file.seek(from))
+    {
+        errorDescription.setBase(QT_TR_NOOP("Failed to read the data from log file"));
+        errorDescription.details() = file.errorString();
+        QNWARNING(errorDescription);
+        unmapLogFile(logFile);
+        return false;
+    }
+
+    QByteArray data = file.read(size - from);
+    if (Q_UNLIKELY(data.size() != size - from))
+    {
+        errorDescription.setBase(QT_TR_NOOP("Failed to read the data from log file"));
+        errorDescription.details() = file.errorString();
+        QNWARNING(errorDescription);
+        unmapLogFile(logFile);
+        return false;
+    }
+
+    if (from == 0) {
+        logFile.m_dataFallback = data;
+    }
+    else {
+        logFile.m_dataFallback.append(data);
+    }
+
+    logFile.m_dataSize = size;
+    return true;
+}
+
+const QBitArray & LogViewerEntryStore::logLevelRows(const LogLevel::type logLevel) const
+{
+    int logLevelIndex = static_cast<int>(logLevel);
+    if ((logLevelIndex < 0) || (logLevelIndex >= m_logLevelRows.size())) {
+        static const QBitArray emptyRows;
+        return emptyRows;
+    }
+
+    return m_logLevelRows.at(logLevelIndex);
+}
+
+namespace {
+
+class TimestampIndexComparator
+{
+public:
+    TimestampIndexComparator(const QVector<qint64> & timestamps) :
+        m_timestamps(timestamps)
+    {}
+
+    bool operator()(const qint32 index, const qint64 timestamp) const
+    {
+        return m_timestamps.at(index) < timestamp;
+    }
+
+    bool operator()(const qint64 timestamp, const qint32 index) const
+    {
+        return timestamp < m_timestamps.at(index);
+    }
+
+private:
+    const QVector<qint64> & m_timestamps;
+};
+
+} // namespace
+
+int LogViewerEntryStore::firstIndexAtOrAfterTimestamp(const qint64 timestamp) const
+{
+    auto it = std::lower_bound(m_indicesSortedByTimestamp.constBegin(), m_indicesSortedByTimestamp.constEnd(),
+                               timestamp, TimestampIndexComparator(m_timestamps));
+    if (it == m_indicesSortedByTimestamp.constEnd()) {
+        return -1;
+    }
+
+    return *it;
+}
+
+QBitArray LogViewerEntryStore::indicesWithinTimeRange(const qint64 from, const qint64 to) const
+{
+    QBitArray result(m_timestamps.size());
+    if (from > to) {
+        return result;
+    }
+
+    TimestampIndexComparator comparator(m_timestamps);
+    auto begin = std::lower_bound(m_indicesSortedByTimestamp.constBegin(), m_indicesSortedByTimestamp.constEnd(),
+                                  from, comparator);
+    auto end = std::upper_bound(begin, m_indicesSortedByTimestamp.constEnd(), to, comparator);
+
+    for(auto it = begin; it != end; ++it) {
+        result.setBit(*it);
+    }
+
+    return result;
+}
+
+void LogViewerEntryStore::addToTimestampIndex(const int index)
+{
+    // The entries within the log file almost always come in the chronological order, so in most cases
+    // the new index simply goes to the end of the sorted list
+    qint64 timestamp = m_timestamps.at(index);
+    if (m_indicesSortedByTimestamp.isEmpty() ||
+        (m_timestamps.at(m_indicesSortedByTimestamp.back()) <= timestamp))
+    {
+        m_indicesSortedByTimestamp << index;
+        return;
+    }
+
+    auto it = std::upper_bound(m_indicesSortedByTimestamp.begin(), m_indicesSortedByTimestamp.end(),
+                               timestamp, TimestampIndexComparator(m_timestamps));
+    Q_UNUSED(m_indicesSortedByTimestamp.insert(it, index))
+}
+
+} // namespace quentier
@@ -0,0 +1,226 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_LOG_VIEWER_ENTRY_STORE_H
+#define QUENTIER_MODELS_LOG_VIEWER_ENTRY_STORE_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <quentier/types/ErrorString.h>
+#include <QBitArray>
+#include <QFile>
+#include <QHash>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+namespace quentier {
+
+/**
+ * @brief The LogViewerEntryStore class holds the parsed entries of a single log file
+ * in a compact columnar form
+ *
+ * Source file names are interned into a table shared by all entries, timestamps are kept
+ * as milliseconds since epoch, log levels as single bytes and log messages are not copied at all:
+ * each entry only stores the offset and size of its message within the log file data held by the store:
+ * the rotated log files which are not supposed to change are memory mapped while the data of the current log file
+ * which keeps growing is read into memory. The message text is decoded on demand. The store can hold entries from several log files
+ * (i.e. the current log file and the rotated ones), each entry refers to its log file by index.
+ *
+ * The store also maintains secondary indexes built while the entries are appended: a bitmap of rows per log level
+ * and the list of rows sorted by timestamp which allows looking up entries by time via binary search.
+ */
+class LogViewerEntryStore
+{
+public:
+    /**
+     * @brief The Entry struct is the row oriented representation of a single entry used
+     * to accumulate freshly parsed entries before they are appended to the store
+     */
+    struct Entry
+    {
+        Entry() :
+            m_timestamp(0),
+            m_logEntryOffset(0),
+            m_logEntrySize(0),
+            m_sourceFileLineNumber(-1),
+            m_sourceFileNameIndex(-1),
+            m_numLogEntryLines(0),
+            m_logEntryMaxNumCharsPerLine(0),
+            m_logLevel(static_cast<quint8>(LogLevel::InfoLevel)),
+            m_logFileIndex(0)
+        {}
+
+        qint64      m_timestamp;
+        qint64      m_logEntryOffset;
+        qint32      m_logEntrySize;
+        qint32      m_sourceFileLineNumber;
+        qint32      m_sourceFileNameIndex;
+        quint16     m_numLogEntryLines;
+        quint16     m_logEntryMaxNumCharsPerLine;
+        quint8      m_logLevel;
+        quint8      m_logFileIndex;
+    };
+
+public:
+    LogViewerEntryStore();
+    ~LogViewerEntryStore();
+
+    /**
+     * Opens the log file at @param logFilePath for reading and adds it to the store; @param immutable tells whether
+     * the file is not supposed to change anymore (i.e. it is a rotated log file) so that it can be safely memory mapped
+     *
+     * @return the index of the added log file or -1 in case of error
+     */
+    int addLogFile(const QString & logFilePath, const bool immutable, ErrorString & errorDescription);
+    void closeLogFiles();
+
+    int numLogFiles() const { return m_logFiles.size(); }
+    QString logFilePath(const int logFileIndex) const;
+    bool isLogFileImmutable(const int logFileIndex) const;
+
+    /**
+     * Makes the first @param size bytes of the log file at @param logFileIndex available in memory: the immutable
+     * log file is memory mapped (or read if mapping fails) while for the growing one only the bytes not read yet
+     * are appended to the data read before; the data of the growing log file is read anew if it has shrunk
+     */
+    bool mapLogFile(const int logFileIndex, const qint64 size, ErrorString & errorDescription);
+
+    const char * logFileData(const int logFileIndex) const;
+    qint64 logFileDataSize(const int logFileIndex) const;
+
+    int size() const { return m_timestamps.size(); }
+    bool isEmpty() const { return m_timestamps.isEmpty(); }
+
+    /**
+     * Removes all the entries and interned source file names but keeps the log file open
+     */
+    void clear();
+
+    /**
+     * Copies the entries and the indexes from @param other store without copying the log file data:
+     * the columns are implicitly shared so this is cheap; the copy can then be safely read by another thread
+     * while the original store keeps growing
+     */
+    void copyEntriesFrom(const LogViewerEntryStore & other);
+
+    int internSourceFileName(const QString & sourceFileName);
+    int numSourceFileNames() const { return m_sourceFileNames.size(); }
+
+    void append(const QVector<Entry> & entries);
+
+    /**
+     * Extends the message of the entry at @param index up to @param logEntryEnd offset within the log file
+     * to include another line of @param lineSize characters
+     */
+    void appendLineToLogEntry(const int index, const qint64 logEntryEnd, const int lineSize);
+
+    static void appendLineToLogEntry(Entry & entry, const qint64 logEntryEnd, const int lineSize);
+
+    qint64 timestamp(const int index) const { return m_timestamps.at(index); }
+    const QString & sourceFileName(const int index) const { return m_sourceFileNames.at(m_sourceFileNameIndices.at(index)); }
+    qint64 sourceFileLineNumber(const int index) const { return m_sourceFileLineNumbers.at(index); }
+    LogLevel::type logLevel(const int index) const { return static_cast<LogLevel::type>(m_logLevels.at(index)); }
+    int numLogEntryLines(const int index) const { return m_numLogEntryLines.at(index); }
+    int logEntryMaxNumCharsPerLine(const int index) const { return m_logEntryMaxNumCharsPerLine.at(index); }
+
+    /**
+     * Decodes the message of the entry at @param index from the log file data, splitting too long lines
+     * the same way they are accounted for in numLogEntryLines and logEntryMaxNumCharsPerLine
+     */
+    QString logEntry(const int index) const;
+
+    int logFileIndex(const int index) const { return m_logFileIndices.at(index); }
+    qint64 logEntryOffset(const int index) const { return m_logEntryOffsets.at(index); }
+    qint32 logEntrySize(const int index) const { return m_logEntrySizes.at(index); }
+
+    /**
+     * Decodes the message of the entry at @param index from @param pRawLogEntry holding logEntrySize(index) bytes
+     * of the log file starting from logEntryOffset(index); this allows decoding the messages read from the log file
+     * by the caller without making the log file data available in memory
+     */
+    QString logEntryFromRawData(const int index, const char * pRawLogEntry) const;
+
+    /**
+     * @return the bitmap in which the bits corresponding to the entries with @param logLevel are set;
+     * the bitmap's size might be smaller than the number of entries if the last entries have other log levels
+     */
+    const QBitArray & logLevelRows(const LogLevel::type logLevel) const;
+
+    /**
+     * @return the index of the entry with the smallest timestamp not less than @param timestamp
+     * or -1 if there is no such entry
+     */
+    int firstIndexAtOrAfterTimestamp(const qint64 timestamp) const;
+
+    /**
+     * @return the bitmap in which the bits corresponding to the entries with timestamps within
+     * [@param from, @param to] range are set
+     */
+    QBitArray indicesWithinTimeRange(const qint64 from, const qint64 to) const;
+
+private:
+    void addToTimestampIndex(const int index);
+
+private:
+    struct LogFile
+    {
+        LogFile() :
+            m_pFile(),
+            m_pMappedData(Q_NULLPTR),
+            m_dataFallback(),
+            m_dataSize(0),
+            m_immutable(false)
+        {}
+
+        QSharedPointer<QFile>   m_pFile;
+        uchar *                 m_pMappedData;
+        QByteArray              m_dataFallback;
+        qint64                  m_dataSize;
+        bool                    m_immutable;
+    };
+
+    void unmapLogFile(LogFile & logFile);
+    bool readLogFileData(LogFile & logFile, const qint64 from, const qint64 size, ErrorString & errorDescription);
+
+private:
+    Q_DISABLE_COPY(LogViewerEntryStore)
+
+private:
+    QVector<LogFile>    m_logFiles;
+
+    QStringList         m_sourceFileNames;
+    QHash<QString, int> m_sourceFileNameIndicesByName;
+
+    QVector<qint64>     m_timestamps;
+    QVector<qint64>     m_logEntryOffsets;
+    QVector<qint32>     m_logEntrySizes;
+    QVector<qint32>     m_sourceFileLineNumbers;
+    QVector<qint32>     m_sourceFileNameIndices;
+    QVector<quint16>    m_numLogEntryLines;
+    QVector<quint16>    m_logEntryMaxNumCharsPerLine;
+    QVector<quint8>     m_logLevels;
+    QVector<quint8>     m_logFileIndices;
+
+    QVector<QBitArray>  m_logLevelRows;
+    QVector<qint32>     m_indicesSortedByTimestamp;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_LOG_VIEWER_ENTRY_STORE_H
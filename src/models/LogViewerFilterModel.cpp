@@ -19,13 +19,25 @@
 #include "LogViewerFilterModel.h"
 #include "LogViewerModel.h"
 #include <quentier/logging/QuentierLogger.h>
+#include <quentier/utility/Utility.h>
+#include <algorithm>
 
 namespace quentier {
 
 LogViewerFilterModel::LogViewerFilterModel(QObject * parent) :
     QSortFilterProxyModel(parent),
     m_filterOutBeforeRow(-1),
-    m_enabledLogLevels()
+    m_enabledLogLevels(),
+    m_enabledLogLevelsRows(),
+    m_filterByTimeRange(false),
+    m_timeRangeFrom(0),
+    m_timeRangeTo(0),
+    m_timeRangeRows(),
+    m_contentFilterPattern(),
+    m_contentFilterCaseSensitivity(Qt::CaseSensitive),
+    m_contentFilterPatternSyntax(QRegExp::RegExp),
+    m_contentCheckedRows(),
+    m_contentMatchedRows()
 {
     for(size_t i = 0; i < sizeof(m_enabledLogLevels); ++i) {
         m_enabledLogLevels[i] = true;
@@ -57,52 +69,227 @@ void LogViewerFilterModel::setLogLevelEnabled(const LogLevel::type logLevel, con
     }
 
     m_enabledLogLevels[static_cast<size_t>(logLevel)] = enabled;
+    updateEnabledLogLevelsRows();
     invalidateFilter();
 }
 
+void LogViewerFilterModel::setTimeRange(const qint64 from, const qint64 to)
+{
+    QNDEBUG(QStringLiteral("LogViewerFilterModel::setTimeRange: from ") << printableDateTimeFromTimestamp(from)
+            << QStringLiteral(" to ") << printableDateTimeFromTimestamp(to));
+
+    if (m_filterByTimeRange && (m_timeRangeFrom == from) && (m_timeRangeTo == to)) {
+        QNDEBUG(QStringLiteral("The same time range is already set"));
+        return;
+    }
+
+    m_filterByTimeRange = true;
+    m_timeRangeFrom = from;
+    m_timeRangeTo = to;
+    updateTimeRangeRows();
+    invalidateFilter();
+}
+
+void LogViewerFilterModel::clearTimeRange()
+{
+    QNDEBUG(QStringLiteral("LogViewerFilterModel::clearTimeRange"));
+
+    if (!m_filterByTimeRange) {
+        return;
+    }
+
+    m_filterByTimeRange = false;
+    m_timeRangeFrom = 0;
+    m_timeRangeTo = 0;
+    m_timeRangeRows.clear();
+    invalidateFilter();
+}
+
+void LogViewerFilterModel::setSourceModel(QAbstractItemModel * pSourceModel)
+{
+    QAbstractItemModel * pPreviousSourceModel = sourceModel();
+    if (pPreviousSourceModel) {
+        QObject::disconnect(pPreviousSourceModel, Q_NULLPTR, this, Q_NULLPTR);
+    }
+
+    onSourceModelReset();
+
+    // NOTE: connecting before QSortFilterProxyModel does it in order to drop the stale cached data
+    // before the proxy model refilters the changed rows
+    if (pSourceModel) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+        QObject::connect(pSourceModel, QNSIGNAL(QAbstractItemModel,dataChanged,const QModelIndex&,const QModelIndex&,const QVector<int>&),
+                         this, QNSLOT(LogViewerFilterModel,onSourceModelDataChanged,const QModelIndex&,const QModelIndex&));
+#else
+        QObject::connect(pSourceModel, QNSIGNAL(QAbstractItemModel,dataChanged,const QModelIndex&,const QModelIndex&),
+                         this, QNSLOT(LogViewerFilterModel,onSourceModelDataChanged,const QModelIndex&,const QModelIndex&));
+#endif
+        QObject::connect(pSourceModel, QNSIGNAL(QAbstractItemModel,modelAboutToBeReset),
+                         this, QNSLOT(LogViewerFilterModel,onSourceModelReset));
+    }
+
+    QSortFilterProxyModel::setSourceModel(pSourceModel);
+}
+
 bool LogViewerFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex & sourceParent) const
 {
     if (sourceRow < m_filterOutBeforeRow) {
         return false;
     }
 
+    if (sourceParent.isValid()) {
+        return false;
+    }
+
     const LogViewerModel * pLogViewerModel = qobject_cast<const LogViewerModel*>(sourceModel());
     if (Q_UNLIKELY(!pLogViewerModel)) {
         return false;
     }
 
-    QModelIndex sourceIndex = pLogViewerModel->index(sourceRow, LogViewerModel::Columns::LogLevel, sourceParent);
-    if (!sourceIndex.isValid()) {
+    if (Q_UNLIKELY((sourceRow < 0) || (sourceRow >= pLogViewerModel->rowCount()))) {
         return false;
     }
 
-    const LogViewerModel::Data * pDataEntry = pLogViewerModel->dataEntry(sourceIndex.row());
-    if (Q_UNLIKELY(!pDataEntry)) {
-        return false;
+    if (sourceRow < m_enabledLogLevelsRows.size())
+    {
+        if (!m_enabledLogLevelsRows.testBit(sourceRow)) {
+            return false;
+        }
     }
+    else
+    {
+        int logLevelInt = pLogViewerModel->logLevel(sourceRow);
+        if (Q_UNLIKELY((logLevelInt < 0) || (logLevelInt >= static_cast<int>(sizeof(m_enabledLogLevels))))) {
+            return false;
+        }
 
-    int logLevelInt = pDataEntry->m_logLevel;
-    if (Q_UNLIKELY((logLevelInt < 0) || (logLevelInt >= static_cast<int>(sizeof(m_enabledLogLevels))))) {
-        return false;
+        if (!m_enabledLogLevels[static_cast<size_t>(logLevelInt)]) {
+            return false;
+        }
     }
 
-    if (!m_enabledLogLevels[static_cast<size_t>(logLevelInt)]) {
-        return false;
+    if (m_filterByTimeRange)
+    {
+        if (sourceRow < m_timeRangeRows.size())
+        {
+            if (!m_timeRangeRows.testBit(sourceRow)) {
+                return false;
+            }
+        }
+        else
+        {
+            qint64 timestamp = pLogViewerModel->timestamp(sourceRow);
+            if ((timestamp < m_timeRangeFrom) || (timestamp > m_timeRangeTo)) {
+                return false;
+            }
+        }
     }
 
-    QRegExp regExp = filterRegExp();
+    return filterAcceptsContent(sourceRow);
+}
 
-    const QString & sourceFileName = pDataEntry->m_sourceFileName;
-    if (regExp.indexIn(sourceFileName) >= 0) {
-        return true;
+void LogViewerFilterModel::onSourceModelDataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid()) {
+        return;
     }
 
-    const QString & logEntry = pDataEntry->m_logEntry;
-    if (regExp.indexIn(logEntry) >= 0) {
+    for(int row = topLeft.row(), lastRow = bottomRight.row(); row <= lastRow; ++row)
+    {
+        if (row >= m_contentCheckedRows.size()) {
+            break;
+        }
+
+        m_contentCheckedRows.clearBit(row);
+    }
+}
+
+void LogViewerFilterModel::onSourceModelReset()
+{
+    m_enabledLogLevelsRows.clear();
+    m_timeRangeRows.clear();
+
+    m_contentFilterPattern.clear();
+    m_contentCheckedRows.clear();
+    m_contentMatchedRows.clear();
+}
+
+void LogViewerFilterModel::updateEnabledLogLevelsRows()
+{
+    m_enabledLogLevelsRows.clear();
+
+    const LogViewerModel * pLogViewerModel = qobject_cast<const LogViewerModel*>(sourceModel());
+    if (Q_UNLIKELY(!pLogViewerModel)) {
+        return;
+    }
+
+    QBitArray enabledLogLevelsRows(pLogViewerModel->rowCount());
+    for(size_t i = 0; i < sizeof(m_enabledLogLevels); ++i)
+    {
+        if (m_enabledLogLevels[i]) {
+            enabledLogLevelsRows |= pLogViewerModel->logLevelRows(static_cast<LogLevel::type>(i));
+        }
+    }
+
+    m_enabledLogLevelsRows = enabledLogLevelsRows;
+}
+
+void LogViewerFilterModel::updateTimeRangeRows()
+{
+    m_timeRangeRows.clear();
+
+    const LogViewerModel * pLogViewerModel = qobject_cast<const LogViewerModel*>(sourceModel());
+    if (Q_UNLIKELY(!pLogViewerModel)) {
+        return;
+    }
+
+    m_timeRangeRows = pLogViewerModel->rowsWithinTimeRange(m_timeRangeFrom, m_timeRangeTo);
+}
+
+bool LogViewerFilterModel::filterAcceptsContent(const int sourceRow) const
+{
+    QRegExp regExp = filterRegExp();
+    if (regExp.isEmpty()) {
         return true;
     }
 
-    return false;
+    const LogViewerModel * pLogViewerModel = qobject_cast<const LogViewerModel*>(sourceModel());
+    if (Q_UNLIKELY(!pLogViewerModel)) {
+        return false;
+    }
+
+    QString pattern = regExp.pattern();
+    Qt::CaseSensitivity caseSensitivity = regExp.caseSensitivity();
+    QRegExp::PatternSyntax patternSyntax = regExp.patternSyntax();
+    if ((pattern != m_contentFilterPattern) ||
+        (caseSensitivity != m_contentFilterCaseSensitivity) ||
+        (patternSyntax != m_contentFilterPatternSyntax))
+    {
+        m_contentFilterPattern = pattern;
+        m_contentFilterCaseSensitivity = caseSensitivity;
+        m_contentFilterPatternSyntax = patternSyntax;
+        m_contentCheckedRows.clear();
+        m_contentMatchedRows.clear();
+    }
+
+    if (sourceRow >= m_contentCheckedRows.size()) {
+        int numRows = std::max(pLogViewerModel->rowCount(), sourceRow + 1);
+        m_contentCheckedRows.resize(numRows);
+        m_contentMatchedRows.resize(numRows);
+    }
+    else if (m_contentCheckedRows.testBit(sourceRow)) {
+        return m_contentMatchedRows.testBit(sourceRow);
+    }
+
+    bool matched = (regExp.indexIn(pLogViewerModel->sourceFileName(sourceRow)) >= 0);
+    if (!matched) {
+        // NOTE: the log entry is decoded from the log file on demand so it is only looked at if necessary
+        matched = (regExp.indexIn(pLogViewerModel->logEntry(sourceRow)) >= 0);
+    }
+
+    m_contentCheckedRows.setBit(sourceRow);
+    m_contentMatchedRows.setBit(sourceRow, matched);
+    return matched;
 }
 
 } // namespace quentier
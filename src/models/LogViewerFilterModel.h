@@ -22,6 +22,8 @@
 #include <quentier/utility/Macros.h>
 #include <quentier/logging/QuentierLogger.h>
 #include <QSortFilterProxyModel>
+#include <QBitArray>
+#include <QRegExp>
 
 namespace quentier {
 
@@ -37,12 +39,51 @@ public:
     bool logLevelEnabled(const LogLevel::type logLevel) const;
     void setLogLevelEnabled(const LogLevel::type logLevel, const bool enabled);
 
+    bool filterByTimeRange() const { return m_filterByTimeRange; }
+    qint64 timeRangeFrom() const { return m_timeRangeFrom; }
+    qint64 timeRangeTo() const { return m_timeRangeTo; }
+
+    /**
+     * Only accept rows with timestamps (msecs since epoch) within [@param from, @param to] range
+     */
+    void setTimeRange(const qint64 from, const qint64 to);
+    void clearTimeRange();
+
 public:
+    virtual void setSourceModel(QAbstractItemModel * pSourceModel) Q_DECL_OVERRIDE;
     virtual bool filterAcceptsRow(int sourceRow, const QModelIndex & sourceParent) const Q_DECL_OVERRIDE;
 
+private Q_SLOTS:
+    void onSourceModelDataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight);
+    void onSourceModelReset();
+
+private:
+    void updateEnabledLogLevelsRows();
+    void updateTimeRangeRows();
+    bool filterAcceptsContent(const int sourceRow) const;
+
 private:
     int         m_filterOutBeforeRow;
     bool        m_enabledLogLevels[6];
+
+    // Union of the source model's per log level row bitmaps for the enabled log levels
+    // as of the last change of enabled log levels; rows beyond its size are checked
+    // against m_enabledLogLevels directly
+    QBitArray   m_enabledLogLevelsRows;
+
+    bool        m_filterByTimeRange;
+    qint64      m_timeRangeFrom;
+    qint64      m_timeRangeTo;
+    QBitArray   m_timeRangeRows;
+
+    // Cached results of matching the rows against the filter by content which is
+    // the most expensive part of filtering; the cache survives the changes of other filters
+    // but not the changes of the pattern, its syntax or case sensitivity
+    mutable QString                 m_contentFilterPattern;
+    mutable Qt::CaseSensitivity     m_contentFilterCaseSensitivity;
+    mutable QRegExp::PatternSyntax  m_contentFilterPatternSyntax;
+    mutable QBitArray               m_contentCheckedRows;
+    mutable QBitArray               m_contentMatchedRows;
 };
 
 } // namespace quentier
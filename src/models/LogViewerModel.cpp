@@ -18,6 +18,8 @@
 
 #include "LogViewerModel.h"
 #include "LogViewerModelFileReaderAsync.h"
+#include "LogViewerModelFileSaverAsync.h"
+#include "../CancellationFlag.h"
 #include <quentier/utility/Utility.h>
 #include <quentier/utility/EventLoopWithExitStatus.h>
 #include <QFileInfo>
@@ -27,6 +29,8 @@
 #include <QTimer>
 #include <QTimerEvent>
 #include <QFile>
+#include <QThreadPool>
+#include <cstring>
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
 #include <QTimeZone>
@@ -38,25 +42,25 @@
 #define LOG_VIEWER_MODEL_PARSED_LINES_BUCKET_SIZE (100)
 #define LOG_VIEWER_MODEL_FETCH_ITEMS_BUCKET_SIZE (100)
 #define LOG_VIEWER_MODEL_LOG_FILE_POLLING_TIMER_MSEC (500)
-#define LOG_VIEWER_MODEL_MAX_LOG_ENTRY_LINE_SIZE (700)
 
 namespace quentier {
 
 LogViewerModel::LogViewerModel(QObject * parent) :
     QAbstractTableModel(parent),
     m_currentLogFileInfo(),
+    m_rotatedLogFileNames(),
     m_currentLogFileWatcher(),
     m_logParsingRegex(QStringLiteral("^(\\d{4}-\\d{2}-\\d{2}\\s+\\d{2}:\\d{2}:\\d{2}.\\d{3})\\s+(\\w+)\\s+(.+)\\s+@\\s+(\\d+)\\s+\\[(\\w+)\\]:\\s(.+$)"),
                       Qt::CaseInsensitive, QRegExp::RegExp),
     m_currentLogFilePos(-1),
-    m_currentParsedLogFileLines(0),
-    m_currentLogFileLines(),
     m_currentLogFileSize(0),
     m_currentLogFileSizePollingTimer(),
     m_pendingLogFileReadData(false),
     m_pReadLogFileIOThread(new QThread),
     m_pFileReaderAsync(Q_NULLPTR),
-    m_data(),
+    m_entries(),
+    m_parsedLogFiles(),
+    m_pSaveEntriesToFileCanceled(),
     m_pendingCurrentLogFileWipe(false),
     m_wipeCurrentLogFileResultStatus(false),
     m_wipeCurrentLogFileErrorDescription()
@@ -74,7 +78,9 @@ LogViewerModel::LogViewerModel(QObject * parent) :
 }
 
 LogViewerModel::~LogViewerModel()
-{}
+{
+    cancelSavingEntriesToFile();
+}
 
 QString LogViewerModel::logFileName() const
 {
@@ -100,9 +106,7 @@ void LogViewerModel::setLogFileName(const QString & logFileName)
     }
 
     m_currentLogFileInfo = newLogFileInfo;
-    m_data.clear();
-    m_currentParsedLogFileLines = 0;
-    m_currentLogFileLines.clear();
+    resetParsedData();
 
     for(size_t i = 0; i < sizeof(m_currentLogFileStartBytes); ++i) {
         m_currentLogFileStartBytes[i] = 0;
@@ -150,6 +154,24 @@ void LogViewerModel::setLogFileName(const QString & logFileName)
     endResetModel();
 }
 
+void LogViewerModel::setRotatedLogFileNames(const QStringList & rotatedLogFileNames)
+{
+    if (m_rotatedLogFileNames == rotatedLogFileNames) {
+        return;
+    }
+
+    beginResetModel();
+
+    m_rotatedLogFileNames = rotatedLogFileNames;
+    resetParsedData();
+
+    if (!m_currentLogFileInfo.absoluteFilePath().isEmpty()) {
+        parseFullDataFromLogFile();
+    }
+
+    endResetModel();
+}
+
 bool LogViewerModel::wipeCurrentLogFile(ErrorString & errorDescription)
 {
     if (!m_pFileReaderAsync) {
@@ -200,9 +222,8 @@ void LogViewerModel::clear()
 
     m_currentLogFileWatcher.removePath(m_currentLogFileInfo.absoluteFilePath());
     m_currentLogFileInfo = QFileInfo();
-    m_data.clear();
-    m_currentParsedLogFileLines = 0;
-    m_currentLogFileLines.clear();
+    m_rotatedLogFileNames.clear();
+    resetParsedData();
 
     for(size_t i = 0; i < sizeof(m_currentLogFileStartBytes); ++i) {
         m_currentLogFileStartBytes[i] = 0;
@@ -216,16 +237,95 @@ void LogViewerModel::clear()
     endResetModel();
 }
 
-const LogViewerModel::Data * LogViewerModel::dataEntry(const int row) const
+bool LogViewerModel::dataEntry(const int row, LogViewerModel::Data & data) const
+{
+    if (Q_UNLIKELY((row < 0) || (row >= m_entries.size()))) {
+        return false;
+    }
+
+    fillDataEntry(m_entries, row, data);
+    return true;
+}
+
+qint64 LogViewerModel::timestamp(const int row) const
+{
+    if (Q_UNLIKELY((row < 0) || (row >= m_entries.size()))) {
+        return 0;
+    }
+
+    return m_entries.timestamp(row);
+}
+
+QString LogViewerModel::sourceFileName(const int row) const
+{
+    if (Q_UNLIKELY((row < 0) || (row >= m_entries.size()))) {
+        return QString();
+    }
+
+    return m_entries.sourceFileName(row);
+}
+
+qint64 LogViewerModel::sourceFileLineNumber(const int row) const
+{
+    if (Q_UNLIKELY((row < 0) || (row >= m_entries.size()))) {
+        return -1;
+    }
+
+    return m_entries.sourceFileLineNumber(row);
+}
+
+LogLevel::type LogViewerModel::logLevel(const int row) const
+{
+    if (Q_UNLIKELY((row < 0) || (row >= m_entries.size()))) {
+        return LogLevel::InfoLevel;
+    }
+
+    return m_entries.logLevel(row);
+}
+
+QString LogViewerModel::logEntry(const int row) const
+{
+    if (Q_UNLIKELY((row < 0) || (row >= m_entries.size()))) {
+        return QString();
+    }
+
+    return m_entries.logEntry(row);
+}
+
+int LogViewerModel::numLogEntryLines(const int row) const
+{
+    if (Q_UNLIKELY((row < 0) || (row >= m_entries.size()))) {
+        return 0;
+    }
+
+    return m_entries.numLogEntryLines(row);
+}
+
+int LogViewerModel::logEntryMaxNumCharsPerLine(const int row) const
 {
-    if (Q_UNLIKELY((row < 0) || (row >= m_data.size()))) {
-        return Q_NULLPTR;
+    if (Q_UNLIKELY((row < 0) || (row >= m_entries.size()))) {
+        return 0;
     }
 
-    return &(m_data.at(row));
+    return m_entries.logEntryMaxNumCharsPerLine(row);
 }
 
-QString LogViewerModel::dataEntryToString(const LogViewerModel::Data & dataEntry) const
+const QBitArray & LogViewerModel::logLevelRows(const LogLevel::type logLevel) const
+{
+    return m_entries.logLevelRows(logLevel);
+}
+
+int LogViewerModel::firstRowAtOrAfterTimestamp(const qint64 timestamp) const
+{
+    return m_entries.firstIndexAtOrAfterTimestamp(timestamp);
+}
+
+QBitArray LogViewerModel::rowsWithinTimeRange(const qint64 from, const qint64 to) const
+{
+    return m_entries.indicesWithinTimeRange(from, to);
+}
+
+QString LogViewerModel::dataEntryToString(const LogViewerModel::Data & dataEntry)
 {
     QString result;
     QTextStream strm(&result);
@@ -251,6 +351,40 @@ QString LogViewerModel::dataEntryToString(const LogViewerModel::Data & dataEntry
     return result;
 }
 
+bool LogViewerModel::saveEntriesToFile(const QVector<int> & rows, const QString & targetFilePath)
+{
+    QNDEBUG(QStringLiteral("LogViewerModel::saveEntriesToFile: ") << rows.size()
+            << QStringLiteral(" entries to ") << targetFilePath);
+
+    if (Q_UNLIKELY(isSavingEntriesToFile())) {
+        QNDEBUG(QStringLiteral("The previous saving of entries to file is still in progress"));
+        return false;
+    }
+
+    m_pSaveEntriesToFileCanceled = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+
+    FileSaverAsync * pFileSaverAsync = new FileSaverAsync(m_entries, rows, targetFilePath,
+                                                          m_pSaveEntriesToFileCanceled);
+    QObject::connect(pFileSaverAsync, QNSIGNAL(FileSaverAsync,progress,double),
+                     this, QNSLOT(LogViewerModel,onFileSaverAsyncProgress,double),
+                     Qt::QueuedConnection);
+    QObject::connect(pFileSaverAsync, QNSIGNAL(FileSaverAsync,finished,QString,bool,ErrorString),
+                     this, QNSLOT(LogViewerModel,onFileSaverAsyncFinished,QString,bool,ErrorString),
+                     Qt::QueuedConnection);
+    QThreadPool::globalInstance()->start(pFileSaverAsync);
+    return true;
+}
+
+void LogViewerModel::cancelSavingEntriesToFile()
+{
+    if (m_pSaveEntriesToFileCanceled.isNull()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("LogViewerModel::cancelSavingEntriesToFile"));
+    setCanceled(*m_pSaveEntriesToFileCanceled);
+}
+
 QColor LogViewerModel::backgroundColorForLogLevel(const LogLevel::type logLevel) const
 {
     int alpha = 140;
@@ -274,7 +408,7 @@ QColor LogViewerModel::backgroundColorForLogLevel(const LogLevel::type logLevel)
 int LogViewerModel::rowCount(const QModelIndex & parent) const
 {
     if (!parent.isValid()) {
-        return m_data.size();
+        return m_entries.size();
     }
 
     return 0;
@@ -305,24 +439,22 @@ QVariant LogViewerModel::data(const QModelIndex & index, int role) const
     }
 
     int rowIndex = index.row();
-    if ((rowIndex < 0) || (rowIndex >= m_data.size())) {
+    if ((rowIndex < 0) || (rowIndex >= m_entries.size())) {
         return QVariant();
     }
 
-    const Data & dataEntry = m_data.at(rowIndex);
-
     switch(columnIndex)
     {
     case Columns::Timestamp:
-        return dataEntry.m_timestamp;
+        return QDateTime::fromMSecsSinceEpoch(m_entries.timestamp(rowIndex));
     case Columns::SourceFileName:
-        return dataEntry.m_sourceFileName;
+        return m_entries.sourceFileName(rowIndex);
     case Columns::SourceFileLineNumber:
-        return dataEntry.m_sourceFileLineNumber;
+        return m_entries.sourceFileLineNumber(rowIndex);
     case Columns::LogLevel:
-        return dataEntry.m_logLevel;
+        return m_entries.logLevel(rowIndex);
     case Columns::LogEntry:
-        return dataEntry.m_logEntry;
+        return m_entries.logEntry(rowIndex);
     default:
         return QVariant();
     }
@@ -366,7 +498,15 @@ bool LogViewerModel::canFetchMore(const QModelIndex & parent) const
         return false;
     }
 
-    return m_currentParsedLogFileLines < m_currentLogFileLines.size();
+    for(auto it = m_parsedLogFiles.constBegin(), end = m_parsedLogFiles.constEnd(); it != end; ++it)
+    {
+        const ParsedLogFile & parsedLogFile = *it;
+        if (parsedLogFile.hasUnparsedData() || !parsedLogFile.m_pendingEntries.isEmpty()) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 void LogViewerModel::fetchMore(const QModelIndex & parent)
@@ -431,9 +571,7 @@ void LogViewerModel::onFileChanged(const QString & path)
         beginResetModel();
         m_currentLogFilePos = 0;
         m_currentLogFileSize = 0;
-        m_data.clear();
-        m_currentParsedLogFileLines = 0;
-        m_currentLogFileLines.clear();
+        resetParsedData();
         parseFullDataFromLogFile();
         endResetModel();
 
@@ -461,13 +599,11 @@ void LogViewerModel::onFileRemoved(const QString & path)
     m_currentLogFilePos = 0;
     m_currentLogFileSize = 0;
     m_currentLogFileSizePollingTimer.stop();
-    m_data.clear();
-    m_currentParsedLogFileLines = 0;
-    m_currentLogFileLines.clear();
+    resetParsedData();
     endResetModel();
 }
 
-void LogViewerModel::onFileReadAsyncReady(qint64 pos, QString readData, ErrorString errorDescription)
+void LogViewerModel::onFileReadAsyncReady(qint64 pos, ErrorString errorDescription)
 {
     if (m_pFileReaderAsync)
     {
@@ -500,11 +636,37 @@ void LogViewerModel::onFileReadAsyncReady(qint64 pos, QString readData, ErrorStr
         return;
     }
 
+    if (m_parsedLogFiles.isEmpty() && !setupParsedLogFiles(errorDescription)) {
+        Q_EMIT notifyError(errorDescription);
+        return;
+    }
+
+    // NOTE: the current log file always goes first within the store
+    if (!m_entries.mapLogFile(0, pos, errorDescription)) {
+        Q_EMIT notifyError(errorDescription);
+        return;
+    }
+
     m_currentLogFilePos = pos;
-    m_currentLogFileLines.append(readData.split(QChar::fromLatin1('\n'), QString::SkipEmptyParts));
+    m_parsedLogFiles[0].m_endPos = pos;
     parseNextChunkOfLogFileLines();
 }
 
+void LogViewerModel::onFileSaverAsyncProgress(double progress)
+{
+    Q_EMIT saveEntriesToFileProgress(progress);
+}
+
+void LogViewerModel::onFileSaverAsyncFinished(QString targetFilePath, bool canceled, ErrorString errorDescription)
+{
+    QNDEBUG(QStringLiteral("LogViewerModel::onFileSaverAsyncFinished: ") << targetFilePath
+            << QStringLiteral(", canceled = ") << (canceled ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", error: ") << errorDescription);
+
+    m_pSaveEntriesToFileCanceled.clear();
+    Q_EMIT saveEntriesToFileFinished(targetFilePath, canceled, errorDescription);
+}
+
 void LogViewerModel::parseFullDataFromLogFile()
 {
     m_currentLogFilePos = 0;
@@ -527,8 +689,8 @@ void LogViewerModel::parseDataFromLogFileFromCurrentPos()
     QObject::connect(this, QNSIGNAL(LogViewerModel,startAsyncLogFileReading),
                      m_pFileReaderAsync, QNSLOT(FileReaderAsync,onStartReading),
                      Qt::QueuedConnection);
-    QObject::connect(m_pFileReaderAsync, QNSIGNAL(FileReaderAsync,finished,qint64,QString,ErrorString),
-                     this, QNSLOT(LogViewerModel,onFileReadAsyncReady,qint64,QString,ErrorString),
+    QObject::connect(m_pFileReaderAsync, QNSIGNAL(FileReaderAsync,finished,qint64,ErrorString),
+                     this, QNSLOT(LogViewerModel,onFileReadAsyncReady,qint64,ErrorString),
                      Qt::QueuedConnection);
     QObject::connect(this, QNSIGNAL(LogViewerModel,deleteFileReaderAsync),
                      m_pFileReaderAsync, QNSLOT(FileReaderAsync,deleteLater));
@@ -540,129 +702,317 @@ void LogViewerModel::parseDataFromLogFileFromCurrentPos()
 
 void LogViewerModel::parseNextChunkOfLogFileLines()
 {
-    QList<LogViewerModel::Data> readLogFileEntries;
-    int lastParsedLogFileLine = 0;
-    bool res = parseNextChunkOfLogFileLines(m_currentParsedLogFileLines, readLogFileEntries, lastParsedLogFileLine);
-    m_currentParsedLogFileLines = lastParsedLogFileLine + 1;
-    if (!res) {
+    int logFileIndex = selectLogFileToParse();
+    if (logFileIndex < 0) {
+        mergeParsedEntries();
         return;
     }
 
-    int numNewRows = readLogFileEntries.size();
-    if (Q_UNLIKELY(numNewRows < 0)) {
+    ParsedLogFile & parsedLogFile = m_parsedLogFiles[logFileIndex];
+
+    const char * pData = m_entries.logFileData(logFileIndex);
+    qint64 endPos = std::min(parsedLogFile.m_endPos, m_entries.logFileDataSize(logFileIndex));
+    if (!pData || (parsedLogFile.m_parsedPos >= endPos)) {
+        parsedLogFile.m_parsedPos = parsedLogFile.m_endPos;
+        mergeParsedEntries();
         return;
     }
 
-    beginInsertRows(QModelIndex(), m_data.size(), m_data.size() + numNewRows);
+    QVector<LogViewerEntryStore::Entry> & newEntries = parsedLogFile.m_pendingEntries;
+    newEntries.reserve(newEntries.size() + LOG_VIEWER_MODEL_PARSED_LINES_BUCKET_SIZE / 10);  // Just a rough guess
+
+    bool lastExistingEntryChanged = false;
+
+    int numParsedLines = 0;
+    qint64 pos = parsedLogFile.m_parsedPos;
+    while(pos < endPos)
+    {
+        const char * pLineStart = pData + pos;
+        const char * pLineEnd = static_cast<const char*>(std::memchr(pLineStart, '\n', static_cast<size_t>(endPos - pos)));
+        qint64 lineSize = (pLineEnd ? static_cast<qint64>(pLineEnd - pLineStart) : (endPos - pos));
+        qint64 nextLinePos = std::min(pos + lineSize + 1, endPos);
+
+        if (lineSize == 0) {
+            pos = nextLinePos;
+            continue;
+        }
+
+        QString line = QString::fromUtf8(pLineStart, static_cast<int>(lineSize));
+        if (m_logParsingRegex.indexIn(line) < 0)
+        {
+            // The line continues the message of the previous entry from the same log file which might have been
+            // parsed within one of the previous chunks and even merged into the timeline already
+            if (!newEntries.isEmpty()) {
+                LogViewerEntryStore::appendLineToLogEntry(newEntries.back(), pos + lineSize, line.size());
+            }
+            else if (parsedLogFile.m_lastEntryIndex >= 0) {
+                m_entries.appendLineToLogEntry(parsedLogFile.m_lastEntryIndex, pos + lineSize, line.size());
+                lastExistingEntryChanged = true;
+            }
+
+            ++numParsedLines;
+            pos = nextLinePos;
+            continue;
+        }
+
+        if (numParsedLines >= LOG_VIEWER_MODEL_PARSED_LINES_BUCKET_SIZE) {
+            break;
+        }
+
+        ++numParsedLines;
+
+        LogViewerEntryStore::Entry entry;
+        bool res = parseLogFileLine(line, pos, lineSize, entry);
+        pos = nextLinePos;
+        if (!res) {
+            break;
+        }
+
+        entry.m_logFileIndex = static_cast<quint8>(logFileIndex);
+        newEntries << entry;
+
+        parsedLogFile.m_lastParsedTimestamp = std::max(parsedLogFile.m_lastParsedTimestamp, entry.m_timestamp);
+        parsedLogFile.m_hasParsedEntries = true;
+    }
+
+    parsedLogFile.m_parsedPos = pos;
 
-    for(int i = 0, numEntries = readLogFileEntries.size(); i < numEntries; ++i) {
-        m_data.append(readLogFileEntries[i]);
+    if (lastExistingEntryChanged) {
+        QModelIndex lastExistingEntryModelIndex = index(parsedLogFile.m_lastEntryIndex, Columns::LogEntry);
+        Q_EMIT dataChanged(lastExistingEntryModelIndex, lastExistingEntryModelIndex);
     }
 
-    endInsertRows();
+    mergeParsedEntries();
 }
 
-bool LogViewerModel::parseNextChunkOfLogFileLines(const int lineNumFrom, QList<Data> & readLogFileEntries,
-                                                  int & lastParsedLogFileLine)
+bool LogViewerModel::setupParsedLogFiles(ErrorString & errorDescription)
 {
-    int estimatedLastLine = lineNumFrom + LOG_VIEWER_MODEL_PARSED_LINES_BUCKET_SIZE;
-    readLogFileEntries.reserve(std::max(readLogFileEntries.size(), 0) + LOG_VIEWER_MODEL_PARSED_LINES_BUCKET_SIZE / 10);  // Just a rough guess
+    m_parsedLogFiles.clear();
+    m_entries.closeLogFiles();
+
+    int currentLogFileIndex = m_entries.addLogFile(m_currentLogFileInfo.absoluteFilePath(),
+                                                    /* immutable = */ false, errorDescription);
+    if (currentLogFileIndex < 0) {
+        return false;
+    }
+
+    m_parsedLogFiles << ParsedLogFile();
+
+    // NOTE: the rotated log files are not supposed to change so they are mapped into memory in full right away;
+    // the failure to read any of them is not fatal, the entries from the remaining log files can still be displayed
+    QString logFilesDirPath = QuentierLogFilesDirPath() + QStringLiteral("/");
+    for(auto it = m_rotatedLogFileNames.constBegin(), end = m_rotatedLogFileNames.constEnd(); it != end; ++it)
+    {
+        QFileInfo rotatedLogFileInfo(logFilesDirPath + *it);
+        if (rotatedLogFileInfo.absoluteFilePath() == m_currentLogFileInfo.absoluteFilePath()) {
+            continue;
+        }
+
+        ErrorString error;
+        int logFileIndex = m_entries.addLogFile(rotatedLogFileInfo.absoluteFilePath(),
+                                                /* immutable = */ true, error);
+        if (logFileIndex < 0) {
+            Q_EMIT notifyError(error);
+            continue;
+        }
+
+        qint64 size = rotatedLogFileInfo.size();
+        if (!m_entries.mapLogFile(logFileIndex, size, error)) {
+            Q_EMIT notifyError(error);
+            size = 0;
+        }
+
+        ParsedLogFile parsedLogFile;
+        parsedLogFile.m_endPos = size;
+        m_parsedLogFiles << parsedLogFile;
+    }
+
+    return true;
+}
 
-    int numFoundMatches = 0;
-    lastParsedLogFileLine = 0;
-    for(int i = lineNumFrom, numLines = m_currentLogFileLines.size(); i < numLines; ++i)
+int LogViewerModel::selectLogFileToParse() const
+{
+    // The log file which unparsed entries are likely to be the earliest ones is chosen:
+    // the one without parsed entries yet or else the one with the earliest last parsed timestamp
+    int selectedIndex = -1;
+    for(int i = 0, size = m_parsedLogFiles.size(); i < size; ++i)
     {
-        const QString & line = m_currentLogFileLines.at(i);
-        int currentIndex = m_logParsingRegex.indexIn(line);
-        if (currentIndex < 0)
+        const ParsedLogFile & parsedLogFile = m_parsedLogFiles.at(i);
+        if (!parsedLogFile.hasUnparsedData()) {
+            continue;
+        }
+
+        if (!parsedLogFile.m_hasParsedEntries) {
+            return i;
+        }
+
+        if ((selectedIndex < 0) ||
+            (parsedLogFile.m_lastParsedTimestamp < m_parsedLogFiles.at(selectedIndex).m_lastParsedTimestamp))
         {
-            lastParsedLogFileLine = i;
+            selectedIndex = i;
+        }
+    }
+
+    return selectedIndex;
+}
+
+void LogViewerModel::mergeParsedEntries()
+{
+    // The entries of each log file are ordered by timestamp so the timeline is built by k-way merge of pending
+    // entries from all log files; the pending entry can only be merged if no log file can still yield an earlier
+    // entry: i.e. the unparsed entries of any other log file can't be earlier than the last parsed entry of that file
+    QVector<LogViewerEntryStore::Entry> newEntries;
+    QVector<int> pendingEntryPositions(m_parsedLogFiles.size(), 0);
 
-            if ((numFoundMatches == 0) || readLogFileEntries.empty()) {
+    while(true)
+    {
+        int earliestLogFileIndex = -1;
+        qint64 earliestTimestamp = 0;
+        for(int i = 0, size = m_parsedLogFiles.size(); i < size; ++i)
+        {
+            const ParsedLogFile & parsedLogFile = m_parsedLogFiles.at(i);
+            int pendingEntryPosition = pendingEntryPositions.at(i);
+            if (pendingEntryPosition >= parsedLogFile.m_pendingEntries.size()) {
                 continue;
             }
 
-            LogViewerModel::Data & lastEntry = readLogFileEntries.back();
-            appendLogEntryLine(lastEntry, line);
-            continue;
+            qint64 timestamp = parsedLogFile.m_pendingEntries.at(pendingEntryPosition).m_timestamp;
+            if ((earliestLogFileIndex < 0) || (timestamp < earliestTimestamp)) {
+                earliestLogFileIndex = i;
+                earliestTimestamp = timestamp;
+            }
         }
 
-        if (i >= estimatedLastLine) {
+        if (earliestLogFileIndex < 0) {
             break;
         }
 
-        lastParsedLogFileLine = i;
+        bool canMerge = true;
+        for(int i = 0, size = m_parsedLogFiles.size(); i < size; ++i)
+        {
+            if (i == earliestLogFileIndex) {
+                continue;
+            }
+
+            const ParsedLogFile & parsedLogFile = m_parsedLogFiles.at(i);
+            if (!parsedLogFile.hasUnparsedData() ||
+                (pendingEntryPositions.at(i) < parsedLogFile.m_pendingEntries.size()))
+            {
+                continue;
+            }
 
-        QStringList capturedTexts = m_logParsingRegex.capturedTexts();
+            if (!parsedLogFile.m_hasParsedEntries || (parsedLogFile.m_lastParsedTimestamp < earliestTimestamp)) {
+                canMerge = false;
+                break;
+            }
+        }
 
-        if (capturedTexts.size() != 7) {
-            ErrorString errorDescription(QT_TR_NOOP("Error parsing the log file's contents: unexpected number of captures by regex"));
-            errorDescription.details() += QString::number(capturedTexts.size());
-            QNWARNING(errorDescription);
-            Q_EMIT notifyError(errorDescription);
-            return false;
+        if (!canMerge) {
+            break;
         }
 
-        bool convertedSourceLineNumberToInt = false;
-        int sourceFileLineNumber = capturedTexts[4].toInt(&convertedSourceLineNumberToInt);
-        if (!convertedSourceLineNumberToInt) {
-            ErrorString errorDescription(QT_TR_NOOP("Error parsing the log file's contents: failed to convert the source line number to int"));
-            errorDescription.details() += capturedTexts[3];
-            QNWARNING(errorDescription);
-            Q_EMIT notifyError(errorDescription);
-            return false;
+        int & pendingEntryPosition = pendingEntryPositions[earliestLogFileIndex];
+        newEntries << m_parsedLogFiles.at(earliestLogFileIndex).m_pendingEntries.at(pendingEntryPosition);
+        m_parsedLogFiles[earliestLogFileIndex].m_lastEntryIndex = m_entries.size() + newEntries.size() - 1;
+        ++pendingEntryPosition;
+    }
+
+    if (newEntries.isEmpty()) {
+        return;
+    }
+
+    for(int i = 0, size = m_parsedLogFiles.size(); i < size; ++i)
+    {
+        int pendingEntryPosition = pendingEntryPositions.at(i);
+        if (pendingEntryPosition > 0) {
+            m_parsedLogFiles[i].m_pendingEntries.remove(0, pendingEntryPosition);
         }
+    }
 
-        Data entry;
-        entry.m_timestamp = QDateTime::fromString(capturedTexts[1],
+    int numExistingEntries = m_entries.size();
+    beginInsertRows(QModelIndex(), numExistingEntries, numExistingEntries + newEntries.size() - 1);
+    m_entries.append(newEntries);
+    endInsertRows();
+}
+
+bool LogViewerModel::parseLogFileLine(const QString & line, const qint64 lineOffset, const qint64 lineSize,
+                                      LogViewerEntryStore::Entry & entry)
+{
+    QStringList capturedTexts = m_logParsingRegex.capturedTexts();
+
+    if (capturedTexts.size() != 7) {
+        ErrorString errorDescription(QT_TR_NOOP("Error parsing the log file's contents: unexpected number of captures by regex"));
+        errorDescription.details() += QString::number(capturedTexts.size());
+        QNWARNING(errorDescription);
+        Q_EMIT notifyError(errorDescription);
+        return false;
+    }
+
+    bool convertedSourceLineNumberToInt = false;
+    int sourceFileLineNumber = capturedTexts[4].toInt(&convertedSourceLineNumberToInt);
+    if (!convertedSourceLineNumberToInt) {
+        ErrorString errorDescription(QT_TR_NOOP("Error parsing the log file's contents: failed to convert the source line number to int"));
+        errorDescription.details() += capturedTexts[3];
+        QNWARNING(errorDescription);
+        Q_EMIT notifyError(errorDescription);
+        return false;
+    }
+
+    QDateTime timestamp = QDateTime::fromString(capturedTexts[1],
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-                                                  QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")
+                                                QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")
 #else
-                                                  QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz")
+                                                QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz")
 #endif
-                                                 );
+                                               );
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
-        // Trying to add timezone info
-        QTimeZone timezone(capturedTexts[2].toLocal8Bit());
-        if (timezone.isValid()) {
-            entry.m_timestamp.setTimeZone(timezone);
-        }
+    // Trying to add timezone info
+    QTimeZone timezone(capturedTexts[2].toLocal8Bit());
+    if (timezone.isValid()) {
+        timestamp.setTimeZone(timezone);
+    }
 #endif
 
-        entry.m_sourceFileName = capturedTexts[3];
-        entry.m_sourceFileLineNumber = sourceFileLineNumber;
+    const QString & logLevel = capturedTexts[5];
+    if (logLevel == QStringLiteral("Trace")) {
+        entry.m_logLevel = static_cast<quint8>(LogLevel::TraceLevel);
+    }
+    else if (logLevel == QStringLiteral("Debug")) {
+        entry.m_logLevel = static_cast<quint8>(LogLevel::DebugLevel);
+    }
+    else if (logLevel == QStringLiteral("Info")) {
+        entry.m_logLevel = static_cast<quint8>(LogLevel::InfoLevel);
+    }
+    else if (logLevel == QStringLiteral("Warn")) {
+        entry.m_logLevel = static_cast<quint8>(LogLevel::WarnLevel);
+    }
+    else if (logLevel == QStringLiteral("Error")) {
+        entry.m_logLevel = static_cast<quint8>(LogLevel::ErrorLevel);
+    }
+    else
+    {
+        ErrorString errorDescription(QT_TR_NOOP("Error parsing the log file's contents: failed to parse the log level"));
+        errorDescription.details() += logLevel;
+        QNWARNING(errorDescription);
+        Q_EMIT notifyError(errorDescription);
+        return false;
+    }
 
-        const QString & logLevel = capturedTexts[5];
-        if (logLevel == QStringLiteral("Trace")) {
-            entry.m_logLevel = LogLevel::TraceLevel;
-        }
-        else if (logLevel == QStringLiteral("Debug")) {
-            entry.m_logLevel = LogLevel::DebugLevel;
-        }
-        else if (logLevel == QStringLiteral("Info")) {
-            entry.m_logLevel = LogLevel::InfoLevel;
-        }
-        else if (logLevel == QStringLiteral("Warn")) {
-            entry.m_logLevel = LogLevel::WarnLevel;
-        }
-        else if (logLevel == QStringLiteral("Error")) {
-            entry.m_logLevel = LogLevel::ErrorLevel;
-        }
-        else
-        {
-            ErrorString errorDescription(QT_TR_NOOP("Error parsing the log file's contents: failed to parse the log level"));
-            errorDescription.details() += logLevel;
-            QNWARNING(errorDescription);
-            Q_EMIT notifyError(errorDescription);
-            return false;
-        }
+    entry.m_timestamp = timestamp.toMSecsSinceEpoch();
+    entry.m_sourceFileNameIndex = m_entries.internSourceFileName(capturedTexts[3]);
+    entry.m_sourceFileLineNumber = sourceFileLineNumber;
 
-        appendLogEntryLine(entry, capturedTexts[6]);
-        readLogFileEntries.push_back(entry);
-        ++numFoundMatches;
+    // The log entry is referenced by its byte offset within the log file; if the line consists of ASCII
+    // characters only, the character position of the captured log entry is the same as its byte offset
+    int logEntryPos = m_logParsingRegex.pos(6);
+    qint64 logEntryByteOffset = logEntryPos;
+    if (static_cast<qint64>(line.size()) != lineSize) {
+        logEntryByteOffset = line.leftRef(logEntryPos).toUtf8().size();
     }
 
+    entry.m_logEntryOffset = lineOffset + logEntryByteOffset;
+    LogViewerEntryStore::appendLineToLogEntry(entry, lineOffset + lineSize, capturedTexts[6].size());
     return true;
 }
 
@@ -695,44 +1045,22 @@ void LogViewerModel::timerEvent(QTimerEvent * pEvent)
     QAbstractTableModel::timerEvent(pEvent);
 }
 
-void LogViewerModel::appendLogEntryLine(LogViewerModel::Data & data, const QString & line) const
+void LogViewerModel::resetParsedData()
 {
-    int lineSize = line.size();
-    if (lineSize < LOG_VIEWER_MODEL_MAX_LOG_ENTRY_LINE_SIZE)
-    {
-        if (!data.m_logEntry.isEmpty()) {
-            data.m_logEntry += QStringLiteral("\n");
-        }
-
-        data.m_logEntry += line;
-        ++data.m_numLogEntryLines;
-
-        if (data.m_logEntryMaxNumCharsPerLine < lineSize) {
-            data.m_logEntryMaxNumCharsPerLine = lineSize;
-        }
-
-        return;
-    }
-
-    int position = 0;
-    while(position < lineSize)
-    {
-        int size = std::min(lineSize - position, LOG_VIEWER_MODEL_MAX_LOG_ENTRY_LINE_SIZE);
-        QStringRef linePart(&line, position, size);
-
-        if (!data.m_logEntry.isEmpty()) {
-            data.m_logEntry += QStringLiteral("\n");
-        }
-
-        data.m_logEntry += linePart;
-        ++data.m_numLogEntryLines;
-
-        if (data.m_logEntryMaxNumCharsPerLine < size) {
-            data.m_logEntryMaxNumCharsPerLine = size;
-        }
+    m_entries.clear();
+    m_entries.closeLogFiles();
+    m_parsedLogFiles.clear();
+}
 
-        position += size;
-    }
+void LogViewerModel::fillDataEntry(const LogViewerEntryStore & entries, const int index, LogViewerModel::Data & data)
+{
+    data.m_timestamp = QDateTime::fromMSecsSinceEpoch(entries.timestamp(index));
+    data.m_sourceFileName = entries.sourceFileName(index);
+    data.m_sourceFileLineNumber = entries.sourceFileLineNumber(index);
+    data.m_logLevel = entries.logLevel(index);
+    data.m_logEntry = entries.logEntry(index);
+    data.m_numLogEntryLines = entries.numLogEntryLines(index);
+    data.m_logEntryMaxNumCharsPerLine = entries.logEntryMaxNumCharsPerLine(index);
 }
 
 bool LogViewerModel::wipeCurrentLogFileImpl(ErrorString & errorDescription)
@@ -752,8 +1080,19 @@ bool LogViewerModel::wipeCurrentLogFileImpl(ErrorString & errorDescription)
         return false;
     }
 
+    // The saver in progress reads the entries straight from the log files, truncating the file under it
+    // would crash it
+    if (Q_UNLIKELY(isSavingEntriesToFile())) {
+        errorDescription.setBase(QT_TR_NOOP("Can't wipe out the current log file while the log entries "
+                                            "are being saved to file, cancel the saving first"));
+        return false;
+    }
+
     beginResetModel();
 
+    // NOTE: the log file must not be mapped into memory while it is being truncated
+    resetParsedData();
+
     QFile currentLogFile(m_currentLogFileInfo.absoluteFilePath());
     bool res = currentLogFile.resize(qint64(0));
     if (Q_UNLIKELY(!res))
@@ -763,16 +1102,15 @@ bool LogViewerModel::wipeCurrentLogFileImpl(ErrorString & errorDescription)
         if (!errorString.isEmpty()) {
             errorDescription.details() = errorString;
         }
+
+        m_currentLogFilePos = 0;
+        parseFullDataFromLogFile();
     }
     else
     {
         m_currentLogFilePos = 0;
         m_currentLogFileSize = 0;
 
-        m_data.clear();
-        m_currentParsedLogFileLines = 0;
-        m_currentLogFileLines.clear();
-
         for(size_t i = 0; i < sizeof(m_currentLogFileStartBytes); ++i) {
             m_currentLogFileStartBytes[i] = 0;
         }
@@ -781,6 +1119,11 @@ bool LogViewerModel::wipeCurrentLogFileImpl(ErrorString & errorDescription)
         m_pendingCurrentLogFileWipe = false;
         m_wipeCurrentLogFileResultStatus = false;
         m_wipeCurrentLogFileErrorDescription.clear();
+
+        // The entries from rotated log files, if any, are still to be displayed
+        if (!m_rotatedLogFileNames.isEmpty()) {
+            parseFullDataFromLogFile();
+        }
     }
 
     endResetModel();
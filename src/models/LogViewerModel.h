@@ -19,6 +19,7 @@
 #ifndef QUENTIER_MODELS_LOG_VIEWER_MODEL_H
 #define QUENTIER_MODELS_LOG_VIEWER_MODEL_H
 
+#include "LogViewerEntryStore.h"
 #include <quentier/utility/Macros.h>
 #include <quentier/logging/QuentierLogger.h>
 #include <quentier/utility/Printable.h>
@@ -30,6 +31,10 @@
 #include <QThread>
 #include <QRegExp>
 #include <QBasicTimer>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QStringList>
+#include <QVector>
 
 namespace quentier {
 
@@ -54,6 +59,14 @@ public:
     QString logFileName() const;
     void setLogFileName(const QString & logFileName);
 
+    /**
+     * Sets the names of rotated log files (within the same log files dir as the current log file)
+     * which entries should be merged with the entries of the current log file into a single timeline
+     * ordered by timestamp; the rotated log files are not watched for changes
+     */
+    QStringList rotatedLogFileNames() const { return m_rotatedLogFileNames; }
+    void setRotatedLogFileNames(const QStringList & rotatedLogFileNames);
+
     qint64 currentLogFilePos() const { return m_currentLogFilePos; }
 
     bool wipeCurrentLogFile(ErrorString & errorDescription);
@@ -88,15 +101,58 @@ public:
         int             m_logEntryMaxNumCharsPerLine;
     };
 
-    const Data * dataEntry(const int row) const;
-
-    QString dataEntryToString(const Data & dataEntry) const;
+    /**
+     * Fills @param data with the entry at @param row; the entry's data is materialized
+     * from the compact storage so prefer the per-column accessors below when only some
+     * of the entry's fields are needed
+     */
+    bool dataEntry(const int row, Data & data) const;
+
+    qint64 timestamp(const int row) const;
+    QString sourceFileName(const int row) const;
+    qint64 sourceFileLineNumber(const int row) const;
+    LogLevel::type logLevel(const int row) const;
+    QString logEntry(const int row) const;
+    int numLogEntryLines(const int row) const;
+    int logEntryMaxNumCharsPerLine(const int row) const;
+
+    /**
+     * @return the bitmap of rows having @param logLevel; rows beyond the bitmap's size don't have this log level
+     */
+    const QBitArray & logLevelRows(const LogLevel::type logLevel) const;
+
+    /**
+     * @return the row of the earliest entry with timestamp not less than @param timestamp (in msecs since epoch)
+     * or -1 if there is no such row; the lookup uses the binary search over the timestamp index
+     */
+    int firstRowAtOrAfterTimestamp(const qint64 timestamp) const;
+
+    /**
+     * @return the bitmap of rows with timestamps within [@param from, @param to] range
+     */
+    QBitArray rowsWithinTimeRange(const qint64 from, const qint64 to) const;
+
+    static QString dataEntryToString(const Data & dataEntry);
+
+    /**
+     * Starts writing the entries at @param rows to the file at @param targetFilePath; the writing
+     * is done by the thread pool's thread, the progress is reported via saveEntriesToFileProgress
+     * signal and the completion - via saveEntriesToFileFinished signal
+     *
+     * @return false if the previous saving of entries to file is still in progress, true otherwise
+     */
+    bool saveEntriesToFile(const QVector<int> & rows, const QString & targetFilePath);
+    void cancelSavingEntriesToFile();
+    bool isSavingEntriesToFile() const { return !m_pSaveEntriesToFileCanceled.isNull(); }
 
     QColor backgroundColorForLogLevel(const LogLevel::type logLevel) const;
 
 Q_SIGNALS:
     void notifyError(ErrorString errorDescription);
 
+    void saveEntriesToFileProgress(double progress);
+    void saveEntriesToFileFinished(QString targetFilePath, bool canceled, ErrorString errorDescription);
+
     // private signals
     void startAsyncLogFileReading();
     void deleteFileReaderAsync();
@@ -115,30 +171,73 @@ private Q_SLOTS:
     void onFileChanged(const QString & path);
     void onFileRemoved(const QString & path);
 
-    void onFileReadAsyncReady(qint64 logFilePos, QString readData, ErrorString errorDescription);
+    void onFileReadAsyncReady(qint64 logFilePos, ErrorString errorDescription);
+
+    void onFileSaverAsyncProgress(double progress);
+    void onFileSaverAsyncFinished(QString targetFilePath, bool canceled, ErrorString errorDescription);
 
 private:
     void parseFullDataFromLogFile();
     void parseDataFromLogFileFromCurrentPos();
     void parseNextChunkOfLogFileLines();
-    bool parseNextChunkOfLogFileLines(const int lineNumFrom, QList<Data> & readLogFileEntries,
-                                      int & lastParsedLogFileLine);
+    bool setupParsedLogFiles(ErrorString & errorDescription);
+    int selectLogFileToParse() const;
+    void mergeParsedEntries();
+    bool parseLogFileLine(const QString & line, const qint64 lineOffset, const qint64 lineSize,
+                          LogViewerEntryStore::Entry & entry);
 
 private:
     virtual void timerEvent(QTimerEvent * pEvent) Q_DECL_OVERRIDE;
 
 private:
-    void appendLogEntryLine(Data & data, const QString & line) const;
+    void resetParsedData();
+    static void fillDataEntry(const LogViewerEntryStore & entries, const int index, Data & data);
     bool wipeCurrentLogFileImpl(ErrorString & errorDescription);
 
 private:
     class FileReaderAsync;
+    class FileSaverAsync;
+
+    /**
+     * The parsing state of each log file which entries are displayed by the model; the index
+     * of ParsedLogFile within m_parsedLogFiles is the same as the index of the log file within
+     * the entry store, the current log file always goes first
+     */
+    struct ParsedLogFile
+    {
+        ParsedLogFile() :
+            m_parsedPos(0),
+            m_endPos(0),
+            m_lastParsedTimestamp(0),
+            m_hasParsedEntries(false),
+            m_pendingEntries(),
+            m_lastEntryIndex(-1)
+        {}
+
+        bool hasUnparsedData() const { return m_parsedPos < m_endPos; }
+
+        // The position of the first line of the log file which has not been parsed yet
+        qint64      m_parsedPos;
+
+        // The position right after the last complete line of the log file available for parsing
+        qint64      m_endPos;
+
+        qint64      m_lastParsedTimestamp;
+        bool        m_hasParsedEntries;
+
+        // Entries parsed from the log file but not yet merged into the model's timeline
+        QVector<LogViewerEntryStore::Entry>     m_pendingEntries;
+
+        // The index of the last entry from this log file merged into the model's timeline
+        int         m_lastEntryIndex;
+    };
 
 private:
     Q_DISABLE_COPY(LogViewerModel)
 
 private:
     QFileInfo           m_currentLogFileInfo;
+    QStringList         m_rotatedLogFileNames;
     FileSystemWatcher   m_currentLogFileWatcher;
 
     QRegExp             m_logParsingRegex;
@@ -146,11 +245,9 @@ private:
     char                m_currentLogFileStartBytes[256];
     qint64              m_currentLogFileStartBytesRead;
 
+    // The position right after the last complete line read from the current log file
     qint64              m_currentLogFilePos;
 
-    int                 m_currentParsedLogFileLines;
-    QStringList         m_currentLogFileLines;
-
     qint64              m_currentLogFileSize;
     QBasicTimer         m_currentLogFileSizePollingTimer;
 
@@ -159,7 +256,11 @@ private:
     QThread *           m_pReadLogFileIOThread;
     FileReaderAsync *   m_pFileReaderAsync;
 
-    QList<Data>         m_data;
+    LogViewerEntryStore         m_entries;
+    QVector<ParsedLogFile>      m_parsedLogFiles;
+
+    // Shared with the FileSaverAsync in progress, if any, to let it know the saving was canceled
+    QSharedPointer<QAtomicInt>  m_pSaveEntriesToFileCanceled;
 
     bool                m_pendingCurrentLogFileWipe;
     bool                m_wipeCurrentLogFileResultStatus;
@@ -169,6 +270,5 @@ private:
 } // namespace quentier
 
 Q_DECLARE_METATYPE(quentier::LogViewerModel::Data)
-Q_DECLARE_METATYPE(QList<quentier::LogViewerModel::Data>)
 
 #endif // QUENTIER_MODELS_LOG_VIEWER_MODEL_H
@@ -42,7 +42,7 @@ void LogViewerModel::FileReaderAsync::onStartReading()
         ErrorString errorDescription(QT_TR_NOOP("Can't open log file for reading"));
         errorDescription.details() = targetFileInfo.absoluteFilePath();
         QNWARNING(errorDescription);
-        Q_EMIT finished(-1, QString(), errorDescription);
+        Q_EMIT finished(-1, errorDescription);
         return;
     }
 
@@ -50,18 +50,20 @@ void LogViewerModel::FileReaderAsync::onStartReading()
         ErrorString errorDescription(QT_TR_NOOP("Failed to read the data from log file: failed to seek at position"));
         errorDescription.details() = QString::number(m_startPos);
         QNWARNING(errorDescription);
-        Q_EMIT finished(-1, QString(), errorDescription);
+        Q_EMIT finished(-1, errorDescription);
         return;
     }
 
-    const qint64 bufSize = 1024;
-    char buf[bufSize];
-    QByteArray readData;
+    // NOTE: the read data is not accumulated here: the model maps the log file into memory and parses it
+    // from there; reading the file here only determines where the last complete line ends and, as a side effect,
+    // brings the file's contents into the OS page cache so that parsing the mapped data doesn't stall on I/O
+    const qint64 bufSize = 65536;
+    QByteArray buf(static_cast<int>(bufSize), Qt::Uninitialized);
 
     qint64 currentPos = m_startPos;
     while(true)
     {
-        qint64 bytesRead = m_targetFile.read(buf, bufSize);
+        qint64 bytesRead = m_targetFile.read(buf.data(), bufSize);
         if (bytesRead == -1)
         {
             ErrorString errorDescription(QT_TR_NOOP("Failed to read the data from log file"));
@@ -71,7 +73,7 @@ void LogViewerModel::FileReaderAsync::onStartReading()
             }
 
             QNWARNING(errorDescription);
-            Q_EMIT finished(-1, QString(), errorDescription);
+            Q_EMIT finished(-1, errorDescription);
             return;
         }
         else if (bytesRead == 0)
@@ -79,11 +81,13 @@ void LogViewerModel::FileReaderAsync::onStartReading()
             break;
         }
 
-        readData.append(buf, static_cast<int>(bytesRead));
-        currentPos = m_targetFile.pos();
+        int lastNewLineIndex = buf.lastIndexOf('\n', static_cast<int>(bytesRead) - 1);
+        if (lastNewLineIndex >= 0) {
+            currentPos = m_targetFile.pos() - bytesRead + lastNewLineIndex + 1;
+        }
     }
 
-    Q_EMIT finished(currentPos, QString::fromUtf8(readData), ErrorString());
+    Q_EMIT finished(currentPos, ErrorString());
 }
 
 } // namespace quentier
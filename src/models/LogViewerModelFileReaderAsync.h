@@ -33,7 +33,7 @@ public:
     ~FileReaderAsync();
 
 Q_SIGNALS:
-    void finished(qint64 currentPos, QString readData, ErrorString errorDescription);
+    void finished(qint64 currentPos, ErrorString errorDescription);
 
 public Q_SLOTS:
     void onStartReading();
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogViewerModelFileSaverAsync.h"
+#include "../CancellationFlag.h"
+#include <QFile>
+#include <algorithm>
+
+#define LOG_VIEWER_MODEL_FILE_SAVER_BUFFER_SIZE (1048576)
+#define LOG_VIEWER_MODEL_FILE_SAVER_READ_CHUNK_SIZE (1048576)
+#define LOG_VIEWER_MODEL_FILE_SAVER_PROGRESS_BUCKET_SIZE (1000)
+
+namespace quentier {
+
+LogViewerModel::FileSaverAsync::FileSaverAsync(const LogViewerEntryStore & entries,
+                                               const QVector<int> & rows,
+                                               const QString & targetFilePath,
+                                               const QSharedPointer<QAtomicInt> & pCanceled,
+                                               QObject * parent) :
+    QObject(parent),
+    QRunnable(),
+    m_entries(),
+    m_logFilePaths(),
+    m_logFileDataSizes(),
+    m_logFileChunks(),
+    m_rows(rows),
+    m_targetFilePath(targetFilePath),
+    m_pCanceled(pCanceled)
+{
+    m_entries.copyEntriesFrom(entries);
+
+    int numLogFiles = entries.numLogFiles();
+    m_logFileDataSizes.reserve(numLogFiles);
+    for(int i = 0; i < numLogFiles; ++i) {
+        m_logFilePaths << entries.logFilePath(i);
+        m_logFileDataSizes << entries.logFileDataSize(i);
+    }
+}
+
+void LogViewerModel::FileSaverAsync::run()
+{
+    QNDEBUG(QStringLiteral("LogViewerModel::FileSaverAsync::run: target file path = ") << m_targetFilePath
+            << QStringLiteral(", num entries = ") << m_rows.size());
+
+    // NOTE: the log files are opened separately from the model's own ones so that the model is free
+    // to remap or close its ones in the meantime; only the part of each log file known to the model is read
+    ErrorString errorDescription;
+    if (!openLogFiles(errorDescription)) {
+        Q_EMIT finished(m_targetFilePath, false, errorDescription);
+        return;
+    }
+
+    QFile file(m_targetFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorDescription.setBase(QT_TR_NOOP("Failed to open the target file for writing"));
+        errorDescription.details() = file.errorString();
+        QNWARNING(errorDescription);
+        Q_EMIT finished(m_targetFilePath, false, errorDescription);
+        return;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(LOG_VIEWER_MODEL_FILE_SAVER_BUFFER_SIZE);
+
+    LogViewerModel::Data dataEntry;
+    for(int i = 0, numRows = m_rows.size(); i < numRows; ++i)
+    {
+        if (isCanceled(*m_pCanceled)) {
+            QNDEBUG(QStringLiteral("Saving log entries to file was canceled"));
+            file.close();
+            Q_UNUSED(file.remove())
+            Q_EMIT finished(m_targetFilePath, true, ErrorString());
+            return;
+        }
+
+        int row = m_rows.at(i);
+        if (Q_UNLIKELY((row < 0) || (row >= m_entries.size()))) {
+            continue;
+        }
+
+        const char * pRawLogEntry = Q_NULLPTR;
+        if (!readRawLogEntry(row, pRawLogEntry, errorDescription)) {
+            file.close();
+            Q_EMIT finished(m_targetFilePath, false, errorDescription);
+            return;
+        }
+
+        // The store has no log file data of its own so the message is decoded from the chunk read above
+        LogViewerModel::fillDataEntry(m_entries, row, dataEntry);
+        dataEntry.m_logEntry = m_entries.logEntryFromRawData(row, pRawLogEntry);
+
+        buffer.append(LogViewerModel::dataEntryToString(dataEntry).toLocal8Bit());
+
+        if ((buffer.size() >= LOG_VIEWER_MODEL_FILE_SAVER_BUFFER_SIZE) && !flushBuffer(file, buffer)) {
+            return;
+        }
+
+        if (((i + 1) % LOG_VIEWER_MODEL_FILE_SAVER_PROGRESS_BUCKET_SIZE) == 0) {
+            Q_EMIT progress(static_cast<double>(i + 1) / numRows);
+        }
+    }
+
+    if (!buffer.isEmpty() && !flushBuffer(file, buffer)) {
+        return;
+    }
+
+    file.close();
+
+    QNDEBUG(QStringLiteral("Successfully saved the log entries to file"));
+    Q_EMIT progress(1.0);
+    Q_EMIT finished(m_targetFilePath, false, ErrorString());
+}
+
+bool LogViewerModel::FileSaverAsync::openLogFiles(ErrorString & errorDescription)
+{
+    int numLogFiles = m_logFilePaths.size();
+    m_logFileChunks.resize(numLogFiles);
+
+    for(int i = 0; i < numLogFiles; ++i)
+    {
+        LogFileChunk & chunk = m_logFileChunks[i];
+        chunk.m_pFile = QSharedPointer<QFile>(new QFile(m_logFilePaths.at(i)));
+        if (Q_UNLIKELY(!chunk.m_pFile->open(QIODevice::ReadOnly))) {
+            errorDescription.setBase(QT_TR_NOOP("Can't open log file for reading"));
+            errorDescription.details() = m_logFilePaths.at(i);
+            QNWARNING(errorDescription);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LogViewerModel::FileSaverAsync::readRawLogEntry(const int row, const char *& pRawLogEntry,
+                                                     ErrorString & errorDescription)
+{
+    pRawLogEntry = Q_NULLPTR;
+
+    int logFileIndex = m_entries.logFileIndex(row);
+    qint64 offset = m_entries.logEntryOffset(row);
+    qint64 size = m_entries.logEntrySize(row);
+
+    if (Q_UNLIKELY((logFileIndex < 0) || (logFileIndex >= m_logFileChunks.size()) ||
+                   (offset < 0) || (offset + size > m_logFileDataSizes.at(logFileIndex))))
+    {
+        // Same as LogViewerEntryStore::logEntry for the entries out of the known log file data
+        return true;
+    }
+
+    LogFileChunk & chunk = m_logFileChunks[logFileIndex];
+    if ((offset >= chunk.m_offset) && (offset + size <= chunk.m_offset + chunk.m_data.size())) {
+        pRawLogEntry = chunk.m_data.constData() + (offset - chunk.m_offset);
+        return true;
+    }
+
+    // The rows are mostly saved in the order of the log file so each chunk serves many consecutive entries
+    qint64 chunkSize = std::max(size, static_cast<qint64>(LOG_VIEWER_MODEL_FILE_SAVER_READ_CHUNK_SIZE));
+    chunkSize = std::min(chunkSize, m_logFileDataSizes.at(logFileIndex) - offset);
+
+    QFile & logFile = *chunk.m_pFile;
+    chunk.m_offset = offset;
+    chunk.m_data.resize(0);
+    if (Q_UNLIKELY(!logFile.seek(offset))) {
+        errorDescription.setBase(QT_TR_NOOP("Failed to read the data from log file"));
+        errorDescription.details() = logFile.errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    chunk.m_data = logFile.read(chunkSize);
+    if (Q_UNLIKELY(static_cast<qint64>(chunk.m_data.size()) < size)) {
+        errorDescription.setBase(QT_TR_NOOP("Failed to read the data from log file"));
+        errorDescription.details() = logFile.errorString();
+        QNWARNING(errorDescription);
+        chunk.m_data.resize(0);
+        return false;
+    }
+
+    pRawLogEntry = chunk.m_data.constData();
+    return true;
+}
+
+bool LogViewerModel::FileSaverAsync::flushBuffer(QFile & file, QByteArray & buffer)
+{
+    qint64 bytesWritten = file.write(buffer);
+    if (bytesWritten != static_cast<qint64>(buffer.size())) {
+        ErrorString errorDescription(QT_TR_NOOP("Failed to write the log entries to file"));
+        errorDescription.details() = file.errorString();
+        QNWARNING(errorDescription);
+        file.close();
+        Q_EMIT finished(m_targetFilePath, false, errorDescription);
+        return false;
+    }
+
+    buffer.resize(0);
+    return true;
+}
+
+} // namespace quentier
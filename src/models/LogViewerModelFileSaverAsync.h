@@ -0,0 +1,83 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_LOG_VIEWER_MODEL_FILE_SAVER_ASYNC_H
+#define QUENTIER_MODELS_LOG_VIEWER_MODEL_FILE_SAVER_ASYNC_H
+
+#include "LogViewerModel.h"
+#include <QRunnable>
+#include <QFile>
+#include <QVector>
+#include <QStringList>
+#include <QSharedPointer>
+
+namespace quentier {
+
+/**
+ * @brief The LogViewerModel::FileSaverAsync class writes the log viewer model's entries
+ * to a file within the thread pool's thread, entry by entry, without building the whole
+ * contents of the file in memory; the log messages are read from the log files in chunks
+ * rather than from the data the log files are mapped or read into
+ */
+class LogViewerModel::FileSaverAsync: public QObject,
+                                      public QRunnable
+{
+    Q_OBJECT
+public:
+    explicit FileSaverAsync(const LogViewerEntryStore & entries, const QVector<int> & rows, const QString & targetFilePath,
+                            const QSharedPointer<QAtomicInt> & pCanceled,
+                            QObject * parent = Q_NULLPTR);
+
+Q_SIGNALS:
+    void progress(double progress);
+    void finished(QString targetFilePath, bool canceled, ErrorString errorDescription);
+
+private:
+    virtual void run() Q_DECL_OVERRIDE;
+
+    bool openLogFiles(ErrorString & errorDescription);
+    bool readRawLogEntry(const int row, const char *& pRawLogEntry, ErrorString & errorDescription);
+    bool flushBuffer(QFile & file, QByteArray & buffer);
+
+private:
+    struct LogFileChunk
+    {
+        LogFileChunk() :
+            m_pFile(),
+            m_offset(0),
+            m_data()
+        {}
+
+        QSharedPointer<QFile>   m_pFile;
+        qint64                  m_offset;
+        QByteArray              m_data;
+    };
+
+private:
+    LogViewerEntryStore         m_entries;
+    QStringList                 m_logFilePaths;
+    QVector<qint64>             m_logFileDataSizes;
+    QVector<LogFileChunk>       m_logFileChunks;
+    QVector<int>                m_rows;
+    QString                     m_targetFilePath;
+    QSharedPointer<QAtomicInt>  m_pCanceled;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_LOG_VIEWER_MODEL_FILE_SAVER_ASYNC_H
@@ -96,6 +96,8 @@ NoteModel::NoteModel(const Account & account, LocalStorageManagerAsync & localSt
     m_findNotebookRequestForNotebookLocalUid(),
     m_noteItemsPendingNotebookDataUpdate(),
     m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap(),
+    m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook(),
+    m_removedNoteItemsPendingUpdate(),
     m_tagDataByTagLocalUid(),
     m_findTagRequestForTagLocalUid(),
     m_tagLocalUidToNoteLocalUid(),
@@ -290,6 +292,130 @@ void NoteModel::unfavoriteNote(const QString & noteLocalUid)
     setNoteFavorited(noteLocalUid, false);
 }
 
+int NoteModel::deleteNotes(const QStringList & noteLocalUids)
+{
+    NMDEBUG(QStringLiteral("NoteModel::deleteNotes: ") << noteLocalUids.join(QStringLiteral(", ")));
+
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    QVector<NoteModelItem> deletedItems;
+    deletedItems.reserve(noteLocalUids.size());
+
+    QStringList deletedNoteLocalUids;
+    deletedNoteLocalUids.reserve(noteLocalUids.size());
+
+    for(auto it = noteLocalUids.constBegin(), end = noteLocalUids.constEnd(); it != end; ++it)
+    {
+        auto itemIt = localUidIndex.find(*it);
+        if (itemIt == localUidIndex.end()) {
+            NMDEBUG(QStringLiteral("Can't find the note to be deleted within the model: local uid = ") << *it);
+            continue;
+        }
+
+        NoteModelItem item = *itemIt;
+        if (!canUpdateNoteItem(item)) {
+            NMDEBUG(QStringLiteral("Can't delete the note with local uid ") << *it
+                    << QStringLiteral(": the notebook restrictions apply"));
+            continue;
+        }
+
+        item.setDeletionTimestamp(timestamp);
+        item.setDirty(true);
+
+        // Same as in setData: the deletion only counts as the modification if the model includes the deleted notes
+        if (m_includedNotes != IncludedNotes::NonDeleted) {
+            item.setModificationTimestamp(timestamp);
+        }
+
+        Q_UNUSED(localUidIndex.replace(itemIt, item))
+
+        deletedItems << item;
+        deletedNoteLocalUids << item.localUid();
+    }
+
+    if (deletedItems.isEmpty()) {
+        NMDEBUG(QStringLiteral("No notes were deleted"));
+        return 0;
+    }
+
+    bool removeDeletedItems = (m_includedNotes == IncludedNotes::NonDeleted);
+
+    if (removeDeletedItems)
+    {
+        // The notes missing from the cache are fetched from the local storage before the update, the items
+        // are needed after that
+        for(auto it = deletedItems.constBegin(), end = deletedItems.constEnd(); it != end; ++it)
+        {
+            const NoteModelItem & item = *it;
+            if (!m_cache.get(item.localUid())) {
+                m_removedNoteItemsPendingUpdate[item.localUid()] = item;
+            }
+        }
+
+        removeItemsByLocalUids(deletedNoteLocalUids);
+    }
+    else
+    {
+        updateItemRowsWithRespectToSorting();
+        notifyItemsChanged(deletedNoteLocalUids, Columns::ModificationTimestamp, Columns::Dirty);
+    }
+
+    // NOTE: the local storage has no batched note update so each note still gets its own update request;
+    // the replies to these requests don't touch the model's rows which are already up to date
+    for(auto it = deletedItems.constBegin(), end = deletedItems.constEnd(); it != end; ++it) {
+        updateNoteInLocalStorage(*it);
+    }
+
+    return deletedItems.size();
+}
+
+void NoteModel::moveNotesToNotebook(const QStringList & noteLocalUids, const QString & notebookName)
+{
+    NMDEBUG(QStringLiteral("NoteModel::moveNotesToNotebook: note local uids = ")
+            << noteLocalUids.join(QStringLiteral(", ")) << QStringLiteral(", notebook name = ") << notebookName);
+
+    if (Q_UNLIKELY(notebookName.isEmpty())) {
+        REPORT_ERROR(QT_TR_NOOP("Can't move the notes to another notebook: the name of the target notebook is empty"));
+        return;
+    }
+
+    if (noteLocalUids.isEmpty()) {
+        NMDEBUG(QStringLiteral("No notes to move"));
+        return;
+    }
+
+    for(auto nit = m_notebookCache.begin(), end = m_notebookCache.end(); nit != end; ++nit)
+    {
+        const Notebook & notebook = nit->second;
+        if (notebook.hasName() && (notebook.name() == notebookName)) {
+            moveNotesToNotebookImpl(noteLocalUids, notebook);
+            return;
+        }
+    }
+
+    Notebook dummy;
+    dummy.setName(notebookName);
+    dummy.setLocalUid(QString());   // Set empty local uid as a hint for local storage to search the notebook by name
+    QUuid requestId = QUuid::createUuid();
+    m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook[requestId] = noteLocalUids;
+    NMTRACE(QStringLiteral("Emitting the request to find a notebook by name for moving the notes to it: request id = ")
+            << requestId << QStringLiteral(", notebook name = ") << notebookName);
+    Q_EMIT findNotebook(dummy, requestId);
+}
+
+void NoteModel::favoriteNotes(const QStringList & noteLocalUids)
+{
+    NMDEBUG(QStringLiteral("NoteModel::favoriteNotes: ") << noteLocalUids.join(QStringLiteral(", ")));
+    setNotesFavorited(noteLocalUids, true);
+}
+
+void NoteModel::unfavoriteNotes(const QStringList & noteLocalUids)
+{
+    NMDEBUG(QStringLiteral("NoteModel::unfavoriteNotes: ") << noteLocalUids.join(QStringLiteral(", ")));
+    setNotesFavorited(noteLocalUids, false);
+}
+
 Qt::ItemFlags NoteModel::flags(const QModelIndex & modelIndex) const
 {
     Qt::ItemFlags indexFlags = QAbstractItemModel::flags(modelIndex);
@@ -726,65 +852,7 @@ void NoteModel::sort(int column, Qt::SortOrder order)
     m_sortedColumn = static_cast<Columns::type>(column);
     m_sortOrder = order;
 
-    Q_EMIT layoutAboutToBeChanged();
-
-    QModelIndexList persistentIndices = persistentIndexList();
-    QVector<std::pair<QString, int> > localUidsToUpdateWithColumns;
-    localUidsToUpdateWithColumns.reserve(persistentIndices.size());
-
-    QStringList localUidsToUpdate;
-    for(auto it = persistentIndices.begin(), end = persistentIndices.end(); it != end; ++it)
-    {
-        const QModelIndex & modelIndex = *it;
-        int column = modelIndex.column();
-
-        if (!modelIndex.isValid()) {
-            localUidsToUpdateWithColumns << std::pair<QString, int>(QString(), column);
-            continue;
-        }
-
-        int row = modelIndex.row();
-
-        if ((row < 0) || (row >= static_cast<int>(m_data.size())) ||
-            (column < 0) || (column >= NUM_NOTE_MODEL_COLUMNS))
-        {
-            localUidsToUpdateWithColumns << std::pair<QString, int>(QString(), column);
-        }
-
-        auto itemIt = index.begin() + row;
-        const NoteModelItem & item = *itemIt;
-        localUidsToUpdateWithColumns << std::pair<QString, int>(item.localUid(), column);
-    }
-
-    std::vector<boost::reference_wrapper<const NoteModelItem> > items(index.begin(), index.end());
-    std::sort(items.begin(), items.end(), NoteComparator(m_sortedColumn, m_sortOrder));
-    index.rearrange(items.begin());
-
-    QModelIndexList replacementIndices;
-    replacementIndices.reserve(std::max(localUidsToUpdateWithColumns.size(), 0));
-    for(auto it = localUidsToUpdateWithColumns.begin(), end = localUidsToUpdateWithColumns.end(); it != end; ++it)
-    {
-        const QString & localUid = it->first;
-        const int column = it->second;
-
-        if (localUid.isEmpty()) {
-            replacementIndices << QModelIndex();
-            continue;
-        }
-
-        QModelIndex newIndex = indexForLocalUid(localUid);
-        if (!newIndex.isValid()) {
-            replacementIndices << QModelIndex();
-            continue;
-        }
-
-        QModelIndex newIndexWithColumn = createIndex(newIndex.row(), column);
-        replacementIndices << newIndexWithColumn;
-    }
-
-    changePersistentIndexList(persistentIndices, replacementIndices);
-
-    Q_EMIT layoutChanged();
+    updateItemRowsWithRespectToSorting();
 }
 
 void NoteModel::onAddNoteComplete(Note note, QUuid requestId)
@@ -928,6 +996,14 @@ void NoteModel::onFindNoteComplete(Note note, bool withResourceBinaryData, QUuid
         auto it = localUidIndex.find(note.localUid());
         if (it != localUidIndex.end()) {
             updateNoteInLocalStorage(*it);
+            return;
+        }
+
+        auto removedItemIt = m_removedNoteItemsPendingUpdate.find(note.localUid());
+        if (removedItemIt != m_removedNoteItemsPendingUpdate.end()) {
+            NoteModelItem item = removedItemIt.value();
+            Q_UNUSED(m_removedNoteItemsPendingUpdate.erase(removedItemIt))
+            updateNoteInLocalStorage(item);
         }
     }
 }
@@ -952,6 +1028,7 @@ void NoteModel::onFindNoteFailed(Note note, bool withResourceBinaryData, ErrorSt
     }
     else if (performUpdateIt != m_findNoteToPerformUpdateRequestIds.end()) {
         Q_UNUSED(m_findNoteToPerformUpdateRequestIds.erase(performUpdateIt))
+        Q_UNUSED(m_removedNoteItemsPendingUpdate.remove(note.localUid()))
     }
 
     Q_EMIT notifyError(errorDescription);
@@ -1042,11 +1119,13 @@ void NoteModel::onFindNotebookComplete(Notebook notebook, QUuid requestId)
 {
     auto fit = m_findNotebookRequestForNotebookLocalUid.right.find(requestId);
     auto mit = ((fit == m_findNotebookRequestForNotebookLocalUid.right.end())
-                ? m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.end()
-                : m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.find(requestId));
+                ? m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.find(requestId)
+                : m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.end());
+    auto bit = m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook.find(requestId);
 
     if ( (fit == m_findNotebookRequestForNotebookLocalUid.right.end()) &&
-         (mit == m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.end()) )
+         (mit == m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.end()) &&
+         (bit == m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook.end()) )
     {
         return;
     }
@@ -1077,17 +1156,25 @@ void NoteModel::onFindNotebookComplete(Notebook notebook, QUuid requestId)
 
         moveNoteToNotebookImpl(it, notebook);
     }
+    else if (bit != m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook.end())
+    {
+        QStringList noteLocalUids = bit.value();
+        Q_UNUSED(m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook.erase(bit))
+        moveNotesToNotebookImpl(noteLocalUids, notebook);
+    }
 }
 
 void NoteModel::onFindNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId)
 {
     auto fit = m_findNotebookRequestForNotebookLocalUid.right.find(requestId);
     auto mit = ((fit == m_findNotebookRequestForNotebookLocalUid.right.end())
-                ? m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.end()
-                : m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.find(requestId));
+                ? m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.find(requestId)
+                : m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.end());
+    auto bit = m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook.find(requestId);
 
     if ( (fit == m_findNotebookRequestForNotebookLocalUid.right.end()) &&
-         (mit == m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.end()) )
+         (mit == m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap.right.end()) &&
+         (bit == m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook.end()) )
     {
         return;
     }
@@ -1111,6 +1198,17 @@ void NoteModel::onFindNotebookFailed(Notebook notebook, ErrorString errorDescrip
         NMDEBUG(error);
         Q_EMIT notifyError(error);
     }
+    else if (bit != m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook.end())
+    {
+        Q_UNUSED(m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook.erase(bit))
+
+        ErrorString error(QT_TR_NOOP("Can't move the notes to another notebook: failed to find the target notebook"));
+        error.appendBase(errorDescription.base());
+        error.appendBase(errorDescription.additionalBases());
+        error.details() = errorDescription.details();
+        NMDEBUG(error);
+        Q_EMIT notifyError(error);
+    }
 }
 
 void NoteModel::onAddNotebookComplete(Notebook notebook, QUuid requestId)
@@ -1541,6 +1639,51 @@ void NoteModel::removeItemByLocalUid(const QString & localUid)
     endRemoveRows();
 }
 
+void NoteModel::removeItemsByLocalUids(const QStringList & localUids)
+{
+    NMDEBUG(QStringLiteral("NoteModel::removeItemsByLocalUids: ") << localUids.join(QStringLiteral(", ")));
+
+    NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+    NoteDataByIndex & index = m_data.get<ByIndex>();
+
+    std::vector<int> rows;
+    rows.reserve(static_cast<size_t>(localUids.size()));
+
+    for(auto it = localUids.constBegin(), end = localUids.constEnd(); it != end; ++it)
+    {
+        auto itemIt = localUidIndex.find(*it);
+        if (Q_UNLIKELY(itemIt == localUidIndex.end())) {
+            NMDEBUG(QStringLiteral("Can't find item to remove from the note model: local uid = ") << *it);
+            continue;
+        }
+
+        auto indexIt = m_data.project<ByIndex>(itemIt);
+        rows.push_back(static_cast<int>(std::distance(index.begin(), indexIt)));
+    }
+
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    // Remove the contiguous ranges of rows starting from the last one so that the rows yet to be removed keep
+    // their positions
+    int i = static_cast<int>(rows.size()) - 1;
+    while(i >= 0)
+    {
+        int lastRow = rows[static_cast<size_t>(i)];
+        int firstRow = lastRow;
+        while((i > 0) && (rows[static_cast<size_t>(i - 1)] == firstRow - 1)) {
+            --i;
+            firstRow = rows[static_cast<size_t>(i)];
+        }
+        --i;
+
+        NMTRACE(QStringLiteral("Removing rows ") << firstRow << QStringLiteral(" - ") << lastRow);
+        beginRemoveRows(QModelIndex(), firstRow, lastRow);
+        Q_UNUSED(index.erase(index.begin() + firstRow, index.begin() + lastRow + 1))
+        endRemoveRows();
+    }
+}
+
 void NoteModel::updateItemRowWithRespectToSorting(const NoteModelItem & item)
 {
     NMDEBUG(QStringLiteral("NoteModel::updateItemRowWithRespectToSorting: item local uid = ")
@@ -1597,6 +1740,108 @@ void NoteModel::updateItemRowWithRespectToSorting(const NoteModelItem & item)
     endInsertRows();
 }
 
+void NoteModel::updateItemRowsWithRespectToSorting()
+{
+    NMDEBUG(QStringLiteral("NoteModel::updateItemRowsWithRespectToSorting"));
+
+    NoteDataByIndex & index = m_data.get<ByIndex>();
+
+    Q_EMIT layoutAboutToBeChanged();
+
+    QModelIndexList persistentIndices = persistentIndexList();
+    QVector<std::pair<QString, int> > localUidsToUpdateWithColumns;
+    localUidsToUpdateWithColumns.reserve(persistentIndices.size());
+
+    QStringList localUidsToUpdate;
+    for(auto it = persistentIndices.begin(), end = persistentIndices.end(); it != end; ++it)
+    {
+        const QModelIndex & modelIndex = *it;
+        int column = modelIndex.column();
+
+        if (!modelIndex.isValid()) {
+            localUidsToUpdateWithColumns << std::pair<QString, int>(QString(), column);
+            continue;
+        }
+
+        int row = modelIndex.row();
+
+        if ((row < 0) || (row >= static_cast<int>(m_data.size())) ||
+            (column < 0) || (column >= NUM_NOTE_MODEL_COLUMNS))
+        {
+            localUidsToUpdateWithColumns << std::pair<QString, int>(QString(), column);
+            continue;
+        }
+
+        auto itemIt = index.begin() + row;
+        const NoteModelItem & item = *itemIt;
+        localUidsToUpdateWithColumns << std::pair<QString, int>(item.localUid(), column);
+    }
+
+    std::vector<boost::reference_wrapper<const NoteModelItem> > items(index.begin(), index.end());
+    std::sort(items.begin(), items.end(), NoteComparator(m_sortedColumn, m_sortOrder));
+    index.rearrange(items.begin());
+
+    QModelIndexList replacementIndices;
+    replacementIndices.reserve(std::max(localUidsToUpdateWithColumns.size(), 0));
+    for(auto it = localUidsToUpdateWithColumns.begin(), end = localUidsToUpdateWithColumns.end(); it != end; ++it)
+    {
+        const QString & localUid = it->first;
+        const int column = it->second;
+
+        if (localUid.isEmpty()) {
+            replacementIndices << QModelIndex();
+            continue;
+        }
+
+        QModelIndex newIndex = indexForLocalUid(localUid);
+        if (!newIndex.isValid()) {
+            replacementIndices << QModelIndex();
+            continue;
+        }
+
+        QModelIndex newIndexWithColumn = createIndex(newIndex.row(), column);
+        replacementIndices << newIndexWithColumn;
+    }
+
+    changePersistentIndexList(persistentIndices, replacementIndices);
+
+    Q_EMIT layoutChanged();
+}
+
+void NoteModel::notifyItemsChanged(const QStringList & localUids, const Columns::type firstColumn,
+                                   const Columns::type lastColumn)
+{
+    int firstRow = -1;
+    int lastRow = -1;
+
+    for(auto it = localUids.constBegin(), end = localUids.constEnd(); it != end; ++it)
+    {
+        QModelIndex modelIndex = indexForLocalUid(*it);
+        if (!modelIndex.isValid()) {
+            continue;
+        }
+
+        int row = modelIndex.row();
+
+        if ((firstRow < 0) || (row < firstRow)) {
+            firstRow = row;
+        }
+
+        if (row > lastRow) {
+            lastRow = row;
+        }
+    }
+
+    if (firstRow < 0) {
+        NMDEBUG(QStringLiteral("None of the changed items were found within the model"));
+        return;
+    }
+
+    QModelIndex topLeftChangedIndex = createIndex(firstRow, firstColumn);
+    QModelIndex bottomRightChangedIndex = createIndex(lastRow, lastColumn);
+    Q_EMIT dataChanged(topLeftChangedIndex, bottomRightChangedIndex);
+}
+
 void NoteModel::updateNoteInLocalStorage(const NoteModelItem & item, const bool updateTags)
 {
     NMDEBUG(QStringLiteral("NoteModel::updateNoteInLocalStorage: local uid = ")
@@ -1852,6 +2097,32 @@ void NoteModel::setNoteFavorited(const QString & noteLocalUid, const bool favori
     updateNoteInLocalStorage(itemCopy);
 }
 
+void NoteModel::setNotesFavorited(const QStringList & noteLocalUids, const bool favorited)
+{
+    NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    // NOTE: the favorited flag is not shown within any column so the model has nothing to notify the views of;
+    // one update request per note as the local storage has no batched note update, see deleteNotes
+    for(auto uit = noteLocalUids.constBegin(), uend = noteLocalUids.constEnd(); uit != uend; ++uit)
+    {
+        auto it = localUidIndex.find(*uit);
+        if (Q_UNLIKELY(it == localUidIndex.end())) {
+            NMDEBUG(QStringLiteral("Can't find the note to be favorited/unfavorited within the model: local uid = ") << *uit);
+            continue;
+        }
+
+        if (favorited == it->isFavorited()) {
+            continue;
+        }
+
+        NoteModelItem itemCopy(*it);
+        itemCopy.setFavorited(favorited);
+
+        localUidIndex.replace(it, itemCopy);
+        updateNoteInLocalStorage(itemCopy);
+    }
+}
+
 void NoteModel::checkAddedNoteItemsPendingNotebookData(const QString & notebookLocalUid, const NotebookData & notebookData)
 {
     auto it = m_noteItemsPendingNotebookDataUpdate.find(notebookLocalUid);
@@ -2121,6 +2392,70 @@ void NoteModel::moveNoteToNotebookImpl(NoteDataByLocalUid::iterator it, const No
     updateNoteInLocalStorage(item);
 }
 
+void NoteModel::moveNotesToNotebookImpl(const QStringList & noteLocalUids, const Notebook & notebook)
+{
+    NMDEBUG(QStringLiteral("NoteModel::moveNotesToNotebookImpl: notebook = ") << notebook
+            << QStringLiteral(", note local uids: ") << noteLocalUids.join(QStringLiteral(", ")));
+
+    if (!notebook.canCreateNotes()) {
+        ErrorString error(QT_TR_NOOP("Can't move the notes to another notebook: the target notebook "
+                                     "doesn't allow to create notes in it"));
+        NMINFO(error << QStringLiteral(", notebook: ") << notebook);
+        Q_EMIT notifyError(error);
+        return;
+    }
+
+    QString notebookName = (notebook.hasName() ? notebook.name() : QString());
+    QString notebookGuid = (notebook.hasGuid() ? notebook.guid() : QString());
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    QVector<NoteModelItem> movedItems;
+    movedItems.reserve(noteLocalUids.size());
+
+    QStringList movedNoteLocalUids;
+    movedNoteLocalUids.reserve(noteLocalUids.size());
+
+    for(auto uit = noteLocalUids.constBegin(), uend = noteLocalUids.constEnd(); uit != uend; ++uit)
+    {
+        auto it = localUidIndex.find(*uit);
+        if (Q_UNLIKELY(it == localUidIndex.end())) {
+            NMDEBUG(QStringLiteral("Can't find the note to be moved within the model: local uid = ") << *uit);
+            continue;
+        }
+
+        NoteModelItem item = *it;
+        if (item.notebookLocalUid() == notebook.localUid()) {
+            continue;
+        }
+
+        item.setNotebookLocalUid(notebook.localUid());
+        item.setNotebookName(notebookName);
+        item.setNotebookGuid(notebookGuid);
+
+        item.setDirty(true);
+        item.setModificationTimestamp(timestamp);
+
+        localUidIndex.replace(it, item);
+        movedItems << item;
+        movedNoteLocalUids << item.localUid();
+    }
+
+    if (movedItems.isEmpty()) {
+        NMDEBUG(QStringLiteral("All the notes are already within the target notebook, nothing to do"));
+        return;
+    }
+
+    updateItemRowsWithRespectToSorting();
+    notifyItemsChanged(movedNoteLocalUids, Columns::ModificationTimestamp, Columns::Dirty);
+
+    // NOTE: one update request per note as the local storage has no batched note update, see deleteNotes
+    for(auto it = movedItems.constBegin(), end = movedItems.constEnd(); it != end; ++it) {
+        updateNoteInLocalStorage(*it);
+    }
+}
+
 void NoteModel::checkAndNotifyAllNotesListed()
 {
     NMDEBUG(QStringLiteral("NoteModel::checkAndNotifyAllNotesListed"));
@@ -148,6 +148,40 @@ public:
      */
     void unfavoriteNote(const QString & noteLocalUid);
 
+    /**
+     * @brief deleteNotes - attempts to mark the notes with the specified local uids as deleted
+     *
+     * Unlike @link deleteNote @endlink called for each note, this method updates the model at once:
+     * the rows of the deleted notes are either removed in contiguous ranges or re-sorted within a single layout change,
+     * depending on which notes the model includes, followed by a single dataChanged signal for the kept rows;
+     * the local storage has no batched note update so the requests to update the notes in it are still issued
+     * one per note, one after another without waiting for the model to process each of them
+     *
+     * @param noteLocalUids - the local uids of notes to be marked as deleted
+     * @return the number of notes marked as deleted; the notes not contained in the model or within notebooks
+     * restricting the update of notes are skipped
+     */
+    int deleteNotes(const QStringList & noteLocalUids);
+
+    /**
+     * @brief moveNotesToNotebook - attempts to move the notes to a different notebook; the model is updated
+     * within a single layout change followed by a single dataChanged signal
+     *
+     * @param noteLocalUids - the local uids of notes to be moved to another notebook
+     * @param notebookName - the name of the notebook into which the notes need to be moved
+     */
+    void moveNotesToNotebook(const QStringList & noteLocalUids, const QString & notebookName);
+
+    /**
+     * @brief favoriteNotes - attempts to mark the notes with the specified local uids as favorited
+     */
+    void favoriteNotes(const QStringList & noteLocalUids);
+
+    /**
+     * @brief unfavoriteNotes - attempts to remove the favorited mark from the notes with the specified local uids
+     */
+    void unfavoriteNotes(const QStringList & noteLocalUids);
+
 public:
     // QAbstractItemModel interface
     virtual Qt::ItemFlags flags(const QModelIndex & index) const Q_DECL_OVERRIDE;
@@ -226,7 +260,14 @@ private:
 
     void processTagExpunging(const QString & tagLocalUid);
     void removeItemByLocalUid(const QString & localUid);
+    void removeItemsByLocalUids(const QStringList & localUids);
     void updateItemRowWithRespectToSorting(const NoteModelItem & item);
+    void updateItemRowsWithRespectToSorting();
+
+    // Emits a single dataChanged signal for the rows spanned by the items with the specified local uids
+    void notifyItemsChanged(const QStringList & localUids, const Columns::type firstColumn,
+                            const Columns::type lastColumn);
+
     void updateNoteInLocalStorage(const NoteModelItem & item, const bool updateTags = false);
 
     // Returns the appropriate row before which the new item should be inserted according to the current sorting criteria and column
@@ -239,6 +280,7 @@ private:
     void updateTagData(const Tag & tag);
 
     void setNoteFavorited(const QString & noteLocalUid, const bool favorited);
+    void setNotesFavorited(const QStringList & noteLocalUids, const bool favorited);
 
 private:
     struct ByLocalUid{};
@@ -321,6 +363,7 @@ private:
     void findTagNamesForItem(NoteModelItem & item);
 
     void moveNoteToNotebookImpl(NoteDataByLocalUid::iterator it, const Notebook & notebook);
+    void moveNotesToNotebookImpl(const QStringList & noteLocalUids, const Notebook & notebook);
 
     void checkAndNotifyAllNotesListed();
 
@@ -353,6 +396,11 @@ private:
     QMultiHash<QString, NoteModelItem>  m_noteItemsPendingNotebookDataUpdate;   // The key is notebook local uid
 
     LocalUidToRequestIdBimap            m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap;
+    QHash<QUuid, QStringList>           m_noteLocalUidsByFindNotebookRequestIdForMoveNotesToNotebook;
+
+    // The items of notes deleted in batch and removed from the model before their update in the local storage,
+    // pending the fetch of the note from the local storage
+    QHash<QString, NoteModelItem>       m_removedNoteItemsPendingUpdate;
 
     QHash<QString, TagData>             m_tagDataByTagLocalUid;
 
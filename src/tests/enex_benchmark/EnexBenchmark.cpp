@@ -0,0 +1,502 @@
+#include "EnexBenchmark.h"
+#include "../../EnexImporter.h"
+#include "../../EnexExporter.h"
+#include "../../models/NoteModel.h"
+#include "../../models/NotebookModel.h"
+#include "../../models/TagModel.h"
+#include "../../models/NoteCache.h"
+#include "../../models/NotebookCache.h"
+#include "../../models/TagCache.h"
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <quentier/utility/EventLoopWithExitStatus.h>
+#include <quentier/utility/StandardPaths.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QCoreApplication>
+#include <QThread>
+#include <QTimer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QXmlStreamWriter>
+#include <QCryptographicHash>
+#include <QTextStream>
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// 30 minutes, the timeout for each stage of the benchmark
+#define ENEX_BENCHMARK_MAX_ALLOWED_MSEC (1800000)
+
+#define ENEX_BENCHMARK_NOTEBOOK_NAME QStringLiteral("ENEX benchmark")
+
+namespace quentier {
+
+EnexBenchmark::Options::Options() :
+    m_numNotes(1000),
+    m_noteTextSize(2048),
+    m_numResourcesPerNote(1),
+    m_resourceSize(64 * 1024),
+    m_numTags(50),
+    m_numTagsPerNote(3)
+{}
+
+EnexBenchmark::EnexBenchmark(const Options & options, QObject * parent) :
+    QObject(parent),
+    m_options(options),
+    m_pImporter(Q_NULLPTR),
+    m_pExporter(Q_NULLPTR)
+{}
+
+bool EnexBenchmark::parseOptions(const QStringList & arguments, Options & options, QString & errorDescription)
+{
+    // The first argument is the name of the executable
+    for(int i = 1, size = arguments.size(); i < size; ++i)
+    {
+        const QString & argument = arguments.at(i);
+
+        int * pValue = Q_NULLPTR;
+        if (argument == QStringLiteral("--notes")) {
+            pValue = &options.m_numNotes;
+        }
+        else if (argument == QStringLiteral("--note-text-size")) {
+            pValue = &options.m_noteTextSize;
+        }
+        else if (argument == QStringLiteral("--resources-per-note")) {
+            pValue = &options.m_numResourcesPerNote;
+        }
+        else if (argument == QStringLiteral("--resource-size")) {
+            pValue = &options.m_resourceSize;
+        }
+        else if (argument == QStringLiteral("--tags")) {
+            pValue = &options.m_numTags;
+        }
+        else if (argument == QStringLiteral("--tags-per-note")) {
+            pValue = &options.m_numTagsPerNote;
+        }
+        else {
+            errorDescription = QStringLiteral("Unrecognized argument: ") + argument;
+            return false;
+        }
+
+        if ((i + 1) >= size) {
+            errorDescription = QStringLiteral("No value for argument ") + argument;
+            return false;
+        }
+
+        ++i;
+        bool conversionResult = false;
+        int value = arguments.at(i).toInt(&conversionResult);
+        if (!conversionResult || (value < 0)) {
+            errorDescription = QStringLiteral("Invalid value for argument ") + argument + QStringLiteral(": ") +
+                               arguments.at(i);
+            return false;
+        }
+
+        *pValue = value;
+    }
+
+    if (options.m_numNotes == 0) {
+        errorDescription = QStringLiteral("The number of notes must be positive");
+        return false;
+    }
+
+    options.m_numTagsPerNote = std::min(options.m_numTagsPerNote, options.m_numTags);
+    return true;
+}
+
+QString EnexBenchmark::usage()
+{
+    Options defaultOptions;
+    QString result;
+    QTextStream strm(&result);
+    strm << QStringLiteral("Usage: quentier_enex_benchmark [options]\n")
+         << QStringLiteral("  --notes <n>                 number of notes (default ")
+         << defaultOptions.m_numNotes << QStringLiteral(")\n")
+         << QStringLiteral("  --note-text-size <bytes>    size of each note's text (default ")
+         << defaultOptions.m_noteTextSize << QStringLiteral(")\n")
+         << QStringLiteral("  --resources-per-note <n>    number of resources per note (default ")
+         << defaultOptions.m_numResourcesPerNote << QStringLiteral(")\n")
+         << QStringLiteral("  --resource-size <bytes>     size of each resource's data (default ")
+         << defaultOptions.m_resourceSize << QStringLiteral(")\n")
+         << QStringLiteral("  --tags <n>                  number of distinct tags (default ")
+         << defaultOptions.m_numTags << QStringLiteral(")\n")
+         << QStringLiteral("  --tags-per-note <n>         number of tags per note (default ")
+         << defaultOptions.m_numTagsPerNote << QStringLiteral(")\n");
+    strm.flush();
+    return result;
+}
+
+int EnexBenchmark::run()
+{
+    QString tempDirPath = QDir::tempPath() + QStringLiteral("/quentier_enex_benchmark_") +
+                          QString::number(QCoreApplication::applicationPid());
+    if (!QDir().mkpath(tempDirPath)) {
+        QTextStream(stderr) << QStringLiteral("Can't create the temporary directory ") << tempDirPath << endl;
+        return 1;
+    }
+
+    // The account is unique per run so that the local storage, the import checkpoints and the hashes
+    // of imported notes of the previous runs don't affect the measurements
+    Account account(QStringLiteral("EnexBenchmark_") + QString::number(QDateTime::currentMSecsSinceEpoch()),
+                    Account::Type::Local);
+
+    int res = runStages(account, tempDirPath);
+
+    Q_UNUSED(removeDirRecursively(tempDirPath))
+    Q_UNUSED(removeDirRecursively(accountPersistentStoragePath(account)))
+    return res;
+}
+
+int EnexBenchmark::runStages(const Account & account, const QString & tempDirPath)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QString importedEnexFilePath = tempDirPath + QStringLiteral("/imported.enex");
+    QString exportedEnexFilePath = tempDirPath + QStringLiteral("/exported.enex");
+
+    out << QStringLiteral("Generating ENEX with ") << m_options.m_numNotes << QStringLiteral(" notes, ")
+        << m_options.m_numResourcesPerNote << QStringLiteral(" resources of ") << m_options.m_resourceSize
+        << QStringLiteral(" bytes per note, ") << m_options.m_numTagsPerNote << QStringLiteral(" of ")
+        << m_options.m_numTags << QStringLiteral(" tags per note") << endl;
+
+    ErrorString errorDescription;
+    if (!generateEnexFile(importedEnexFilePath, errorDescription)) {
+        err << QStringLiteral("Failed to generate the ENEX file: ") << errorDescription.nonLocalizedString() << endl;
+        return 1;
+    }
+
+    // The local storage works in its own thread, the same way as in the application
+    QThread * pLocalStorageManagerThread = new QThread;
+    pLocalStorageManagerThread->start();
+
+    LocalStorageManagerAsync * pLocalStorageManagerAsync = new LocalStorageManagerAsync(account,
+                                                                                        /* start from scratch = */ true,
+                                                                                        /* override lock = */ false);
+    pLocalStorageManagerAsync->init();
+    pLocalStorageManagerAsync->moveToThread(pLocalStorageManagerThread);
+    QObject::connect(pLocalStorageManagerThread, QNSIGNAL(QThread,finished),
+                     pLocalStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,deleteLater));
+
+    int res = 0;
+
+    {
+        NoteCache noteCache;
+        NotebookCache notebookCache;
+        TagCache tagCache;
+
+        NoteModel noteModel(account, *pLocalStorageManagerAsync, noteCache, notebookCache,
+                            Q_NULLPTR, NoteModel::IncludedNotes::NonDeleted);
+        NotebookModel notebookModel(account, noteModel, *pLocalStorageManagerAsync, notebookCache);
+        TagModel tagModel(account, noteModel, *pLocalStorageManagerAsync, tagCache);
+
+        // Import stage
+        {
+            QTimer timer;
+            timer.setInterval(ENEX_BENCHMARK_MAX_ALLOWED_MSEC);
+            timer.setSingleShot(true);
+
+            EnexImporter importer(importedEnexFilePath, ENEX_BENCHMARK_NOTEBOOK_NAME, account,
+                                  *pLocalStorageManagerAsync, tagModel, notebookModel);
+
+            EventLoopWithExitStatus loop;
+            loop.connect(&timer, SIGNAL(timeout()), SLOT(exitAsTimeout()));
+            loop.connect(&importer, SIGNAL(enexImportedSuccessfully(QString)), SLOT(exitAsSuccess()));
+            loop.connect(&importer, SIGNAL(enexImportFailed(ErrorString)),
+                         SLOT(exitAsFailureWithErrorString(ErrorString)));
+
+            QElapsedTimer importTimer;
+            importTimer.start();
+            timer.start();
+            m_pImporter = &importer;
+            QTimer::singleShot(0, this, SLOT(startImport()));
+            int status = loop.exec();
+            m_pImporter = Q_NULLPTR;
+            qint64 elapsedMsec = importTimer.elapsed();
+
+            if (status == EventLoopWithExitStatus::ExitStatus::Success) {
+                printResults(QStringLiteral("Import"), m_options.m_numNotes, QFileInfo(importedEnexFilePath).size(),
+                             elapsedMsec);
+            }
+            else if (status == EventLoopWithExitStatus::ExitStatus::Timeout) {
+                err << QStringLiteral("ENEX import failed to finish in time") << endl;
+                res = 1;
+            }
+            else {
+                err << QStringLiteral("ENEX import failed: ") << loop.errorDescription().nonLocalizedString() << endl;
+                res = 1;
+            }
+        }
+
+        // The export stage is only meaningful if each of the generated notes has been imported exactly once
+        if ((res == 0) && (noteModel.rowCount() != m_options.m_numNotes)) {
+            err << QStringLiteral("Unexpected number of imported notes: expected ") << m_options.m_numNotes
+                << QStringLiteral(", got ") << noteModel.rowCount() << endl;
+            res = 1;
+        }
+
+        // Export stage: all the imported notes are known to the note model by now
+        if (res == 0)
+        {
+            QStringList noteLocalUids;
+            for(int i = 0, numRows = noteModel.rowCount(); i < numRows; ++i)
+            {
+                const NoteModelItem * pItem = noteModel.itemAtRow(i);
+                if (pItem) {
+                    noteLocalUids << pItem->localUid();
+                }
+            }
+
+            QTimer timer;
+            timer.setInterval(ENEX_BENCHMARK_MAX_ALLOWED_MSEC);
+            timer.setSingleShot(true);
+
+            EnexExporter exporter(*pLocalStorageManagerAsync, Q_NULLPTR, tagModel);
+            exporter.setTargetEnexFilePath(exportedEnexFilePath);
+            exporter.setIncludeTags(true);
+            exporter.setNoteLocalUids(noteLocalUids);
+
+            EventLoopWithExitStatus loop;
+            loop.connect(&timer, SIGNAL(timeout()), SLOT(exitAsTimeout()));
+            loop.connect(&exporter, SIGNAL(notesExportedToEnex(QString)), SLOT(exitAsSuccess()));
+            loop.connect(&exporter, SIGNAL(failedToExportNotesToEnex(ErrorString)),
+                         SLOT(exitAsFailureWithErrorString(ErrorString)));
+
+            QElapsedTimer exportTimer;
+            exportTimer.start();
+            timer.start();
+            m_pExporter = &exporter;
+            QTimer::singleShot(0, this, SLOT(startExport()));
+            int status = loop.exec();
+            m_pExporter = Q_NULLPTR;
+            qint64 elapsedMsec = exportTimer.elapsed();
+
+            if (status == EventLoopWithExitStatus::ExitStatus::Success) {
+                printResults(QStringLiteral("Export"), noteLocalUids.size(), QFileInfo(exportedEnexFilePath).size(),
+                             elapsedMsec);
+            }
+            else if (status == EventLoopWithExitStatus::ExitStatus::Timeout) {
+                err << QStringLiteral("ENEX export failed to finish in time") << endl;
+                res = 1;
+            }
+            else {
+                err << QStringLiteral("ENEX export failed: ") << loop.errorDescription().nonLocalizedString() << endl;
+                res = 1;
+            }
+        }
+    }
+
+    pLocalStorageManagerThread->quit();
+    pLocalStorageManagerThread->wait();
+    delete pLocalStorageManagerThread;
+
+    return res;
+}
+
+void EnexBenchmark::startImport()
+{
+    if (m_pImporter) {
+        m_pImporter->start();
+    }
+}
+
+void EnexBenchmark::startExport()
+{
+    if (m_pExporter) {
+        m_pExporter->start();
+    }
+}
+
+bool EnexBenchmark::generateEnexFile(const QString & enexFilePath, ErrorString & errorDescription) const
+{
+    QFile file(enexFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorDescription.setBase(QT_TR_NOOP("can't open file for writing"));
+        errorDescription.details() = file.errorString();
+        return false;
+    }
+
+    // The same data on each run for the measurements to be comparable
+    qsrand(1);
+
+    QString timestamp = QDateTime::currentDateTimeUtc().toString(QStringLiteral("yyyyMMdd'T'hhmmss'Z'"));
+
+    QString textPattern = QStringLiteral("The quick brown fox jumps over the lazy dog. ");
+    QString noteText;
+    noteText.reserve(m_options.m_noteTextSize);
+    while(noteText.size() < m_options.m_noteTextSize) {
+        noteText += textPattern;
+    }
+    noteText.truncate(m_options.m_noteTextSize);
+
+    QXmlStreamWriter writer(&file);
+    writer.writeStartDocument();
+    writer.writeDTD(QStringLiteral("<!DOCTYPE en-export SYSTEM \"http://xml.evernote.com/pub/evernote-export3.dtd\">"));
+
+    writer.writeStartElement(QStringLiteral("en-export"));
+    writer.writeAttribute(QStringLiteral("export-date"), timestamp);
+    writer.writeAttribute(QStringLiteral("application"), QStringLiteral("QuentierEnexBenchmark"));
+    writer.writeAttribute(QStringLiteral("version"), QStringLiteral("1.0"));
+
+    QByteArray resourceData;
+    resourceData.resize(m_options.m_resourceSize);
+
+    for(int noteIndex = 0; noteIndex < m_options.m_numNotes; ++noteIndex)
+    {
+        QStringList resourceHashes;
+        QList<QByteArray> resourcesData;
+        for(int resourceIndex = 0; resourceIndex < m_options.m_numResourcesPerNote; ++resourceIndex)
+        {
+            for(int i = 0; i < m_options.m_resourceSize; ++i) {
+                resourceData[i] = static_cast<char>(qrand() % 256);
+            }
+
+            resourceHashes << QString::fromLatin1(QCryptographicHash::hash(resourceData, QCryptographicHash::Md5).toHex());
+            resourcesData << resourceData.toBase64();
+        }
+
+        writer.writeStartElement(QStringLiteral("note"));
+        writer.writeTextElement(QStringLiteral("title"), QStringLiteral("Benchmark note #") + QString::number(noteIndex));
+
+        // The note index is a part of the content so that none of the notes is skipped as a duplicate on import
+        QString content = QStringLiteral("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                                         "<!DOCTYPE en-note SYSTEM \"http://xml.evernote.com/pub/enml2.dtd\">"
+                                         "<en-note><div>#") + QString::number(noteIndex) + QStringLiteral(": ") +
+                          noteText + QStringLiteral("</div>");
+        for(auto it = resourceHashes.constBegin(), end = resourceHashes.constEnd(); it != end; ++it) {
+            content += QStringLiteral("<div><en-media type=\"application/octet-stream\" hash=\"") + *it +
+                       QStringLiteral("\"/></div>");
+        }
+        content += QStringLiteral("</en-note>");
+
+        writer.writeStartElement(QStringLiteral("content"));
+        writer.writeCDATA(content);
+        writer.writeEndElement();
+
+        writer.writeTextElement(QStringLiteral("created"), timestamp);
+        writer.writeTextElement(QStringLiteral("updated"), timestamp);
+
+        for(int i = 0; i < m_options.m_numTagsPerNote; ++i) {
+            int tagIndex = (noteIndex + i) % m_options.m_numTags;
+            writer.writeTextElement(QStringLiteral("tag"), QStringLiteral("Benchmark tag #") + QString::number(tagIndex));
+        }
+
+        for(int resourceIndex = 0, numResources = resourcesData.size(); resourceIndex < numResources; ++resourceIndex)
+        {
+            writer.writeStartElement(QStringLiteral("resource"));
+
+            writer.writeStartElement(QStringLiteral("data"));
+            writer.writeAttribute(QStringLiteral("encoding"), QStringLiteral("base64"));
+            writer.writeCharacters(QString::fromLatin1(resourcesData.at(resourceIndex)));
+            writer.writeEndElement();
+
+            writer.writeTextElement(QStringLiteral("mime"), QStringLiteral("application/octet-stream"));
+
+            writer.writeStartElement(QStringLiteral("resource-attributes"));
+            writer.writeTextElement(QStringLiteral("file-name"), QStringLiteral("resource_") +
+                                    QString::number(noteIndex) + QStringLiteral("_") +
+                                    QString::number(resourceIndex) + QStringLiteral(".bin"));
+            writer.writeEndElement();
+
+            writer.writeEndElement();
+        }
+
+        writer.writeEndElement();
+
+        if (writer.hasError()) {
+            errorDescription.setBase(QT_TR_NOOP("can't write the ENEX file"));
+            errorDescription.details() = file.errorString();
+            return false;
+        }
+    }
+
+    writer.writeEndElement();
+    writer.writeEndDocument();
+
+    if (writer.hasError()) {
+        errorDescription.setBase(QT_TR_NOOP("can't write the ENEX file"));
+        errorDescription.details() = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void EnexBenchmark::printResults(const QString & stageName, const qint64 numNotes, const qint64 numBytes,
+                                 const qint64 elapsedMsec) const
+{
+    double elapsedSec = std::max(static_cast<double>(elapsedMsec), 1.0) / 1000.0;
+    double notesPerSecond = static_cast<double>(numNotes) / elapsedSec;
+    double megabytesPerSecond = static_cast<double>(numBytes) / (1024.0 * 1024.0) / elapsedSec;
+    qint64 peakRss = peakResidentSetSize();
+
+    QTextStream out(stdout);
+    out << stageName << QStringLiteral(": ") << numNotes << QStringLiteral(" notes, ") << numBytes
+        << QStringLiteral(" bytes in ") << elapsedMsec << QStringLiteral(" msec; ")
+        << QString::number(notesPerSecond, 'f', 1) << QStringLiteral(" notes/s, ")
+        << QString::number(megabytesPerSecond, 'f', 2) << QStringLiteral(" MB/s; peak RSS ");
+    if (peakRss < 0) {
+        out << QStringLiteral("unknown");
+    }
+    else {
+        out << QString::number(static_cast<double>(peakRss) / (1024.0 * 1024.0), 'f', 1) << QStringLiteral(" MB");
+    }
+    out << endl;
+}
+
+qint64 EnexBenchmark::peakResidentSetSize()
+{
+    // NOTE: the peak is process-wide so the value reported after the export stage covers the import stage as well
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return -1;
+    }
+
+    return static_cast<qint64>(counters.PeakWorkingSetSize);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+
+#ifdef Q_OS_MAC
+    // On Mac ru_maxrss is in bytes, elsewhere it's in kilobytes
+    return static_cast<qint64>(usage.ru_maxrss);
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+bool EnexBenchmark::removeDirRecursively(const QString & dirPath)
+{
+    QDir dir(dirPath);
+    if (!dir.exists()) {
+        return true;
+    }
+
+    bool res = true;
+    QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    for(auto it = entries.constBegin(), end = entries.constEnd(); it != end; ++it)
+    {
+        const QFileInfo & entry = *it;
+        if (entry.isDir() && !entry.isSymLink()) {
+            res = removeDirRecursively(entry.absoluteFilePath()) && res;
+        }
+        else {
+            res = QFile::remove(entry.absoluteFilePath()) && res;
+        }
+    }
+
+    return dir.rmdir(dirPath) && res;
+}
+
+} // namespace quentier
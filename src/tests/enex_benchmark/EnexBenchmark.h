@@ -0,0 +1,76 @@
+#ifndef QUENTIER_TESTS_ENEX_BENCHMARK_ENEX_BENCHMARK_H
+#define QUENTIER_TESTS_ENEX_BENCHMARK_ENEX_BENCHMARK_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Account.h>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(EnexImporter)
+QT_FORWARD_DECLARE_CLASS(EnexExporter)
+
+/**
+ * @brief The EnexBenchmark class measures the throughput of ENEX import and export
+ *
+ * The benchmark generates the synthetic ENEX file with the given number of notes, resources and tags, imports it
+ * with EnexImporter into the local storage of a temporary account, exports all the imported notes back to ENEX
+ * with EnexExporter and prints notes per second, megabytes per second and the peak resident set size
+ * for both stages
+ */
+class EnexBenchmark: public QObject
+{
+    Q_OBJECT
+public:
+    struct Options
+    {
+        Options();
+
+        int     m_numNotes;
+        int     m_noteTextSize;
+        int     m_numResourcesPerNote;
+        int     m_resourceSize;
+        int     m_numTags;
+        int     m_numTagsPerNote;
+    };
+
+    explicit EnexBenchmark(const Options & options, QObject * parent = Q_NULLPTR);
+
+    /**
+     * Parses the benchmark options from the command line arguments; returns false and fills
+     * @param errorDescription if some argument is not recognized or has an invalid value
+     */
+    static bool parseOptions(const QStringList & arguments, Options & options, QString & errorDescription);
+    static QString usage();
+
+    /**
+     * Runs the benchmark; returns 0 on success
+     */
+    int run();
+
+private Q_SLOTS:
+    // The stages are started from within the running event loop as their failures to start are reported synchronously
+    void startImport();
+    void startExport();
+
+private:
+    int runStages(const Account & account, const QString & tempDirPath);
+    bool generateEnexFile(const QString & enexFilePath, ErrorString & errorDescription) const;
+    void printResults(const QString & stageName, const qint64 numNotes, const qint64 numBytes,
+                      const qint64 elapsedMsec) const;
+
+    static qint64 peakResidentSetSize();
+    static bool removeDirRecursively(const QString & dirPath);
+
+private:
+    Options         m_options;
+    EnexImporter *  m_pImporter;
+    EnexExporter *  m_pExporter;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_TESTS_ENEX_BENCHMARK_ENEX_BENCHMARK_H
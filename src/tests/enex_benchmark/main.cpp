@@ -0,0 +1,31 @@
+#include "EnexBenchmark.h"
+#include <quentier/utility/Utility.h>
+#include <QApplication>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    // Keep the settings and the data of the benchmark apart from those of the application
+    app.setOrganizationName(QStringLiteral("quentier.org"));
+    app.setApplicationName(QStringLiteral("QuentierEnexBenchmark"));
+
+    quentier::initializeLibquentier();
+
+    QStringList arguments = app.arguments();
+    if (arguments.contains(QStringLiteral("--help")) || arguments.contains(QStringLiteral("-h"))) {
+        QTextStream(stdout) << quentier::EnexBenchmark::usage();
+        return 0;
+    }
+
+    quentier::EnexBenchmark::Options options;
+    QString errorDescription;
+    if (!quentier::EnexBenchmark::parseOptions(arguments, options, errorDescription)) {
+        QTextStream(stderr) << errorDescription << QStringLiteral("\n") << quentier::EnexBenchmark::usage();
+        return 1;
+    }
+
+    quentier::EnexBenchmark benchmark(options);
+    return benchmark.run();
+}
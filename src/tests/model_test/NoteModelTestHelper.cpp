@@ -32,7 +32,12 @@ NoteModelTestHelper::NoteModelTestHelper(LocalStorageManagerAsync * pLocalStorag
     m_pLocalStorageManagerAsync(pLocalStorageManagerAsync),
     m_model(Q_NULLPTR),
     m_firstNotebook(),
+    m_secondNotebook(),
     m_noteToExpungeLocalUid(),
+    m_noteLocalUidsToDeleteInBatch(),
+    m_noteLocalUidsToMoveInBatch(),
+    m_noteLocalUidsPendingBatchDeletion(),
+    m_noteLocalUidsPendingBatchMove(),
     m_expectingNewNoteFromLocalStorage(false),
     m_expectingNoteUpdateFromLocalStorage(false),
     m_expectingNoteDeletionFromLocalStorage(false),
@@ -194,12 +199,61 @@ void NoteModelTestHelper::launchTest()
         sixthNote.setTagLocalUids(QStringList() << fourthTag.localUid());
         sixthNote.setTagGuids(QStringList() << fourthTag.guid());
 
+        // The notes for the batch deletion and move checks, not touched by the other checks
+        Note seventhNote;
+        seventhNote.setGuid(UidGenerator::Generate());
+        seventhNote.setTitle(QStringLiteral("Seventh note"));
+        seventhNote.setContent(QStringLiteral("<en-note><h1>Seventh note</h1></en-note>"));
+        seventhNote.setCreationTimestamp(QDateTime::currentMSecsSinceEpoch());
+        seventhNote.setModificationTimestamp(seventhNote.creationTimestamp());
+        seventhNote.setNotebookLocalUid(secondNotebook.localUid());
+        seventhNote.setNotebookGuid(secondNotebook.guid());
+        seventhNote.setLocal(false);
+        seventhNote.setDirty(false);
+
+        Note eighthNote;
+        eighthNote.setGuid(UidGenerator::Generate());
+        eighthNote.setTitle(QStringLiteral("Eighth note"));
+        eighthNote.setContent(QStringLiteral("<en-note><h1>Eighth note</h1></en-note>"));
+        eighthNote.setCreationTimestamp(QDateTime::currentMSecsSinceEpoch());
+        eighthNote.setModificationTimestamp(eighthNote.creationTimestamp());
+        eighthNote.setNotebookLocalUid(secondNotebook.localUid());
+        eighthNote.setNotebookGuid(secondNotebook.guid());
+        eighthNote.setLocal(false);
+        eighthNote.setDirty(false);
+
+        Note ninthNote;
+        ninthNote.setGuid(UidGenerator::Generate());
+        ninthNote.setTitle(QStringLiteral("Ninth note"));
+        ninthNote.setContent(QStringLiteral("<en-note><h1>Ninth note</h1></en-note>"));
+        ninthNote.setCreationTimestamp(QDateTime::currentMSecsSinceEpoch());
+        ninthNote.setModificationTimestamp(ninthNote.creationTimestamp());
+        ninthNote.setNotebookLocalUid(secondNotebook.localUid());
+        ninthNote.setNotebookGuid(secondNotebook.guid());
+        ninthNote.setLocal(false);
+        ninthNote.setDirty(false);
+
+        Note tenthNote;
+        tenthNote.setGuid(UidGenerator::Generate());
+        tenthNote.setTitle(QStringLiteral("Tenth note"));
+        tenthNote.setContent(QStringLiteral("<en-note><h1>Tenth note</h1></en-note>"));
+        tenthNote.setCreationTimestamp(QDateTime::currentMSecsSinceEpoch());
+        tenthNote.setModificationTimestamp(tenthNote.creationTimestamp());
+        tenthNote.setNotebookLocalUid(thirdNotebook.localUid());
+        tenthNote.setNotebookGuid(thirdNotebook.guid());
+        tenthNote.setLocal(false);
+        tenthNote.setDirty(false);
+
         m_pLocalStorageManagerAsync->onAddNoteRequest(firstNote, QUuid());
         m_pLocalStorageManagerAsync->onAddNoteRequest(secondNote, QUuid());
         m_pLocalStorageManagerAsync->onAddNoteRequest(thirdNote, QUuid());
         m_pLocalStorageManagerAsync->onAddNoteRequest(fourthNote, QUuid());
         m_pLocalStorageManagerAsync->onAddNoteRequest(fifthNote, QUuid());
         m_pLocalStorageManagerAsync->onAddNoteRequest(sixthNote, QUuid());
+        m_pLocalStorageManagerAsync->onAddNoteRequest(seventhNote, QUuid());
+        m_pLocalStorageManagerAsync->onAddNoteRequest(eighthNote, QUuid());
+        m_pLocalStorageManagerAsync->onAddNoteRequest(ninthNote, QUuid());
+        m_pLocalStorageManagerAsync->onAddNoteRequest(tenthNote, QUuid());
 
         NoteCache noteCache(20);
         NotebookCache notebookCache(3);
@@ -427,7 +481,10 @@ void NoteModelTestHelper::launchTest()
 
         m_model = model;
         m_firstNotebook = firstNotebook;
+        m_secondNotebook = secondNotebook;
         m_noteToExpungeLocalUid = secondNote.localUid();
+        m_noteLocalUidsToDeleteInBatch = QStringList() << seventhNote.localUid() << eighthNote.localUid();
+        m_noteLocalUidsToMoveInBatch = QStringList() << ninthNote.localUid() << tenthNote.localUid();
 
         // Should be able to add the new note model item and get the asynchonous acknowledgement from the local storage about that
         m_expectingNewNoteFromLocalStorage = true;
@@ -580,6 +637,94 @@ void NoteModelTestHelper::onUpdateNoteComplete(Note note, bool updateResources,
         }
         CATCH_EXCEPTION()
 
+        Q_EMIT failure(errorDescription);
+    }
+    else if (m_noteLocalUidsPendingBatchDeletion.contains(note.localUid()))
+    {
+        QNDEBUG(QStringLiteral("NoteModelTestHelper::onUpdateNoteComplete: note deleted in batch = ") << note);
+
+        Q_UNUSED(m_noteLocalUidsPendingBatchDeletion.remove(note.localUid()))
+
+        ErrorString errorDescription;
+
+        try
+        {
+            if (!note.hasDeletionTimestamp()) {
+                FAIL(QStringLiteral("The note marked as deleted in batch by the note model has no deletion timestamp "
+                                    "within the local storage"));
+            }
+
+            if (!m_noteLocalUidsPendingBatchDeletion.isEmpty()) {
+                return;
+            }
+
+            testBatchNoteMove();
+            return;
+        }
+        CATCH_EXCEPTION()
+
+        Q_EMIT failure(errorDescription);
+    }
+    else if (m_noteLocalUidsPendingBatchMove.contains(note.localUid()))
+    {
+        QNDEBUG(QStringLiteral("NoteModelTestHelper::onUpdateNoteComplete: note moved in batch = ") << note);
+
+        Q_UNUSED(m_noteLocalUidsPendingBatchMove.remove(note.localUid()))
+
+        ErrorString errorDescription;
+
+        try
+        {
+            if (!note.hasNotebookLocalUid() || (note.notebookLocalUid() != m_firstNotebook.localUid())) {
+                FAIL(QStringLiteral("The note moved in batch by the note model has not been moved to the target notebook "
+                                    "within the local storage"));
+            }
+
+            if (!m_noteLocalUidsPendingBatchMove.isEmpty()) {
+                return;
+            }
+
+            for(auto it = m_noteLocalUidsToMoveInBatch.constBegin(), end = m_noteLocalUidsToMoveInBatch.constEnd(); it != end; ++it)
+            {
+                const NoteModelItem * item = m_model->itemForLocalUid(*it);
+                if (Q_UNLIKELY(!item)) {
+                    FAIL(QStringLiteral("Can't find the note model item by local uid after moving several notes to another notebook"));
+                }
+
+                if (item->notebookLocalUid() != m_firstNotebook.localUid()) {
+                    FAIL(QStringLiteral("The note model item's notebook local uid doesn't match the one of the notebook the note was moved to"));
+                }
+
+                if (item->notebookName() != m_firstNotebook.name()) {
+                    FAIL(QStringLiteral("The note model item's notebook name doesn't match the name of the notebook the note was moved to: ")
+                         << item->notebookName() << QStringLiteral(", expected ") << m_firstNotebook.name());
+                }
+
+                if (!item->isDirty()) {
+                    FAIL(QStringLiteral("The note model item is not dirty after moving several notes to another notebook"));
+                }
+            }
+
+            // The notes not included into the batch should stay within their original notebook
+            for(auto it = m_noteLocalUidsToDeleteInBatch.constBegin(), end = m_noteLocalUidsToDeleteInBatch.constEnd(); it != end; ++it)
+            {
+                const NoteModelItem * item = m_model->itemForLocalUid(*it);
+                if (Q_UNLIKELY(!item)) {
+                    FAIL(QStringLiteral("Can't find the note model item by local uid after moving several other notes to another notebook"));
+                }
+
+                if (item->notebookLocalUid() != m_secondNotebook.localUid()) {
+                    FAIL(QStringLiteral("The notebook of the note model item not included into the batch move has changed"));
+                }
+            }
+
+            checkSorting(*m_model);
+
+            Q_EMIT success();
+            return;
+        }
+        CATCH_EXCEPTION()
+
         Q_EMIT failure(errorDescription);
     }
 }
@@ -643,7 +788,7 @@ void NoteModelTestHelper::onExpungeNoteComplete(Note note, QUuid requestId)
             FAIL(QStringLiteral("Was able to get the non-null pointer to the note model item while the corresponding note was expunged from local storage"));
         }
 
-        Q_EMIT success();
+        testBatchNoteDeletion();
         return;
     }
     CATCH_EXCEPTION()
@@ -683,6 +828,68 @@ void NoteModelTestHelper::onAddTagFailed(Tag tag, ErrorString errorDescription,
     notifyFailureWithStackTrace(errorDescription);
 }
 
+void NoteModelTestHelper::testBatchNoteDeletion()
+{
+    QNDEBUG(QStringLiteral("NoteModelTestHelper::testBatchNoteDeletion"));
+
+    // Should be able to mark several notes as deleted at once
+    int numRowsBeforeDeletion = m_model->rowCount(QModelIndex());
+
+    for(auto it = m_noteLocalUidsToDeleteInBatch.constBegin(), end = m_noteLocalUidsToDeleteInBatch.constEnd(); it != end; ++it) {
+        Q_UNUSED(m_noteLocalUidsPendingBatchDeletion.insert(*it))
+    }
+
+    int numDeletedNotes = m_model->deleteNotes(m_noteLocalUidsToDeleteInBatch);
+    if (numDeletedNotes != m_noteLocalUidsToDeleteInBatch.size()) {
+        FAIL(QStringLiteral("Unexpected number of notes marked as deleted by the note model: expected ")
+             << m_noteLocalUidsToDeleteInBatch.size() << QStringLiteral(", got ") << numDeletedNotes);
+    }
+
+    // The model including all notes should keep the rows of the deleted notes
+    if (m_model->rowCount(QModelIndex()) != numRowsBeforeDeletion) {
+        FAIL(QStringLiteral("The number of rows in the note model including all notes has changed after marking several notes as deleted"));
+    }
+
+    for(auto it = m_noteLocalUidsToDeleteInBatch.constBegin(), end = m_noteLocalUidsToDeleteInBatch.constEnd(); it != end; ++it)
+    {
+        const NoteModelItem * item = m_model->itemForLocalUid(*it);
+        if (Q_UNLIKELY(!item)) {
+            FAIL(QStringLiteral("Can't find the note model item by local uid after marking several notes as deleted"));
+        }
+
+        if (item->deletionTimestamp() == 0) {
+            FAIL(QStringLiteral("The note model item's deletion timestamp is unexpectedly zero after marking several notes as deleted"));
+        }
+
+        if (!item->isDirty()) {
+            FAIL(QStringLiteral("The note model item is not dirty after marking several notes as deleted"));
+        }
+    }
+
+    // The notes not contained in the model should be ignored by the batch deletion
+    numDeletedNotes = m_model->deleteNotes(QStringList() << UidGenerator::Generate());
+    if (numDeletedNotes != 0) {
+        FAIL(QStringLiteral("The note model has marked as deleted the note it doesn't contain"));
+    }
+
+    checkSorting(*m_model);
+
+    // The batch move is checked once the local storage acknowledges the update of each deleted note
+}
+
+void NoteModelTestHelper::testBatchNoteMove()
+{
+    QNDEBUG(QStringLiteral("NoteModelTestHelper::testBatchNoteMove"));
+
+    // Should be able to move several notes to another notebook at once; the model might need to find the target notebook
+    // in the local storage first so the result is checked once the local storage acknowledges the update of each moved note
+    for(auto it = m_noteLocalUidsToMoveInBatch.constBegin(), end = m_noteLocalUidsToMoveInBatch.constEnd(); it != end; ++it) {
+        Q_UNUSED(m_noteLocalUidsPendingBatchMove.insert(*it))
+    }
+
+    m_model->moveNotesToNotebook(m_noteLocalUidsToMoveInBatch, m_firstNotebook.name());
+}
+
 void NoteModelTestHelper::checkSorting(const NoteModel & model)
 {
     int numRows = model.rowCount(QModelIndex());
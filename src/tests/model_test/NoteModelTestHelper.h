@@ -20,6 +20,7 @@
 #define QUENTIER_TESTS_MODEL_TEST_NOTE_MODEL_TEST_HELPER_H
 
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <QSet>
 
 namespace quentier {
 
@@ -60,6 +61,9 @@ private Q_SLOTS:
     void onAddTagFailed(Tag tag, ErrorString errorDescription, QUuid requestId);
 
 private:
+    void testBatchNoteDeletion();
+    void testBatchNoteMove();
+
     void checkSorting(const NoteModel & model);
     void notifyFailureWithStackTrace(ErrorString errorDescription);
 
@@ -158,7 +162,12 @@ private:
     LocalStorageManagerAsync *          m_pLocalStorageManagerAsync;
     NoteModel *                         m_model;
     Notebook                            m_firstNotebook;
+    Notebook                            m_secondNotebook;
     QString                             m_noteToExpungeLocalUid;
+    QStringList                         m_noteLocalUidsToDeleteInBatch;
+    QStringList                         m_noteLocalUidsToMoveInBatch;
+    QSet<QString>                       m_noteLocalUidsPendingBatchDeletion;
+    QSet<QString>                       m_noteLocalUidsPendingBatchMove;
     bool                                m_expectingNewNoteFromLocalStorage;
     bool                                m_expectingNoteUpdateFromLocalStorage;
     bool                                m_expectingNoteDeletionFromLocalStorage;
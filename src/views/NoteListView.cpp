@@ -133,6 +133,60 @@ QString NoteListView::currentNoteLocalUid() const
     return pItem->localUid();
 }
 
+QStringList NoteListView::neighbourNotesLocalUids(const int numNotesEachSide) const
+{
+    QStringList result;
+
+    NoteFilterModel * pNoteFilterModel = qobject_cast<NoteFilterModel*>(model());
+    if (Q_UNLIKELY(!pNoteFilterModel)) {
+        QNDEBUG(QStringLiteral("Can't return the list of neighbour note local uids: "
+                               "wrong model connected to the note list view"));
+        return result;
+    }
+
+    NoteModel * pNoteModel = qobject_cast<NoteModel*>(pNoteFilterModel->sourceModel());
+    if (Q_UNLIKELY(!pNoteModel)) {
+        QNDEBUG(QStringLiteral("Can't return the list of neighbour note local uids: can't get the source model "
+                               "from the note filter model connected to the note list view"));
+        return result;
+    }
+
+    QModelIndex currentFilterModelIndex = currentIndex();
+    if (!currentFilterModelIndex.isValid()) {
+        QNDEBUG(QStringLiteral("Note view has no valid current index"));
+        return result;
+    }
+
+    int currentRow = currentFilterModelIndex.row();
+    int numRows = pNoteFilterModel->rowCount(currentFilterModelIndex.parent());
+
+    for(int offset = 1; offset <= numNotesEachSide; ++offset)
+    {
+        int rows[2] = { currentRow + offset, currentRow - offset };
+        for(int i = 0; i < 2; ++i)
+        {
+            int row = rows[i];
+            if ((row < 0) || (row >= numRows)) {
+                continue;
+            }
+
+            QModelIndex filterModelIndex = pNoteFilterModel->index(row, currentFilterModelIndex.column(),
+                                                                   currentFilterModelIndex.parent());
+            QModelIndex sourceModelIndex = pNoteFilterModel->mapToSource(filterModelIndex);
+            const NoteModelItem * pItem = pNoteModel->itemForIndex(sourceModelIndex);
+            if (Q_UNLIKELY(!pItem)) {
+                QNWARNING(QStringLiteral("Found no note model item for the neighbour index mapped from filter model "
+                                         "to source model"));
+                continue;
+            }
+
+            result << pItem->localUid();
+        }
+    }
+
+    return result;
+}
+
 const Account & NoteListView::currentAccount() const
 {
     return m_currentAccount;
@@ -466,6 +520,126 @@ void NoteListView::onFavoriteAction()
     pNoteModel->favoriteNote(pAction->data().toString());
 }
 
+void NoteListView::onDeleteNotesAction()
+{
+    QNDEBUG(QStringLiteral("NoteListView::onDeleteNotesAction"));
+
+    QAction * pAction = qobject_cast<QAction*>(sender());
+    if (Q_UNLIKELY(!pAction)) {
+        REPORT_ERROR(QT_TR_NOOP("Internal error: can't delete notes, "
+                                "can't cast the slot invoker to QAction"))
+        return;
+    }
+
+    NoteFilterModel * pNoteFilterModel = qobject_cast<NoteFilterModel*>(model());
+    if (Q_UNLIKELY(!pNoteFilterModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't delete notes: wrong model connected to the note list view"));
+        return;
+    }
+
+    NoteModel * pNoteModel = qobject_cast<NoteModel*>(pNoteFilterModel->sourceModel());
+    if (Q_UNLIKELY(!pNoteModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't delete notes: can't get the source model from the note filter model connected to the note list view"));
+        return;
+    }
+
+    QStringList noteLocalUids = pAction->data().toStringList();
+    int numDeletedNotes = pNoteModel->deleteNotes(noteLocalUids);
+    if (numDeletedNotes != noteLocalUids.size()) {
+        REPORT_ERROR(QT_TR_NOOP("Can't delete some of the notes: can't find the items to be deleted within the model "
+                                "or the notebook restrictions apply"));
+        return;
+    }
+}
+
+void NoteListView::onMoveNotesToOtherNotebookAction()
+{
+    QNDEBUG(QStringLiteral("NoteListView::onMoveNotesToOtherNotebookAction"));
+
+    QAction * pAction = qobject_cast<QAction*>(sender());
+    if (Q_UNLIKELY(!pAction)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't move notes to another notebook: internal error, "
+                                "can't cast the slot invoker to QAction"));
+        return;
+    }
+
+    QStringList actionData = pAction->data().toStringList();
+    if (actionData.size() < 2) {
+        REPORT_ERROR(QT_TR_NOOP("Can't move notes to another notebook: internal error, "
+                                "wrong action data"));
+        return;
+    }
+
+    NoteFilterModel * pNoteFilterModel = qobject_cast<NoteFilterModel*>(model());
+    if (Q_UNLIKELY(!pNoteFilterModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't move notes to another notebook: wrong model connected to the note list view"));
+        return;
+    }
+
+    NoteModel * pNoteModel = qobject_cast<NoteModel*>(pNoteFilterModel->sourceModel());
+    if (Q_UNLIKELY(!pNoteModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't move notes to another notebook: can't get the source model "
+                                "from the note filter model connected to the note list view"));
+        return;
+    }
+
+    QString notebookName = actionData.takeFirst();
+    pNoteModel->moveNotesToNotebook(actionData, notebookName);
+}
+
+void NoteListView::onUnfavoriteNotesAction()
+{
+    QNDEBUG(QStringLiteral("NoteListView::onUnfavoriteNotesAction"));
+
+    QAction * pAction = qobject_cast<QAction*>(sender());
+    if (Q_UNLIKELY(!pAction)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't unfavorite notes: internal error, "
+                                "can't cast the slot invoker to QAction"));
+        return;
+    }
+
+    NoteFilterModel * pNoteFilterModel = qobject_cast<NoteFilterModel*>(model());
+    if (Q_UNLIKELY(!pNoteFilterModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't unfavorite notes: wrong model connected to the note list view"));
+        return;
+    }
+
+    NoteModel * pNoteModel = qobject_cast<NoteModel*>(pNoteFilterModel->sourceModel());
+    if (Q_UNLIKELY(!pNoteModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't unfavorite notes: can't get the source model from the note filter model "
+                                "connected to the note list view"));
+        return;
+    }
+
+    pNoteModel->unfavoriteNotes(pAction->data().toStringList());
+}
+
+void NoteListView::onFavoriteNotesAction()
+{
+    QNDEBUG(QStringLiteral("NoteListView::onFavoriteNotesAction"));
+
+    QAction * pAction = qobject_cast<QAction*>(sender());
+    if (Q_UNLIKELY(!pAction)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't favorite notes: internal error, can't cast the slot invoker to QAction"));
+        return;
+    }
+
+    NoteFilterModel * pNoteFilterModel = qobject_cast<NoteFilterModel*>(model());
+    if (Q_UNLIKELY(!pNoteFilterModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't favorite notes: wrong model connected to the note list view"));
+        return;
+    }
+
+    NoteModel * pNoteModel = qobject_cast<NoteModel*>(pNoteFilterModel->sourceModel());
+    if (Q_UNLIKELY(!pNoteModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't favorite notes: can't get the source model from the note filter model "
+                                "connected to the note list view"));
+        return;
+    }
+
+    pNoteModel->favoriteNotes(pAction->data().toStringList());
+}
+
 void NoteListView::onShowNoteInfoAction()
 {
     QNDEBUG(QStringLiteral("NoteListView::onShowNoteInfoAction"));
@@ -556,6 +730,80 @@ void NoteListView::onExportSeveralNotesToEnexAction()
     Q_EMIT enexExportRequested(noteLocalUids);
 }
 
+void NoteListView::onExportNotesToPdfAction()
+{
+    QNDEBUG(QStringLiteral("NoteListView::onExportNotesToPdfAction"));
+
+    QAction * pAction = qobject_cast<QAction*>(sender());
+    if (Q_UNLIKELY(!pAction)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't export notes to pdf: internal error, can't cast the slot invoker to QAction"));
+        return;
+    }
+
+    QStringList noteLocalUids = pAction->data().toStringList();
+    if (Q_UNLIKELY(noteLocalUids.isEmpty())) {
+        REPORT_ERROR(QT_TR_NOOP("Can't export notes to pdf: internal error, "
+                                "the list of local uids of notes to be exported is empty"));
+        return;
+    }
+
+    Q_EMIT pdfExportRequested(noteLocalUids);
+}
+
+void NoteListView::onExportNotebookToPdfAction()
+{
+    QNDEBUG(QStringLiteral("NoteListView::onExportNotebookToPdfAction"));
+
+    QAction * pAction = qobject_cast<QAction*>(sender());
+    if (Q_UNLIKELY(!pAction)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't export notebook to pdf: internal error, can't cast the slot invoker to QAction"));
+        return;
+    }
+
+    QString notebookLocalUid = pAction->data().toString();
+    if (Q_UNLIKELY(notebookLocalUid.isEmpty())) {
+        REPORT_ERROR(QT_TR_NOOP("Can't export notebook to pdf: internal error, "
+                                "the local uid of the notebook to be exported is empty"));
+        return;
+    }
+
+    NoteFilterModel * pNoteFilterModel = qobject_cast<NoteFilterModel*>(model());
+    if (Q_UNLIKELY(!pNoteFilterModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't export notebook to pdf: wrong model connected to the note list view"));
+        return;
+    }
+
+    const NoteModel * pNoteModel = qobject_cast<const NoteModel*>(pNoteFilterModel->sourceModel());
+    if (Q_UNLIKELY(!pNoteModel)) {
+        REPORT_ERROR(QT_TR_NOOP("Can't export notebook to pdf: can't get the source model from the note filter model "
+                                "connected to the note list view"));
+        return;
+    }
+
+    if (!pNoteModel->allNotesListed()) {
+        REPORT_ERROR(QT_TR_NOOP("Can't export notebook to pdf: not all notes have been loaded yet, "
+                                "please try again later"));
+        return;
+    }
+
+    // All the notes from the notebook are exported, not only the ones passing the current note filters
+    QStringList noteLocalUids;
+    for(int i = 0, numRows = pNoteModel->rowCount(); i < numRows; ++i)
+    {
+        const NoteModelItem * pItem = pNoteModel->itemAtRow(i);
+        if (pItem && (pItem->notebookLocalUid() == notebookLocalUid)) {
+            noteLocalUids << pItem->localUid();
+        }
+    }
+
+    if (noteLocalUids.isEmpty()) {
+        QNDEBUG(QStringLiteral("The notebook has no notes to export"));
+        return;
+    }
+
+    Q_EMIT pdfExportRequested(noteLocalUids);
+}
+
 void NoteListView::onSelectFirstNoteEvent()
 {
     QNDEBUG(QStringLiteral("NoteListView::onSelectFirstNoteEvent"));
@@ -674,7 +922,7 @@ void NoteListView::showContextMenuAtPoint(const QPoint & pos, const QPoint & glo
         showSingleNoteContextMenu(pos, globalPos, *pNoteFilterModel, *pNoteModel);
     }
     else {
-        showMultipleNotesContextMenu(globalPos, noteLocalUids);
+        showMultipleNotesContextMenu(globalPos, noteLocalUids, *pNoteModel);
     }
 }
 
@@ -798,6 +1046,13 @@ void NoteListView::showSingleNoteContextMenu(const QPoint & pos, const QPoint &
     ADD_CONTEXT_MENU_ACTION(tr("Export to enex") + QStringLiteral("..."), m_pNoteItemContextMenu,
                             onExportSingleNoteToEnexAction, pItem->localUid(), true);
 
+    ADD_CONTEXT_MENU_ACTION(tr("Export to pdf") + QStringLiteral("..."), m_pNoteItemContextMenu,
+                            onExportNotesToPdfAction, QStringList(pItem->localUid()), true);
+
+    ADD_CONTEXT_MENU_ACTION(tr("Export notebook to pdf") + QStringLiteral("..."), m_pNoteItemContextMenu,
+                            onExportNotebookToPdfAction, pItem->notebookLocalUid(),
+                            !pItem->notebookLocalUid().isEmpty());
+
     ADD_CONTEXT_MENU_ACTION(tr("Info") + QStringLiteral("..."), m_pNoteItemContextMenu,
                             onShowNoteInfoAction, pItem->localUid(), true);
 
@@ -814,16 +1069,83 @@ void NoteListView::showSingleNoteContextMenu(const QPoint & pos, const QPoint &
     m_pNoteItemContextMenu->exec(globalPos);
 }
 
-void NoteListView::showMultipleNotesContextMenu(const QPoint & globalPos, const QStringList & noteLocalUids)
+void NoteListView::showMultipleNotesContextMenu(const QPoint & globalPos, const QStringList & noteLocalUids,
+                                                const NoteModel & noteModel)
 {
     QNDEBUG(QStringLiteral("NoteListView::showMultipleNotesContextMenu"));
 
     delete m_pNoteItemContextMenu;
     m_pNoteItemContextMenu = new QMenu(this);
 
+    // Same as for the single note, only the non-synchronizable notes can be deleted
+    QStringList deletableNoteLocalUids;
+    QStringList favoritedNoteLocalUids;
+    QStringList unfavoritedNoteLocalUids;
+
+    for(auto it = noteLocalUids.constBegin(), end = noteLocalUids.constEnd(); it != end; ++it)
+    {
+        const NoteModelItem * pItem = noteModel.itemForLocalUid(*it);
+        if (Q_UNLIKELY(!pItem)) {
+            QNWARNING(QStringLiteral("Found no note model item for selected note local uid ") << *it);
+            continue;
+        }
+
+        if (!pItem->isSynchronizable()) {
+            deletableNoteLocalUids << *it;
+        }
+
+        if (pItem->isFavorited()) {
+            favoritedNoteLocalUids << *it;
+        }
+        else {
+            unfavoritedNoteLocalUids << *it;
+        }
+    }
+
+    ADD_CONTEXT_MENU_ACTION(tr("Delete"), m_pNoteItemContextMenu,
+                            onDeleteNotesAction, deletableNoteLocalUids,
+                            !deletableNoteLocalUids.isEmpty());
+
+    const NotebookModel * pNotebookModel = (m_pNotebookItemView
+                                            ? qobject_cast<const NotebookModel*>(m_pNotebookItemView->model())
+                                            : Q_NULLPTR);
+    if (pNotebookModel)
+    {
+        QStringList notebookNames = pNotebookModel->notebookNames(NotebookModel::NotebookFilters(NotebookModel::NotebookFilter::CanCreateNotes));
+        if (!notebookNames.isEmpty())
+        {
+            QMenu * pTargetNotebooksSubMenu = m_pNoteItemContextMenu->addMenu(tr("Move to notebook"));
+            for(auto it = notebookNames.constBegin(), end = notebookNames.constEnd(); it != end; ++it)
+            {
+                // The name of the target notebook goes first, then the local uids of notes to be moved
+                QStringList data;
+                data.reserve(noteLocalUids.size() + 1);
+                data << *it;
+                data << noteLocalUids;
+                ADD_CONTEXT_MENU_ACTION(*it, pTargetNotebooksSubMenu, onMoveNotesToOtherNotebookAction,
+                                        data, true);
+            }
+        }
+    }
+
+    if (!unfavoritedNoteLocalUids.isEmpty()) {
+        ADD_CONTEXT_MENU_ACTION(tr("Favorite"), m_pNoteItemContextMenu,
+                                onFavoriteNotesAction, unfavoritedNoteLocalUids, true);
+    }
+
+    if (!favoritedNoteLocalUids.isEmpty()) {
+        ADD_CONTEXT_MENU_ACTION(tr("Unfavorite"), m_pNoteItemContextMenu,
+                                onUnfavoriteNotesAction, favoritedNoteLocalUids, true);
+    }
+
+    m_pNoteItemContextMenu->addSeparator();
+
     ADD_CONTEXT_MENU_ACTION(tr("Export to enex") + QStringLiteral("..."), m_pNoteItemContextMenu,
                             onExportSeveralNotesToEnexAction, noteLocalUids, true);
 
+    ADD_CONTEXT_MENU_ACTION(tr("Export to pdf") + QStringLiteral("..."), m_pNoteItemContextMenu,
+                            onExportNotesToPdfAction, noteLocalUids, true);
+
     m_pNoteItemContextMenu->show();
     m_pNoteItemContextMenu->exec(globalPos);
 }
@@ -63,6 +63,12 @@ public:
      */
     QString currentNoteLocalUid() const;
 
+    /**
+     * @return local uids of the notes surrounding the current note within the view, nearest first,
+     * at most @param numNotesEachSide above and below the current note
+     */
+    QStringList neighbourNotesLocalUids(const int numNotesEachSide) const;
+
     /**
      * @return the current account
      */
@@ -81,6 +87,7 @@ Q_SIGNALS:
     void copyInAppNoteLinkRequested(QString noteLocalUid, QString noteGuid);
 
     void enexExportRequested(QStringList noteLocalUids);
+    void pdfExportRequested(QStringList noteLocalUids);
 
 public Q_SLOTS:
     /**
@@ -120,12 +127,21 @@ protected Q_SLOTS:
     void onUnfavoriteAction();
     void onFavoriteAction();
 
+    // Actions applied to all the selected notes at once
+    void onDeleteNotesAction();
+    void onMoveNotesToOtherNotebookAction();
+    void onUnfavoriteNotesAction();
+    void onFavoriteNotesAction();
+
     void onShowNoteInfoAction();
     void onCopyInAppNoteLinkAction();
 
     void onExportSingleNoteToEnexAction();
     void onExportSeveralNotesToEnexAction();
 
+    void onExportNotesToPdfAction();
+    void onExportNotebookToPdfAction();
+
     void onSelectFirstNoteEvent();
     void onTrySetLastCurrentNoteByLocalUidEvent();
 
@@ -142,7 +158,8 @@ protected:
     void showContextMenuAtPoint(const QPoint & pos, const QPoint & globalPos);
     void showSingleNoteContextMenu(const QPoint & pos, const QPoint & globalPos,
                                    const NoteFilterModel & noteFilterModel, const NoteModel & noteModel);
-    void showMultipleNotesContextMenu(const QPoint & globalPos, const QStringList & noteLocalUids);
+    void showMultipleNotesContextMenu(const QPoint & globalPos, const QStringList & noteLocalUids,
+                                      const NoteModel & noteModel);
 
 protected:
     QMenu *             m_pNoteItemContextMenu;
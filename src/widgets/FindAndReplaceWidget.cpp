@@ -107,6 +107,21 @@ void FindAndReplaceWidget::setReplaceEnabled(const bool enabled)
     }
 }
 
+void FindAndReplaceWidget::setMatchCount(const int numMatches, const bool complete)
+{
+    QString text = tr("Matches") + QStringLiteral(": ") + QString::number(numMatches);
+    if (!complete) {
+        text += QStringLiteral("...");
+    }
+
+    m_pUI->matchCountLabel->setText(text);
+}
+
+void FindAndReplaceWidget::clearMatchCount()
+{
+    m_pUI->matchCountLabel->clear();
+}
+
 void FindAndReplaceWidget::setFocus()
 {
     m_pUI->findLineEdit->setFocus();
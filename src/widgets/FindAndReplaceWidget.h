@@ -49,6 +49,13 @@ public:
     bool replaceEnabled() const;
     void setReplaceEnabled(const bool enabled);
 
+    /**
+     * Displays the number of occurrences of the text to find within the note;
+     * @param complete is false while the note is still being searched
+     */
+    void setMatchCount(const int numMatches, const bool complete);
+    void clearMatchCount();
+
 public:
     virtual QSize sizeHint() const Q_DECL_OVERRIDE;
     virtual QSize minimumSizeHint() const Q_DECL_OVERRIDE;
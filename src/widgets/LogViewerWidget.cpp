@@ -35,11 +35,16 @@
 #include <QApplication>
 #include <QMenu>
 #include <QCloseEvent>
+#include <QStyleOption>
+#include <QDateTime>
 #include <set>
+#include <cmath>
+#include <algorithm>
 
 #define QUENTIER_NUM_LOG_LEVELS (5)
 #define FETCHING_MORE_TIMER_PERIOD (200)
 #define DELAY_SECTION_RESIZE_TIMER_PERIOD (500)
+#define MAX_CLIPBOARD_TEXT_SIZE (10485760)
 
 namespace quentier {
 
@@ -51,11 +56,15 @@ LogViewerWidget::LogViewerWidget(QWidget * parent) :
     m_pLogViewerFilterModel(new LogViewerFilterModel(this)),
     m_modelFetchingMoreTimer(),
     m_delayedSectionResizeTimer(),
+    m_pendingFullLogEntriesViewResize(false),
+    m_firstLogEntriesViewRowPendingResize(-1),
+    m_lastLogEntriesViewRowPendingResize(-1),
     m_logLevelEnabledCheckboxPtrs(),
     m_pLogEntriesContextMenu(Q_NULLPTR),
     m_minLogLevelBeforeTracing(LogLevel::InfoLevel),
     m_filterByContentBeforeTracing(),
     m_filterByLogLevelBeforeTracing(),
+    m_filterByTimeBeforeTracing(false),
     m_filterOutBeforeRowBeforeTracing(0)
 {
     m_pUi->setupUi(this);
@@ -65,6 +74,9 @@ LogViewerWidget::LogViewerWidget(QWidget * parent) :
 
     m_pUi->statusBarLineEdit->hide();
 
+    m_pUi->saveToFileProgressBar->hide();
+    m_pUi->cancelSavingToFilePushButton->hide();
+
     m_pUi->logEntriesTableView->verticalHeader()->hide();
     m_pUi->logEntriesTableView->setWordWrap(true);
 
@@ -86,6 +98,7 @@ LogViewerWidget::LogViewerWidget(QWidget * parent) :
     setupLogLevels();
     setupLogFiles();
     setupFilterByLogLevelWidget();
+    setupFilterByTimeWidgets();
     startWatchingForLogFilesFolderChanges();
 
     m_pLogViewerFilterModel->setSourceModel(m_pLogViewerModel);
@@ -98,20 +111,35 @@ LogViewerWidget::LogViewerWidget(QWidget * parent) :
                      this, QNSLOT(LogViewerWidget,onCopyAllToClipboardButtonPressed));
     QObject::connect(m_pUi->saveToFilePushButton, QNSIGNAL(QPushButton,clicked),
                      this, QNSLOT(LogViewerWidget,onSaveAllToFileButtonPressed));
+    QObject::connect(m_pUi->cancelSavingToFilePushButton, QNSIGNAL(QPushButton,clicked),
+                     this, QNSLOT(LogViewerWidget,onCancelSavingToFileButtonPressed));
     QObject::connect(m_pUi->clearPushButton, QNSIGNAL(QPushButton,clicked),
                      this, QNSLOT(LogViewerWidget,onClearButtonPressed));
     QObject::connect(m_pUi->resetPushButton, QNSIGNAL(QPushButton,clicked),
                      this, QNSLOT(LogViewerWidget,onResetButtonPressed));
     QObject::connect(m_pUi->tracePushButton, QNSIGNAL(QPushButton,toggled,bool),
                      this, QNSLOT(LogViewerWidget,onTraceButtonToggled,bool));
+    QObject::connect(m_pUi->mergeRotatedLogFilesCheckBox, QNSIGNAL(QCheckBox,toggled,bool),
+                     this, QNSLOT(LogViewerWidget,onMergeRotatedLogFilesCheckboxToggled,bool));
     QObject::connect(m_pUi->logFileWipePushButton, QNSIGNAL(QPushButton,clicked),
                      this, QNSLOT(LogViewerWidget,onWipeLogPushButtonPressed));
     QObject::connect(m_pUi->filterByContentLineEdit, QNSIGNAL(QLineEdit,editingFinished),
                      this, QNSLOT(LogViewerWidget,onFilterByContentEditingFinished));
     QObject::connect(m_pLogViewerModel, QNSIGNAL(LogViewerModel,notifyError,ErrorString),
                      this, QNSLOT(LogViewerWidget,onModelError,ErrorString));
-    QObject::connect(m_pLogViewerModel, QNSIGNAL(LogViewerModel,rowsInserted,QModelIndex,int,int),
+    QObject::connect(m_pLogViewerModel, QNSIGNAL(LogViewerModel,saveEntriesToFileProgress,double),
+                     this, QNSLOT(LogViewerWidget,onSaveEntriesToFileProgress,double));
+    QObject::connect(m_pLogViewerModel, QNSIGNAL(LogViewerModel,saveEntriesToFileFinished,QString,bool,ErrorString),
+                     this, QNSLOT(LogViewerWidget,onSaveEntriesToFileFinished,QString,bool,ErrorString));
+    QObject::connect(m_pLogViewerFilterModel, QNSIGNAL(LogViewerFilterModel,rowsInserted,QModelIndex,int,int),
                      this, QNSLOT(LogViewerWidget,onModelRowsInserted,QModelIndex,int,int));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    QObject::connect(m_pLogViewerFilterModel, QNSIGNAL(LogViewerFilterModel,dataChanged,const QModelIndex&,const QModelIndex&,const QVector<int>&),
+                     this, QNSLOT(LogViewerWidget,onModelDataChanged,const QModelIndex&,const QModelIndex&));
+#else
+    QObject::connect(m_pLogViewerFilterModel, QNSIGNAL(LogViewerFilterModel,dataChanged,const QModelIndex&,const QModelIndex&),
+                     this, QNSLOT(LogViewerWidget,onModelDataChanged,const QModelIndex&,const QModelIndex&));
+#endif
     QObject::connect(m_pUi->logEntriesTableView, QNSIGNAL(QTableView,customContextMenuRequested,QPoint),
                      this, QNSLOT(LogViewerWidget,onLogEntriesViewContextMenuRequested,QPoint));
 }
@@ -196,6 +224,7 @@ void LogViewerWidget::setupLogFiles()
     }
 
     m_pLogViewerModel->setLogFileName(logFileName);
+    updateRotatedLogFileNames();
     resizeLogEntriesViewColumns();
 
     if (!m_modelFetchingMoreTimer.isActive()) {
@@ -241,6 +270,23 @@ void LogViewerWidget::setupFilterByLogLevelWidget()
     }
 }
 
+void LogViewerWidget::setupFilterByTimeWidgets()
+{
+    QDateTime currentDateTime = QDateTime::currentDateTime();
+    m_pUi->filterFromDateTimeEdit->setDateTime(currentDateTime.addSecs(-3600));
+    m_pUi->filterToDateTimeEdit->setDateTime(currentDateTime);
+    m_pUi->filterToDateTimeEdit->setEnabled(false);
+
+    QObject::connect(m_pUi->filterByTimeCheckBox, QNSIGNAL(QCheckBox,toggled,bool),
+                     this, QNSLOT(LogViewerWidget,onFilterByTimeCheckboxToggled,bool));
+    QObject::connect(m_pUi->filterFromDateTimeEdit, QNSIGNAL(QDateTimeEdit,editingFinished),
+                     this, QNSLOT(LogViewerWidget,onFilterByTimeRangeChanged));
+    QObject::connect(m_pUi->filterToDateTimeEdit, QNSIGNAL(QDateTimeEdit,editingFinished),
+                     this, QNSLOT(LogViewerWidget,onFilterByTimeRangeChanged));
+    QObject::connect(m_pUi->jumpToTimePushButton, QNSIGNAL(QPushButton,clicked),
+                     this, QNSLOT(LogViewerWidget,onJumpToTimeButtonPressed));
+}
+
 void LogViewerWidget::onCurrentLogLevelChanged(int index)
 {
     QNDEBUG(QStringLiteral("LogViewerWidget::onCurrentLogLevelChanged: ") << index);
@@ -295,6 +341,79 @@ void LogViewerWidget::onFilterByLogLevelCheckboxToggled(int state)
     scheduleLogEntriesViewColumnsResize();
 }
 
+void LogViewerWidget::onFilterByTimeCheckboxToggled(bool checked)
+{
+    QNDEBUG(QStringLiteral("LogViewerWidget::onFilterByTimeCheckboxToggled: checked = ")
+            << (checked ? QStringLiteral("true") : QStringLiteral("false")));
+
+    m_pUi->filterToDateTimeEdit->setEnabled(checked);
+
+    if (!checked) {
+        m_pLogViewerFilterModel->clearTimeRange();
+        scheduleLogEntriesViewColumnsResize();
+        return;
+    }
+
+    onFilterByTimeRangeChanged();
+}
+
+void LogViewerWidget::onFilterByTimeRangeChanged()
+{
+    m_pUi->statusBarLineEdit->clear();
+    m_pUi->statusBarLineEdit->hide();
+
+    if (!m_pUi->filterByTimeCheckBox->isChecked()) {
+        return;
+    }
+
+    qint64 from = m_pUi->filterFromDateTimeEdit->dateTime().toMSecsSinceEpoch();
+    qint64 to = m_pUi->filterToDateTimeEdit->dateTime().toMSecsSinceEpoch();
+    if (Q_UNLIKELY(from > to)) {
+        ErrorString errorDescription(QT_TR_NOOP("The start of the time range is after its end"));
+        m_pUi->statusBarLineEdit->setText(errorDescription.localizedString());
+        m_pUi->statusBarLineEdit->show();
+        return;
+    }
+
+    m_pLogViewerFilterModel->setTimeRange(from, to);
+    scheduleLogEntriesViewColumnsResize();
+}
+
+void LogViewerWidget::onJumpToTimeButtonPressed()
+{
+    m_pUi->statusBarLineEdit->clear();
+    m_pUi->statusBarLineEdit->hide();
+
+    qint64 timestamp = m_pUi->filterFromDateTimeEdit->dateTime().toMSecsSinceEpoch();
+    int row = m_pLogViewerModel->firstRowAtOrAfterTimestamp(timestamp);
+    if (row < 0) {
+        ErrorString errorDescription(QT_TR_NOOP("Found no log entries at or after the specified time"));
+        m_pUi->statusBarLineEdit->setText(errorDescription.localizedString());
+        m_pUi->statusBarLineEdit->show();
+        return;
+    }
+
+    // The found row itself might be filtered out, in this case jumping to the next displayed one
+    QModelIndex filterModelIndex;
+    for(int numRows = m_pLogViewerModel->rowCount(); row < numRows; ++row)
+    {
+        filterModelIndex = m_pLogViewerFilterModel->mapFromSource(m_pLogViewerModel->index(row, LogViewerModel::Columns::Timestamp));
+        if (filterModelIndex.isValid()) {
+            break;
+        }
+    }
+
+    if (!filterModelIndex.isValid()) {
+        ErrorString errorDescription(QT_TR_NOOP("All log entries at or after the specified time are filtered out"));
+        m_pUi->statusBarLineEdit->setText(errorDescription.localizedString());
+        m_pUi->statusBarLineEdit->show();
+        return;
+    }
+
+    m_pUi->logEntriesTableView->scrollTo(filterModelIndex, QAbstractItemView::PositionAtTop);
+    m_pUi->logEntriesTableView->selectRow(filterModelIndex.row());
+}
+
 void LogViewerWidget::onCurrentLogFileChanged(const QString & currentLogFile)
 {
     m_pUi->statusBarLineEdit->clear();
@@ -305,6 +424,21 @@ void LogViewerWidget::onCurrentLogFileChanged(const QString & currentLogFile)
     }
 
     m_pLogViewerModel->setLogFileName(currentLogFile);
+    updateRotatedLogFileNames();
+}
+
+void LogViewerWidget::onMergeRotatedLogFilesCheckboxToggled(bool checked)
+{
+    Q_UNUSED(checked)
+
+    m_pUi->statusBarLineEdit->clear();
+    m_pUi->statusBarLineEdit->hide();
+
+    updateRotatedLogFileNames();
+
+    if (!m_modelFetchingMoreTimer.isActive()) {
+        m_modelFetchingMoreTimer.start(FETCHING_MORE_TIMER_PERIOD, this);
+    }
 }
 
 void LogViewerWidget::onLogFileDirRemoved(const QString & path)
@@ -318,6 +452,7 @@ void LogViewerWidget::onLogFileDirChanged(const QString & path)
 {
     if (path == QuentierLogFilesDirPath()) {
         setupLogFiles();
+        updateRotatedLogFileNames();
     }
 }
 
@@ -326,8 +461,17 @@ void LogViewerWidget::onCopyAllToClipboardButtonPressed()
     m_pUi->statusBarLineEdit->clear();
     m_pUi->statusBarLineEdit->hide();
 
-    QString text = displayedLogEntriesToString();
+    bool truncated = false;
+    QString text = displayedLogEntriesToString(MAX_CLIPBOARD_TEXT_SIZE, truncated);
     copyStringToClipboard(text);
+
+    if (truncated) {
+        ErrorString errorDescription(QT_TR_NOOP("Too many log entries to copy to clipboard, only the first ones "
+                                                "were copied; use saving to file to get all of them"));
+        QNINFO(errorDescription);
+        m_pUi->statusBarLineEdit->setText(errorDescription.localizedString());
+        m_pUi->statusBarLineEdit->show();
+    }
 }
 
 void LogViewerWidget::onSaveAllToFileButtonPressed()
@@ -367,8 +511,8 @@ void LogViewerWidget::onSaveAllToFileButtonPressed()
         }
     }
 
-    QString text = displayedLogEntriesToString();
-    if (text.isEmpty()) {
+    QVector<int> rows = displayedLogEntriesRows();
+    if (rows.isEmpty()) {
         ErrorString errorDescription(QT_TR_NOOP("No logs to save"));
         m_pUi->statusBarLineEdit->setText(errorDescription.localizedString());
         m_pUi->statusBarLineEdit->show();
@@ -376,18 +520,47 @@ void LogViewerWidget::onSaveAllToFileButtonPressed()
         return;
     }
 
-    QFile file(fileInfo.absoluteFilePath());
-    bool open = file.open(QIODevice::WriteOnly);
-    if (!open) {
-        ErrorString errorDescription(QT_TR_NOOP("Failed to open the target file for writing"));
+    bool res = m_pLogViewerModel->saveEntriesToFile(rows, fileInfo.absoluteFilePath());
+    if (Q_UNLIKELY(!res)) {
+        ErrorString errorDescription(QT_TR_NOOP("The previous saving of the logs to file is still in progress"));
         m_pUi->statusBarLineEdit->setText(errorDescription.localizedString());
         m_pUi->statusBarLineEdit->show();
         Q_UNUSED(errorDescription)
         return;
     }
 
-    Q_UNUSED(file.write(text.toLocal8Bit()))
-    file.close();
+    m_pUi->saveToFilePushButton->setEnabled(false);
+    m_pUi->saveToFileProgressBar->setValue(0);
+    m_pUi->saveToFileProgressBar->show();
+    m_pUi->cancelSavingToFilePushButton->show();
+}
+
+void LogViewerWidget::onCancelSavingToFileButtonPressed()
+{
+    m_pLogViewerModel->cancelSavingEntriesToFile();
+}
+
+void LogViewerWidget::onSaveEntriesToFileProgress(double progress)
+{
+    m_pUi->saveToFileProgressBar->setValue(static_cast<int>(std::floor(progress * 100.0 + 0.5)));
+}
+
+void LogViewerWidget::onSaveEntriesToFileFinished(QString targetFilePath, bool canceled, ErrorString errorDescription)
+{
+    QNDEBUG(QStringLiteral("LogViewerWidget::onSaveEntriesToFileFinished: ") << targetFilePath);
+
+    m_pUi->saveToFilePushButton->setEnabled(true);
+    m_pUi->saveToFileProgressBar->hide();
+    m_pUi->cancelSavingToFilePushButton->hide();
+
+    if (canceled) {
+        return;
+    }
+
+    if (!errorDescription.isEmpty()) {
+        m_pUi->statusBarLineEdit->setText(errorDescription.localizedString());
+        m_pUi->statusBarLineEdit->show();
+    }
 }
 
 void LogViewerWidget::onClearButtonPressed()
@@ -450,6 +623,12 @@ void LogViewerWidget::onTraceButtonToggled(bool checked)
             m_logLevelEnabledCheckboxPtrs[i]->setChecked(true);
         }
         m_pUi->filterByLogLevelTableWidget->setEnabled(false);
+
+        // New entries would be displayed while tracing, the filter by time would only get in the way
+        m_filterByTimeBeforeTracing = m_pUi->filterByTimeCheckBox->isChecked();
+        m_pUi->filterByTimeCheckBox->setChecked(false);
+        m_pUi->filterByTimeCheckBox->setEnabled(false);
+
         m_pUi->logFileWipePushButton->setEnabled(false);
     }
     else
@@ -483,6 +662,11 @@ void LogViewerWidget::onTraceButtonToggled(bool checked)
             m_filterByLogLevelBeforeTracing[i] = false;
         }
         m_pUi->filterByLogLevelTableWidget->setEnabled(true);
+
+        m_pUi->filterByTimeCheckBox->setEnabled(true);
+        m_pUi->filterByTimeCheckBox->setChecked(m_filterByTimeBeforeTracing);
+        m_filterByTimeBeforeTracing = false;
+
         m_pUi->logFileWipePushButton->setEnabled(true);
     }
 
@@ -497,10 +681,20 @@ void LogViewerWidget::onModelError(ErrorString errorDescription)
 
 void LogViewerWidget::onModelRowsInserted(const QModelIndex & parent, int first, int last)
 {
-    Q_UNUSED(parent)
-    Q_UNUSED(first)
-    Q_UNUSED(last)
-    scheduleLogEntriesViewColumnsResize();
+    if (parent.isValid()) {
+        return;
+    }
+
+    scheduleLogEntriesViewRowsResize(first, last);
+}
+
+void LogViewerWidget::onModelDataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid()) {
+        return;
+    }
+
+    scheduleLogEntriesViewRowsResize(topLeft.row(), bottomRight.row());
 }
 
 void LogViewerWidget::onLogEntriesViewContextMenuRequested(const QPoint & pos)
@@ -563,12 +757,12 @@ void LogViewerWidget::onLogEntriesViewCopySelectedItemsAction()
             continue;
         }
 
-        const LogViewerModel::Data * pDataEntry = m_pLogViewerModel->dataEntry(row);
-        if (Q_UNLIKELY(!pDataEntry)) {
+        LogViewerModel::Data dataEntry;
+        if (Q_UNLIKELY(!m_pLogViewerModel->dataEntry(row, dataEntry))) {
             continue;
         }
 
-        strm << m_pLogViewerModel->dataEntryToString(*pDataEntry);
+        strm << m_pLogViewerModel->dataEntryToString(dataEntry);
     }
 
     strm.flush();
@@ -632,8 +826,29 @@ void LogViewerWidget::clear()
     m_pUi->statusBarLineEdit->hide();
 }
 
+void LogViewerWidget::updateRotatedLogFileNames()
+{
+    QStringList rotatedLogFileNames;
+
+    if (m_pUi->mergeRotatedLogFilesCheckBox->isChecked())
+    {
+        QString currentLogFileName = m_pLogViewerModel->logFileName();
+        for(int i = 0, size = m_pUi->logFileComboBox->count(); i < size; ++i)
+        {
+            QString logFileName = m_pUi->logFileComboBox->itemText(i);
+            if (logFileName != currentLogFileName) {
+                rotatedLogFileNames << logFileName;
+            }
+        }
+    }
+
+    m_pLogViewerModel->setRotatedLogFileNames(rotatedLogFileNames);
+}
+
 void LogViewerWidget::scheduleLogEntriesViewColumnsResize()
 {
+    m_pendingFullLogEntriesViewResize = true;
+
     if (m_delayedSectionResizeTimer.isActive()) {
         // Already scheduled
         return;
@@ -653,30 +868,122 @@ void LogViewerWidget::resizeLogEntriesViewColumns()
     }
 
     m_pUi->logEntriesTableView->verticalHeader()->resizeSections(QHeaderView::ResizeToContents);
+
+    m_pendingFullLogEntriesViewResize = false;
+    m_firstLogEntriesViewRowPendingResize = -1;
+    m_lastLogEntriesViewRowPendingResize = -1;
 }
 
-QString LogViewerWidget::displayedLogEntriesToString() const
+void LogViewerWidget::scheduleLogEntriesViewRowsResize(const int first, const int last)
 {
-    QString result;
-    QTextStream strm(&result);
+    if (m_firstLogEntriesViewRowPendingResize < 0) {
+        m_firstLogEntriesViewRowPendingResize = first;
+        m_lastLogEntriesViewRowPendingResize = last;
+    }
+    else {
+        m_firstLogEntriesViewRowPendingResize = std::min(m_firstLogEntriesViewRowPendingResize, first);
+        m_lastLogEntriesViewRowPendingResize = std::max(m_lastLogEntriesViewRowPendingResize, last);
+    }
+
+    if (m_delayedSectionResizeTimer.isActive()) {
+        // Already scheduled
+        return;
+    }
+
+    m_delayedSectionResizeTimer.start(DELAY_SECTION_RESIZE_TIMER_PERIOD, this);
+}
+
+void LogViewerWidget::resizeLogEntriesViewRows(const int first, const int last)
+{
+    QTableView * pView = m_pUi->logEntriesTableView;
+
+    int lastRow = std::min(last, m_pLogViewerFilterModel->rowCount() - 1);
+    if ((first < 0) || (first > lastRow)) {
+        return;
+    }
+
+    QAbstractItemDelegate * pDelegate = pView->itemDelegate();
+    if (Q_UNLIKELY(!pDelegate)) {
+        resizeLogEntriesViewColumns();
+        return;
+    }
 
-    int fromLine = m_pLogViewerFilterModel->filterOutBeforeRow();
-    int numEntries = m_pLogViewerModel->rowCount();
-    for(int i = fromLine; i < numEntries; ++i)
+    QStyleOptionViewItem option;
+    option.initFrom(pView);
+    option.font = pView->font();
+
+    QHeaderView * pHorizontalHeader = pView->horizontalHeader();
+    int numColumns = m_pLogViewerFilterModel->columnCount();
+    QVector<int> columnWidths(numColumns, 0);
+
+    for(int row = first; row <= lastRow; ++row)
     {
-        if (!m_pLogViewerFilterModel->filterAcceptsRow(i, QModelIndex())) {
+        pView->resizeRowToContents(row);
+
+        for(int column = 0; column < numColumns; ++column) {
+            QModelIndex index = m_pLogViewerFilterModel->index(row, column);
+            columnWidths[column] = std::max(columnWidths[column], pDelegate->sizeHint(option, index).width());
+        }
+    }
+
+    // The columns only grow to fit the new rows, the existing rows don't need to be measured again
+    for(int column = 0; column < numColumns; ++column)
+    {
+        int width = columnWidths[column];
+        if (column == LogViewerModel::Columns::SourceFileName) {
+            width = std::min(width, MAX_SOURCE_FILE_NAME_COLUMN_WIDTH);
+        }
+
+        if (width > pHorizontalHeader->sectionSize(column)) {
+            pHorizontalHeader->resizeSection(column, width);
+        }
+    }
+}
+
+QVector<int> LogViewerWidget::displayedLogEntriesRows() const
+{
+    // NOTE: the filter model has already figured out which rows are accepted, no need to check that again
+    int numRows = m_pLogViewerFilterModel->rowCount();
+
+    QVector<int> rows;
+    rows.reserve(numRows);
+
+    for(int i = 0; i < numRows; ++i)
+    {
+        QModelIndex sourceIndex = m_pLogViewerFilterModel->mapToSource(m_pLogViewerFilterModel->index(i, 0));
+        if (Q_UNLIKELY(!sourceIndex.isValid())) {
             continue;
         }
 
-        const LogViewerModel::Data * pDataEntry = m_pLogViewerModel->dataEntry(i);
-        if (Q_UNLIKELY(!pDataEntry)) {
+        rows << sourceIndex.row();
+    }
+
+    return rows;
+}
+
+QString LogViewerWidget::displayedLogEntriesToString(const int maxSize, bool & truncated) const
+{
+    truncated = false;
+
+    QString result;
+    LogViewerModel::Data dataEntry;
+
+    QVector<int> rows = displayedLogEntriesRows();
+    for(auto it = rows.constBegin(), end = rows.constEnd(); it != end; ++it)
+    {
+        if (Q_UNLIKELY(!m_pLogViewerModel->dataEntry(*it, dataEntry))) {
             continue;
         }
 
-        strm << m_pLogViewerModel->dataEntryToString(*pDataEntry);
+        QString dataEntryStr = LogViewerModel::dataEntryToString(dataEntry);
+        if (result.size() + dataEntryStr.size() > maxSize) {
+            truncated = true;
+            break;
+        }
+
+        result += dataEntryStr;
     }
 
-    strm.flush();
     return result;
 }
 
@@ -703,8 +1010,8 @@ void LogViewerWidget::timerEvent(QTimerEvent * pEvent)
     if (pEvent->timerId() == m_modelFetchingMoreTimer.timerId())
     {
         if (m_pLogViewerModel->canFetchMore(QModelIndex())) {
+            // NOTE: the fetched rows are resized on their insertion into the filter model
             m_pLogViewerModel->fetchMore(QModelIndex());
-            scheduleLogEntriesViewColumnsResize();
         }
         else {
             m_modelFetchingMoreTimer.stop();
@@ -712,8 +1019,21 @@ void LogViewerWidget::timerEvent(QTimerEvent * pEvent)
     }
     else if (pEvent->timerId() == m_delayedSectionResizeTimer.timerId())
     {
-        resizeLogEntriesViewColumns();
         m_delayedSectionResizeTimer.stop();
+
+        if (m_pendingFullLogEntriesViewResize) {
+            resizeLogEntriesViewColumns();
+            return;
+        }
+
+        int first = m_firstLogEntriesViewRowPendingResize;
+        int last = m_lastLogEntriesViewRowPendingResize;
+        m_firstLogEntriesViewRowPendingResize = -1;
+        m_lastLogEntriesViewRowPendingResize = -1;
+
+        if (first >= 0) {
+            resizeLogEntriesViewRows(first, last);
+        }
     }
 }
 
@@ -727,4 +1047,14 @@ void LogViewerWidget::closeEvent(QCloseEvent * pEvent)
     QWidget::closeEvent(pEvent);
 }
 
+void LogViewerWidget::changeEvent(QEvent * pEvent)
+{
+    // The cached row heights are no longer valid once the font changes
+    if (pEvent && (pEvent->type() == QEvent::FontChange)) {
+        scheduleLogEntriesViewColumnsResize();
+    }
+
+    QWidget::changeEvent(pEvent);
+}
+
 } // namespace quentier
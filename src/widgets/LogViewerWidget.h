@@ -26,6 +26,7 @@
 #include <QWidget>
 #include <QBasicTimer>
 #include <QModelIndex>
+#include <QVector>
 
 namespace Ui {
 class LogViewerWidget;
@@ -51,19 +52,27 @@ private:
     void setupLogFiles();
     void startWatchingForLogFilesFolderChanges();
     void setupFilterByLogLevelWidget();
+    void setupFilterByTimeWidgets();
 
 private Q_SLOTS:
     void onCurrentLogLevelChanged(int index);
     void onFilterByContentEditingFinished();
     void onFilterByLogLevelCheckboxToggled(int state);
+    void onFilterByTimeCheckboxToggled(bool checked);
+    void onFilterByTimeRangeChanged();
+    void onJumpToTimeButtonPressed();
 
     void onCurrentLogFileChanged(const QString & currentLogFile);
+    void onMergeRotatedLogFilesCheckboxToggled(bool checked);
 
     void onLogFileDirRemoved(const QString & path);
     void onLogFileDirChanged(const QString & path);
 
     void onCopyAllToClipboardButtonPressed();
     void onSaveAllToFileButtonPressed();
+    void onCancelSavingToFileButtonPressed();
+    void onSaveEntriesToFileProgress(double progress);
+    void onSaveEntriesToFileFinished(QString targetFilePath, bool canceled, ErrorString errorDescription);
 
     void onClearButtonPressed();
     void onResetButtonPressed();
@@ -72,6 +81,7 @@ private Q_SLOTS:
 
     void onModelError(ErrorString errorDescription);
     void onModelRowsInserted(const QModelIndex & parent, int first, int last);
+    void onModelDataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight);
 
     void onLogEntriesViewContextMenuRequested(const QPoint & pos);
     void onLogEntriesViewCopySelectedItemsAction();
@@ -82,15 +92,33 @@ private Q_SLOTS:
 private:
     void clear();
 
+    void updateRotatedLogFileNames();
+
     void scheduleLogEntriesViewColumnsResize();
     void resizeLogEntriesViewColumns();
 
-    QString displayedLogEntriesToString() const;
+    /**
+     * Schedules the resizing of only the rows within [@param first, @param last] range of the log entries view
+     * and the growth of columns if these rows need wider ones; unlike scheduleLogEntriesViewColumnsResize,
+     * it doesn't lead to the relayout of all the rows
+     */
+    void scheduleLogEntriesViewRowsResize(const int first, const int last);
+    void resizeLogEntriesViewRows(const int first, const int last);
+
+    QVector<int> displayedLogEntriesRows() const;
+
+    /**
+     * @return the string representation of the displayed log entries which is no larger
+     * than @param maxSize characters; @param truncated is set to true if not all the displayed
+     * log entries fit in
+     */
+    QString displayedLogEntriesToString(const int maxSize, bool & truncated) const;
     void copyStringToClipboard(const QString & text);
 
 private:
     virtual void timerEvent(QTimerEvent * pEvent) Q_DECL_OVERRIDE;
     virtual void closeEvent(QCloseEvent * pEvent) Q_DECL_OVERRIDE;
+    virtual void changeEvent(QEvent * pEvent) Q_DECL_OVERRIDE;
 
 private:
     Ui::LogViewerWidget *   m_pUi;
@@ -102,6 +130,12 @@ private:
     QBasicTimer             m_modelFetchingMoreTimer;
     QBasicTimer             m_delayedSectionResizeTimer;
 
+    // What the delayed section resize timer would resize: either all rows and columns
+    // or only the rows within the range, -1 if there are none
+    bool                    m_pendingFullLogEntriesViewResize;
+    int                     m_firstLogEntriesViewRowPendingResize;
+    int                     m_lastLogEntriesViewRowPendingResize;
+
     QCheckBox *             m_logLevelEnabledCheckboxPtrs[6];
     QMenu *                 m_pLogEntriesContextMenu;
 
@@ -109,6 +143,7 @@ private:
     LogLevel::type          m_minLogLevelBeforeTracing;
     QString                 m_filterByContentBeforeTracing;
     bool                    m_filterByLogLevelBeforeTracing[6];
+    bool                    m_filterByTimeBeforeTracing;
     int                     m_filterOutBeforeRowBeforeTracing;
 };
 
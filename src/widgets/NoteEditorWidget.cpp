@@ -29,6 +29,9 @@
 #include "NewListItemLineEdit.h"
 #include "FindAndReplaceWidget.h"
 #include "../BasicXMLSyntaxHighlighter.h"
+#include "../NotePdfRendererAsync.h"
+#include "../CancellationFlag.h"
+#include "../NoteTextMatchIndex.h"
 #include "../insert-table-tool-button/InsertTableToolButton.h"
 #include "../insert-table-tool-button/TableSettingsDialog.h"
 #include "../color-picker-tool-button/ColorPickerToolButton.h"
@@ -41,7 +44,6 @@ using quentier::NoteTagsWidget;
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <quentier/logging/QuentierLogger.h>
 #include <quentier/types/Resource.h>
-#include <quentier/utility/EventLoopWithExitStatus.h>
 #include <quentier/utility/ApplicationSettings.h>
 #include <quentier/utility/FileIOProcessorAsync.h>
 #include <quentier/utility/MessageBox.h>
@@ -58,6 +60,13 @@ using quentier::NoteTagsWidget;
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QStringListModel>
+#include <QCryptographicHash>
+#include <QThreadPool>
+
+// The rough estimates of the memory held by the note editor's page on its own and per byte of the note's content
+// which is kept as ENML, HTML and the page's document model
+#define NOTE_EDITOR_PAGE_MEMORY_USAGE_ESTIMATE (16 * 1024 * 1024)
+#define NOTE_CONTENT_MEMORY_USAGE_FACTOR (8)
 
 #define CHECK_NOTE_SET() \
     if (Q_UNLIKELY(m_pCurrentNote.isNull()) { \
@@ -87,12 +96,39 @@ NoteEditorWidget::NoteEditorWidget(const Account & account, LocalStorageManagerA
     m_pUndoStack(pUndoStack),
     m_pConvertToNoteDeadlineTimer(Q_NULLPTR),
     m_findCurrentNoteRequestId(),
+    m_findCurrentNoteResourceBinaryDataRequestId(),
+    m_currentNoteResourceLocalUidsPendingBinaryData(),
+    m_currentNoteResourceBinaryDataFetched(false),
+    m_currentNoteResourceBinaryDataLoadFailed(false),
+    m_noteEditorReadOnly(false),
     m_findCurrentNotebookRequestId(),
     m_updateNoteRequestIds(),
+    m_noteSaveInProgress(false),
+    m_saveNoteRequestId(),
+    m_deleteAfterNoteSave(false),
+    m_numPendingNoteConversions(0),
+    m_lastNoteSaveStatus(NoteSaveStatus::Ok),
+    m_lastNoteSaveErrorDescription(),
+    m_pAutoSaveTimer(Q_NULLPTR),
+    m_autoSaveIdleTimeout(DEFAULT_AUTO_SAVE_NOTE_IDLE_TIMEOUT),
+    m_autoSaveMaxDelay(DEFAULT_AUTO_SAVE_NOTE_MAX_DELAY),
+    m_unsavedModificationElapsedTimer(),
+    m_noteEditorHtmlUpToDate(false),
+    m_lastSavedNoteEditorHtmlHash(),
+    m_savingNoteEditorHtmlHash(),
+    m_noteResourcesModified(false),
+    m_hibernated(false),
+    m_hibernationPending(false),
+    m_hibernatedNoteTitleOrPreview(),
+    m_renderNoteToPdfRequestIds(),
+    m_pRenderNoteToPdfCanceled(new QAtomicInt(0)),
+    m_printersPendingNoteSave(),
+    m_printersPendingResourceBinaryData(),
     m_noteLinkInfoByFindNoteRequestIds(),
     m_lastFontSizeComboBoxIndex(-1),
     m_lastFontComboBoxFontFamily(),
     m_lastNoteEditorHtml(),
+    m_pNoteTextMatchIndex(new NoteTextMatchIndex(this)),
     m_stringUtils(),
     m_lastSuggestedFontSize(-1),
     m_lastActualFontSize(-1),
@@ -119,6 +155,7 @@ NoteEditorWidget::NoteEditorWidget(const Account & account, LocalStorageManagerA
     m_pUi->saveNotePushButton->setEnabled(false);
 
     m_pUi->noteNameLineEdit->installEventFilter(this);
+    m_pUi->noteEditor->installEventFilter(this);
 
     m_pUi->noteEditor->setUndoStack(m_pUndoStack.data());
 
@@ -130,12 +167,25 @@ NoteEditorWidget::NoteEditorWidget(const Account & account, LocalStorageManagerA
     m_pUi->tagNameLabelsContainer->setTagModel(&tagModel);
     m_pUi->tagNameLabelsContainer->setLocalStorageManagerThreadWorker(localStorageManagerAsync);
     createConnections(localStorageManagerAsync);
+    readAutoSaveSettings();
 
     QWidget::setAttribute(Qt::WA_DeleteOnClose, /* on = */ true);
 }
 
 NoteEditorWidget::~NoteEditorWidget()
-{}
+{
+    bool renderingNoteToPdf = isRenderingNoteToPdf();
+
+    qDeleteAll(m_printersPendingNoteSave);
+    m_printersPendingNoteSave.clear();
+
+    qDeleteAll(m_printersPendingResourceBinaryData);
+    m_printersPendingResourceBinaryData.clear();
+
+    if (renderingNoteToPdf) {
+        Q_EMIT noteRenderingToPdfFinished();
+    }
+}
 
 QString NoteEditorWidget::noteLocalUid() const
 {
@@ -153,6 +203,9 @@ void NoteEditorWidget::setNoteLocalUid(const QString & noteLocalUid, const bool
             << QStringLiteral(", is new note = ") << (isNewNote ? QStringLiteral("true") : QStringLiteral("false")));
 
     m_noteLocalUid = noteLocalUid;
+    m_hibernated = false;
+    m_hibernationPending = false;
+    m_hibernatedNoteTitleOrPreview.clear();
 
     if (!m_pCurrentNote.isNull() && (m_pCurrentNote->localUid() == noteLocalUid)) {
         QNDEBUG(QStringLiteral("This note is already set to the editor, nothing to do"));
@@ -168,34 +221,18 @@ void NoteEditorWidget::setNoteLocalUid(const QString & noteLocalUid, const bool
 
     m_isNewNote = isNewNote;
 
+    // NOTE: the note is shown without the binary data of its resources first so that its text doesn't wait
+    // for all the resources to be loaded; the cached note might lack the binary data as well. The binary data
+    // is requested once the note is set to the editor
     const Note * pCachedNote = m_noteCache.get(noteLocalUid);
-
-    // The cache might contain the note without resource binary data, need to check for this
-    bool hasMissingResources = false;
-    if (Q_LIKELY(pCachedNote))
-    {
-        QList<Resource> resources = pCachedNote->resources();
-        if (!resources.isEmpty())
-        {
-            for(int i = 0, size = resources.size(); i < size; ++i)
-            {
-                const Resource & resource = resources[i];
-                if (resource.hasDataHash() && !resource.hasDataBody()) {
-                    hasMissingResources = true;
-                    break;
-                }
-            }
-        }
-    }
-
-    if (Q_UNLIKELY(!pCachedNote || hasMissingResources))
+    if (Q_UNLIKELY(!pCachedNote))
     {
         m_findCurrentNoteRequestId = QUuid::createUuid();
         Note dummy;
         dummy.setLocalUid(noteLocalUid);
         QNTRACE(QStringLiteral("Emitting the request to find the current note: local uid = ") << noteLocalUid
                 << QStringLiteral(", request id = ") << m_findCurrentNoteRequestId);
-        Q_EMIT findNote(dummy, /* with resource binary data = */ true, m_findCurrentNoteRequestId);
+        Q_EMIT findNote(dummy, /* with resource binary data = */ false, m_findCurrentNoteRequestId);
         return;
     }
 
@@ -248,6 +285,212 @@ bool NoteEditorWidget::isResolved() const
     return !m_pCurrentNote.isNull() && !m_pCurrentNotebook.isNull();
 }
 
+bool NoteEditorWidget::isLoadingResourceBinaryData() const
+{
+    return !m_findCurrentNoteResourceBinaryDataRequestId.isNull();
+}
+
+void NoteEditorWidget::hibernate()
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::hibernate: note local uid = ") << m_noteLocalUid);
+
+    if (m_hibernated || m_hibernationPending || m_pCurrentNote.isNull()) {
+        return;
+    }
+
+    if (m_noteSaveInProgress || saveModifiedNoteAsync()) {
+        QNDEBUG(QStringLiteral("The note would be released once it is saved"));
+        m_hibernationPending = true;
+        return;
+    }
+
+    completeHibernation();
+}
+
+void NoteEditorWidget::wakeUp()
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::wakeUp: note local uid = ") << m_noteLocalUid);
+
+    m_hibernationPending = false;
+
+    if (!m_hibernated) {
+        return;
+    }
+
+    setNoteLocalUid(m_noteLocalUid, m_isNewNote);
+}
+
+bool NoteEditorWidget::isHibernated() const
+{
+    return m_hibernated;
+}
+
+bool NoteEditorWidget::renderNoteToPdf(QPrinter * pPrinter, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::renderNoteToPdf"));
+
+    QScopedPointer<QPrinter> pPrinterHolder(pPrinter);
+
+    if (Q_UNLIKELY(m_pCurrentNote.isNull())) {
+        errorDescription.setBase(QT_TR_NOOP("Can't render the note: no note is set to the editor"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    if (Q_UNLIKELY(m_currentNoteResourceBinaryDataLoadFailed)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't render the note: the attachments of the note could not be loaded"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    bool renderingNoteToPdf = isRenderingNoteToPdf();
+
+    // NOTE: the note can't be modified until the binary data of its resources is loaded so there's nothing
+    // to save before rendering it
+    if (isPendingResourceBinaryData()) {
+        QNDEBUG(QStringLiteral("The note would be rendered once the binary data of its resources is loaded"));
+        m_printersPendingResourceBinaryData << pPrinterHolder.take();
+    }
+    else if (m_noteSaveInProgress || saveModifiedNoteAsync()) {
+        QNDEBUG(QStringLiteral("The note would be rendered once the modified note is saved"));
+        m_printersPendingNoteSave << pPrinterHolder.take();
+    }
+    else {
+        startRenderingNoteToPdf(pPrinterHolder.take());
+    }
+
+    if (!renderingNoteToPdf && isRenderingNoteToPdf()) {
+        Q_EMIT noteRenderingToPdfStarted();
+    }
+
+    return true;
+}
+
+void NoteEditorWidget::startRenderingNoteToPdf(QPrinter * pPrinter)
+{
+    QScopedPointer<QPrinter> pPrinterHolder(pPrinter);
+
+    if (Q_UNLIKELY(m_pCurrentNote.isNull())) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't render the note: no note is set to the editor"));
+        QNWARNING(errorDescription);
+        Q_EMIT notifyError(errorDescription);
+        return;
+    }
+
+    if (Q_UNLIKELY(m_currentNoteResourceBinaryDataLoadFailed)) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't render the note: the attachments of the note could not be loaded"));
+        QNWARNING(errorDescription);
+        Q_EMIT notifyError(errorDescription);
+        return;
+    }
+
+    if (isPendingResourceBinaryData()) {
+        QNDEBUG(QStringLiteral("The note would be rendered once the binary data of its resources is loaded"));
+        m_printersPendingResourceBinaryData << pPrinterHolder.take();
+        return;
+    }
+
+    QUuid requestId = QUuid::createUuid();
+    Q_UNUSED(m_renderNoteToPdfRequestIds.insert(requestId))
+
+    NotePdfRendererAsync * pRenderer = new NotePdfRendererAsync(*m_pCurrentNote, pPrinterHolder.take(),
+                                                                /* note index = */ 0, requestId,
+                                                                m_pRenderNoteToPdfCanceled);
+    QObject::connect(pRenderer, QNSIGNAL(NotePdfRendererAsync,noteRendered,int,QUuid),
+                     this, QNSLOT(NoteEditorWidget,onNoteRenderedToPdf,int,QUuid),
+                     Qt::QueuedConnection);
+    QObject::connect(pRenderer, QNSIGNAL(NotePdfRendererAsync,failed,ErrorString,int,QUuid),
+                     this, QNSLOT(NoteEditorWidget,onNoteRenderingToPdfFailed,ErrorString,int,QUuid),
+                     Qt::QueuedConnection);
+    QThreadPool::globalInstance()->start(pRenderer);
+
+    QNTRACE(QStringLiteral("Started rendering the note: request id = ") << requestId);
+}
+
+void NoteEditorWidget::checkNoteRenderingToPdfFinished()
+{
+    if (!isRenderingNoteToPdf()) {
+        QNDEBUG(QStringLiteral("No more renderings of the note to pdf"));
+        Q_EMIT noteRenderingToPdfFinished();
+    }
+}
+
+bool NoteEditorWidget::isRenderingNoteToPdf() const
+{
+    return !m_renderNoteToPdfRequestIds.isEmpty() || !m_printersPendingNoteSave.isEmpty() ||
+           !m_printersPendingResourceBinaryData.isEmpty();
+}
+
+void NoteEditorWidget::cancelRenderingNoteToPdf()
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::cancelRenderingNoteToPdf"));
+
+    if (!isRenderingNoteToPdf()) {
+        return;
+    }
+
+    // NOTE: the renderers in progress remove their incomplete files; the renderings started
+    // after this call need the new cancellation flag
+    setCanceled(*m_pRenderNoteToPdfCanceled);
+    m_pRenderNoteToPdfCanceled = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+    m_renderNoteToPdfRequestIds.clear();
+
+    qDeleteAll(m_printersPendingNoteSave);
+    m_printersPendingNoteSave.clear();
+
+    qDeleteAll(m_printersPendingResourceBinaryData);
+    m_printersPendingResourceBinaryData.clear();
+
+    Q_EMIT noteRenderingToPdfFinished();
+}
+
+void NoteEditorWidget::setHibernatedNoteLocalUid(const QString & noteLocalUid, const QString & noteTitleOrPreview)
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::setHibernatedNoteLocalUid: ") << noteLocalUid
+            << QStringLiteral(", title or preview = ") << noteTitleOrPreview);
+
+    if (!m_noteLocalUid.isEmpty()) {
+        setNoteLocalUid(QString());
+    }
+
+    m_noteLocalUid = noteLocalUid;
+    m_isNewNote = false;
+    m_hibernatedNoteTitleOrPreview = noteTitleOrPreview;
+    m_hibernated = true;
+}
+
+qint64 NoteEditorWidget::estimatedMemoryUsage() const
+{
+    return NOTE_EDITOR_PAGE_MEMORY_USAGE_ESTIMATE + estimatedNoteMemoryUsage();
+}
+
+qint64 NoteEditorWidget::estimatedNoteMemoryUsage() const
+{
+    if (m_hibernated || m_pCurrentNote.isNull()) {
+        return 0;
+    }
+
+    qint64 usage = 0;
+
+    if (m_pCurrentNote->hasContent()) {
+        usage += static_cast<qint64>(m_pCurrentNote->content().size()) * NOTE_CONTENT_MEMORY_USAGE_FACTOR;
+    }
+
+    QList<Resource> resources = m_pCurrentNote->resources();
+    for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+    {
+        const Resource & resource = *it;
+        if (resource.hasDataBody()) {
+            usage += static_cast<qint64>(resource.dataBody().size());
+        }
+        else if (resource.hasDataSize()) {
+            usage += static_cast<qint64>(resource.dataSize());
+        }
+    }
+
+    return usage;
+}
+
 bool NoteEditorWidget::isModified() const
 {
     return !m_pCurrentNote.isNull() &&
@@ -261,6 +504,10 @@ bool NoteEditorWidget::hasBeenModified() const
 
 QString NoteEditorWidget::titleOrPreview() const
 {
+    if (m_hibernated) {
+        return m_hibernatedNoteTitleOrPreview;
+    }
+
     if (Q_UNLIKELY(m_pCurrentNote.isNull())) {
         return QString();
     }
@@ -304,26 +551,26 @@ bool NoteEditorWidget::isSpellCheckEnabled() const
     return m_pUi->noteEditor->spellCheckEnabled();
 }
 
-NoteEditorWidget::NoteSaveStatus::type NoteEditorWidget::checkAndSaveModifiedNote(ErrorString & errorDescription)
+bool NoteEditorWidget::saveModifiedNoteAsync()
 {
-    QNDEBUG(QStringLiteral("NoteEditorWidget::checkAndSaveModifiedNote"));
+    QNDEBUG(QStringLiteral("NoteEditorWidget::saveModifiedNoteAsync"));
 
     if (m_pCurrentNote.isNull()) {
         QNDEBUG(QStringLiteral("No note is set to the editor"));
-        return NoteSaveStatus::Ok;
+        return false;
     }
 
     if (m_pCurrentNote->hasDeletionTimestamp()) {
         QNDEBUG(QStringLiteral("The note is deleted which means it just got deleted and the editor is closing => "
                                "there is no need to save whatever is left in the editor for this note"));
-        return NoteSaveStatus::Ok;
+        return false;
     }
 
     bool noteContentModified = m_pUi->noteEditor->isModified();
 
     if (!m_noteTitleIsEdited && !noteContentModified) {
         QNDEBUG(QStringLiteral("Note is not modified, nothing to save"));
-        return NoteSaveStatus::Ok;
+        return false;
     }
 
     bool noteTitleUpdated = false;
@@ -358,67 +605,78 @@ NoteEditorWidget::NoteSaveStatus::type NoteEditorWidget::checkAndSaveModifiedNot
         attributes.noteTitleQuality.clear();
     }
 
-    if (noteContentModified || noteTitleUpdated)
-    {
-        ApplicationSettings appSettings;
-        appSettings.beginGroup(NOTE_EDITOR_SETTINGS_GROUP_NAME);
-        QVariant editorConvertToNoteTimeoutData = appSettings.value(CONVERT_TO_NOTE_TIMEOUT_SETTINGS_KEY);
-        appSettings.endGroup();
+    if (!noteContentModified && !noteTitleUpdated) {
+        return false;
+    }
 
-        bool conversionResult = false;
-        int editorConvertToNoteTimeout = editorConvertToNoteTimeoutData.toInt(&conversionResult);
-        if (Q_UNLIKELY(!conversionResult)) {
-            QNDEBUG(QStringLiteral("Can't read the timeout for note editor to note conversion from the application settings, "
-                                   "fallback to the default value of ") << DEFAULT_EDITOR_CONVERT_TO_NOTE_TIMEOUT
-                    << QStringLiteral(" milliseconds"));
-            editorConvertToNoteTimeout = DEFAULT_EDITOR_CONVERT_TO_NOTE_TIMEOUT;
-        }
-        else {
-            editorConvertToNoteTimeout = std::max(editorConvertToNoteTimeout, 100);
-        }
+    ApplicationSettings appSettings;
+    appSettings.beginGroup(NOTE_EDITOR_SETTINGS_GROUP_NAME);
+    QVariant editorConvertToNoteTimeoutData = appSettings.value(CONVERT_TO_NOTE_TIMEOUT_SETTINGS_KEY);
+    appSettings.endGroup();
 
-        if (m_pConvertToNoteDeadlineTimer) {
-            m_pConvertToNoteDeadlineTimer->deleteLater();
-        }
+    bool conversionResult = false;
+    int editorConvertToNoteTimeout = editorConvertToNoteTimeoutData.toInt(&conversionResult);
+    if (Q_UNLIKELY(!conversionResult)) {
+        QNDEBUG(QStringLiteral("Can't read the timeout for note editor to note conversion from the application settings, "
+                               "fallback to the default value of ") << DEFAULT_EDITOR_CONVERT_TO_NOTE_TIMEOUT
+                << QStringLiteral(" milliseconds"));
+        editorConvertToNoteTimeout = DEFAULT_EDITOR_CONVERT_TO_NOTE_TIMEOUT;
+    }
+    else {
+        editorConvertToNoteTimeout = std::max(editorConvertToNoteTimeout, 100);
+    }
 
+    if (!m_pConvertToNoteDeadlineTimer) {
         m_pConvertToNoteDeadlineTimer = new QTimer(this);
         m_pConvertToNoteDeadlineTimer->setSingleShot(true);
-
-        EventLoopWithExitStatus eventLoop;
         QObject::connect(m_pConvertToNoteDeadlineTimer, QNSIGNAL(QTimer,timeout),
-                         &eventLoop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
-        QObject::connect(this, QNSIGNAL(NoteEditorWidget,noteSavedInLocalStorage),
-                         &eventLoop, QNSLOT(EventLoopWithExitStatus,exitAsSuccess));
-        QObject::connect(this, QNSIGNAL(NoteEditorWidget,noteSaveInLocalStorageFailed),
-                         &eventLoop, QNSLOT(EventLoopWithExitStatus,exitAsFailure));
-        QObject::connect(this, QNSIGNAL(NoteEditorWidget,conversionToNoteFailed),
-                         &eventLoop, QNSLOT(EventLoopWithExitStatus,exitAsFailure));
-
-        m_pConvertToNoteDeadlineTimer->start(editorConvertToNoteTimeout);
-
-        if (noteContentModified) {
-            QTimer::singleShot(0, m_pUi->noteEditor, SLOT(convertToNote()));
-        }
-        else {
-            QTimer::singleShot(0, this, SLOT(updateNoteInLocalStorage()));
-        }
+                         this, QNSLOT(NoteEditorWidget,onNoteSaveDeadline));
+    }
 
-        int result = eventLoop.exec(QEventLoop::ExcludeUserInputEvents);
+    // The save started now covers all the modifications pending the autosave
+    stopAutoSave();
+    m_savingNoteEditorHtmlHash.clear();
 
-        if (result == EventLoopWithExitStatus::ExitStatus::Failure) {
-            errorDescription.setBase(QT_TR_NOOP("Failed to convert the editor contents to note"));
-            QNWARNING(errorDescription);
-            return NoteSaveStatus::Failed;
-        }
-        else if (result == EventLoopWithExitStatus::ExitStatus::Timeout) {
-            errorDescription.setBase(QT_TR_NOOP("The conversion of note editor contents "
-                                                "to note failed to finish in time"));
-            QNWARNING(errorDescription);
-            return NoteSaveStatus::Timeout;
-        }
+    // NOTE: if the previous save is still in progress, the one started now supersedes it
+    // as it would contain the most recent modifications
+    m_noteSaveInProgress = true;
+    m_saveNoteRequestId = QUuid();
+    m_pConvertToNoteDeadlineTimer->start(editorConvertToNoteTimeout);
+
+    if (noteContentModified) {
+        ++m_numPendingNoteConversions;
+        QTimer::singleShot(0, m_pUi->noteEditor, SLOT(convertToNote()));
+    }
+    else {
+        QTimer::singleShot(0, this, SLOT(updateNoteInLocalStorage()));
     }
 
-    return NoteSaveStatus::Ok;
+    return true;
+}
+
+bool NoteEditorWidget::isSavingNote() const
+{
+    return m_noteSaveInProgress;
+}
+
+void NoteEditorWidget::clearUndoStack()
+{
+    if (!m_pUndoStack.isNull()) {
+        m_pUndoStack->clear();
+    }
+}
+
+void NoteEditorWidget::saveModifiedNoteAndDeleteLater()
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::saveModifiedNoteAndDeleteLater: note local uid = ") << m_noteLocalUid);
+
+    if (m_noteSaveInProgress || saveModifiedNoteAsync() || (m_numPendingNoteConversions > 0)) {
+        QNDEBUG(QStringLiteral("The widget would be deleted once the note is saved"));
+        m_deleteAfterNoteSave = true;
+        return;
+    }
+
+    deleteLater();
 }
 
 bool NoteEditorWidget::isSeparateWindow() const
@@ -477,8 +735,8 @@ bool NoteEditorWidget::printNote(ErrorString & errorDescription)
         return false;
     }
 
-    QPrinter printer;
-    QScopedPointer<QPrintDialog> pPrintDialog(new QPrintDialog(&printer, this));
+    QScopedPointer<QPrinter> pPrinter(new QPrinter);
+    QScopedPointer<QPrintDialog> pPrintDialog(new QPrintDialog(pPrinter.data(), this));
     pPrintDialog->setWindowModality(Qt::WindowModal);
 
     QAbstractPrintDialog::PrintDialogOptions options;
@@ -488,7 +746,7 @@ bool NoteEditorWidget::printNote(ErrorString & errorDescription)
     pPrintDialog->setOptions(options);
 
     if (pPrintDialog->exec() == QDialog::Accepted) {
-        return m_pUi->noteEditor->print(printer, errorDescription);
+        return renderNoteToPdf(pPrinter.take(), errorDescription);
     }
 
     QNTRACE(QStringLiteral("Note printing has been cancelled"));
@@ -581,7 +839,10 @@ bool NoteEditorWidget::exportNoteToPdf(ErrorString & errorDescription)
             appSettings.endGroup();
         }
 
-        return m_pUi->noteEditor->exportToPdf(selectedFiles[0], errorDescription);
+        QScopedPointer<QPrinter> pPrinter(new QPrinter(QPrinter::HighResolution));
+        pPrinter->setOutputFormat(QPrinter::PdfFormat);
+        pPrinter->setOutputFileName(selectedFiles[0]);
+        return renderNoteToPdf(pPrinter.take(), errorDescription);
     }
 
     QNTRACE(QStringLiteral("Exporting the note to pdf has been cancelled"));
@@ -696,10 +957,15 @@ void NoteEditorWidget::closeEvent(QCloseEvent * pEvent)
         return;
     }
 
-    ErrorString errorDescription;
-    NoteSaveStatus::type status = checkAndSaveModifiedNote(errorDescription);
-    QNDEBUG(QStringLiteral("Check and save modified note, status: ") << status
-            << QStringLiteral(", error description: ") << errorDescription);
+    // NOTE: the closing doesn't wait for the note to be saved; if the widget is to be deleted on close,
+    // the deletion is postponed until the save is finished
+    if ((m_noteSaveInProgress || saveModifiedNoteAsync() || (m_numPendingNoteConversions > 0)) &&
+        testAttribute(Qt::WA_DeleteOnClose))
+    {
+        QNDEBUG(QStringLiteral("The note is being saved, the widget would be deleted once the save is finished"));
+        setAttribute(Qt::WA_DeleteOnClose, false);
+        m_deleteAfterNoteSave = true;
+    }
 
     pEvent->accept();
 }
@@ -717,6 +983,13 @@ bool NoteEditorWidget::eventFilter(QObject * pWatched, QEvent * pEvent)
         return true;
     }
 
+    if (m_noteEditorReadOnly && isNoteEditorInputEvent(pEvent->type()) &&
+        ((pWatched == m_pUi->noteEditor) || m_pUi->noteEditor->isAncestorOf(qobject_cast<QWidget*>(pWatched))))
+    {
+        QNTRACE(QStringLiteral("Blocking the input to the note editor while it's read-only"));
+        return true;
+    }
+
     if (pWatched == m_pUi->noteNameLineEdit)
     {
         QEvent::Type eventType = pEvent->type();
@@ -952,6 +1225,7 @@ void NoteEditorWidget::onSaveNoteAction()
     }
 
     m_pUi->saveNotePushButton->setEnabled(false);
+    ++m_numPendingNoteConversions;
     m_pUi->noteEditor->convertToNote();
 }
 
@@ -1120,9 +1394,20 @@ void NoteEditorWidget::onUpdateNoteComplete(Note note, bool updateResources, boo
             << QStringLiteral(", update tags = ") << (updateTags ? QStringLiteral("true") : QStringLiteral("false")));
 
     auto it = m_updateNoteRequestIds.find(requestId);
-    if (it != m_updateNoteRequestIds.end()) {
+    if (it != m_updateNoteRequestIds.end())
+    {
         Q_UNUSED(m_updateNoteRequestIds.erase(it))
+
+        if (updateResources) {
+            m_noteResourcesModified = false;
+        }
+
         Q_EMIT noteSavedInLocalStorage();
+
+        if (m_noteSaveInProgress && (requestId == m_saveNoteRequestId)) {
+            finishNoteSave(NoteSaveStatus::Ok, ErrorString());
+        }
+
         return;
     }
 
@@ -1250,6 +1535,10 @@ void NoteEditorWidget::onUpdateNoteFailed(Note note, bool updateResources, bool
     // NOTE: not clearing out the unsaved stuff because it may be of value to the user
 
     Q_EMIT noteSaveInLocalStorageFailed();
+
+    if (m_noteSaveInProgress && (requestId == m_saveNoteRequestId)) {
+        finishNoteSave(NoteSaveStatus::Failed, error);
+    }
 }
 
 void NoteEditorWidget::onFindNoteComplete(Note note, bool withResourceBinaryData, QUuid requestId)
@@ -1372,6 +1661,45 @@ void NoteEditorWidget::onAddResourceComplete(Resource resource, QUuid requestId)
     m_pUi->noteEditor->setNoteAndNotebook(*m_pCurrentNote, *m_pCurrentNotebook);
 }
 
+void NoteEditorWidget::onFindResourceComplete(Resource resource, bool withBinaryData, QUuid requestId)
+{
+    if (requestId != m_findCurrentNoteResourceBinaryDataRequestId) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NoteEditorWidget::onFindResourceComplete: found the binary data of the current note's resource, ")
+            << QStringLiteral("request id = ") << requestId << QStringLiteral(", with binary data = ")
+            << (withBinaryData ? QStringLiteral("true") : QStringLiteral("false")));
+
+    m_findCurrentNoteResourceBinaryDataRequestId = QUuid();
+    onCurrentNoteResourceBinaryDataFound(resource);
+}
+
+void NoteEditorWidget::onFindResourceFailed(Resource resource, bool withBinaryData, ErrorString errorDescription,
+                                            QUuid requestId)
+{
+    if (requestId != m_findCurrentNoteResourceBinaryDataRequestId) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("NoteEditorWidget::onFindResourceFailed: failed to find the binary data of the current note's ")
+              << QStringLiteral("resource: ") << errorDescription << QStringLiteral(", with binary data = ")
+              << (withBinaryData ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", resource: ")
+              << resource);
+
+    // NOTE: not clearing the request id and leaving the note non-editable: otherwise the note saved from the editor
+    // would lose the binary data of its resources
+    m_currentNoteResourceBinaryDataLoadFailed = true;
+
+    ErrorString error(QT_TR_NOOP("Can't load the attachments of the note, the note can't be edited"));
+    error.appendBase(errorDescription.base());
+    error.appendBase(errorDescription.additionalBases());
+    error.details() = errorDescription.details();
+    Q_EMIT notifyError(error);
+
+    dropPrintersPendingResourceBinaryData(errorDescription);
+}
+
 void NoteEditorWidget::onUpdateResourceComplete(Resource resource, QUuid requestId)
 {
     if (!m_pCurrentNote || !m_pCurrentNotebook) {
@@ -1487,6 +1815,7 @@ void NoteEditorWidget::onNoteEditorModified()
     QNTRACE(QStringLiteral("NoteEditorWidget::onNoteEditorModified"));
 
     m_noteHasBeenModified = true;
+    m_noteEditorHtmlUpToDate = false;
 
     if (!m_pUi->noteEditor->isNoteLoaded()) {
         QNTRACE(QStringLiteral("The note is still being loaded"));
@@ -1495,6 +1824,7 @@ void NoteEditorWidget::onNoteEditorModified()
 
     if (Q_LIKELY(m_pUi->noteEditor->isModified())) {
         m_pUi->saveNotePushButton->setEnabled(true);
+        scheduleAutoSave();
     }
 }
 
@@ -1550,7 +1880,8 @@ void NoteEditorWidget::onNoteTitleUpdated()
     Q_UNUSED(m_updateNoteRequestIds.insert(requestId))
     QNTRACE(QStringLiteral("Emitting the request to update note due to note title update: request id = ") << requestId
             << QStringLiteral(", note = ") << *m_pCurrentNote);
-    Q_EMIT updateNote(*m_pCurrentNote, /* update resources = */ true, /* update tags = */ false, requestId);
+    Q_EMIT updateNote(*m_pCurrentNote, /* update resources = */ m_noteResourcesModified && !isLoadingResourceBinaryData(),
+                      /* update tags = */ false, requestId);
 
     Q_EMIT titleOrPreviewChanged(titleOrPreview());
 }
@@ -1560,13 +1891,37 @@ void NoteEditorWidget::onEditorNoteUpdate(Note note)
     QNDEBUG(QStringLiteral("NoteEditorWidget::onEditorNoteUpdate: note local uid = ") << note.localUid());
     QNTRACE(QStringLiteral("Note: ") << note);
 
-    if (Q_UNLIKELY(!m_pCurrentNote)) {
+    m_numPendingNoteConversions = std::max(m_numPendingNoteConversions - 1, 0);
+
+    // The deadline only applies to the conversion, the note is already being written to the local storage after it
+    if ((m_numPendingNoteConversions == 0) && m_pConvertToNoteDeadlineTimer) {
+        m_pConvertToNoteDeadlineTimer->stop();
+    }
+
+    if (Q_UNLIKELY(!m_pCurrentNote))
+    {
         // That shouldn't really happen in normal circumstances but it could in theory be some old event
         // which has reached this object after the note has already been cleaned up
         QNDEBUG(QStringLiteral("No current note in the note editor widget! Ignoring the update from the note editor"));
+
+        if (m_deleteAfterNoteSave && !m_noteSaveInProgress && (m_numPendingNoteConversions == 0)) {
+            deleteLater();
+        }
+
         return;
     }
 
+    // NOTE: the conversion which has missed the deadline of the save of the widget pending deletion is saved anyway,
+    // the widget is deleted once it is done
+    if (!m_noteSaveInProgress && m_deleteAfterNoteSave) {
+        m_noteSaveInProgress = true;
+    }
+
+    if (noteResourcesDiffer(*m_pCurrentNote, note)) {
+        QNTRACE(QStringLiteral("The note's resources were modified"));
+        m_noteResourcesModified = true;
+    }
+
     QString noteTitle = (m_pCurrentNote->hasTitle() ? m_pCurrentNote->title() : QString());
     *m_pCurrentNote = note;
     m_pCurrentNote->setTitle(noteTitle);
@@ -1586,6 +1941,21 @@ void NoteEditorWidget::onEditorNoteUpdateFailed(ErrorString error)
     Q_EMIT notifyError(error);
 
     Q_EMIT conversionToNoteFailed();
+
+    m_numPendingNoteConversions = std::max(m_numPendingNoteConversions - 1, 0);
+
+    if (m_noteSaveInProgress) {
+        ErrorString errorDescription(QT_TR_NOOP("Failed to convert the editor contents to note"));
+        errorDescription.appendBase(error.base());
+        errorDescription.appendBase(error.additionalBases());
+        errorDescription.details() = error.details();
+        finishNoteSave(NoteSaveStatus::Failed, errorDescription);
+        return;
+    }
+
+    if (m_deleteAfterNoteSave && (m_numPendingNoteConversions == 0)) {
+        deleteLater();
+    }
 }
 
 void NoteEditorWidget::onEditorInAppLinkPasteRequested(QString url, QString userId, QString shardId, QString noteGuid)
@@ -1951,6 +2321,8 @@ void NoteEditorWidget::onEditorHtmlUpdate(QString html)
     QNTRACE(QStringLiteral("NoteEditorWidget::onEditorHtmlUpdate"));
 
     m_lastNoteEditorHtml = html;
+    m_noteEditorHtmlUpToDate = true;
+    m_pNoteTextMatchIndex->setHtml(html);
 
     if (Q_LIKELY(m_pUi->noteEditor->isModified())) {
         m_pUi->saveNotePushButton->setEnabled(true);
@@ -2040,6 +2412,7 @@ void NoteEditorWidget::onFindAndReplaceWidgetClosed()
 {
     QNDEBUG(QStringLiteral("NoteEditorWidget::onFindAndReplaceWidgetClosed"));
     onFindNextInsideNote(QString(), false);
+    m_pUi->findAndReplaceWidget->clearMatchCount();
 }
 
 void NoteEditorWidget::onTextToFindInsideNoteEdited(const QString & textToFind)
@@ -2064,6 +2437,7 @@ void NoteEditorWidget::onFindNextInsideNote(const QString & textToFind, const bo
 
     CHECK_FIND_AND_REPLACE_WIDGET_STATE()
     m_pUi->noteEditor->findNext(textToFind, matchCase);
+    searchInsideNoteText(textToFind, matchCase);
 }
 
 void NoteEditorWidget::onFindPreviousInsideNote(const QString & textToFind, const bool matchCase)
@@ -2074,6 +2448,7 @@ void NoteEditorWidget::onFindPreviousInsideNote(const QString & textToFind, cons
 
     CHECK_FIND_AND_REPLACE_WIDGET_STATE()
     m_pUi->noteEditor->findPrevious(textToFind, matchCase);
+    searchInsideNoteText(textToFind, matchCase);
 }
 
 void NoteEditorWidget::onFindInsideNoteCaseSensitivityChanged(const bool matchCase)
@@ -2085,6 +2460,7 @@ void NoteEditorWidget::onFindInsideNoteCaseSensitivityChanged(const bool matchCa
 
     QString textToFind = m_pUi->findAndReplaceWidget->textToFind();
     m_pUi->noteEditor->findNext(textToFind, matchCase);
+    searchInsideNoteText(textToFind, matchCase);
 }
 
 void NoteEditorWidget::onReplaceInsideNote(const QString & textToReplace,
@@ -2112,11 +2488,49 @@ void NoteEditorWidget::onReplaceAllInsideNote(const QString & textToReplace,
     CHECK_FIND_AND_REPLACE_WIDGET_STATE()
     m_pUi->findAndReplaceWidget->setReplaceEnabled(true);
 
+    // The note editor replaces all the occurrences as a single undoable command; the round trip to the editor
+    // is avoided if the note is already known to contain no occurrences, provided the index finds the text
+    // the same way the editor does
+    searchInsideNoteText(textToReplace, matchCase);
+    if (m_noteEditorHtmlUpToDate && m_pNoteTextMatchIndex->isComplete() &&
+        (m_pNoteTextMatchIndex->numMatches() == 0) &&
+        m_pNoteTextMatchIndex->matchesEditorSearch(textToReplace))
+    {
+        QNDEBUG(QStringLiteral("The text to replace was not found within the note"));
+        return;
+    }
+
     m_pUi->noteEditor->replaceAll(textToReplace, replacementText, matchCase);
 }
 
+void NoteEditorWidget::onNoteTextMatchCountChanged(int numMatches, bool complete)
+{
+    QNTRACE(QStringLiteral("NoteEditorWidget::onNoteTextMatchCountChanged: ") << numMatches
+            << QStringLiteral(", complete = ") << (complete ? QStringLiteral("true") : QStringLiteral("false")));
+
+    if (m_pUi->findAndReplaceWidget->isHidden() || m_pUi->findAndReplaceWidget->textToFind().isEmpty()) {
+        m_pUi->findAndReplaceWidget->clearMatchCount();
+        return;
+    }
+
+    m_pUi->findAndReplaceWidget->setMatchCount(numMatches, complete);
+}
+
 #undef CHECK_FIND_AND_REPLACE_WIDGET_STATE
 
+void NoteEditorWidget::searchInsideNoteText(const QString & textToFind, const bool matchCase)
+{
+    // The note editor's HTML is not available until the editor reports it for the first time
+    if (m_noteEditorHtmlUpToDate) {
+        m_pNoteTextMatchIndex->setHtml(m_lastNoteEditorHtml);
+    }
+    else if (!m_pNoteTextMatchIndex->hasHtml() && !m_pCurrentNote.isNull() && m_pCurrentNote->hasContent()) {
+        m_pNoteTextMatchIndex->setHtml(m_pCurrentNote->content());
+    }
+
+    m_pNoteTextMatchIndex->search(textToFind, matchCase);
+}
+
 void NoteEditorWidget::updateNoteInLocalStorage()
 {
     QNDEBUG(QStringLiteral("NoteEditorWidget::updateNoteInLocalStorage"));
@@ -2137,9 +2551,64 @@ void NoteEditorWidget::updateNoteInLocalStorage()
 
     QUuid requestId = QUuid::createUuid();
     Q_UNUSED(m_updateNoteRequestIds.insert(requestId))
+
+    if (m_noteSaveInProgress) {
+        m_saveNoteRequestId = requestId;
+    }
+
     QNTRACE(QStringLiteral("Emitting the request to update note: request id = ") << requestId
             << QStringLiteral(", note = ") << *m_pCurrentNote);
-    Q_EMIT updateNote(*m_pCurrentNote, /* update resources = */ true, /* update tags = */ false, requestId);
+
+    // NOTE: only the modified resources are written; the resources without the binary data
+    // must not replace the ones in the local storage
+    Q_EMIT updateNote(*m_pCurrentNote, /* update resources = */ m_noteResourcesModified && !isLoadingResourceBinaryData(),
+                      /* update tags = */ false, requestId);
+}
+
+void NoteEditorWidget::onNoteSaveDeadline()
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::onNoteSaveDeadline"));
+
+    if (!m_noteSaveInProgress) {
+        return;
+    }
+
+    ErrorString errorDescription(QT_TR_NOOP("The conversion of note editor contents to note failed to finish in time"));
+    QNWARNING(errorDescription);
+    finishNoteSave(NoteSaveStatus::Timeout, errorDescription);
+}
+
+void NoteEditorWidget::onAutoSaveTimeout()
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::onAutoSaveTimeout: note local uid = ") << m_noteLocalUid);
+
+    if (m_pCurrentNote.isNull() || !m_pUi->noteEditor->isModified()) {
+        QNDEBUG(QStringLiteral("No note modifications to save"));
+        m_unsavedModificationElapsedTimer.invalidate();
+        return;
+    }
+
+    if (m_noteSaveInProgress || isLoadingResourceBinaryData()) {
+        QNDEBUG(QStringLiteral("Can't save the note right now, postponing the autosave"));
+        m_pAutoSaveTimer->start(m_autoSaveIdleTimeout);
+        return;
+    }
+
+    // NOTE: the editor's HTML can only be trusted if it was received after the last modification
+    QByteArray htmlHash;
+    if (m_noteEditorHtmlUpToDate)
+    {
+        htmlHash = noteEditorHtmlHash();
+        if (!m_lastSavedNoteEditorHtmlHash.isEmpty() && (htmlHash == m_lastSavedNoteEditorHtmlHash)) {
+            QNDEBUG(QStringLiteral("The editor contents are the same as the last saved ones, skipping the conversion"));
+            m_unsavedModificationElapsedTimer.invalidate();
+            return;
+        }
+    }
+
+    if (saveModifiedNoteAsync()) {
+        m_savingNoteEditorHtmlHash = htmlHash;
+    }
 }
 
 void NoteEditorWidget::onPrintNoteButtonPressed()
@@ -2164,6 +2633,32 @@ void NoteEditorWidget::onExportNoteToPdfButtonPressed()
     }
 }
 
+void NoteEditorWidget::onNoteRenderedToPdf(int noteIndex, QUuid requestId)
+{
+    Q_UNUSED(noteIndex)
+
+    if (!m_renderNoteToPdfRequestIds.remove(requestId)) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NoteEditorWidget::onNoteRenderedToPdf: request id = ") << requestId);
+    checkNoteRenderingToPdfFinished();
+}
+
+void NoteEditorWidget::onNoteRenderingToPdfFailed(ErrorString errorDescription, int noteIndex, QUuid requestId)
+{
+    Q_UNUSED(noteIndex)
+
+    if (!m_renderNoteToPdfRequestIds.remove(requestId)) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("NoteEditorWidget::onNoteRenderingToPdfFailed: request id = ") << requestId
+              << QStringLiteral(", error: ") << errorDescription);
+    Q_EMIT notifyError(errorDescription);
+    checkNoteRenderingToPdfFinished();
+}
+
 void NoteEditorWidget::onExportNoteToEnexButtonPressed()
 {
     QNDEBUG(QStringLiteral("NoteEditorWidget::onExportNoteToEnexButtonPressed"));
@@ -2189,6 +2684,8 @@ void NoteEditorWidget::createConnections(LocalStorageManagerAsync & localStorage
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateNoteRequest,Note,bool,bool,QUuid));
     QObject::connect(this, QNSIGNAL(NoteEditorWidget,findNote,Note,bool,QUuid),
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindNoteRequest,Note,bool,QUuid));
+    QObject::connect(this, QNSIGNAL(NoteEditorWidget,findResource,Resource,bool,QUuid),
+                     &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindResourceRequest,Resource,bool,QUuid));
     QObject::connect(this, QNSIGNAL(NoteEditorWidget,findNotebook,Notebook,QUuid),
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindNotebookRequest,Notebook,QUuid));
 
@@ -2208,6 +2705,10 @@ void NoteEditorWidget::createConnections(LocalStorageManagerAsync & localStorage
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeNoteComplete,Note,QUuid),
                      this, QNSLOT(NoteEditorWidget,onExpungeNoteComplete,Note,QUuid));
 
+    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findResourceComplete,Resource,bool,QUuid),
+                     this, QNSLOT(NoteEditorWidget,onFindResourceComplete,Resource,bool,QUuid));
+    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findResourceFailed,Resource,bool,ErrorString,QUuid),
+                     this, QNSLOT(NoteEditorWidget,onFindResourceFailed,Resource,bool,ErrorString,QUuid));
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,addResourceComplete,Resource,QUuid),
                      this, QNSLOT(NoteEditorWidget,onAddResourceComplete,Resource,QUuid));
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateResourceComplete,Resource,QUuid),
@@ -2307,6 +2808,8 @@ void NoteEditorWidget::createConnections(LocalStorageManagerAsync & localStorage
                      this, QNSLOT(NoteEditorWidget,onReplaceInsideNote,const QString&,const QString&,const bool));
     QObject::connect(m_pUi->findAndReplaceWidget, QNSIGNAL(FindAndReplaceWidget,replaceAll,const QString&,const QString&,const bool),
                      this, QNSLOT(NoteEditorWidget,onReplaceAllInsideNote,const QString&,const QString&,const bool));
+    QObject::connect(m_pNoteTextMatchIndex, QNSIGNAL(NoteTextMatchIndex,matchCountChanged,int,bool),
+                     this, QNSLOT(NoteEditorWidget,onNoteTextMatchCountChanged,int,bool));
 
     // Connect toolbar buttons actions to local slots
     QObject::connect(m_pUi->fontBoldPushButton, QNSIGNAL(QPushButton,clicked),
@@ -2373,17 +2876,39 @@ void NoteEditorWidget::clear()
 {
     QNDEBUG(QStringLiteral("NoteEditorWidget::clear: note ") << (m_pCurrentNote ? m_pCurrentNote->localUid() : QStringLiteral("<null>")));
 
+    if (m_noteSaveInProgress) {
+        ErrorString errorDescription(QT_TR_NOOP("The note was removed from the editor before it was saved"));
+        QNWARNING(errorDescription);
+        finishNoteSave(NoteSaveStatus::Failed, errorDescription);
+    }
+
     m_pCurrentNote.reset(Q_NULLPTR);
     m_pCurrentNotebook.reset(Q_NULLPTR);
     m_pUi->noteEditor->clear();
     m_pUi->tagNameLabelsContainer->clear();
     m_pUi->noteNameLineEdit->clear();
+    m_pNoteTextMatchIndex->clear();
 
     m_lastNoteTitleOrPreviewText.clear();
 
     m_findCurrentNoteRequestId = QUuid();
+    m_findCurrentNoteResourceBinaryDataRequestId = QUuid();
+    m_currentNoteResourceLocalUidsPendingBinaryData.clear();
+    m_currentNoteResourceBinaryDataFetched = false;
+    m_currentNoteResourceBinaryDataLoadFailed = false;
     m_findCurrentNotebookRequestId = QUuid();
+
+    dropPrintersPendingResourceBinaryData(ErrorString(QT_TR_NOOP("the note was closed before they were loaded")));
+
     m_updateNoteRequestIds.clear();
+
+    stopAutoSave();
+    m_noteEditorHtmlUpToDate = false;
+    m_lastSavedNoteEditorHtmlHash.clear();
+    m_savingNoteEditorHtmlHash.clear();
+    m_noteResourcesModified = false;
+
+    setNoteEditingEnabled(true);
     m_noteLinkInfoByFindNoteRequestIds.clear();
 
     m_pendingEditorSpellChecker = false;
@@ -2433,6 +2958,368 @@ void NoteEditorWidget::onCurrentNoteFound(const Note & note)
     Q_EMIT resolved();
 }
 
+void NoteEditorWidget::onCurrentNoteResourceBinaryDataFound(const Resource & resource)
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::onCurrentNoteResourceBinaryDataFound: resource local uid = ")
+            << resource.localUid());
+
+    if (Q_UNLIKELY(m_pCurrentNote.isNull() || !resource.hasNoteLocalUid() ||
+                   (m_pCurrentNote->localUid() != resource.noteLocalUid())))
+    {
+        QNDEBUG(QStringLiteral("The resource's note is no longer set to the editor"));
+        return;
+    }
+
+    // The note couldn't be edited while the binary data was being loaded so the resource can simply replace
+    // its version without the binary data
+    if (!resource.hasDataBody()) {
+        QNDEBUG(QStringLiteral("The resource has no binary data within the local storage yet"));
+    }
+    else if (Q_UNLIKELY(!m_pCurrentNote->updateResource(resource))) {
+        QNWARNING(QStringLiteral("Could not find the resource with the loaded binary data within the current note: ")
+                  << resource);
+    }
+
+    requestNextCurrentNoteResourceBinaryData();
+}
+
+void NoteEditorWidget::requestCurrentNoteResourceBinaryData()
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::requestCurrentNoteResourceBinaryData"));
+
+    if (!m_findCurrentNoteResourceBinaryDataRequestId.isNull()) {
+        QNDEBUG(QStringLiteral("The binary data is already being loaded"));
+        return;
+    }
+
+    m_currentNoteResourceLocalUidsPendingBinaryData.clear();
+
+    QList<Resource> resources = m_pCurrentNote->resources();
+    for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+    {
+        const Resource & resource = *it;
+        if (resource.hasDataHash() && !resource.hasDataBody()) {
+            m_currentNoteResourceLocalUidsPendingBinaryData << resource.localUid();
+        }
+    }
+
+    requestNextCurrentNoteResourceBinaryData();
+}
+
+void NoteEditorWidget::requestNextCurrentNoteResourceBinaryData()
+{
+    if (!m_currentNoteResourceLocalUidsPendingBinaryData.isEmpty())
+    {
+        Resource dummy;
+        dummy.setLocalUid(m_currentNoteResourceLocalUidsPendingBinaryData.takeFirst());
+
+        m_findCurrentNoteResourceBinaryDataRequestId = QUuid::createUuid();
+        QNTRACE(QStringLiteral("Emitting the request to find the current note's resource with binary data: local uid = ")
+                << dummy.localUid() << QStringLiteral(", request id = ") << m_findCurrentNoteResourceBinaryDataRequestId);
+        Q_EMIT findResource(dummy, /* with binary data = */ true, m_findCurrentNoteResourceBinaryDataRequestId);
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("The binary data of all the current note's resources has been loaded"));
+    m_currentNoteResourceBinaryDataFetched = true;
+
+    // NOTE: the rendering only needs the note itself so it doesn't wait for the notebook
+    if (!m_printersPendingResourceBinaryData.isEmpty())
+    {
+        QList<QPrinter*> printers = m_printersPendingResourceBinaryData;
+        m_printersPendingResourceBinaryData.clear();
+
+        for(auto it = printers.constBegin(), end = printers.constEnd(); it != end; ++it) {
+            startRenderingNoteToPdf(*it);
+        }
+    }
+
+    if (m_pCurrentNotebook.isNull()) {
+        QNDEBUG(QStringLiteral("The notebook is not found yet, the note would be set to the editor once it's found"));
+        return;
+    }
+
+    if (noteHasMissingResourceBinaryData(*m_pCurrentNote)) {
+        QNDEBUG(QStringLiteral("Some resources have no binary data within the local storage yet, "
+                               "the note is considered fully loaded anyway"));
+    }
+
+    // NOTE: the editor is refreshed once all the resources are loaded rather than after each of them since it reloads
+    // the whole note
+    m_pUi->noteEditor->setNoteAndNotebook(*m_pCurrentNote, *m_pCurrentNotebook);
+
+    setNoteEditingEnabled(true);
+    m_pUi->printNotePushButton->setDisabled(false);
+    m_pUi->exportNoteToPdfPushButton->setDisabled(false);
+    m_pUi->exportNoteToEnexPushButton->setDisabled(false);
+}
+
+void NoteEditorWidget::dropPrintersPendingResourceBinaryData(const ErrorString & errorDescription)
+{
+    if (m_printersPendingResourceBinaryData.isEmpty()) {
+        return;
+    }
+
+    qDeleteAll(m_printersPendingResourceBinaryData);
+    m_printersPendingResourceBinaryData.clear();
+
+    ErrorString error(QT_TR_NOOP("Can't render the note: the attachments of the note could not be loaded"));
+    error.appendBase(errorDescription.base());
+    error.appendBase(errorDescription.additionalBases());
+    error.details() = errorDescription.details();
+    QNWARNING(error);
+    Q_EMIT notifyError(error);
+
+    checkNoteRenderingToPdfFinished();
+}
+
+void NoteEditorWidget::setNoteEditingEnabled(const bool enabled)
+{
+    // NOTE: the editor itself is not disabled, otherwise the note couldn't even be scrolled; the input events
+    // are filtered out instead. The web view creates its child widgets lazily so the filter is (re)installed
+    // onto the ones existing by now
+    m_noteEditorReadOnly = !enabled;
+    if (m_noteEditorReadOnly)
+    {
+        QList<QWidget*> noteEditorChildWidgets = m_pUi->noteEditor->findChildren<QWidget*>();
+        for(auto it = noteEditorChildWidgets.constBegin(), end = noteEditorChildWidgets.constEnd(); it != end; ++it) {
+            (*it)->installEventFilter(this);
+        }
+    }
+
+    m_pUi->noteNameLineEdit->setReadOnly(!enabled);
+    m_pUi->tagNameLabelsContainer->setEnabled(enabled);
+}
+
+bool NoteEditorWidget::isNoteEditorInputEvent(const QEvent::Type eventType) const
+{
+    switch(eventType)
+    {
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+    case QEvent::ShortcutOverride:
+    case QEvent::InputMethod:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::DragEnter:
+    case QEvent::DragMove:
+    case QEvent::Drop:
+    case QEvent::ContextMenu:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool NoteEditorWidget::noteHasMissingResourceBinaryData(const Note & note) const
+{
+    QList<Resource> resources = note.resources();
+    for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+    {
+        const Resource & resource = *it;
+        if (resource.hasDataHash() && !resource.hasDataBody()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool NoteEditorWidget::isPendingResourceBinaryData() const
+{
+    // NOTE: the binary data is only requested once the notebook is found too so the note lacking it
+    // might be not loading it yet
+    if (isLoadingResourceBinaryData()) {
+        return true;
+    }
+
+    return !m_pCurrentNote.isNull() && !m_currentNoteResourceBinaryDataFetched &&
+           noteHasMissingResourceBinaryData(*m_pCurrentNote);
+}
+
+void NoteEditorWidget::finishNoteSave(const NoteSaveStatus::type status, const ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::finishNoteSave: status = ") << status
+            << QStringLiteral(", error description: ") << errorDescription);
+
+    m_noteSaveInProgress = false;
+    m_saveNoteRequestId = QUuid();
+
+    if (m_pConvertToNoteDeadlineTimer) {
+        m_pConvertToNoteDeadlineTimer->stop();
+    }
+
+    m_lastNoteSaveStatus = status;
+    m_lastNoteSaveErrorDescription = errorDescription;
+
+    if (status == NoteSaveStatus::Ok) {
+        m_lastSavedNoteEditorHtmlHash = m_savingNoteEditorHtmlHash;
+    }
+
+    m_savingNoteEditorHtmlHash.clear();
+
+    if (!m_printersPendingNoteSave.isEmpty())
+    {
+        QList<QPrinter*> printers = m_printersPendingNoteSave;
+        m_printersPendingNoteSave.clear();
+
+        if (status == NoteSaveStatus::Ok)
+        {
+            for(auto it = printers.constBegin(), end = printers.constEnd(); it != end; ++it) {
+                startRenderingNoteToPdf(*it);
+            }
+        }
+        else
+        {
+            qDeleteAll(printers);
+
+            ErrorString error(QT_TR_NOOP("Can't render the note: failed to save the modified note"));
+            error.appendBase(errorDescription.base());
+            error.appendBase(errorDescription.additionalBases());
+            error.details() = errorDescription.details();
+            QNWARNING(error);
+            Q_EMIT notifyError(error);
+        }
+
+        checkNoteRenderingToPdfFinished();
+    }
+
+    Q_EMIT noteSaveFinished(status, errorDescription);
+
+    if (m_hibernationPending)
+    {
+        m_hibernationPending = false;
+
+        // NOTE: the note which failed to be saved is kept within the editor not to lose the modifications
+        if (status == NoteSaveStatus::Ok) {
+            completeHibernation();
+        }
+    }
+
+    if (m_deleteAfterNoteSave && (m_numPendingNoteConversions == 0)) {
+        deleteLater();
+    }
+}
+
+void NoteEditorWidget::completeHibernation()
+{
+    QNDEBUG(QStringLiteral("NoteEditorWidget::completeHibernation: note local uid = ") << m_noteLocalUid);
+
+    QString noteLocalUid = m_noteLocalUid;
+    QString noteTitleOrPreview = titleOrPreview();
+
+    clear();
+
+    // The undo commands refer to the contents of the editor's page being released
+    clearUndoStack();
+
+    m_noteLocalUid = noteLocalUid;
+    m_hibernatedNoteTitleOrPreview = noteTitleOrPreview;
+    m_hibernated = true;
+}
+
+void NoteEditorWidget::readAutoSaveSettings()
+{
+    ApplicationSettings appSettings;
+    appSettings.beginGroup(NOTE_EDITOR_SETTINGS_GROUP_NAME);
+    QVariant autoSaveIdleTimeoutData = appSettings.value(AUTO_SAVE_NOTE_IDLE_TIMEOUT_SETTINGS_KEY);
+    QVariant autoSaveMaxDelayData = appSettings.value(AUTO_SAVE_NOTE_MAX_DELAY_SETTINGS_KEY);
+    appSettings.endGroup();
+
+    bool conversionResult = false;
+    int autoSaveIdleTimeout = autoSaveIdleTimeoutData.toInt(&conversionResult);
+    if (conversionResult) {
+        // NOTE: zero or negative timeout disables the autosave
+        m_autoSaveIdleTimeout = autoSaveIdleTimeout;
+    }
+
+    conversionResult = false;
+    int autoSaveMaxDelay = autoSaveMaxDelayData.toInt(&conversionResult);
+    if (conversionResult && (autoSaveMaxDelay > 0)) {
+        m_autoSaveMaxDelay = autoSaveMaxDelay;
+    }
+
+    QNDEBUG(QStringLiteral("NoteEditorWidget::readAutoSaveSettings: idle timeout = ") << m_autoSaveIdleTimeout
+            << QStringLiteral(", max delay = ") << m_autoSaveMaxDelay);
+}
+
+void NoteEditorWidget::scheduleAutoSave()
+{
+    if (m_autoSaveIdleTimeout <= 0) {
+        return;
+    }
+
+    if (!m_pAutoSaveTimer) {
+        m_pAutoSaveTimer = new QTimer(this);
+        m_pAutoSaveTimer->setSingleShot(true);
+        QObject::connect(m_pAutoSaveTimer, QNSIGNAL(QTimer,timeout),
+                         this, QNSLOT(NoteEditorWidget,onAutoSaveTimeout));
+    }
+
+    if (!m_unsavedModificationElapsedTimer.isValid()) {
+        m_unsavedModificationElapsedTimer.start();
+    }
+
+    // Each modification postpones the autosave while the editing goes on but not beyond the max delay
+    qint64 remainingDelay = static_cast<qint64>(m_autoSaveMaxDelay) - m_unsavedModificationElapsedTimer.elapsed();
+    qint64 interval = std::max(std::min(static_cast<qint64>(m_autoSaveIdleTimeout), remainingDelay), qint64(0));
+    m_pAutoSaveTimer->start(static_cast<int>(interval));
+}
+
+void NoteEditorWidget::stopAutoSave()
+{
+    if (m_pAutoSaveTimer) {
+        m_pAutoSaveTimer->stop();
+    }
+
+    m_unsavedModificationElapsedTimer.invalidate();
+}
+
+QByteArray NoteEditorWidget::noteEditorHtmlHash() const
+{
+    QByteArray rawHtml = QByteArray::fromRawData(reinterpret_cast<const char*>(m_lastNoteEditorHtml.constData()),
+                                                 m_lastNoteEditorHtml.size() * static_cast<int>(sizeof(QChar)));
+    return QCryptographicHash::hash(rawHtml, QCryptographicHash::Md5);
+}
+
+bool NoteEditorWidget::noteResourcesDiffer(const Note & lhs, const Note & rhs) const
+{
+    QList<Resource> lhsResources = lhs.resources();
+    QList<Resource> rhsResources = rhs.resources();
+
+    if (lhsResources.size() != rhsResources.size()) {
+        return true;
+    }
+
+    for(int i = 0, size = lhsResources.size(); i < size; ++i)
+    {
+        const Resource & lhsResource = lhsResources[i];
+        const Resource & rhsResource = rhsResources[i];
+
+        if (lhsResource.localUid() != rhsResource.localUid()) {
+            return true;
+        }
+
+        // NOTE: the binary data is compared by hashes only; the resource without the hash is considered modified
+        if (!lhsResource.hasDataHash() || !rhsResource.hasDataHash() || (lhsResource.dataHash() != rhsResource.dataHash())) {
+            return true;
+        }
+
+        if ((lhsResource.hasMime() != rhsResource.hasMime()) ||
+            (lhsResource.hasMime() && (lhsResource.mime() != rhsResource.mime())))
+        {
+            return true;
+        }
+
+        if ((lhsResource.hasResourceAttributes() != rhsResource.hasResourceAttributes()) ||
+            (lhsResource.hasResourceAttributes() && (lhsResource.resourceAttributes() != rhsResource.resourceAttributes())))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void NoteEditorWidget::setupSpecialIcons()
 {
     QNDEBUG(QStringLiteral("NoteEditorWidget::setupSpecialIcons"));
@@ -2697,9 +3584,18 @@ void NoteEditorWidget::setNoteAndNotebook(const Note & note, const Notebook & no
     m_pUi->noteEditor->setNoteAndNotebook(note, notebook);
     m_pUi->tagNameLabelsContainer->setCurrentNoteAndNotebook(note, notebook);
 
-    m_pUi->printNotePushButton->setDisabled(false);
-    m_pUi->exportNoteToPdfPushButton->setDisabled(false);
-    m_pUi->exportNoteToEnexPushButton->setDisabled(false);
+    // The note without the binary data of its resources is shown right away but is not editable, printable
+    // or exportable until the binary data is loaded
+    bool missingResourceBinaryData = !m_currentNoteResourceBinaryDataFetched && noteHasMissingResourceBinaryData(note);
+    if (missingResourceBinaryData) {
+        requestCurrentNoteResourceBinaryData();
+    }
+
+    setNoteEditingEnabled(!missingResourceBinaryData);
+
+    m_pUi->printNotePushButton->setDisabled(missingResourceBinaryData);
+    m_pUi->exportNoteToPdfPushButton->setDisabled(missingResourceBinaryData);
+    m_pUi->exportNoteToEnexPushButton->setDisabled(missingResourceBinaryData);
 }
 
 QString NoteEditorWidget::blankPageHtml() const
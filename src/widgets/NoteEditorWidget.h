@@ -36,6 +36,12 @@
 #include <QPointer>
 #include <QUndoStack>
 #include <QPrinter>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QSet>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QEvent>
 
 namespace Ui {
 class NoteEditorWidget;
@@ -50,6 +56,7 @@ QT_FORWARD_DECLARE_CLASS(TagModel)
 QT_FORWARD_DECLARE_CLASS(LocalStorageManagerAsync)
 QT_FORWARD_DECLARE_CLASS(FileIOProcessorAsync)
 QT_FORWARD_DECLARE_CLASS(SpellChecker)
+QT_FORWARD_DECLARE_CLASS(NoteTextMatchIndex)
 
 /**
  * @brief The NoteEditorWidget class contains the actual note editor +
@@ -99,6 +106,41 @@ public:
      */
     bool isResolved() const;
 
+    /**
+     * @return true if the note is shown within the editor without the binary data of its resources which is being
+     * loaded from the local storage; the note can't be edited until the binary data is loaded
+     */
+    bool isLoadingResourceBinaryData() const;
+
+    /**
+     * @brief hibernate - saves the modifications of the note, if any, and then releases the note
+     * and the contents of the editor's page keeping only the note local uid and its title
+     * so that the widget consumes little memory while not being shown; the note is loaded
+     * back into the editor by @link wakeUp @endlink
+     */
+    void hibernate();
+    void wakeUp();
+    bool isHibernated() const;
+
+    /**
+     * @brief setHibernatedNoteLocalUid - sets the note to the editor in the hibernated state right away,
+     * without loading it, so that the note is loaded only once the editor is woken up
+     * @param noteTitleOrPreview - the title or preview text to show for the note until it is loaded
+     */
+    void setHibernatedNoteLocalUid(const QString & noteLocalUid, const QString & noteTitleOrPreview);
+
+    /**
+     * @return the rough estimate of the memory held by the widget, in bytes: the editor's page is kept
+     * even by the hibernated widget, the loaded note is counted on top of it
+     */
+    qint64 estimatedMemoryUsage() const;
+
+    /**
+     * @return the rough estimate of the memory held by the widget for the loaded note, in bytes; that is the memory
+     * released by the hibernation
+     */
+    qint64 estimatedNoteMemoryUsage() const;
+
     /**
      * @return true if the widget currently has a note loaded and somehow changed and the change has not yet been saved
      * within the local storage; false otherwise
@@ -175,14 +217,31 @@ public:
     };
 
     /**
-     * @brief checkAndSaveModifiedNote - if the note editor has some note set and
+     * @brief saveModifiedNoteAsync - if the note editor has some note set and
      * it also contains some modifications to the content of the note which are
-     * not saved yet, this method attempts to save these synchronously
-     * @param errorDescription - contains the textual description of the error
-     * if the method wasn't able to save the note
-     * @return the result of the attempt to save the note synchronously
+     * not saved yet, this method starts saving these without waiting for the save
+     * to finish; the outcome of the save is reported via @link noteSaveFinished @endlink signal
+     * @return true if the save was started, false if there was nothing to save
+     */
+    bool saveModifiedNoteAsync();
+
+    /**
+     * @brief clearUndoStack - removes all the undo commands, i.e. once the note is removed from the editor
+     * which is about to be reused for another note
+     */
+    void clearUndoStack();
+
+    /**
+     * @brief isSavingNote
+     * @return true if the save started by @link saveModifiedNoteAsync @endlink has not finished yet
+     */
+    bool isSavingNote() const;
+
+    /**
+     * @brief saveModifiedNoteAndDeleteLater - starts saving the unsaved modifications of the note, if any,
+     * and schedules the deletion of the widget once the save is finished
      */
-    NoteSaveStatus::type checkAndSaveModifiedNote(ErrorString & errorDescription);
+    void saveModifiedNoteAndDeleteLater();
 
     /**
      * @brief isSeparateWindow
@@ -211,22 +270,32 @@ public:
     void setFocusToEditor();
 
     /**
-     * @brief printNote - attempts to print the note within the editor (if any)
-     * @param errorDescription - the textual description of the error if the note
-     * from the editor could not be printed
-     * @return true if the note was printed successfully, false otherwise
+     * @brief printNote - attempts to print the note within the editor (if any); the note is rendered
+     * onto the printer in background from its ENML rather than from the editor's page, see NotePdfRendererAsync
+     * for what the printed note lacks compared to the editor; the failure to do so is reported via notifyError signal
+     * @param errorDescription - the textual description of the error if the printing of the note
+     * from the editor could not be started
+     * @return true if the printing of the note was started successfully, false otherwise
      */
     bool printNote(ErrorString & errorDescription);
 
     /**
      * @brief exportNoteToPdf - attempts to export the note within the editor (if any)
-     * to a pdf file
-     * @param errorDescription - the textual description of the error if the note
-     * could not be exported to pdf
-     * @return true if the note was exported to pdf successfully, false otherwise
+     * to a pdf file; the note is rendered into the file in background from its ENML rather than from the editor's
+     * page, see NotePdfRendererAsync for what the pdf lacks compared to the editor; the failure to do so
+     * is reported via notifyError signal
+     * @param errorDescription - the textual description of the error if the export of the note
+     * to pdf could not be started
+     * @return true if the export of the note to pdf was started successfully, false otherwise
      */
     bool exportNoteToPdf(ErrorString & errorDescription);
 
+    /**
+     * @return true if the note printed or exported to pdf from the editor is still being rendered
+     * or waits for the modified note to be saved before the rendering, false otherwise
+     */
+    bool isRenderingNoteToPdf() const;
+
     /**
      * @brief exportNoteToEnex - attempts to export the note within the editor (if any)
      * to a enex file
@@ -270,9 +339,27 @@ Q_SIGNALS:
      */
     void inAppNoteLinkClicked(QString userId, QString shardId, QString noteGuid);
 
+    /**
+     * The save started by saveModifiedNoteAsync has finished with the given status
+     */
+    void noteSaveFinished(NoteEditorWidget::NoteSaveStatus::type status, ErrorString errorDescription);
+
+    /**
+     * The note is being printed or exported to pdf: the signal is emitted when the first rendering starts
+     */
+    void noteRenderingToPdfStarted();
+
+    /**
+     * The note printed or exported to pdf is no longer rendered by the editor: all renderings have finished,
+     * failed or were canceled; the signal is also emitted when the editor is destroyed while the rendering
+     * is still in progress, in that case the rendering continues in background
+     */
+    void noteRenderingToPdfFinished();
+
 // private signals
     void updateNote(Note note, bool updateResources, bool updateTags, QUuid requestId);
     void findNote(Note note, bool withResourceBinaryData, QUuid requestId);
+    void findResource(Resource resource, bool withBinaryData, QUuid requestId);
     void findNotebook(Notebook notebook, QUuid requestId);
 
     void noteSavedInLocalStorage();
@@ -284,6 +371,11 @@ Q_SIGNALS:
 public Q_SLOTS:
     virtual void closeEvent(QCloseEvent * pEvent) Q_DECL_OVERRIDE;
 
+    /**
+     * Cancels the printing or the export to pdf of the note from the editor, if any
+     */
+    void cancelRenderingNoteToPdf();
+
     virtual bool eventFilter(QObject * pWatched, QEvent * pEvent) Q_DECL_OVERRIDE;
 
     // Slots for toolbar button actions or external actions
@@ -353,6 +445,8 @@ private Q_SLOTS:
     void onFindNoteFailed(Note note, bool withResourceBinaryData, ErrorString errorDescription, QUuid requestId);
     void onExpungeNoteComplete(Note note, QUuid requestId);
 
+    void onFindResourceComplete(Resource resource, bool withBinaryData, QUuid requestId);
+    void onFindResourceFailed(Resource resource, bool withBinaryData, ErrorString errorDescription, QUuid requestId);
     void onAddResourceComplete(Resource resource, QUuid requestId);
     void onUpdateResourceComplete(Resource resource, QUuid requestId);
     void onExpungeResourceComplete(Resource resource, QUuid requestId);
@@ -411,20 +505,46 @@ private Q_SLOTS:
     void onFindInsideNoteCaseSensitivityChanged(const bool matchCase);
     void onReplaceInsideNote(const QString & textToReplace, const QString & replacementText, const bool matchCase);
     void onReplaceAllInsideNote(const QString & textToReplace, const QString & replacementText, const bool matchCase);
+    void onNoteTextMatchCountChanged(int numMatches, bool complete);
 
     // Helper slot called from QTimer::singleShot
     void updateNoteInLocalStorage();
 
+    void onNoteSaveDeadline();
+    void onAutoSaveTimeout();
+
     // Slots for print/export buttons
     void onPrintNoteButtonPressed();
     void onExportNoteToPdfButtonPressed();
     void onExportNoteToEnexButtonPressed();
 
+    void onNoteRenderedToPdf(int noteIndex, QUuid requestId);
+    void onNoteRenderingToPdfFailed(ErrorString errorDescription, int noteIndex, QUuid requestId);
+
 private:
     void createConnections(LocalStorageManagerAsync & localStorageManagerAsync);
     void clear();
 
     void onCurrentNoteFound(const Note & note);
+    void onCurrentNoteResourceBinaryDataFound(const Resource & resource);
+    void requestCurrentNoteResourceBinaryData();
+    void requestNextCurrentNoteResourceBinaryData();
+    void setNoteEditingEnabled(const bool enabled);
+    bool isNoteEditorInputEvent(const QEvent::Type eventType) const;
+    bool noteHasMissingResourceBinaryData(const Note & note) const;
+    bool isPendingResourceBinaryData() const;
+    void finishNoteSave(const NoteSaveStatus::type status, const ErrorString & errorDescription);
+    void completeHibernation();
+    bool renderNoteToPdf(QPrinter * pPrinter, ErrorString & errorDescription);
+    void startRenderingNoteToPdf(QPrinter * pPrinter);
+    void checkNoteRenderingToPdfFinished();
+    void dropPrintersPendingResourceBinaryData(const ErrorString & errorDescription);
+
+    void readAutoSaveSettings();
+    void scheduleAutoSave();
+    void stopAutoSave();
+    QByteArray noteEditorHtmlHash() const;
+    bool noteResourcesDiffer(const Note & lhs, const Note & rhs) const;
 
     void setupSpecialIcons();
     void setupFontsComboBox();
@@ -433,6 +553,7 @@ private:
     void setupFontSizesForFont(const QFont & font);
 
     void updateNoteSourceView(const QString & html);
+    void searchInsideNoteText(const QString & textToFind, const bool matchCase);
 
     void setNoteAndNotebook(const Note & note, const Notebook & notebook);
 
@@ -470,9 +591,67 @@ private:
     QTimer *                    m_pConvertToNoteDeadlineTimer;
 
     QUuid                       m_findCurrentNoteRequestId;
+    // The binary data of the current note's resources is loaded one resource at a time so that neither the local
+    // storage nor the editor has to handle the data of all the resources at once
+    QUuid                       m_findCurrentNoteResourceBinaryDataRequestId;
+    QStringList                 m_currentNoteResourceLocalUidsPendingBinaryData;
+
+    // Whether the current note's resources were already fetched with their binary data; the resources still
+    // lacking the binary data after that (i.e. not downloaded yet) are not requested again
+    bool                        m_currentNoteResourceBinaryDataFetched;
+
+    // Whether the binary data of some of the current note's resources could not be loaded; such note can't be
+    // rendered to pdf without losing its images
+    bool                        m_currentNoteResourceBinaryDataLoadFailed;
+
+    // While the binary data of the resources is being loaded the note is shown but the input to the editor is blocked
+    bool                        m_noteEditorReadOnly;
     QUuid                       m_findCurrentNotebookRequestId;
     QSet<QUuid>                 m_updateNoteRequestIds;
 
+    // The state of the save started by saveModifiedNoteAsync
+    bool                        m_noteSaveInProgress;
+    QUuid                       m_saveNoteRequestId;
+    bool                        m_deleteAfterNoteSave;
+
+    // The widget is not deleted while the note editor is converting its contents to note, even if the save
+    // has already timed out, not to lose the modifications which would still arrive
+    int                         m_numPendingNoteConversions;
+    NoteSaveStatus::type        m_lastNoteSaveStatus;
+    ErrorString                 m_lastNoteSaveErrorDescription;
+
+    // The autosave happens once the editing pauses for the idle timeout but no later than the max delay
+    // since the first unsaved modification
+    QTimer *                    m_pAutoSaveTimer;
+    int                         m_autoSaveIdleTimeout;
+    int                         m_autoSaveMaxDelay;
+    QElapsedTimer               m_unsavedModificationElapsedTimer;
+
+    // The hashes of the editor's HTML allow to skip the conversion of the editor contents to note
+    // when the contents are the same as the last saved ones
+    bool                        m_noteEditorHtmlUpToDate;
+    QByteArray                  m_lastSavedNoteEditorHtmlHash;
+    QByteArray                  m_savingNoteEditorHtmlHash;
+
+    // Whether the resources of the current note changed since they were last written to the local storage
+    bool                        m_noteResourcesModified;
+
+    bool                        m_hibernated;
+    bool                        m_hibernationPending;
+    QString                     m_hibernatedNoteTitleOrPreview;
+
+    // The note is printed or exported to pdf in background; the rendering is only canceled explicitly,
+    // the pdf requested by user is finished even if the widget is destroyed before that
+    QSet<QUuid>                 m_renderNoteToPdfRequestIds;
+    QSharedPointer<QAtomicInt>  m_pRenderNoteToPdfCanceled;
+
+    // The modified note is saved before it is rendered; the printers wait here for the save to finish
+    QList<QPrinter*>            m_printersPendingNoteSave;
+
+    // The note is rendered along with the images among its resources so the printers requested while the binary
+    // data of the resources is being loaded wait here for it
+    QList<QPrinter*>            m_printersPendingResourceBinaryData;
+
     class NoteLinkInfo: public Printable
     {
     public:
@@ -490,6 +669,9 @@ private:
 
     QString                     m_lastNoteEditorHtml;
 
+    // Counts the occurrences of the text to find within the note in the background
+    NoteTextMatchIndex *        m_pNoteTextMatchIndex;
+
     StringUtils                 m_stringUtils;
 
     int                         m_lastSuggestedFontSize;